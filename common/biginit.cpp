@@ -17,6 +17,7 @@ is in the allocations of memory for the big numbers.
 
 #include <cstdio>
 #include <cstring>
+#include <ctime>
 
 // globals
 int bnstep = 0;
@@ -31,7 +32,7 @@ int rbflength = 0;
 int bfdecimals = 0;
 
 // used internally by bignum.c routines
-static char s_storage[4096];
+static char s_storage[0x10000]; // maxstack plus the corners and params above it
 static bn_t bnroot = BIG_NULL;
 static bn_t stack_ptr = BIG_NULL; // memory allocator base after global variables
 bn_t bntmp1 = BIG_NULL;
@@ -673,3 +674,88 @@ void init_big_pi()
     bf_pi = big_pi;
     bn_pi = big_pi + (bflength-2) - (bnlength-intlength);
 }
+
+/************************************************************************/
+// microseconds per call of op, run for at least a quarter second
+template <typename Op>
+static double usec_per_call(Op op)
+{
+    long calls = 0;
+    std::clock_t const start = std::clock();
+    std::clock_t elapsed;
+    do
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            op();
+        }
+        calls += 16;
+        elapsed = std::clock() - start;
+    }
+    while (elapsed < CLOCKS_PER_SEC/4);
+    return 1.0e6*elapsed/CLOCKS_PER_SEC/calls;
+}
+
+/************************************************************************/
+// debugflag=202: times bignum and bigflt mult, full (double width) mult,
+// square, div and sqrt at 50, 200 and 1000 digits and appends the results
+// to the "bench" file
+void bench_big_math()
+{
+    std::FILE *fp = dir_fopen(g_working_dir.c_str(), "bench", "a");
+    if (fp == nullptr)
+    {
+        return;
+    }
+    std::fprintf(fp, "big math, %d bit limbs\n",
+#if defined(BIG_64_BIT_LIMBS)
+        64
+#else
+        16
+#endif
+    );
+    int const bf_digits = g_bf_digits;
+    g_bf_digits = 0;
+    for (int dec : { 50, 200, 1000 })
+    {
+        init_bf_dec(dec);
+        int const saved = save_stack();
+        bn_t n1 = alloc_stack(bnlength);
+        bn_t n2 = alloc_stack(bnlength);
+        bn_t r = alloc_stack(rlength*2);
+        bf_t f1 = alloc_stack(bflength+2);
+        bf_t f2 = alloc_stack(bflength+2);
+        bf_t fr = alloc_stack((rbflength+2)*2);
+
+        // two fractions, the second one at least 1/2
+        clear_bn(n1);
+        clear_bn(n2);
+        for (int i = 0; i < bnlength-intlength; i++)
+        {
+            n1[i] = (BYTE) rand15();
+            n2[i] = (BYTE) rand15();
+        }
+        n2[bnlength-intlength-1] |= 0x80;
+        bntobf(f1, n1);
+        bntobf(f2, n2);
+
+        std::fprintf(fp, "%5d digits  bignum mult %9.2f  full %9.2f  square %9.2f  div %9.2f  sqrt %9.2f usec\n",
+            dec,
+            usec_per_call([&] { mult_bn(r, n1, n2); }),
+            usec_per_call([&] { full_mult_bn(r, n1, n2); }),
+            usec_per_call([&] { square_bn(r, n1); }),
+            usec_per_call([&] { div_bn(r, n1, n2); }),
+            usec_per_call([&] { sqrt_bn(r, n1); }));
+        std::fprintf(fp, "%5d digits  bigflt mult %9.2f  full %9.2f  square %9.2f  div %9.2f  sqrt %9.2f usec\n",
+            dec,
+            usec_per_call([&] { mult_bf(fr, f1, f2); }),
+            usec_per_call([&] { full_mult_bf(fr, f1, f2); }),
+            usec_per_call([&] { square_bf(fr, f1); }),
+            usec_per_call([&] { div_bf(fr, f1, f2); }),
+            usec_per_call([&] { sqrt_bf(fr, f1); }));
+        restore_stack(saved);
+    }
+    std::fclose(fp);
+    g_bf_digits = bf_digits;
+    free_bf_vars();
+}
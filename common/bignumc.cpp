@@ -8,9 +8,11 @@ Wesley Loewer's Big Numbers.        (C) 1994-95, Wesley B. Loewer
 #include "big.h"
 #include "fractint.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 /********************************************************************
  The following code contains the C versions of the routines from the
@@ -27,7 +29,9 @@ Wesley Loewer's Big Numbers.        (C) 1994-95, Wesley B. Loewer
 
  The 16/32 bit compination of integer sizes could be increased to
  32/64 bit to improve efficiency, but since many compilers don't offer
- 64 bit integers, this option was not included.
+ 64 bit integers, this option was not included.  The multiplications,
+ where nearly all of the time goes, do have a 64/128 bit version for
+ compilers that offer it, see BIG_64_BIT_LIMBS in big.h.
 
 *********************************************************************/
 
@@ -348,6 +352,411 @@ bn_t half_a_bn(bn_t r)
     return r;
 }
 
+#if defined(BIG_64_BIT_LIMBS)
+/************************************************************************
+ The multiplications below load the numbers into 64 bit limbs and use
+ 128 bit products, eight bytes per step instead of two.  bnlength is
+ only a multiple of 4, so the top limb may be half empty.  The partial
+ products are summed column by column: a partial mult or square skips
+ the columns below the rlength bytes it keeps, except for one guard limb
+ to catch most of the carries, the same trade the 16 bit code makes.
+*************************************************************************/
+using U64 = std::uint64_t;
+using U128 = unsigned __int128;
+
+static std::vector<U64> s_limbs1, s_limbs2, s_limb_prod;
+
+// loads the bytes of n into limbs, returns the number of limbs
+static int load_limbs(std::vector<U64> &limbs, bn_t n, int length)
+{
+    int const count = (length + 7) >> 3;
+    limbs.assign(count, 0);
+    std::memcpy(limbs.data(), n, length);
+    return count;
+}
+
+// p += a * b, for the columns from first up; p[0] is column first
+static void mult_limbs(U64 *p, U64 const *a, U64 const *b, int count, int first)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int const j0 = first > i ? first - i : 0;
+        if (j0 >= count)
+        {
+            continue;
+        }
+        U64 const ai = a[i];
+        U64 *pp = p + i + j0 - first;
+        U64 carry = 0;
+        for (int j = j0; j < count; j++)
+        {
+            U128 const sum = (U128) ai * b[j] + *pp + carry;
+            *pp++ = (U64) sum;
+            carry = (U64)(sum >> 64);
+        }
+        *pp = carry; // nothing has been added this high yet
+    }
+}
+
+// p += a^2, for the columns from first up; p[0] is column first
+static void square_limbs(U64 *p, U64 const *a, int count, int first)
+{
+    int const top = 2*count - 1 - first; // highest column, relative to first
+
+    // the middle terms, a[i]*a[j] with i < j
+    for (int i = 0; i < count; i++)
+    {
+        int j0 = first > i ? first - i : 0;
+        if (j0 <= i)
+        {
+            j0 = i + 1;
+        }
+        if (j0 >= count)
+        {
+            continue;
+        }
+        U64 const ai = a[i];
+        U64 *pp = p + i + j0 - first;
+        U64 carry = 0;
+        for (int j = j0; j < count; j++)
+        {
+            U128 const sum = (U128) ai * a[j] + *pp + carry;
+            *pp++ = (U64) sum;
+            carry = (U64)(sum >> 64);
+        }
+        *pp = carry;
+    }
+
+    // double them
+    U64 high = 0;
+    for (int k = 0; k <= top; k++)
+    {
+        U64 const next = p[k] >> 63;
+        p[k] = (p[k] << 1) | high;
+        high = next;
+    }
+
+    // and add in the squared terms
+    for (int i = 0; i < count; i++)
+    {
+        int k = 2*i - first;
+        if (k < -1)
+        {
+            continue;
+        }
+        U128 sum = (U128) a[i] * a[i];
+        if (k < 0)
+        {
+            sum >>= 64; // only the upper half lands in the columns kept
+            k = 0;
+        }
+        for (; sum != 0 && k <= top; k++)
+        {
+            sum += p[k];
+            p[k] = (U64) sum;
+            sum >>= 64;
+        }
+    }
+}
+
+/************************************************************************
+ Above KARATSUBA_LIMBS a full product splits each number in two halves,
+ a = a1*B + a0, and gets by with three half size products instead of four:
+     a*b = a1*b1*B^2 + (a1*b1 + a0*b0 - (a0-a1)*(b0-b1))*B + a0*b0
+ A square needs three half size squares the same way, but a schoolbook
+ square already does half the work, so it takes bigger numbers to pay.
+ A partial product skips about half of the schoolbook steps as well, so
+ it only goes to a full Karatsuba product, which is exact, when the
+ numbers are bigger still.  The thresholds are timings on x86-64, about
+ 600, 3700 and 6200 digits.
+*************************************************************************/
+#define KARATSUBA_LIMBS         32
+#define KARATSUBA_SQUARE_LIMBS  192
+#define KARATSUBA_PARTIAL_LIMBS 320
+
+static std::vector<U64> s_karatsuba_work;
+
+// work space the products of count limbs need, at most
+static int karatsuba_work(int count)
+{
+    if (count < KARATSUBA_LIMBS)
+    {
+        return 0;
+    }
+    int const half = (count + 1) >> 1;
+    return 4*half + std::max(karatsuba_work(half), 2*half + 1);
+}
+
+// d = |x - y|, x has count limbs, y has fewer or the same; true if x < y
+static bool limb_difference(U64 *d, U64 const *x, U64 const *y, int count, int ycount)
+{
+    int i = count - 1;
+    for (; i >= 0; i--)
+    {
+        U64 const yi = i < ycount ? y[i] : 0;
+        if (x[i] != yi)
+        {
+            break;
+        }
+    }
+    bool const less = i >= 0 && x[i] < (i < ycount ? y[i] : 0);
+    if (less)
+    {
+        std::swap(x, y);
+    }
+    U64 borrow = 0;
+    for (int k = 0; k < count; k++)
+    {
+        U64 const xk = less && k >= ycount ? 0 : x[k];
+        U64 const yk = !less && k >= ycount ? 0 : y[k];
+        U64 const diff = xk - yk - borrow;
+        borrow = (xk < yk) || (xk - yk < borrow);
+        d[k] = diff;
+    }
+    return less;
+}
+
+// p[0..2*count) = a*b, or a^2 when b == a
+static void karatsuba(U64 *p, U64 const *a, U64 const *b, int count, U64 *work)
+{
+    bool const square = (a == b);
+    if (count < (square ? KARATSUBA_SQUARE_LIMBS : KARATSUBA_LIMBS))
+    {
+        std::fill(p, p + 2*count, 0);
+        if (square)
+        {
+            square_limbs(p, a, count, 0);
+        }
+        else
+        {
+            mult_limbs(p, a, b, count, 0);
+        }
+        return;
+    }
+
+    int const half = (count + 1) >> 1;   // low half, the high half may be a limb shorter
+    int const high = count - half;
+    U64 *da = work;
+    U64 *db = work + half;
+    U64 *middle = work + 2*half;
+    work += 4*half;
+
+    bool negative = limb_difference(da, a, a + half, half, high);
+    if (square)
+    {
+        negative = false;
+        db = da;
+    }
+    else
+    {
+        negative = negative != limb_difference(db, b, b + half, half, high);
+    }
+    karatsuba(p, a, b, half, work);                         // a0*b0
+    karatsuba(p + 2*half, a + half, b + half, high, work);  // a1*b1
+    karatsuba(middle, da, db, half, work);                  // (a0-a1)*(b0-b1)
+
+    // sum = a0*b0 + a1*b1 -/+ (a0-a1)*(b0-b1), never negative
+    U64 *sum = work;
+    int const sum_limbs = 2*half + 1;
+    U128 carry = 0;
+    for (int k = 0; k < sum_limbs; k++)
+    {
+        carry += k < 2*half ? p[k] : 0;
+        carry += k < 2*high ? p[2*half + k] : 0;
+        sum[k] = (U64) carry;
+        carry >>= 64;
+    }
+    if (negative)
+    {
+        carry = 0;
+        for (int k = 0; k < sum_limbs; k++)
+        {
+            carry += (U128) sum[k] + (k < 2*half ? middle[k] : 0);
+            sum[k] = (U64) carry;
+            carry >>= 64;
+        }
+    }
+    else
+    {
+        U64 borrow = 0;
+        for (int k = 0; k < sum_limbs; k++)
+        {
+            U64 const mk = k < 2*half ? middle[k] : 0;
+            U64 const sk = sum[k];
+            sum[k] = sk - mk - borrow;
+            borrow = (sk < mk) || (sk - mk < borrow);
+        }
+    }
+
+    // add it in, half limbs up
+    carry = 0;
+    for (int k = 0; k < sum_limbs || (carry != 0 && half + k < 2*count); k++)
+    {
+        carry += (U128) p[half + k] + (k < sum_limbs ? sum[k] : 0);
+        p[half + k] = (U64) carry;
+        carry >>= 64;
+    }
+}
+
+// the columns from first up of a*b, or a^2 when b == a; [0] is column first
+static U64 const *product_columns(U64 const *a, U64 const *b, int count, int first)
+{
+    s_limb_prod.assign(2*count + 1, 0);
+    U64 *p = s_limb_prod.data();
+    int const limbs = first != 0 ? KARATSUBA_PARTIAL_LIMBS
+        : a == b ? KARATSUBA_SQUARE_LIMBS : KARATSUBA_LIMBS;
+    if (count >= limbs)
+    {
+        s_karatsuba_work.resize(karatsuba_work(count));
+        karatsuba(p, a, b, count, s_karatsuba_work.data());
+        return p + first;
+    }
+    if (a == b)
+    {
+        square_limbs(p, a, count, first);
+    }
+    else
+    {
+        mult_limbs(p, a, b, count, first);
+    }
+    return p;
+}
+
+/************************************************************************/
+// r = n1 * n2
+// Note: r will be a double wide result, 2*bnlength
+//       n1 and n2 can be the same pointer
+// SIDE-EFFECTS: n1 and n2 are changed to their absolute values
+bn_t unsafe_full_mult_bn(bn_t r, bn_t n1, bn_t n2)
+{
+    bool sign2 = false;
+
+    bool sign1 = is_bn_neg(n1);
+    if (sign1) // =, not ==
+    {
+        neg_a_bn(n1);
+    }
+    const bool samevar = (n1 == n2);
+    if (!samevar) // check to see if they're the same pointer
+    {
+        sign2 = is_bn_neg(n2);
+        if (sign2) // =, not ==
+        {
+            neg_a_bn(n2);
+        }
+    }
+
+    int const count = load_limbs(s_limbs1, n1, bnlength);
+    load_limbs(s_limbs2, n2, bnlength);
+    U64 const *prod = product_columns(s_limbs1.data(), s_limbs2.data(), count, 0);
+    std::memcpy(r, prod, bnlength << 1);
+
+    // if they were the same or same sign, the product must be positive
+    if (!samevar && sign1 != sign2)
+    {
+        bnlength <<= 1;         // for a double wide number
+        neg_a_bn(r);
+        bnlength >>= 1; // restore bnlength
+    }
+    return r;
+}
+
+/************************************************************************/
+// r = n1 * n2 calculating only the top rlength bytes
+// Note: r will be of length rlength
+//       2*bnlength <= rlength < bnlength
+//       n1 and n2 can be the same pointer
+// SIDE-EFFECTS: n1 and n2 are changed to their absolute values
+bn_t unsafe_mult_bn(bn_t r, bn_t n1, bn_t n2)
+{
+    bool sign2 = false;
+    int bnl; // temp bnlength holder
+
+    bnl = bnlength;
+    bool sign1 = is_bn_neg(n1);
+    if (sign1 != 0)   // =, not ==
+    {
+        neg_a_bn(n1);
+    }
+    const bool samevar = (n1 == n2);
+    if (!samevar) // check to see if they're the same pointer
+    {
+        sign2 = is_bn_neg(n2);
+        if (sign2)   // =, not ==
+        {
+            neg_a_bn(n2);
+        }
+    }
+
+    // r starts this many bytes into the full product
+    int const skip = (bnlength << 1) - rlength;
+    int const first = skip >= 16 ? (skip >> 3) - 1 : 0; // one guard limb
+    int const count = load_limbs(s_limbs1, n1, bnlength);
+    load_limbs(s_limbs2, n2, bnlength);
+    U64 const *prod = product_columns(s_limbs1.data(), s_limbs2.data(), count, first);
+    std::memcpy(r, (BYTE const *) prod + skip - (first << 3), rlength);
+
+    // if they were the same or same sign, the product must be positive
+    if (!samevar && sign1 != sign2)
+    {
+        bnlength = rlength;
+        neg_a_bn(r);            // wider bignumber
+        bnlength = bnl;
+    }
+    return r;
+}
+
+/************************************************************************/
+// r = n^2
+//   because of the symetry involved, n^2 is much faster than n*n
+//   for a bignumber of length l
+//      n*n takes l^2 multiplications
+//      n^2 takes (l^2+l)/2 multiplications
+//          which is about 1/2 n*n as l gets large
+//  uses the fact that (a+b+c+...)^2 = (a^2+b^2+c^2+...)+2(ab+ac+bc+...)
+//
+// SIDE-EFFECTS: n is changed to its absolute value
+bn_t unsafe_full_square_bn(bn_t r, bn_t n)
+{
+    if (is_bn_neg(n))    // don't need to keep track of sign since the
+    {
+        neg_a_bn(n);   // answer must be positive.
+    }
+
+    int const count = load_limbs(s_limbs1, n, bnlength);
+    U64 const *prod = product_columns(s_limbs1.data(), s_limbs1.data(), count, 0);
+    std::memcpy(r, prod, bnlength << 1);
+    return r;
+}
+
+/************************************************************************/
+// r = n^2
+//   because of the symetry involved, n^2 is much faster than n*n
+//   for a bignumber of length l
+//      n*n takes l^2 multiplications
+//      n^2 takes (l^2+l)/2 multiplications
+//          which is about 1/2 n*n as l gets large
+//  uses the fact that (a+b+c+...)^2 = (a^2+b^2+c^2+...)+2(ab+ac+bc+...)
+//
+// Note: r will be of length rlength
+//       2*bnlength >= rlength > bnlength
+// SIDE-EFFECTS: n is changed to its absolute value
+bn_t unsafe_square_bn(bn_t r, bn_t n)
+{
+    if (is_bn_neg(n))    // don't need to keep track of sign since the
+    {
+        neg_a_bn(n);   // answer must be positive.
+    }
+
+    int const skip = (bnlength << 1) - rlength;
+    int const first = skip >= 16 ? (skip >> 3) - 1 : 0;
+    int const count = load_limbs(s_limbs1, n, bnlength);
+    U64 const *prod = product_columns(s_limbs1.data(), s_limbs1.data(), count, first);
+    std::memcpy(r, (BYTE const *) prod + skip - (first << 3), rlength);
+    return r;
+}
+
+#else
 /************************************************************************/
 // r = n1 * n2
 // Note: r will be a double wide result, 2*bnlength
@@ -754,6 +1163,7 @@ bn_t unsafe_square_bn(bn_t r, bn_t n)
     }
     return r;
 }
+#endif
 
 /********************************************************************/
 // r = n * u  where u is an unsigned integer
@@ -16,12 +16,17 @@
 
 #include "biginit.h"
 #include "calcfrac.h"
+#include "calclane.h"
 #include "calcmand.h"
+#include "calcpool.h"
 #include "calmanfp.h"
+#include "checkpoint.h"
 #include "cmdfiles.h"
 #include "cmplx.h"
+#include "density.h"
 #include "diskvid.h"
 #include "drivers.h"
+#include "encoder.h"
 #include "fpu087.h"
 #include "fracsubr.h"
 #include "fractalp.h"
@@ -35,28 +40,62 @@
 #include "miscovl.h"
 #include "miscres.h"
 #include "mpmath_c.h"
+#include "orbitsave.h"
 #include "os.h"
 #include "newton.h"
 #include "parser.h"
+#include "perturb.h"
+#include "prompts2.h"
 #include "realdos.h"
 #include "soi.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <vector>
 
+// what standard_fractal() found while iterating a pixel, for coloring it
+struct orbit_info
+{
+    long savemaxit = 0;
+    double tantable[16] = { 0.0 };
+    int hooper = 0;
+    double memvalue = 0.0;
+    double min_orbit = 100000.0;        // orbit value closest to origin
+    long   min_index = 0;               // iteration of min_orbit
+    long cyclelen = -1;
+    bool caught_a_cycle = false;
+    bool attracted = false;
+    DComplex deriv = { 0.0 };
+    long dem_color = -1;
+    DComplex dem_new = { 0 };
+    double totaldist = 0.0;
+};
+
 // routines in this module
 static void perform_worklist();
+static void bench_tesseral();
 static int  one_or_two_pass();
 static int  standard_calc(int);
+static int  standard_calc_row(int);
+static int  row_columns(int, int, int *, int &);
+static int  calcmandfp_row(int);
+static int  standard_fractal_row(int);
+static void copy_first_pass_pixel();
+static void plot_mandfp_pixel();
+static int  color_standard_pixel(orbit_info const &orbit, bool inside);
 static int  potential(double, long);
 static void decomposition();
 static int  bound_trace_main();
+static int  bound_trace_rows(int first_row, int last_row);
+static int  bound_trace_strips();
 static void step_col_row();
 static int  solid_guess();
 static bool guessrow(bool firstpass, int y, int blocksize);
@@ -69,11 +108,14 @@ static int diffusion_engine();
 static int sticky_orbits();
 
 static int tesseral();
+static int tesseral_tasks();
 static int tesschkcol(int, int, int);
 static int tesschkrow(int, int, int);
 static int tesscol(int, int, int);
 static int tessrow(int, int, int);
 
+static int mariani_silver();
+
 static int diffusion_scan();
 
 // lookup tables to avoid too much bit fiddling :
@@ -110,7 +152,7 @@ static char dif_lb[] =
 // added for testing autologmap()
 static long autologmap();
 
-static DComplex saved{};
+static THREAD_LOCAL DComplex saved{};
 static double rqlim_save = 0.0;
 static int (*calctypetmp)() = nullptr;
 static unsigned long lm = 0;                   // magnitude limit (CALCMAND)
@@ -126,45 +168,186 @@ static int halfblock = 0;
 static bool guessplot = false;          // paint 1st pass row at a time?
 static bool right_guess = false;
 static bool bottom_guess = false;
-#define maxyblk 7    // maxxblk*maxyblk*2 <= 4096, the size of "prefix"
-#define maxxblk 202  // each maxnblk is oversize by 2 for a "border"
-// maxxblk defn must match fracsubr.c
-// next has a skip bit for each maxblock unit;
-//   1st pass sets bit  [1]... off only if block's contents guessed;
-//   at end of 1st pass [0]... bits are set if any surrounding block not guessed;
-//   bits are numbered [..][y/16+1][x+1]&(1<<(y&15))
-// size of next puts a limit of MAX_PIXELS pixels across on solid guessing logic
 namespace
 {
-BYTE dstack[4096] = { 0 };              // common temp, two put_line calls
+std::vector<BYTE> dstack;               // common temp, two put_line calls
+int dstack_row2 = 0;                    // where the second put_line row starts
+
+// A bit for each maxblock square of the image, with a border of one block
+// all round: the bit for pixel x, y is numbered [y/maxblock+1][x/maxblock+1].
+// Each row of blocks takes whole 64 bit words so rows can be combined a word
+// at a time.
+class block_bits
+{
+public:
+    void resize(int cols, int rows);
+    void fill(bool on);
+    bool test(int col, int row) const
+    {
+        return (word(col, row) >> (col & 63)) & 1;
+    }
+    void set(int col, int row)
+    {
+        word(col, row) |= std::uint64_t(1) << (col & 63);
+    }
+    void set_column(int col);
+    void set_row(int row);
+    int next_set(int col, int row, int end) const;
+    void spread(block_bits const &from);
+
+private:
+    std::uint64_t &word(int col, int row)
+    {
+        return m_bits[static_cast<std::size_t>(row)*m_words + (col >> 6)];
+    }
+    std::uint64_t word(int col, int row) const
+    {
+        return m_bits[static_cast<std::size_t>(row)*m_words + (col >> 6)];
+    }
+
+    int m_words{};                      // per row of blocks
+    int m_rows{};
+    std::vector<std::uint64_t> m_bits;
+};
+
+void block_bits::resize(int cols, int rows)
+{
+    m_words = (cols + 63)/64;
+    m_rows = rows;
+    m_bits.assign(static_cast<std::size_t>(m_words)*m_rows, 0);
+}
+
+void block_bits::fill(bool on)
+{
+    std::fill(m_bits.begin(), m_bits.end(), on ? ~std::uint64_t(0) : 0);
+}
+
+void block_bits::set_column(int col)
+{
+    for (int row = 0; row < m_rows; ++row)
+    {
+        set(col, row);
+    }
+}
+
+void block_bits::set_row(int row)
+{
+    std::fill_n(&m_bits[static_cast<std::size_t>(row)*m_words], m_words, ~std::uint64_t(0));
+}
+
+// the first column from col on with its bit set in row, or end if none is
+// before it
+int block_bits::next_set(int col, int row, int end) const
+{
+    std::uint64_t const *bits = &m_bits[static_cast<std::size_t>(row)*m_words];
+    int w = col >> 6;
+    std::uint64_t u = bits[w] >> (col & 63);
+    if (u == 0)
+    {
+        col = w*64;
+        do
+        {
+            col += 64;
+            if (++w == m_words || col >= end)
+            {
+                return end;
+            }
+            u = bits[w];
+        }
+        while (u == 0);
+    }
+    while ((u & 1) == 0)
+    {
+        u >>= 1;
+        ++col;
+    }
+    return std::min(col, end);
+}
+
+// set each bit inside the border to the OR of it and the 8 around it in from
+void block_bits::spread(block_bits const &from)
+{
+    for (int row = 1; row < m_rows - 1; ++row)
+    {
+        std::uint64_t const *above = &from.m_bits[static_cast<std::size_t>(row - 1)*m_words];
+        std::uint64_t const *here = above + m_words;
+        std::uint64_t const *below = here + m_words;
+        std::uint64_t *out = &m_bits[static_cast<std::size_t>(row)*m_words];
+        std::uint64_t left = 0;
+        std::uint64_t u = above[0] | here[0] | below[0];
+        for (int w = 0; w < m_words; ++w)
+        {
+            std::uint64_t const right = w + 1 < m_words ? above[w+1] | here[w+1] | below[w+1] : 0;
+            out[w] = u | (u << 1) | (left >> 63) | (u >> 1) | (right << 63);
+            left = u;
+            u = right;
+        }
+    }
+}
+
+// A row of the screen from g_i_x_start to g_i_x_stop, read in one go for
+// guessrow() to look up the colors of block corners in.
+class guess_row
+{
+public:
+    void fetch(int row)
+    {
+        m_pixels.resize(g_i_x_stop - g_i_x_start + 1);
+        get_line(row, g_i_x_start, g_i_x_stop, &m_pixels[0]);
+    }
+    int operator[](int x) const
+    {
+        return m_pixels[x - g_i_x_start];
+    }
+
+private:
+    std::vector<BYTE> m_pixels;
+};
+
+// skip flags for solid guessing:
+//   1st pass sets a block's bit in s_guess_calc unless its contents were all
+//   guessed; at the end of the 1st pass each bit in s_guess_skip is set if
+//   that block's or any surrounding block's bit is
+block_bits s_guess_calc;
+block_bits s_guess_skip;
+guess_row s_row_up_block;               // y-blocksize
+guess_row s_row_up_half;                // y-halfblock
+guess_row s_row_this;                   // y
+guess_row s_row_down_block;             // y+blocksize
+std::vector<BYTE> s_block_span;         // plotblock() rows painted with put_line
+
+// A strip of rows boundary traced on a calc thread.  It holds the whole
+// width of the screen for its rows, read before the trace starts, and is
+// drawn once it is finished.  Regions crossing the edge of a strip are
+// traced as far as the edge in each strip, so the pixels along its top and
+// bottom rows are calculated rather than filled.
+struct trace_strip
+{
+    int top;
+    int bottom;
+    std::vector<BYTE> pixels;
+};
+std::vector<trace_strip> s_trace_strips;
+THREAD_LOCAL trace_strip *s_trace_strip = nullptr; // strip being traced, if any
 }
-static unsigned int tprefix[2][maxyblk][maxxblk] = { 0 }; // common temp
 
 // variables exported from this file
 LComplex g_l_init_orbit = { 0 };
-long g_l_magnitude = 0;
+THREAD_LOCAL long g_l_magnitude = 0;
 long g_l_magnitude_limit = 0;
 long g_l_magnitude_limit2 = 0;
 long g_l_close_enough = 0;
-DComplex g_init = { 0.0 };
-DComplex g_tmp_z = { 0.0 };
-DComplex g_old_z = { 0.0 };
-DComplex g_new_z = { 0.0 };
-int g_color = 0;
-long g_color_iter = 0;
-long g_old_color_iter = 0;
-long g_real_color_iter = 0;
-int g_row = 0;
-int g_col = 0;
+THREAD_LOCAL CalcContext g_ctx{};
+THREAD_LOCAL int g_color = 0;
+THREAD_LOCAL int g_row = 0;
+THREAD_LOCAL int g_col = 0;
 int g_invert = 0;
 double g_f_radius = 0.0;
 double g_f_x_center = 0.0;
 double g_f_y_center = 0.0;                 // for inversion
 void (*g_put_color)(int, int, int) = putcolor_a;
-void (*g_plot)(int, int, int) = putcolor_a;
+THREAD_LOCAL void (*g_plot)(int, int, int) = putcolor_a;
 
-double g_magnitude = 0.0;
-double g_magnitude_limit = 0.0;
 double g_magnitude_limit2 = 0.0;
 bool g_magnitude_calc = true;
 bool g_use_old_periodicity = false;
@@ -178,8 +361,8 @@ double g_close_enough = 0.0;
 int g_pi_in_pixels = 0;                        // value of pi in pixels
 
 // ORBIT variables
-bool g_show_orbit = false;                // flag to turn on and off
-int g_orbit_save_index = 0;             // index into save_orbit array
+THREAD_LOCAL bool g_show_orbit = false;   // flag to turn on and off
+THREAD_LOCAL int g_orbit_save_index = 0; // index into save_orbit array
 int g_orbit_color = 15;                 // XOR color
 
 int g_i_x_start = 0;
@@ -187,8 +370,8 @@ int g_i_x_stop = 0;
 int g_i_y_start = 0;
 int g_i_y_stop = 0;                         // start, stop here
 symmetry_type g_symmetry = symmetry_type::NONE; // symmetry flag
-bool g_reset_periodicity = false;         // true if escape time pixel rtn to reset
-int g_keyboard_check_interval = 0;
+THREAD_LOCAL bool g_reset_periodicity = false; // true if escape time pixel rtn to reset
+THREAD_LOCAL int g_keyboard_check_interval = 0;
 int g_max_keyboard_check_interval = 0;                   // avoids checking keyboard too often
 
 std::vector<BYTE> g_resume_data;          // resume info
@@ -205,7 +388,7 @@ int g_work_symmetry = 0;                        // for the sake of calcmand
 // variables which must be visible for tab_display
 int g_got_status = -1;                    // -1 if not, 0 for 1or2pass, 1 for ssg,
                                         // 2 for btm, 3 for 3d, 4 for tesseral, 5 for diffusion_scan
-                                        // 6 for orbits
+                                        // 6 for orbits, 7 for mariani-silver
 int g_current_pass = 0;
 int g_total_passes = 0;
 int g_current_row = 0;
@@ -232,9 +415,9 @@ enum class direction
     South,
     West
 };
-static direction going_to;
-static int trail_row = 0;
-static int trail_col = 0;
+static THREAD_LOCAL direction going_to;
+static THREAD_LOCAL int trail_row = 0;
+static THREAD_LOCAL int trail_col = 0;
 
 // --------------------------------------------------------------------
 //              These variables are external for speed's sake only
@@ -298,8 +481,8 @@ long multiply(long x, long y, int n)
 
 double fmodtest_bailout_or()
 {
-    double const tmpx = sqr(g_new_z.x);
-    double const tmpy = sqr(g_new_z.y);
+    double const tmpx = sqr(g_ctx.new_z.x);
+    double const tmpy = sqr(g_ctx.new_z.y);
     if (tmpx > tmpy)
     {
         return tmpx;
@@ -323,22 +506,22 @@ double fmodtest()
     switch (g_bail_out_test)
     {
     case bailouts::Mod:
-        if (g_magnitude == 0.0 || g_magnitude_calc || g_integer_fractal)
+        if (g_ctx.magnitude == 0.0 || g_magnitude_calc || g_integer_fractal)
         {
-            result = sqr(g_new_z.x)+sqr(g_new_z.y);
+            result = sqr(g_ctx.new_z.x)+sqr(g_ctx.new_z.y);
         }
         else
         {
-            result = g_magnitude; // don't recalculate
+            result = g_ctx.magnitude; // don't recalculate
         }
         break;
 
     case bailouts::Real:
-        result = sqr(g_new_z.x);
+        result = sqr(g_ctx.new_z.x);
         break;
 
     case bailouts::Imag:
-        result = sqr(g_new_z.y);
+        result = sqr(g_ctx.new_z.y);
         break;
 
     case bailouts::Or:
@@ -346,15 +529,15 @@ double fmodtest()
         break;
 
     case bailouts::Manh:
-        result = sqr(std::fabs(g_new_z.x) + std::fabs(g_new_z.y));
+        result = sqr(std::fabs(g_ctx.new_z.x) + std::fabs(g_ctx.new_z.y));
         break;
 
     case bailouts::Manr:
-        result = sqr(g_new_z.x+g_new_z.y);
+        result = sqr(g_ctx.new_z.x+g_ctx.new_z.y);
         break;
 
     default:
-        result = sqr(g_new_z.x)+sqr(g_new_z.y);
+        result = sqr(g_ctx.new_z.x)+sqr(g_ctx.new_z.y);
         break;
     }
 
@@ -611,6 +794,49 @@ int calctypeshowdot()
     return out;
 }
 
+SavedFractal::SavedFractal() :
+    type(g_fractal_type),
+    formula_filename(g_formula_filename),
+    formula_name(g_formula_name),
+    corners{ g_x_min, g_x_max, g_y_min, g_y_max, g_x_3rd, g_y_3rd },
+    math(bf_math)
+{
+    std::copy(g_params, g_params + MAX_PARAMS, params);
+}
+
+SavedFractal::~SavedFractal()
+{
+    g_fractal_type = type;
+    g_cur_fractal_specific = &g_fractal_specific[static_cast<int>(type)];
+    g_formula_filename = formula_filename;
+    g_formula_name = formula_name;
+    std::copy(params, params + MAX_PARAMS, g_params);
+    g_x_min = corners[0];
+    g_x_max = corners[1];
+    g_y_min = corners[2];
+    g_y_max = corners[3];
+    g_x_3rd = corners[4];
+    g_y_3rd = corners[5];
+    bf_math = math;
+}
+
+// Switch to a floating point type at its default parameters and corners.
+void SavedFractal::use_defaults(fractal_type new_type)
+{
+    fractalspecificstuff const &specific = g_fractal_specific[static_cast<int>(new_type)];
+    g_fractal_type = new_type;
+    g_cur_fractal_specific = &g_fractal_specific[static_cast<int>(new_type)];
+    std::copy(specific.paramvalue, specific.paramvalue + 4, g_params);
+    std::fill(g_params + 4, g_params + MAX_PARAMS, 0.0);
+    g_x_min = specific.xmin;
+    g_x_max = specific.xmax;
+    g_y_min = specific.ymin;
+    g_y_max = specific.ymax;
+    g_x_3rd = g_x_min;
+    g_y_3rd = g_y_min;
+    bf_math = bf_math_type::NONE;
+}
+
 // calcfract - the top level routine for generating an image
 int calcfract()
 {
@@ -618,6 +844,7 @@ int calcfract()
     g_display_3d = display_3d_modes::NONE;
     g_basin = 0;
     g_put_color = putcolor_a;
+    encoder_cancel_ahead();     // a new image
     if (g_is_true_color && g_true_mode != true_color_mode::default_color)
     {
         // Have to force passes = 1
@@ -657,10 +884,10 @@ int calcfract()
     {
         g_distance_estimator = 0;
     }
-    g_param_z1.x   = g_params[0];
-    g_param_z1.y   = g_params[1];
-    g_param_z2.x  = g_params[2];
-    g_param_z2.y  = g_params[3];
+    g_ctx.param_z1.x   = g_params[0];
+    g_ctx.param_z1.y   = g_params[1];
+    g_ctx.param_z2.x  = g_params[2];
+    g_ctx.param_z2.y  = g_params[3];
 
     if (g_log_map_flag && g_colors < 16)
     {
@@ -832,15 +1059,15 @@ int calcfract()
     }
 
     g_close_enough = g_delta_min*std::pow(2.0, -(double)(std::abs(g_periodicity_check)));
-    rqlim_save = g_magnitude_limit;
-    g_magnitude_limit2 = std::sqrt(g_magnitude_limit);
+    rqlim_save = g_ctx.magnitude_limit;
+    g_magnitude_limit2 = std::sqrt(g_ctx.magnitude_limit);
     if (g_integer_fractal)          // for integer routines (lambda)
     {
-        g_l_param.x = (long)(g_param_z1.x * g_fudge_factor);    // real portion of Lambda
-        g_l_param.y = (long)(g_param_z1.y * g_fudge_factor);    // imaginary portion of Lambda
-        g_l_param2.x = (long)(g_param_z2.x * g_fudge_factor);  // real portion of Lambda2
-        g_l_param2.y = (long)(g_param_z2.y * g_fudge_factor);  // imaginary portion of Lambda2
-        g_l_magnitude_limit = (long)(g_magnitude_limit * g_fudge_factor);      // stop if magnitude exceeds this
+        g_l_param.x = (long)(g_ctx.param_z1.x * g_fudge_factor);    // real portion of Lambda
+        g_l_param.y = (long)(g_ctx.param_z1.y * g_fudge_factor);    // imaginary portion of Lambda
+        g_l_param2.x = (long)(g_ctx.param_z2.x * g_fudge_factor);  // real portion of Lambda2
+        g_l_param2.y = (long)(g_ctx.param_z2.y * g_fudge_factor);  // imaginary portion of Lambda2
+        g_l_magnitude_limit = (long)(g_ctx.magnitude_limit * g_fudge_factor);      // stop if magnitude exceeds this
         if (g_l_magnitude_limit <= 0)
         {
             g_l_magnitude_limit = 0x7fffffffL; // klooge for integer math
@@ -948,6 +1175,11 @@ int calcfract()
             }
             g_std_calc_mode = (char)oldcalcmode;
         }
+        else if (g_debug_flag == debug_flags::benchmark_tesseral && !g_resuming)
+        {
+            g_three_pass = false;
+            timer(0, (int(*)())bench_tesseral);
+        }
         else // main case, much nicer!
         {
             g_three_pass = false;
@@ -955,6 +1187,11 @@ int calcfract()
         }
     }
     g_calc_time += g_timer_interval;
+    orbit_save_close();
+    if (density_end() && g_calc_status == calc_status_value::RESUMABLE)
+    {
+        g_calc_status = calc_status_value::NON_RESUMABLE;   // the hit counts are gone
+    }
 
     if (!g_log_map_table.empty() && !g_log_map_calculate)
     {
@@ -977,6 +1214,51 @@ int calcfract()
     return g_calc_status == calc_status_value::COMPLETED ? 0 : -1;
 }
 
+// Time passes=t on one calc thread and on all of them, then passes=g on all
+// of them, from a blank screen each time, appending the times to "bench".
+static void bench_tesseral()
+{
+    struct bench_run
+    {
+        char mode;
+        int threads;
+    };
+    int const threads = g_calc_threads;
+    char const mode = g_std_calc_mode;
+    std::vector<BYTE> const blank(g_logical_screen_x_dots, 0);
+    std::FILE *fp = dir_fopen(g_working_dir.c_str(), "bench", "a");
+    for (bench_run const &run : {bench_run{'t', 1}, bench_run{'t', threads}, bench_run{'g', threads}})
+    {
+        for (int row = 0; row < g_logical_screen_y_dots; ++row)
+        {
+            put_line(row, 0, g_logical_screen_x_dots-1, blank.data());
+        }
+        g_calc_threads = run.threads;
+        g_std_calc_mode = run.mode;
+        auto const start = std::chrono::steady_clock::now();
+        perform_worklist();
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool const completed = g_calc_status == calc_status_value::COMPLETED;
+        if (fp != nullptr)
+        {
+            std::fprintf(fp, "%s %dx%d maxiter=%ld passes=%c threads=%u %.3f seconds%s\n",
+                g_cur_fractal_specific->name[0] == '*' ? &g_cur_fractal_specific->name[1] : g_cur_fractal_specific->name,
+                g_logical_screen_x_dots, g_logical_screen_y_dots,
+                g_max_iterations, run.mode, calc_pool_threads(), seconds, completed ? "" : " (interrupted)");
+        }
+        if (!completed)
+        {
+            break;
+        }
+    }
+    if (fp != nullptr)
+    {
+        std::fclose(fp);
+    }
+    g_calc_threads = threads;
+    g_std_calc_mode = mode;
+}
+
 // locate alternate math record
 int find_alternate_math(fractal_type type, bf_math_type math)
 {
@@ -1006,6 +1288,9 @@ static void perform_worklist()
     bool (*sv_per_image)() = nullptr;  // once-per-image setup
     int alt = find_alternate_math(g_fractal_type, bf_math);
 
+    perturb_start_image();
+    dstack_row2 = g_logical_screen_x_dots;
+    dstack.resize(2*dstack_row2);
     if (alt > -1)
     {
         sv_orbitcalc = g_cur_fractal_specific->orbitcalc;
@@ -1069,6 +1354,7 @@ static void perform_worklist()
             xxbegin = 0;
         }
     }
+    checkpoint_start();
 
     if (g_distance_estimator) // setup stuff for distance estimator
     {
@@ -1093,12 +1379,12 @@ static void perform_worklist()
         delyy2 = (g_y_3rd - g_y_min) / d_x_size;
 
         g_use_old_distance_estimator = false;
-        g_magnitude_limit = rqlim_save; // just in case changed to DEM_BAILOUT earlier
+        g_ctx.magnitude_limit = rqlim_save; // just in case changed to DEM_BAILOUT earlier
         if (g_distance_estimator != 1 || g_colors == 2)   // not doing regular outside colors
         {
-            if (g_magnitude_limit < DEM_BAILOUT)           // so go straight for dem bailout
+            if (g_ctx.magnitude_limit < DEM_BAILOUT)           // so go straight for dem bailout
             {
-                g_magnitude_limit = DEM_BAILOUT;
+                g_ctx.magnitude_limit = DEM_BAILOUT;
             }
         }
         // must be mandel type, formula, or old PAR/GIF
@@ -1127,7 +1413,7 @@ static void perform_worklist()
         }
         dem_width = (std::sqrt(sqr(g_x_max-g_x_min) + sqr(g_x_3rd-g_x_min)) * aspect
                      + std::sqrt(sqr(g_y_max-g_y_min) + sqr(g_y_3rd-g_y_min))) / g_distance_estimator;
-        ftemp = (g_magnitude_limit < DEM_BAILOUT) ? DEM_BAILOUT : g_magnitude_limit;
+        ftemp = (g_ctx.magnitude_limit < DEM_BAILOUT) ? DEM_BAILOUT : g_ctx.magnitude_limit;
         ftemp += 3; // bailout plus just a bit
         ftemp2 = std::log(ftemp);
         if (g_use_old_distance_estimator)
@@ -1275,6 +1561,9 @@ static void perform_worklist()
         case 't':
             tesseral();
             break;
+        case 'm':
+            mariani_silver();
+            break;
         case 'b':
             bound_trace_main();
             break;
@@ -1295,11 +1584,14 @@ static void perform_worklist()
             savedots.clear();
             fillbuff = nullptr;
         }
-        if (check_key())   // interrupted?
+        bool const interrupted = check_key();
+        checkpoint_work_done(interrupted || g_num_work_list == 0);
+        if (interrupted)
         {
             break;
         }
     }
+    checkpoint_end();
 
     if (g_num_work_list > 0)
     {
@@ -1350,15 +1642,15 @@ static int diffusion_scan()
 // little macro that plots a filled square of color c, size s with
 // top left cornet at (x,y) with optimization from sym_fill_line
 #define plot_block(x, y, s, c) \
-    std::memset(dstack, (c), (s)); \
+    std::memset(&dstack[0], (c), (s)); \
     for (int ty = (y); ty < (y)+(s); ty++) \
-       sym_fill_line(ty, (x), (x)+(s)-1, dstack)
+       sym_fill_line(ty, (x), (x)+(s)-1, &dstack[0])
 
 // macro that does the same as above, but checks the limits in x and y
 #define plot_block_lim(x, y, s, c) \
-    std::memset(dstack, (c), (s)); \
+    std::memset(&dstack[0], (c), (s)); \
     for (int ty = (y); ty < std::min((y)+(s), g_i_y_stop+1); ty++) \
-       sym_fill_line(ty, (x), std::min((x)+(s)-1, g_i_x_stop), dstack)
+       sym_fill_line(ty, (x), std::min((x)+(s)-1, g_i_x_stop), &dstack[0])
 
 // macro: count_to_int(dif_counter, colo, rowo)
 #define count_to_int(C, x, y)     \
@@ -1837,6 +2129,14 @@ static int one_or_two_pass()
         yybegin = g_yy_start;
     }
     // second or only pass
+    if (g_num_work_list == 0
+        && xxbegin == 0 && yybegin == 0
+        && g_xx_start == 0 && g_xx_stop == g_logical_screen_x_dots - 1
+        && g_yy_start == 0 && g_yy_stop == g_logical_screen_y_dots - 1
+        && g_i_y_stop == g_yy_stop)     // rows finish top to bottom
+    {
+        encoder_start_ahead();
+    }
     if (standard_calc(2) == -1)
     {
         i = g_yy_stop;
@@ -1851,61 +2151,232 @@ static int one_or_two_pass()
     return 0;
 }
 
+// rows of the current pass up to and including row are finished
+static void pass_rows_done(int row)
+{
+    if (g_current_pass == 2)
+    {
+        encoder_rows_done(row);
+    }
+    checkpoint_rows_done(row);
+}
+
 static int standard_calc(int passnum)
 {
     g_got_status = 0;
     g_current_pass = passnum;
     g_row = yybegin;
     g_col = xxbegin;
+    checkpoint_pass_start(g_row);
+
+    if (calc_pool_usable())
+    {
+        int const status = calc_pool_rows(passnum, standard_calc_row, pass_rows_done);
+        if (status <= 0)
+        {
+            return status;
+        }
+        // no calc threads could be started, carry on with this one
+    }
 
     while (g_row <= g_i_y_stop)
     {
         g_current_row = g_row;
-        g_reset_periodicity = true;
-        while (g_col <= g_i_x_stop)
+        if (standard_calc_row(passnum) == -1)
+        {
+            return -1;          // interrupted
+        }
+        pass_rows_done(g_row);
+        g_col = g_i_x_start;
+        if (passnum == 1 && (g_row&1) == 0)
+        {
+            ++g_row;
+        }
+        ++g_row;
+    }
+    return 0;
+}
+
+// on the first pass of two, copy the pixel just calculated to its skipped
+// neighbours and bump g_col past them
+static void copy_first_pass_pixel()
+{
+    if ((g_row&1) == 0 && g_row < g_i_y_stop)
+    {
+        (*g_plot)(g_col, g_row+1, g_color);
+        if ((g_col&1) == 0 && g_col < g_i_x_stop)
+        {
+            (*g_plot)(g_col+1, g_row+1, g_color);
+        }
+    }
+    if ((g_col&1) == 0 && g_col < g_i_x_stop)
+    {
+        (*g_plot)(++g_col, g_row, g_color);
+    }
+}
+
+// the columns of row g_row from g_col on that the pixel at a time loop of
+// standard_calc_row() would calculate next, at most max of them; returns
+// how many, with the column after them in next_col
+static int row_columns(int passnum, int max, int *cols, int &next_col)
+{
+    int count = 0;
+    int col = g_col;
+    while (col <= g_i_x_stop && count < max)
+    {
+        if (passnum == 1 || g_std_calc_mode == '1' || (g_row&1) != 0 || (col&1) != 0)
+        {
+            cols[count++] = col;
+            if (passnum == 1 && (col&1) == 0 && col < g_i_x_stop)
+            {
+                ++col;                  // copied from this one
+            }
+        }
+        ++col;
+    }
+    next_col = col;
+    return count;
+}
+
+// standard_calc_row() for calcmandfp(), calculating the pixels of the row
+// a batch at a time with calcmandfpasm_batch().  Stops at the end of the
+// row, or early with g_col set to carry on if orbits are switched on.
+static int calcmandfp_row(int passnum)
+{
+    int const lanes = calcmandfpasm_lanes();
+    int cols[MAX_MANDFP_LANES];
+    DComplex init[MAX_MANDFP_LANES];
+    MandelFPPixel result[MAX_MANDFP_LANES];
+    while (g_col <= g_i_x_stop && !g_show_orbit)
+    {
+        int col;
+        int const count = row_columns(passnum, lanes, cols, col);
+        for (int i = 0; i < count; ++i)
+        {
+            g_col = cols[i];
+            init[i].x = g_dx_pixel();
+            init[i].y = g_dy_pixel();
+        }
+        if (count > 0)
         {
-            // on 2nd pass of two, skip even pts
-            if (g_quick_calc && !g_resuming)
+            if (calcmandfpasm_batch(init, count, result) < 0)
+            {
+                g_col = cols[0];
+                return -1;              // interrupted
+            }
+            for (int i = 0; i < count; ++i)
             {
-                g_color = getcolor(g_col, g_row);
-                if (g_color != g_inside_color)
+                g_col = cols[i];
+                g_ctx.color_iter = result[i].color_iter;
+                g_ctx.real_color_iter = result[i].real_color_iter;
+                g_ctx.magnitude = result[i].magnitude;
+                plot_mandfp_pixel();
+                if (passnum == 1)
                 {
-                    ++g_col;
-                    continue;
+                    copy_first_pass_pixel();
                 }
             }
-            if (passnum == 1 || g_std_calc_mode == '1' || (g_row&1) != 0 || (g_col&1) != 0)
+            g_reset_periodicity = false;
+        }
+        g_col = col;
+    }
+    return 0;
+}
+
+// standard_calc_row() for standard_fractal(), iterating the pixels of the
+// row a run at a time with calc_lanes_batch() and coloring each as
+// standard_fractal() does.  Stops like calcmandfp_row().
+static int standard_fractal_row(int passnum)
+{
+    int cols[MAX_LANE_BATCH];
+    LanePixel result[MAX_LANE_BATCH];
+    while (g_col <= g_i_x_stop && !g_show_orbit)
+    {
+        int col;
+        int const count = row_columns(passnum, MAX_LANE_BATCH, cols, col);
+        if (count > 0)
+        {
+            if (calc_lanes_batch(cols, count, result) < 0)
+            {
+                g_col = cols[0];
+                return -1;              // interrupted
+            }
+            for (int i = 0; i < count; ++i)
             {
-                if ((*g_calc_type)() == -1)   // standard_fractal(), calcmand() or calcmandfp()
+                g_col = cols[i];
+                g_ctx.color_iter = result[i].color_iter;
+                g_ctx.new_z = result[i].new_z;
+                orbit_info orbit;
+                orbit.savemaxit = g_max_iterations;
+                orbit.caught_a_cycle = result[i].caught_a_cycle;
+                if (color_standard_pixel(orbit, false) == -1)
                 {
                     return -1;          // interrupted
                 }
-                g_resuming = false;       // reset so quick_calc works
-                g_reset_periodicity = false;
-                if (passnum == 1)       // first pass, copy pixel and bump col
+                if (passnum == 1)
                 {
-                    if ((g_row&1) == 0 && g_row < g_i_y_stop)
-                    {
-                        (*g_plot)(g_col, g_row+1, g_color);
-                        if ((g_col&1) == 0 && g_col < g_i_x_stop)
-                        {
-                            (*g_plot)(g_col+1, g_row+1, g_color);
-                        }
-                    }
-                    if ((g_col&1) == 0 && g_col < g_i_x_stop)
-                    {
-                        (*g_plot)(++g_col, g_row, g_color);
-                    }
+                    copy_first_pass_pixel();
                 }
             }
-            ++g_col;
+            g_reset_periodicity = false;
         }
-        g_col = g_i_x_start;
-        if (passnum == 1 && (g_row&1) == 0)
+        g_col = col;
+    }
+    return 0;
+}
+
+// one row of standard_calc(), from g_col to the end of row g_row
+static int standard_calc_row(int passnum)
+{
+    g_reset_periodicity = true;
+    if (g_calc_type == calcmandfp
+        && calcmandfpasm_lanes() > 0
+        && g_invert == 0
+        && !g_quick_calc)
+    {
+        if (calcmandfp_row(passnum) == -1)
         {
-            ++g_row;
+            return -1;                  // interrupted
         }
-        ++g_row;
+    }
+    else if (g_calc_type == standard_fractal
+        && !g_quick_calc
+        && calc_lanes() > 0)
+    {
+        if (standard_fractal_row(passnum) == -1)
+        {
+            return -1;                  // interrupted
+        }
+    }
+    while (g_col <= g_i_x_stop)
+    {
+        // on 2nd pass of two, skip even pts
+        if (g_quick_calc && !g_resuming)
+        {
+            g_color = getcolor(g_col, g_row);
+            if (g_color != g_inside_color)
+            {
+                ++g_col;
+                continue;
+            }
+        }
+        if (passnum == 1 || g_std_calc_mode == '1' || (g_row&1) != 0 || (g_col&1) != 0)
+        {
+            if ((*g_calc_type)() == -1)   // standard_fractal(), calcmand() or calcmandfp()
+            {
+                return -1;          // interrupted
+            }
+            if (g_resuming)         // shared with the calc threads, so only write on a change
+            {
+                g_resuming = false;       // reset so quick_calc works
+            }
+            g_reset_periodicity = false;
+            if (passnum == 1)       // first pass, copy pixel and bump col
+            {
+                copy_first_pass_pixel();
+            }
+        }
+        ++g_col;
     }
     return 0;
 }
@@ -1919,22 +2390,22 @@ int calcmand()              // fast per pixel 1/2/b/g, called with row & col set
     if (calcmandasm() >= 0)
     {
         if ((!g_log_map_table.empty() || g_log_map_calculate) // map color, but not if maxit & adjusted for inside,etc
-            && (g_real_color_iter < g_max_iterations
-                || (g_inside_color < COLOR_BLACK && g_color_iter == g_max_iterations)))
+            && (g_ctx.real_color_iter < g_max_iterations
+                || (g_inside_color < COLOR_BLACK && g_ctx.color_iter == g_max_iterations)))
         {
-            g_color_iter = logtablecalc(g_color_iter);
+            g_ctx.color_iter = logtablecalc(g_ctx.color_iter);
         }
-        g_color = std::abs((int)g_color_iter);
-        if (g_color_iter >= g_colors)
+        g_color = std::abs((int)g_ctx.color_iter);
+        if (g_ctx.color_iter >= g_colors)
         {
             // don't use color 0 unless from inside/outside
             if (g_colors < 16)
             {
-                g_color = (int)(g_color_iter & g_and_color);
+                g_color = (int)(g_ctx.color_iter & g_and_color);
             }
             else
             {
-                g_color = (int)(((g_color_iter - 1) % g_and_color) + 1);
+                g_color = (int)(((g_ctx.color_iter - 1) % g_and_color) + 1);
             }
         }
         if (g_debug_flag != debug_flags::force_boundary_trace_error)
@@ -1948,11 +2419,47 @@ int calcmand()              // fast per pixel 1/2/b/g, called with row & col set
     }
     else
     {
-        g_color = (int)g_color_iter;
+        g_color = (int)g_ctx.color_iter;
     }
     return g_color;
 }
 
+// color and plot the pixel calcmandfpasm() has just calculated
+static void plot_mandfp_pixel()
+{
+    if (g_potential_flag)
+    {
+        g_ctx.color_iter = potential(g_ctx.magnitude, g_ctx.real_color_iter);
+    }
+    if ((!g_log_map_table.empty() || g_log_map_calculate) // map color, but not if maxit & adjusted for inside,etc
+        && (g_ctx.real_color_iter < g_max_iterations
+            || (g_inside_color < COLOR_BLACK && g_ctx.color_iter == g_max_iterations)))
+    {
+        g_ctx.color_iter = logtablecalc(g_ctx.color_iter);
+    }
+    g_color = std::abs((int)g_ctx.color_iter);
+    if (g_ctx.color_iter >= g_colors)
+    {
+        // don't use color 0 unless from inside/outside
+        if (g_colors < 16)
+        {
+            g_color = (int)(g_ctx.color_iter & g_and_color);
+        }
+        else
+        {
+            g_color = (int)(((g_ctx.color_iter - 1) % g_and_color) + 1);
+        }
+    }
+    if (g_debug_flag != debug_flags::force_boundary_trace_error)
+    {
+        if (g_color == 0 && g_std_calc_mode == 'b')
+        {
+            g_color = 1;
+        }
+    }
+    (*g_plot)(g_col, g_row, g_color);
+}
+
 // sort of a floating point version of calcmand()
 // can also handle invert, any rqlim, potflag, zmag, epsilon cross,
 // and all the current outside options
@@ -1960,50 +2467,20 @@ int calcmandfp()
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        g_ctx.init.x = g_dx_pixel();
+        g_ctx.init.y = g_dy_pixel();
     }
     if (calcmandfpasm() >= 0)
     {
-        if (g_potential_flag)
-        {
-            g_color_iter = potential(g_magnitude, g_real_color_iter);
-        }
-        if ((!g_log_map_table.empty() || g_log_map_calculate) // map color, but not if maxit & adjusted for inside,etc
-            && (g_real_color_iter < g_max_iterations
-                || (g_inside_color < COLOR_BLACK && g_color_iter == g_max_iterations)))
-        {
-            g_color_iter = logtablecalc(g_color_iter);
-        }
-        g_color = std::abs((int)g_color_iter);
-        if (g_color_iter >= g_colors)
-        {
-            // don't use color 0 unless from inside/outside
-            if (g_colors < 16)
-            {
-                g_color = (int)(g_color_iter & g_and_color);
-            }
-            else
-            {
-                g_color = (int)(((g_color_iter - 1) % g_and_color) + 1);
-            }
-        }
-        if (g_debug_flag != debug_flags::force_boundary_trace_error)
-        {
-            if (g_color == 0 && g_std_calc_mode == 'b')
-            {
-                g_color = 1;
-            }
-        }
-        (*g_plot)(g_col, g_row, g_color);
+        plot_mandfp_pixel();
     }
     else
     {
-        g_color = (int)g_color_iter;
+        g_color = (int)g_ctx.color_iter;
     }
     return g_color;
 }
@@ -2011,50 +2488,35 @@ int calcmandfp()
 
 int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
 {
-    int const green = 2;
-    int const yellow = 6;
-
-    long savemaxit = 0;
-    double tantable[16] = { 0.0 };
-    int hooper = 0;
+    orbit_info orbit;
     long lcloseprox = 0;
-    double memvalue = 0.0;
-    double min_orbit = 100000.0;        // orbit value closest to origin
-    long   min_index = 0;               // iteration of min_orbit
-    long cyclelen = -1;
     long savedcoloriter = 0;
-    bool caught_a_cycle = false;
     long savedand = 0;
     int savedincr = 0;                  // for periodicity checking
     LComplex lsaved = { 0 };
-    bool attracted = false;
     LComplex lat = { 0 };
     DComplex  at = { 0.0 };
-    DComplex deriv = { 0.0 };
-    long dem_color = -1;
-    DComplex dem_new = { 0 };
     int check_freq = 0;
-    double totaldist = 0.0;
     DComplex lastz = { 0.0 };
 
     lcloseprox = (long)(g_close_proximity*g_fudge_factor);
-    savemaxit = g_max_iterations;
+    orbit.savemaxit = g_max_iterations;
     if (g_inside_color == STARTRAIL)
     {
-        std::fill(std::begin(tantable), std::end(tantable), 0.0);
+        std::fill(std::begin(orbit.tantable), std::end(orbit.tantable), 0.0);
         g_max_iterations = 16;
     }
     if (g_periodicity_check == 0 || g_inside_color == ZMAG || g_inside_color == STARTRAIL)
     {
-        g_old_color_iter = 2147483647L;       // don't check periodicity at all
+        g_ctx.old_color_iter = 2147483647L;       // don't check periodicity at all
     }
     else if (g_inside_color == PERIOD)       // for display-periodicity
     {
-        g_old_color_iter = (g_max_iterations/5)*4;       // don't check until nearly done
+        g_ctx.old_color_iter = (g_max_iterations/5)*4;       // don't check until nearly done
     }
     else if (g_reset_periodicity)
     {
-        g_old_color_iter = 255;               // don't check periodicity 1st 250 iterations
+        g_ctx.old_color_iter = 255;               // don't check periodicity 1st 250 iterations
     }
 
     // Jonathan - how about this idea ? skips first saved value which never works
@@ -2064,9 +2526,9 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         oldcoloriter = MINSAVEDAND;
     }
 #else
-    if (g_old_color_iter < g_first_saved_and)   // I like it!
+    if (g_ctx.old_color_iter < g_first_saved_and)   // I like it!
     {
-        g_old_color_iter = g_first_saved_and;
+        g_ctx.old_color_iter = g_first_saved_and;
     }
 #endif
     // really fractal specific, but we'll leave it here
@@ -2098,24 +2560,24 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                 clear_bf(bfsaved.y);
             }
         }
-        g_init.y = g_dy_pixel();
+        g_ctx.init.y = g_dy_pixel();
         if (g_distance_estimator)
         {
             if (g_use_old_distance_estimator)
             {
-                g_magnitude_limit = rqlim_save;
+                g_ctx.magnitude_limit = rqlim_save;
                 if (g_distance_estimator != 1 || g_colors == 2)   // not doing regular outside colors
                 {
-                    if (g_magnitude_limit < DEM_BAILOUT)     // so go straight for dem bailout
+                    if (g_ctx.magnitude_limit < DEM_BAILOUT)     // so go straight for dem bailout
                     {
-                        g_magnitude_limit = DEM_BAILOUT;
+                        g_ctx.magnitude_limit = DEM_BAILOUT;
                     }
                 }
-                dem_color = -1;
+                orbit.dem_color = -1;
             }
-            deriv.x = 1;
-            deriv.y = 0;
-            g_magnitude = 0;
+            orbit.deriv.x = 1;
+            orbit.deriv.y = 0;
+            g_ctx.magnitude = 0;
         }
     }
     else
@@ -2132,12 +2594,12 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         g_l_init.y = g_l_y_pixel();
     }
     g_orbit_save_index = 0;
-    g_color_iter = 0;
+    g_ctx.color_iter = 0;
     if (g_fractal_type == fractal_type::JULIAFP || g_fractal_type == fractal_type::JULIA)
     {
-        g_color_iter = -1;
+        g_ctx.color_iter = -1;
     }
-    caught_a_cycle = false;
+    orbit.caught_a_cycle = false;
     if (g_inside_color == PERIOD)
     {
         savedand = 16;           // begin checking every 16th cycle
@@ -2155,32 +2617,45 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
     if (g_inside_color <= BOF60 && g_inside_color >= BOF61)
     {
         g_l_magnitude = 0;
-        g_magnitude = g_l_magnitude;
-        min_orbit = 100000.0;
+        g_ctx.magnitude = g_l_magnitude;
+        orbit.min_orbit = 100000.0;
     }
     g_overflow = false;           // reset integer math overflow flag
 
+    if (bf_math != bf_math_type::NONE)
+    {
+        int const status = perturb_pixel();
+        if (status == -1)
+        {
+            return -1;              // interrupted
+        }
+        if (status == 1)
+        {
+            return color_standard_pixel(orbit, false);
+        }
+    }
+
     g_cur_fractal_specific->per_pixel(); // initialize the calculations
 
-    attracted = false;
+    orbit.attracted = false;
 
     if (g_outside_color == TDIS)
     {
         if (g_integer_fractal)
         {
-            g_old_z.x = ((double)g_l_old_z.x) / g_fudge_factor;
-            g_old_z.y = ((double)g_l_old_z.y) / g_fudge_factor;
+            g_ctx.old_z.x = ((double)g_l_old_z.x) / g_fudge_factor;
+            g_ctx.old_z.y = ((double)g_l_old_z.y) / g_fudge_factor;
         }
         else if (bf_math == bf_math_type::BIGNUM)
         {
-            g_old_z = cmplxbntofloat(&bnold);
+            g_ctx.old_z = cmplxbntofloat(&bnold);
         }
         else if (bf_math == bf_math_type::BIGFLT)
         {
-            g_old_z = cmplxbftofloat(&bfold);
+            g_ctx.old_z = cmplxbftofloat(&bfold);
         }
-        lastz.x = g_old_z.x;
-        lastz.y = g_old_z.y;
+        lastz.x = g_ctx.old_z.x;
+        lastz.y = g_ctx.old_z.y;
     }
 
     if (((g_sound_flag & SOUNDFLAG_ORBITMASK) > SOUNDFLAG_X || g_show_dot >= 0) && g_orbit_delay > 0)
@@ -2196,11 +2671,11 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
     {
         snd_time_write();
     }
-    while (++g_color_iter < g_max_iterations)
+    while (++g_ctx.color_iter < g_max_iterations)
     {
         // calculation of one orbit goes here
         // input in "old" -- output in "new"
-        if (g_color_iter % check_freq == 0)
+        if (g_ctx.color_iter % check_freq == 0)
         {
             if (check_key())
             {
@@ -2215,24 +2690,24 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
             // Algorithms from Peitgen & Saupe, Science of Fractal Images, p.198
             if (dem_mandel)
             {
-                ftemp = 2 * (g_old_z.x * deriv.x - g_old_z.y * deriv.y) + 1;
+                ftemp = 2 * (g_ctx.old_z.x * orbit.deriv.x - g_ctx.old_z.y * orbit.deriv.y) + 1;
             }
             else
             {
-                ftemp = 2 * (g_old_z.x * deriv.x - g_old_z.y * deriv.y);
+                ftemp = 2 * (g_ctx.old_z.x * orbit.deriv.x - g_ctx.old_z.y * orbit.deriv.y);
             }
-            deriv.y = 2 * (g_old_z.y * deriv.x + g_old_z.x * deriv.y);
-            deriv.x = ftemp;
+            orbit.deriv.y = 2 * (g_ctx.old_z.y * orbit.deriv.x + g_ctx.old_z.x * orbit.deriv.y);
+            orbit.deriv.x = ftemp;
             if (g_use_old_distance_estimator)
             {
-                if (sqr(deriv.x)+sqr(deriv.y) > dem_toobig)
+                if (sqr(orbit.deriv.x)+sqr(orbit.deriv.y) > dem_toobig)
                 {
                     break;
                 }
             }
             else
             {
-                if (std::max(std::fabs(deriv.x), std::fabs(deriv.y)) > dem_toobig)
+                if (std::max(std::fabs(orbit.deriv.x), std::fabs(orbit.deriv.y)) > dem_toobig)
                 {
                     break;
                 }
@@ -2244,14 +2719,14 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
             {
                 if (g_use_old_distance_estimator)
                 {
-                    if (dem_color < 0)
+                    if (orbit.dem_color < 0)
                     {
-                        dem_color = g_color_iter;
-                        dem_new = g_new_z;
+                        orbit.dem_color = g_ctx.color_iter;
+                        orbit.dem_new = g_ctx.new_z;
                     }
-                    if (g_magnitude_limit >= DEM_BAILOUT
-                        || g_magnitude >= (g_magnitude_limit = DEM_BAILOUT)
-                        || g_magnitude == 0)
+                    if (g_ctx.magnitude_limit >= DEM_BAILOUT
+                        || g_ctx.magnitude >= (g_ctx.magnitude_limit = DEM_BAILOUT)
+                        || g_ctx.magnitude == 0)
                     {
                         break;
                     }
@@ -2261,7 +2736,7 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     break;
                 }
             }
-            g_old_z = g_new_z;
+            g_ctx.old_z = g_ctx.new_z;
         }
 
         // the usual case
@@ -2275,13 +2750,13 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
             {
                 if (bf_math == bf_math_type::BIGNUM)
                 {
-                    g_new_z = cmplxbntofloat(&bnnew);
+                    g_ctx.new_z = cmplxbntofloat(&bnnew);
                 }
                 else if (bf_math == bf_math_type::BIGFLT)
                 {
-                    g_new_z = cmplxbftofloat(&bfnew);
+                    g_ctx.new_z = cmplxbftofloat(&bfnew);
                 }
-                plot_orbit(g_new_z.x, g_new_z.y, -1);
+                plot_orbit(g_ctx.new_z.x, g_ctx.new_z.y, -1);
             }
             else
             {
@@ -2292,78 +2767,78 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         {
             if (bf_math == bf_math_type::BIGNUM)
             {
-                g_new_z = cmplxbntofloat(&bnnew);
+                g_ctx.new_z = cmplxbntofloat(&bnnew);
             }
             else if (bf_math == bf_math_type::BIGFLT)
             {
-                g_new_z = cmplxbftofloat(&bfnew);
+                g_ctx.new_z = cmplxbftofloat(&bfnew);
             }
             if (g_inside_color == STARTRAIL)
             {
-                if (0 < g_color_iter && g_color_iter < 16)
+                if (0 < g_ctx.color_iter && g_ctx.color_iter < 16)
                 {
                     if (g_integer_fractal)
                     {
-                        g_new_z.x = g_l_new_z.x;
-                        g_new_z.x /= g_fudge_factor;
-                        g_new_z.y = g_l_new_z.y;
-                        g_new_z.y /= g_fudge_factor;
+                        g_ctx.new_z.x = g_l_new_z.x;
+                        g_ctx.new_z.x /= g_fudge_factor;
+                        g_ctx.new_z.y = g_l_new_z.y;
+                        g_ctx.new_z.y /= g_fudge_factor;
                     }
 
-                    if (g_new_z.x > STARTRAILMAX)
+                    if (g_ctx.new_z.x > STARTRAILMAX)
                     {
-                        g_new_z.x = STARTRAILMAX;
+                        g_ctx.new_z.x = STARTRAILMAX;
                     }
-                    if (g_new_z.x < -STARTRAILMAX)
+                    if (g_ctx.new_z.x < -STARTRAILMAX)
                     {
-                        g_new_z.x = -STARTRAILMAX;
+                        g_ctx.new_z.x = -STARTRAILMAX;
                     }
-                    if (g_new_z.y > STARTRAILMAX)
+                    if (g_ctx.new_z.y > STARTRAILMAX)
                     {
-                        g_new_z.y = STARTRAILMAX;
+                        g_ctx.new_z.y = STARTRAILMAX;
                     }
-                    if (g_new_z.y < -STARTRAILMAX)
+                    if (g_ctx.new_z.y < -STARTRAILMAX)
                     {
-                        g_new_z.y = -STARTRAILMAX;
+                        g_ctx.new_z.y = -STARTRAILMAX;
                     }
-                    g_temp_sqr_x = g_new_z.x * g_new_z.x;
-                    g_temp_sqr_y = g_new_z.y * g_new_z.y;
-                    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-                    g_old_z = g_new_z;
+                    g_ctx.temp_sqr_x = g_ctx.new_z.x * g_ctx.new_z.x;
+                    g_ctx.temp_sqr_y = g_ctx.new_z.y * g_ctx.new_z.y;
+                    g_ctx.magnitude = g_ctx.temp_sqr_x + g_ctx.temp_sqr_y;
+                    g_ctx.old_z = g_ctx.new_z;
                     {
                         int tmpcolor;
-                        tmpcolor = (int)(((g_color_iter - 1) % g_and_color) + 1);
-                        tantable[tmpcolor-1] = g_new_z.y/(g_new_z.x+.000001);
+                        tmpcolor = (int)(((g_ctx.color_iter - 1) % g_and_color) + 1);
+                        orbit.tantable[tmpcolor-1] = g_ctx.new_z.y/(g_ctx.new_z.x+.000001);
                     }
                 }
             }
             else if (g_inside_color == EPSCROSS)
             {
-                hooper = 0;
+                orbit.hooper = 0;
                 if (g_integer_fractal)
                 {
                     if (labs(g_l_new_z.x) < labs(lcloseprox))
                     {
-                        hooper = (lcloseprox > 0? 1 : -1); // close to y axis
-                        goto plot_inside;
+                        orbit.hooper = (lcloseprox > 0? 1 : -1); // close to y axis
+                        return color_standard_pixel(orbit, true);
                     }
                     else if (labs(g_l_new_z.y) < labs(lcloseprox))
                     {
-                        hooper = (lcloseprox > 0 ? 2: -2); // close to x axis
-                        goto plot_inside;
+                        orbit.hooper = (lcloseprox > 0 ? 2: -2); // close to x axis
+                        return color_standard_pixel(orbit, true);
                     }
                 }
                 else
                 {
-                    if (std::fabs(g_new_z.x) < std::fabs(g_close_proximity))
+                    if (std::fabs(g_ctx.new_z.x) < std::fabs(g_close_proximity))
                     {
-                        hooper = (g_close_proximity > 0? 1 : -1); // close to y axis
-                        goto plot_inside;
+                        orbit.hooper = (g_close_proximity > 0? 1 : -1); // close to y axis
+                        return color_standard_pixel(orbit, true);
                     }
-                    else if (std::fabs(g_new_z.y) < std::fabs(g_close_proximity))
+                    else if (std::fabs(g_ctx.new_z.y) < std::fabs(g_close_proximity))
                     {
-                        hooper = (g_close_proximity > 0? 2 : -2); // close to x axis
-                        goto plot_inside;
+                        orbit.hooper = (g_close_proximity > 0? 2 : -2); // close to x axis
+                        return color_standard_pixel(orbit, true);
                     }
                 }
             }
@@ -2372,13 +2847,13 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                 double mag;
                 if (g_integer_fractal)
                 {
-                    g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-                    g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+                    g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+                    g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
                 }
                 mag = fmodtest();
                 if (mag < g_close_proximity)
                 {
-                    memvalue = mag;
+                    orbit.memvalue = mag;
                 }
             }
             else if (g_inside_color <= BOF60 && g_inside_color >= BOF61)
@@ -2389,17 +2864,17 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     {
                         g_l_magnitude = lsqr(g_l_new_z.x) + lsqr(g_l_new_z.y);
                     }
-                    g_magnitude = g_l_magnitude;
-                    g_magnitude = g_magnitude / g_fudge_factor;
+                    g_ctx.magnitude = g_l_magnitude;
+                    g_ctx.magnitude = g_ctx.magnitude / g_fudge_factor;
                 }
-                else if (g_magnitude == 0.0 || g_magnitude_calc)
+                else if (g_ctx.magnitude == 0.0 || g_magnitude_calc)
                 {
-                    g_magnitude = sqr(g_new_z.x) + sqr(g_new_z.y);
+                    g_ctx.magnitude = sqr(g_ctx.new_z.x) + sqr(g_ctx.new_z.y);
                 }
-                if (g_magnitude < min_orbit)
+                if (g_ctx.magnitude < orbit.min_orbit)
                 {
-                    min_orbit = g_magnitude;
-                    min_index = g_color_iter + 1;
+                    orbit.min_orbit = g_ctx.magnitude;
+                    orbit.min_index = g_ctx.color_iter + 1;
                 }
             }
         }
@@ -2408,35 +2883,35 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         {
             if (bf_math == bf_math_type::BIGNUM)
             {
-                g_new_z = cmplxbntofloat(&bnnew);
+                g_ctx.new_z = cmplxbntofloat(&bnnew);
             }
             else if (bf_math == bf_math_type::BIGFLT)
             {
-                g_new_z = cmplxbftofloat(&bfnew);
+                g_ctx.new_z = cmplxbftofloat(&bfnew);
             }
             if (g_outside_color == TDIS)
             {
                 if (g_integer_fractal)
                 {
-                    g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-                    g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+                    g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+                    g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
                 }
-                totaldist += std::sqrt(sqr(lastz.x-g_new_z.x)+sqr(lastz.y-g_new_z.y));
-                lastz.x = g_new_z.x;
-                lastz.y = g_new_z.y;
+                orbit.totaldist += std::sqrt(sqr(lastz.x-g_ctx.new_z.x)+sqr(lastz.y-g_ctx.new_z.y));
+                lastz.x = g_ctx.new_z.x;
+                lastz.y = g_ctx.new_z.y;
             }
             else if (g_outside_color == FMOD)
             {
                 double mag;
                 if (g_integer_fractal)
                 {
-                    g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-                    g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+                    g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+                    g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
                 }
                 mag = fmodtest();
                 if (mag < g_close_proximity)
                 {
-                    memvalue = mag;
+                    orbit.memvalue = mag;
                 }
             }
         }
@@ -2458,10 +2933,10 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                         {
                             if ((lat.x + lat.y) < g_l_at_rad)
                             {
-                                attracted = true;
+                                orbit.attracted = true;
                                 if (g_finite_attractor)
                                 {
-                                    g_color_iter = (g_color_iter % g_attractor_period[i]) + 1;
+                                    g_ctx.color_iter = (g_ctx.color_iter % g_attractor_period[i]) + 1;
                                 }
                                 break;
                             }
@@ -2473,20 +2948,20 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
             {
                 for (int i = 0; i < g_attractors; i++)
                 {
-                    at.x = g_new_z.x - g_attractor[i].x;
+                    at.x = g_ctx.new_z.x - g_attractor[i].x;
                     at.x = sqr(at.x);
                     if (at.x < g_f_at_rad)
                     {
-                        at.y = g_new_z.y - g_attractor[i].y;
+                        at.y = g_ctx.new_z.y - g_attractor[i].y;
                         at.y = sqr(at.y);
                         if (at.y < g_f_at_rad)
                         {
                             if ((at.x + at.y) < g_f_at_rad)
                             {
-                                attracted = true;
+                                orbit.attracted = true;
                                 if (g_finite_attractor)
                                 {
-                                    g_color_iter = (g_color_iter % g_attractor_period[i]) + 1;
+                                    g_ctx.color_iter = (g_ctx.color_iter % g_attractor_period[i]) + 1;
                                 }
                                 break;
                             }
@@ -2494,17 +2969,17 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     }
                 }
             }
-            if (attracted)
+            if (orbit.attracted)
             {
                 break;              // AHA! Eaten by an attractor
             }
         }
 
-        if (g_color_iter > g_old_color_iter) // check periodicity
+        if (g_ctx.color_iter > g_ctx.old_color_iter) // check periodicity
         {
-            if ((g_color_iter & savedand) == 0)            // time to save a new value
+            if ((g_ctx.color_iter & savedand) == 0)            // time to save a new value
             {
-                savedcoloriter = g_color_iter;
+                savedcoloriter = g_ctx.color_iter;
                 if (g_integer_fractal)
                 {
                     lsaved = g_l_new_z;// integer fractals
@@ -2521,7 +2996,7 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                 }
                 else
                 {
-                    saved = g_new_z;  // floating pt fractals
+                    saved = g_ctx.new_z;  // floating pt fractals
                 }
                 if (--savedincr == 0)    // time to lengthen the periodicity?
                 {
@@ -2537,7 +3012,7 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     {
                         if (labs(lsaved.y - g_l_new_z.y) < g_l_close_enough)
                         {
-                            caught_a_cycle = true;
+                            orbit.caught_a_cycle = true;
                         }
                     }
                 }
@@ -2547,7 +3022,7 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     {
                         if (cmp_bn(abs_a_bn(sub_bn(bntmp, bnsaved.y, bnnew.y)), bnclosenuff) < 0)
                         {
-                            caught_a_cycle = true;
+                            orbit.caught_a_cycle = true;
                         }
                     }
                 }
@@ -2557,46 +3032,61 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
                     {
                         if (cmp_bf(abs_a_bf(sub_bf(bftmp, bfsaved.y, bfnew.y)), bfclosenuff) < 0)
                         {
-                            caught_a_cycle = true;
+                            orbit.caught_a_cycle = true;
                         }
                     }
                 }
                 else
                 {
-                    if (std::fabs(saved.x - g_new_z.x) < g_close_enough)
+                    if (std::fabs(saved.x - g_ctx.new_z.x) < g_close_enough)
                     {
-                        if (std::fabs(saved.y - g_new_z.y) < g_close_enough)
+                        if (std::fabs(saved.y - g_ctx.new_z.y) < g_close_enough)
                         {
-                            caught_a_cycle = true;
+                            orbit.caught_a_cycle = true;
                         }
                     }
                 }
-                if (caught_a_cycle)
+                if (orbit.caught_a_cycle)
                 {
-                    cyclelen = g_color_iter-savedcoloriter;
-                    g_color_iter = g_max_iterations - 1;
+                    orbit.cyclelen = g_ctx.color_iter-savedcoloriter;
+                    g_ctx.color_iter = g_max_iterations - 1;
                 }
 
             }
         }
-    }  // end while (g_color_iter++ < maxit)
+    }  // end while (g_ctx.color_iter++ < maxit)
 
     if (g_show_orbit)
     {
         scrub_orbit();
     }
 
-    g_real_color_iter = g_color_iter;           // save this before we start adjusting it
-    if (g_color_iter >= g_max_iterations)
+    return color_standard_pixel(orbit, false);
+}
+
+// color and plot the pixel standard_fractal() has just iterated, as an
+// inside point straight away if inside is set
+static int color_standard_pixel(orbit_info const &orbit, bool inside)
+{
+    int const green = 2;
+    int const yellow = 6;
+
+    if (inside)
+    {
+        goto plot_inside;
+    }
+
+    g_ctx.real_color_iter = g_ctx.color_iter;           // save this before we start adjusting it
+    if (g_ctx.color_iter >= g_max_iterations)
     {
-        g_old_color_iter = 0;         // check periodicity immediately next time
+        g_ctx.old_color_iter = 0;         // check periodicity immediately next time
     }
     else
     {
-        g_old_color_iter = g_color_iter + 10;    // check when past this + 10 next time
-        if (g_color_iter == 0)
+        g_ctx.old_color_iter = g_ctx.color_iter + 10;    // check when past this + 10 next time
+        if (g_ctx.color_iter == 0)
         {
-            g_color_iter = 1;         // needed to make same as calcmand
+            g_ctx.color_iter = 1;         // needed to make same as calcmand
         }
     }
 
@@ -2604,29 +3094,29 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
     {
         if (g_integer_fractal)       // adjust integer fractals
         {
-            g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-            g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+            g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+            g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
         }
         else if (bf_math == bf_math_type::BIGNUM)
         {
-            g_new_z.x = (double)bntofloat(bnnew.x);
-            g_new_z.y = (double)bntofloat(bnnew.y);
+            g_ctx.new_z.x = (double)bntofloat(bnnew.x);
+            g_ctx.new_z.y = (double)bntofloat(bnnew.y);
         }
         else if (bf_math == bf_math_type::BIGFLT)
         {
-            g_new_z.x = (double)bftofloat(bfnew.x);
-            g_new_z.y = (double)bftofloat(bfnew.y);
+            g_ctx.new_z.x = (double)bftofloat(bfnew.x);
+            g_ctx.new_z.y = (double)bftofloat(bfnew.y);
         }
-        g_magnitude = sqr(g_new_z.x) + sqr(g_new_z.y);
-        g_color_iter = potential(g_magnitude, g_color_iter);
+        g_ctx.magnitude = sqr(g_ctx.new_z.x) + sqr(g_ctx.new_z.y);
+        g_ctx.color_iter = potential(g_ctx.magnitude, g_ctx.color_iter);
         if (!g_log_map_table.empty() || g_log_map_calculate)
         {
-            g_color_iter = logtablecalc(g_color_iter);
+            g_ctx.color_iter = logtablecalc(g_ctx.color_iter);
         }
         goto plot_pixel;          // skip any other adjustments
     }
 
-    if (g_color_iter >= g_max_iterations)                // an "inside" point
+    if (g_ctx.color_iter >= g_max_iterations)                // an "inside" point
     {
         goto plot_inside;         // distest, decomp, biomorph don't apply
     }
@@ -2636,56 +3126,56 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
     {
         if (g_integer_fractal)
         {
-            g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-            g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+            g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+            g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
         }
         else if (bf_math ==  bf_math_type::BIGNUM)
         {
-            g_new_z.x = (double)bntofloat(bnnew.x);
-            g_new_z.y = (double)bntofloat(bnnew.y);
+            g_ctx.new_z.x = (double)bntofloat(bnnew.x);
+            g_ctx.new_z.y = (double)bntofloat(bnnew.y);
         }
         // Add 7 to overcome negative values on the MANDEL
         if (g_outside_color == REAL)                 // "real"
         {
-            g_color_iter += (long)g_new_z.x + 7;
+            g_ctx.color_iter += (long)g_ctx.new_z.x + 7;
         }
         else if (g_outside_color == IMAG)              // "imag"
         {
-            g_color_iter += (long)g_new_z.y + 7;
+            g_ctx.color_iter += (long)g_ctx.new_z.y + 7;
         }
-        else if (g_outside_color == MULT  && g_new_z.y)      // "mult"
+        else if (g_outside_color == MULT  && g_ctx.new_z.y)      // "mult"
         {
-            g_color_iter = (long)((double)g_color_iter * (g_new_z.x/g_new_z.y));
+            g_ctx.color_iter = (long)((double)g_ctx.color_iter * (g_ctx.new_z.x/g_ctx.new_z.y));
         }
         else if (g_outside_color == SUM)               // "sum"
         {
-            g_color_iter += (long)(g_new_z.x + g_new_z.y);
+            g_ctx.color_iter += (long)(g_ctx.new_z.x + g_ctx.new_z.y);
         }
         else if (g_outside_color == ATAN)              // "atan"
         {
-            g_color_iter = (long)std::fabs(std::atan2(g_new_z.y, g_new_z.x)*g_atan_colors/PI);
+            g_ctx.color_iter = (long)std::fabs(std::atan2(g_ctx.new_z.y, g_ctx.new_z.x)*g_atan_colors/PI);
         }
         else if (g_outside_color == FMOD)
         {
-            g_color_iter = (long)(memvalue * g_colors / g_close_proximity);
+            g_ctx.color_iter = (long)(orbit.memvalue * g_colors / g_close_proximity);
         }
         else if (g_outside_color == TDIS)
         {
-            g_color_iter = (long)(totaldist);
+            g_ctx.color_iter = (long)(orbit.totaldist);
         }
 
 
         // eliminate negative colors & wrap arounds
-        if ((g_color_iter <= 0 || g_color_iter > g_max_iterations) && g_outside_color != FMOD)
+        if ((g_ctx.color_iter <= 0 || g_ctx.color_iter > g_max_iterations) && g_outside_color != FMOD)
         {
-            g_color_iter = 1;
+            g_ctx.color_iter = 1;
         }
     }
 
     if (g_distance_estimator)
     {
         double dist;
-        dist = sqr(g_new_z.x) + sqr(g_new_z.y);
+        dist = sqr(g_ctx.new_z.x) + sqr(g_ctx.new_z.y);
         if (dist == 0 || g_overflow)
         {
             dist = 0;
@@ -2694,7 +3184,7 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         {
             double temp;
             temp = std::log(dist);
-            dist = dist * sqr(temp) / (sqr(deriv.x) + sqr(deriv.y));
+            dist = dist * sqr(temp) / (sqr(orbit.deriv.x) + sqr(orbit.deriv.y));
         }
         if (dist < dem_delta)     // point is on the edge
         {
@@ -2702,35 +3192,35 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
             {
                 goto plot_inside;   // show it as an inside point
             }
-            g_color_iter = 0 - g_distance_estimator;       // show boundary as specified color
+            g_ctx.color_iter = 0 - g_distance_estimator;       // show boundary as specified color
             goto plot_pixel;       // no further adjustments apply
         }
         if (g_colors == 2)
         {
-            g_color_iter = !g_inside_color;   // the only useful distest 2 color use
+            g_ctx.color_iter = !g_inside_color;   // the only useful distest 2 color use
             goto plot_pixel;       // no further adjustments apply
         }
         if (g_distance_estimator > 1)          // pick color based on distance
         {
             if (g_old_demm_colors)   // this one is needed for old color scheme
             {
-                g_color_iter = (long)std::sqrt(sqrt(dist) / dem_width + 1);
+                g_ctx.color_iter = (long)std::sqrt(sqrt(dist) / dem_width + 1);
             }
             else if (g_use_old_distance_estimator)
             {
-                g_color_iter = (long)std::sqrt(dist / dem_width + 1);
+                g_ctx.color_iter = (long)std::sqrt(dist / dem_width + 1);
             }
             else
             {
-                g_color_iter = (long)(dist / dem_width + 1);
+                g_ctx.color_iter = (long)(dist / dem_width + 1);
             }
-            g_color_iter &= LONG_MAX;  // oops - color can be negative
+            g_ctx.color_iter &= LONG_MAX;  // oops - color can be negative
             goto plot_pixel;       // no further adjustments apply
         }
         if (g_use_old_distance_estimator)
         {
-            g_color_iter = dem_color;
-            g_new_z = dem_new;
+            g_ctx.color_iter = orbit.dem_color;
+            g_ctx.new_z = orbit.dem_new;
         }
         // use pixel's "regular" color
     }
@@ -2745,74 +3235,74 @@ int standard_fractal()       // per pixel 1/2/b/g, called with row & col set
         {
             if (labs(g_l_new_z.x) < g_l_magnitude_limit2 || labs(g_l_new_z.y) < g_l_magnitude_limit2)
             {
-                g_color_iter = g_biomorph;
+                g_ctx.color_iter = g_biomorph;
             }
         }
-        else if (std::fabs(g_new_z.x) < g_magnitude_limit2 || std::fabs(g_new_z.y) < g_magnitude_limit2)
+        else if (std::fabs(g_ctx.new_z.x) < g_magnitude_limit2 || std::fabs(g_ctx.new_z.y) < g_magnitude_limit2)
         {
-            g_color_iter = g_biomorph;
+            g_ctx.color_iter = g_biomorph;
         }
     }
 
-    if (g_outside_color >= COLOR_BLACK && !attracted)       // merge escape-time stripes
+    if (g_outside_color >= COLOR_BLACK && !orbit.attracted)       // merge escape-time stripes
     {
-        g_color_iter = g_outside_color;
+        g_ctx.color_iter = g_outside_color;
     }
     else if (!g_log_map_table.empty() || g_log_map_calculate)
     {
-        g_color_iter = logtablecalc(g_color_iter);
+        g_ctx.color_iter = logtablecalc(g_ctx.color_iter);
     }
     goto plot_pixel;
 
 plot_inside: // we're "inside"
-    if (g_periodicity_check < 0 && caught_a_cycle)
+    if (g_periodicity_check < 0 && orbit.caught_a_cycle)
     {
-        g_color_iter = 7;           // show periodicity
+        g_ctx.color_iter = 7;           // show periodicity
     }
     else if (g_inside_color >= COLOR_BLACK)
     {
-        g_color_iter = g_inside_color;              // set to specified color, ignore logpal
+        g_ctx.color_iter = g_inside_color;              // set to specified color, ignore logpal
     }
     else
     {
         if (g_inside_color == STARTRAIL)
         {
             double diff;
-            g_color_iter = 0;
+            g_ctx.color_iter = 0;
             for (int i = 1; i < 16; i++)
             {
-                diff = tantable[0] - tantable[i];
+                diff = orbit.tantable[0] - orbit.tantable[i];
                 if (std::fabs(diff) < .05)
                 {
-                    g_color_iter = i;
+                    g_ctx.color_iter = i;
                     break;
                 }
             }
         }
         else if (g_inside_color == PERIOD)
         {
-            if (cyclelen > 0)
+            if (orbit.cyclelen > 0)
             {
-                g_color_iter = cyclelen;
+                g_ctx.color_iter = orbit.cyclelen;
             }
             else
             {
-                g_color_iter = g_max_iterations;
+                g_ctx.color_iter = g_max_iterations;
             }
         }
         else if (g_inside_color == EPSCROSS)
         {
-            if (hooper == 1)
+            if (orbit.hooper == 1)
             {
-                g_color_iter = green;
+                g_ctx.color_iter = green;
             }
-            else if (hooper == 2)
+            else if (orbit.hooper == 2)
             {
-                g_color_iter = yellow;
+                g_ctx.color_iter = yellow;
             }
-            else if (hooper == 0)
+            else if (orbit.hooper == 0)
             {
-                g_color_iter = g_max_iterations;
+                g_ctx.color_iter = g_max_iterations;
             }
             if (g_show_orbit)
             {
@@ -2821,63 +3311,63 @@ plot_inside: // we're "inside"
         }
         else if (g_inside_color == FMODI)
         {
-            g_color_iter = (long)(memvalue * g_colors / g_close_proximity);
+            g_ctx.color_iter = (long)(orbit.memvalue * g_colors / g_close_proximity);
         }
         else if (g_inside_color == ATANI)            // "atan"
         {
             if (g_integer_fractal)
             {
-                g_new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
-                g_new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
-                g_color_iter = (long)std::fabs(std::atan2(g_new_z.y, g_new_z.x)*g_atan_colors/PI);
+                g_ctx.new_z.x = ((double)g_l_new_z.x) / g_fudge_factor;
+                g_ctx.new_z.y = ((double)g_l_new_z.y) / g_fudge_factor;
+                g_ctx.color_iter = (long)std::fabs(std::atan2(g_ctx.new_z.y, g_ctx.new_z.x)*g_atan_colors/PI);
             }
             else
             {
-                g_color_iter = (long)std::fabs(std::atan2(g_new_z.y, g_new_z.x)*g_atan_colors/PI);
+                g_ctx.color_iter = (long)std::fabs(std::atan2(g_ctx.new_z.y, g_ctx.new_z.x)*g_atan_colors/PI);
             }
         }
         else if (g_inside_color == BOF60)
         {
-            g_color_iter = (long)(std::sqrt(min_orbit) * 75);
+            g_ctx.color_iter = (long)(std::sqrt(orbit.min_orbit) * 75);
         }
         else if (g_inside_color == BOF61)
         {
-            g_color_iter = min_index;
+            g_ctx.color_iter = orbit.min_index;
         }
         else if (g_inside_color == ZMAG)
         {
             if (g_integer_fractal)
             {
-                g_color_iter = (long)(((double)g_l_magnitude/g_fudge_factor) * (g_max_iterations >> 1) + 1);
+                g_ctx.color_iter = (long)(((double)g_l_magnitude/g_fudge_factor) * (g_max_iterations >> 1) + 1);
             }
             else
             {
-                g_color_iter = (long)((sqr(g_new_z.x) + sqr(g_new_z.y)) * (g_max_iterations >> 1) + 1);
+                g_ctx.color_iter = (long)((sqr(g_ctx.new_z.x) + sqr(g_ctx.new_z.y)) * (g_max_iterations >> 1) + 1);
             }
         }
         else   // inside == -1
         {
-            g_color_iter = g_max_iterations;
+            g_ctx.color_iter = g_max_iterations;
         }
         if (!g_log_map_table.empty() || g_log_map_calculate)
         {
-            g_color_iter = logtablecalc(g_color_iter);
+            g_ctx.color_iter = logtablecalc(g_ctx.color_iter);
         }
     }
 
 plot_pixel:
 
-    g_color = std::abs((int)g_color_iter);
-    if (g_color_iter >= g_colors)
+    g_color = std::abs((int)g_ctx.color_iter);
+    if (g_ctx.color_iter >= g_colors)
     {
         // don't use color 0 unless from inside/outside
         if (g_colors < 16)
         {
-            g_color = (int)(g_color_iter & g_and_color);
+            g_color = (int)(g_ctx.color_iter & g_and_color);
         }
         else
         {
-            g_color = (int)(((g_color_iter - 1) % g_and_color) + 1);
+            g_color = (int)(((g_ctx.color_iter - 1) % g_and_color) + 1);
         }
     }
     if (g_debug_flag != debug_flags::force_boundary_trace_error)
@@ -2889,8 +3379,11 @@ plot_pixel:
     }
     (*g_plot)(g_col, g_row, g_color);
 
-    g_max_iterations = savemaxit;
-    if ((g_keyboard_check_interval -= std::abs((int)g_real_color_iter)) <= 0)
+    if (g_inside_color == STARTRAIL)
+    {
+        g_max_iterations = orbit.savemaxit;
+    }
+    if ((g_keyboard_check_interval -= std::abs((int)g_ctx.real_color_iter)) <= 0)
     {
         if (check_key())
         {
@@ -2939,7 +3432,7 @@ static void decomposition()
     int save_temp = 0;
     LComplex lalt;
     DComplex alt;
-    g_color_iter = 0;
+    g_ctx.color_iter = 0;
     if (g_integer_fractal) // the only case
     {
         if (reset_fudge != g_fudge_factor)
@@ -3065,15 +3558,15 @@ static void decomposition()
     }
     else // double case
     {
-        if (g_new_z.y < 0)
+        if (g_ctx.new_z.y < 0)
         {
             temp = 2;
-            g_new_z.y = -g_new_z.y;
+            g_ctx.new_z.y = -g_ctx.new_z.y;
         }
-        if (g_new_z.x < 0)
+        if (g_ctx.new_z.x < 0)
         {
             ++temp;
-            g_new_z.x = -g_new_z.x;
+            g_ctx.new_z.x = -g_ctx.new_z.x;
         }
         if (g_decomp[0] == 2)
         {
@@ -3090,61 +3583,61 @@ static void decomposition()
         if (g_decomp[0] >= 8)
         {
             temp <<= 1;
-            if (g_new_z.x < g_new_z.y)
+            if (g_ctx.new_z.x < g_ctx.new_z.y)
             {
                 ++temp;
-                alt.x = g_new_z.x; // just
-                g_new_z.x = g_new_z.y; // swap
-                g_new_z.y = alt.x; // them
+                alt.x = g_ctx.new_z.x; // just
+                g_ctx.new_z.x = g_ctx.new_z.y; // swap
+                g_ctx.new_z.y = alt.x; // them
             }
             if (g_decomp[0] >= 16)
             {
                 temp <<= 1;
-                if (g_new_z.x*tan22_5 < g_new_z.y)
+                if (g_ctx.new_z.x*tan22_5 < g_ctx.new_z.y)
                 {
                     ++temp;
-                    alt = g_new_z;
-                    g_new_z.x = alt.x*cos45 + alt.y*sin45;
-                    g_new_z.y = alt.x*sin45 - alt.y*cos45;
+                    alt = g_ctx.new_z;
+                    g_ctx.new_z.x = alt.x*cos45 + alt.y*sin45;
+                    g_ctx.new_z.y = alt.x*sin45 - alt.y*cos45;
                 }
 
                 if (g_decomp[0] >= 32)
                 {
                     temp <<= 1;
-                    if (g_new_z.x*tan11_25 < g_new_z.y)
+                    if (g_ctx.new_z.x*tan11_25 < g_ctx.new_z.y)
                     {
                         ++temp;
-                        alt = g_new_z;
-                        g_new_z.x = alt.x*cos22_5 + alt.y*sin22_5;
-                        g_new_z.y = alt.x*sin22_5 - alt.y*cos22_5;
+                        alt = g_ctx.new_z;
+                        g_ctx.new_z.x = alt.x*cos22_5 + alt.y*sin22_5;
+                        g_ctx.new_z.y = alt.x*sin22_5 - alt.y*cos22_5;
                     }
 
                     if (g_decomp[0] >= 64)
                     {
                         temp <<= 1;
-                        if (g_new_z.x*tan5_625 < g_new_z.y)
+                        if (g_ctx.new_z.x*tan5_625 < g_ctx.new_z.y)
                         {
                             ++temp;
-                            alt = g_new_z;
-                            g_new_z.x = alt.x*cos11_25 + alt.y*sin11_25;
-                            g_new_z.y = alt.x*sin11_25 - alt.y*cos11_25;
+                            alt = g_ctx.new_z;
+                            g_ctx.new_z.x = alt.x*cos11_25 + alt.y*sin11_25;
+                            g_ctx.new_z.y = alt.x*sin11_25 - alt.y*cos11_25;
                         }
 
                         if (g_decomp[0] >= 128)
                         {
                             temp <<= 1;
-                            if (g_new_z.x*tan2_8125 < g_new_z.y)
+                            if (g_ctx.new_z.x*tan2_8125 < g_ctx.new_z.y)
                             {
                                 ++temp;
-                                alt = g_new_z;
-                                g_new_z.x = alt.x*cos5_625 + alt.y*sin5_625;
-                                g_new_z.y = alt.x*sin5_625 - alt.y*cos5_625;
+                                alt = g_ctx.new_z;
+                                g_ctx.new_z.x = alt.x*cos5_625 + alt.y*sin5_625;
+                                g_ctx.new_z.y = alt.x*sin5_625 - alt.y*cos5_625;
                             }
 
                             if (g_decomp[0] == 256)
                             {
                                 temp <<= 1;
-                                if ((g_new_z.x*tan1_4063 < g_new_z.y))
+                                if ((g_ctx.new_z.x*tan1_4063 < g_ctx.new_z.y))
                                 {
                                     ++temp;
                                 }
@@ -3159,7 +3652,7 @@ static void decomposition()
     {
         if (temp & 1)
         {
-            g_color_iter = (1 << i) - 1 - g_color_iter;
+            g_ctx.color_iter = (1 << i) - 1 - g_ctx.color_iter;
         }
         temp >>= 1;
     }
@@ -3167,20 +3660,20 @@ static void decomposition()
     {
         if (save_temp & 2)
         {
-            g_color_iter = 1;
+            g_ctx.color_iter = 1;
         }
         else
         {
-            g_color_iter = 0;
+            g_ctx.color_iter = 0;
         }
         if (g_colors == 2)
         {
-            g_color_iter++;
+            g_ctx.color_iter++;
         }
     }
     if (g_colors > g_decomp[0])
     {
-        g_color_iter++;
+        g_ctx.color_iter++;
     }
 }
 
@@ -3295,9 +3788,37 @@ static int potential(double mag, long iterations)
 // boundary trace method
 #define bkcolor 0
 
+static BYTE *trace_strip_pixel(int col, int row)
+{
+    return &s_trace_strip->pixels[static_cast<std::size_t>(row - s_trace_strip->top)*g_logical_screen_x_dots + col];
+}
+
+// getcolor() from the strip being traced, if any
+static int trace_getcolor(int col, int row)
+{
+    if (s_trace_strip == nullptr)
+    {
+        return getcolor(col, row);
+    }
+    if (col < 0 || col >= g_logical_screen_x_dots)
+    {
+        return 0;
+    }
+    return *trace_strip_pixel(col, row);
+}
+
+// g_plot for tracing a strip on a calc thread
+static void trace_strip_plot(int x, int y, int color)
+{
+    if (x >= 0 && x < g_logical_screen_x_dots && y >= s_trace_strip->top && y <= s_trace_strip->bottom)
+    {
+        *trace_strip_pixel(x, y) = (BYTE)(color & g_and_color);
+    }
+}
+
 inline direction advance(direction dir, int increment)
 {
-    return static_cast<direction>((static_cast<int>(dir) + increment) % 4);
+    return static_cast<direction>((static_cast<int>(dir) + increment + 4) % 4);
 }
 
 inline void advance_match(direction &coming_from)
@@ -3313,11 +3834,6 @@ inline void advance_no_match()
 
 static int bound_trace_main()
 {
-    direction coming_from;
-    unsigned int matches_found;
-    int trail_color, fillcolor_used, last_fillcolor_used = -1;
-    int max_putline_length;
-    int right, left, length;
     if (g_inside_color == COLOR_BLACK || g_outside_color == COLOR_BLACK)
     {
         stopmsg(STOPMSG_NONE, "Boundary tracing cannot be used with inside=0 or outside=0");
@@ -3330,14 +3846,40 @@ static int bound_trace_main()
     }
 
     g_got_status = 2;
+    int status = bound_trace_strips();
+    if (status == 1)
+    {
+        status = bound_trace_rows(g_i_y_start, g_i_y_stop);
+    }
+    if (status == -1)
+    {
+        if (g_i_y_stop != g_yy_stop)
+        {
+            g_i_y_stop = g_yy_stop - (g_row - g_yy_start); // allow for sym
+        }
+        add_worklist(g_xx_start, g_xx_stop, g_col, g_row, g_i_y_stop, g_row, 0, g_work_symmetry);
+    }
+    return status;
+}
+
+// Trace and fill the regions starting in rows first_row to last_row; only
+// pixels in those rows are looked at.  Returns -1 if interrupted with g_row,
+// g_col set to where to start again, else 0.
+static int bound_trace_rows(int first_row, int last_row)
+{
+    direction coming_from;
+    unsigned int matches_found;
+    int trail_color, fillcolor_used, last_fillcolor_used = -1;
+    int max_putline_length;
+    int right, left, length;
     max_putline_length = 0; // reset max_putline_length
-    for (int currow = g_i_y_start; currow <= g_i_y_stop; currow++)
+    for (int currow = first_row; currow <= last_row; currow++)
     {
         g_reset_periodicity = true; // reset for a new row
         g_color = bkcolor;
         for (int curcol = g_i_x_start; curcol <= g_i_x_stop; curcol++)
         {
-            if (getcolor(curcol, currow) != bkcolor)
+            if (trace_getcolor(curcol, currow) != bkcolor)
             {
                 continue;
             }
@@ -3351,11 +3893,8 @@ static int bound_trace_main()
                 {
                     (*g_plot)(g_col, g_row, bkcolor);
                 }
-                if (g_i_y_stop != g_yy_stop)
-                {
-                    g_i_y_stop = g_yy_stop - (currow - g_yy_start); // allow for sym
-                }
-                add_worklist(g_xx_start, g_xx_stop, curcol, currow, g_i_y_stop, currow, 0, g_work_symmetry);
+                g_row = currow;
+                g_col = curcol;
                 return -1;
             }
             g_reset_periodicity = false; // normal periodicity checking
@@ -3382,10 +3921,10 @@ static int bound_trace_main()
                 if (g_row >= currow
                     && g_col >= g_i_x_start
                     && g_col <= g_i_x_stop
-                    && g_row <= g_i_y_stop)
+                    && g_row <= last_row)
                 {
                     // the order of operations in this next line is critical
-                    g_color = getcolor(g_col, g_row);
+                    g_color = trace_getcolor(g_col, g_row);
                     if (g_color == bkcolor && (*g_calc_type)() == -1)
                         // color, row, col are global for (*calctype)()
                     {
@@ -3393,11 +3932,8 @@ static int bound_trace_main()
                         {
                             (*g_plot)(g_col, g_row, bkcolor);
                         }
-                        if (g_i_y_stop != g_yy_stop)
-                        {
-                            g_i_y_stop = g_yy_stop - (currow - g_yy_start); // allow for sym
-                        }
-                        add_worklist(g_xx_start, g_xx_stop, curcol, currow, g_i_y_stop, currow, 0, g_work_symmetry);
+                        g_row = currow;
+                        g_col = curcol;
                         return -1;
                     }
                     if (g_color == trail_color)
@@ -3447,9 +3983,9 @@ static int bound_trace_main()
                     if (g_row >= currow
                         && g_col >= g_i_x_start
                         && g_col <= g_i_x_stop
-                        && g_row <= g_i_y_stop
-                        && getcolor(g_col, g_row) == trail_color)
-                        // getcolor() must be last
+                        && g_row <= last_row
+                        && trace_getcolor(g_col, g_row) == trail_color)
+                        // trace_getcolor() must be last
                     {
                         if (going_to == direction::South
                             || (going_to == direction::West && coming_from != direction::East))
@@ -3458,8 +3994,8 @@ static int bound_trace_main()
                             right = g_col;
                             while (--right >= g_i_x_start)
                             {
-                                g_color = getcolor(right, g_row);
-                                if (g_color == trail_color)
+                                g_color = trace_getcolor(right, g_row);
+                                if (g_color != trail_color)
                                 {
                                     break;
                                 }
@@ -3467,7 +4003,7 @@ static int bound_trace_main()
                             if (g_color == bkcolor) // check last color
                             {
                                 left = right;
-                                while (getcolor(--left, g_row) == bkcolor)
+                                while (--left >= g_i_x_start && trace_getcolor(left, g_row) == bkcolor)
                                 {
                                     // Should NOT be possible for left < ixstart
                                     ; // do nothing
@@ -3477,6 +4013,10 @@ static int bound_trace_main()
                                 {
                                     (*g_plot)(left, g_row, fillcolor_used);
                                 }
+                                else if (s_trace_strip != nullptr)
+                                {
+                                    std::fill_n(trace_strip_pixel(left, g_row), right-left+1, (BYTE)(fillcolor_used & g_and_color));
+                                }
                                 else
                                 {
                                     // fill the line to the left
@@ -3484,11 +4024,11 @@ static int bound_trace_main()
                                     if (fillcolor_used != last_fillcolor_used || length > max_putline_length)
                                     {
                                         // only reset dstack if necessary
-                                        std::memset(dstack, fillcolor_used, length);
+                                        std::memset(&dstack[0], fillcolor_used, length);
                                         last_fillcolor_used = fillcolor_used;
                                         max_putline_length = length;
                                     }
-                                    sym_fill_line(g_row, left, right, dstack);
+                                    sym_fill_line(g_row, left, right, &dstack[0]);
                                 }
                             } // end of fill line
                         }
@@ -3521,6 +4061,83 @@ static int bound_trace_main()
     return 0;
 }
 
+static bool trace_strip_calc(int strip)
+{
+    s_trace_strip = &s_trace_strips[strip];
+    g_plot = trace_strip_plot;
+    bool const done = bound_trace_rows(s_trace_strip->top, s_trace_strip->bottom) != -1;
+    s_trace_strip = nullptr;
+    return done;
+}
+
+static void trace_strip_done(int strip)
+{
+    trace_strip &done = s_trace_strips[strip];
+    for (int row = done.top; row <= done.bottom; ++row)
+    {
+        sym_fill_line(row, g_i_x_start, g_i_x_stop,
+            &done.pixels[static_cast<std::size_t>(row - done.top)*g_logical_screen_x_dots + g_i_x_start]);
+    }
+    std::vector<BYTE>().swap(done.pixels);
+}
+
+// Boundary trace on the calc threads, cutting the rows into strips that are
+// traced side by side, as many strips at a time as fit in about 32MB.
+// Returns 0 when done, -1 if interrupted with g_row, g_col set for resuming
+// like bound_trace_rows(), or 1 if the calc threads can't be used.
+static int bound_trace_strips()
+{
+    // sym_fill_line() only copes with rows of many colors for these
+    if (!calc_pool_usable()
+        || g_put_color != putcolor_a
+        || (g_plot != putcolor_a && g_plot != symplot2))
+    {
+        return 1;
+    }
+    int const num_threads = static_cast<int>(calc_pool_threads());
+    int const strip_rows = std::max(32, (g_i_y_stop - g_i_y_start + 1)/(num_threads*4));
+    if (g_i_y_stop - g_i_y_start + 1 < 2*strip_rows)
+    {
+        return 1;
+    }
+    int const max_strips = std::max(2*num_threads, (1 << 25)/(strip_rows*g_logical_screen_x_dots));
+
+    int status = 0;
+    int top = g_i_y_start;
+    while (status == 0 && top <= g_i_y_stop)
+    {
+        s_trace_strips.clear();
+        while (top <= g_i_y_stop && static_cast<int>(s_trace_strips.size()) < max_strips)
+        {
+            int const bottom = std::min(top + strip_rows - 1, g_i_y_stop);
+            s_trace_strips.push_back(trace_strip{top, bottom, {}});
+            std::vector<BYTE> &pixels = s_trace_strips.back().pixels;
+            pixels.resize(static_cast<std::size_t>(bottom - top + 1)*g_logical_screen_x_dots);
+            for (int row = top; row <= bottom; ++row)
+            {
+                get_line(row, 0, g_logical_screen_x_dots-1, &pixels[static_cast<std::size_t>(row - top)*g_logical_screen_x_dots]);
+            }
+            top = bottom + 1;
+        }
+        int const num_strips = static_cast<int>(s_trace_strips.size());
+        int const done = calc_pool_strips(num_strips, trace_strip_calc, trace_strip_done);
+        if (done < 0)
+        {
+            // no calc thread, finish on this one
+            status = bound_trace_rows(s_trace_strips[0].top, g_i_y_stop);
+            top = g_i_y_stop + 1;
+        }
+        else if (done < num_strips)
+        {
+            g_row = s_trace_strips[done].top;
+            g_col = g_i_x_start;
+            status = -1;
+        }
+    }
+    std::vector<trace_strip>().swap(s_trace_strips);
+    return status;
+}
+
 // take one step in the direction of going_to
 static void step_col_row()
 {
@@ -3559,11 +4176,7 @@ static void step_col_row()
 static int solid_guess()
 {
     int i;
-    int xlim;
-    int ylim;
     int blocksize;
-    unsigned int *pfxp0, *pfxp1;
-    unsigned int u;
 
     guessplot = (g_plot != g_put_color && g_plot != symplot2 && g_plot != symplot2J);
     // check if guessing at bottom & right edges is ok
@@ -3594,6 +4207,8 @@ static int solid_guess()
     g_i_y_start = yybegin;
     g_i_y_start &= -1 - (maxblock-1);
 
+    s_guess_calc.resize(g_logical_screen_x_dots/maxblock + 4, g_logical_screen_y_dots/maxblock + 4);
+    s_guess_skip.resize(g_logical_screen_x_dots/maxblock + 4, g_logical_screen_y_dots/maxblock + 4);
     g_got_status = 1;
 
     if (g_work_pass == 0) // otherwise first pass already done
@@ -3603,7 +4218,7 @@ static int solid_guess()
         if (g_i_y_start <= g_yy_start) // first time for this window, init it
         {
             g_current_row = 0;
-            std::memset(&tprefix[1][0][0], 0, maxxblk*maxyblk*2); // noskip flags off
+            s_guess_calc.fill(false); // noskip flags off
             g_reset_periodicity = true;
             g_row = g_i_y_start;
             for (g_col = g_i_x_start; g_col <= g_i_x_stop; g_col += maxblock)
@@ -3619,7 +4234,7 @@ static int solid_guess()
         }
         else
         {
-            std::memset(&tprefix[1][0][0], -1, maxxblk*maxyblk*2); // noskip flags on
+            s_guess_calc.fill(true); // noskip flags on
         }
         for (int y = g_i_y_start; y <= g_i_y_stop; y += blocksize)
         {
@@ -3661,43 +4276,20 @@ static int solid_guess()
         g_i_y_start = g_yy_start & (-1 - (maxblock-1));
 
         // calculate skip flags for skippable blocks
-        xlim = (g_i_x_stop+maxblock)/maxblock+1;
-        ylim = ((g_i_y_stop+maxblock)/maxblock+15)/16+1;
         if (!right_guess)         // no right edge guessing, zap border
         {
-            for (int y = 0; y <= ylim; ++y)
-            {
-                tprefix[1][y][xlim] = 0xffff;
-            }
+            s_guess_calc.set_column((g_i_x_stop+maxblock)/maxblock+1);
         }
         if (!bottom_guess)      // no bottom edge guessing, zap border
         {
-            i = (g_i_y_stop+maxblock)/maxblock+1;
-            int y = i/16+1;
-            i = 1 << (i&15);
-            for (int x = 0; x <= xlim; ++x)
-            {
-                tprefix[1][y][x] |= i;
-            }
-        }
-        // set each bit in tprefix[0] to OR of it & surrounding 8 in tprefix[1]
-        for (int y = 0; ++y < ylim;)
-        {
-            pfxp0 = (unsigned int *)&tprefix[0][y][0];
-            pfxp1 = (unsigned int *)&tprefix[1][y][0];
-            for (int x = 0; ++x < xlim;)
-            {
-                ++pfxp1;
-                u = *(pfxp1-1)|*pfxp1|*(pfxp1+1);
-                *(++pfxp0) = u|(u >> 1)|(u << 1)
-                             |((*(pfxp1-(maxxblk+1))|*(pfxp1-maxxblk)|*(pfxp1-(maxxblk-1))) >> 15)
-                             |((*(pfxp1+(maxxblk-1))|*(pfxp1+maxxblk)|*(pfxp1+(maxxblk+1))) << 15);
-            }
+            s_guess_calc.set_row((g_i_y_stop+maxblock)/maxblock+2);
         }
+        // set each bit in s_guess_skip to OR of it & surrounding 8 in s_guess_calc
+        s_guess_skip.spread(s_guess_calc);
     }
     else   // first pass already done
     {
-        std::memset(&tprefix[0][0][0], -1, maxxblk*maxyblk*2); // noskip flags on
+        s_guess_skip.fill(true); // noskip flags on
     }
     if (g_three_pass)
     {
@@ -3769,30 +4361,41 @@ static bool guessrow(bool firstpass, int y, int blocksize)
     int     c24,    c44;         // iteration
     int guessed23, guessed32, guessed33, guessed12, guessed13;
     int prev11, fix21, fix31;
-    unsigned int *pfxptr, pfxmask;
 
     c42 = 0;  // just for warning
     c41 = c42;
     c44 = c41;
 
     halfblock = blocksize >> 1;
-    int i = y/maxblock;
-    pfxptr = (unsigned int *) &tprefix[firstpass ? 1 : 0][(i >> 4) + 1][g_i_x_start/maxblock];
-    pfxmask = 1 << (i & 15);
+    int const block_row = y/maxblock + 1;
+    int const end_col = g_i_x_stop/maxblock + 2;
     ylesshalf = y - halfblock;
     ylessblock = y - blocksize; // constants, for speed
     yplushalf = y + halfblock;
     yplusblock = y + blocksize;
+    // the corners this row of blocks looks at are all read before any of
+    // them are calculated, so read their rows in one go
+    s_row_this.fetch(y);
+    guess_row const &row_up_half = (y > 0) ? s_row_up_half : s_row_this;
+    if (y > 0)
+    {
+        s_row_up_half.fetch(ylesshalf);
+        s_row_up_block.fetch(ylessblock);
+    }
+    if (yplusblock <= g_i_y_stop)
+    {
+        s_row_down_block.fetch(yplusblock);
+    }
     prev11 = -1;
-    c22 = getcolor(g_i_x_start, y);
+    c22 = s_row_this[g_i_x_start];
     c13 = c22;
     c12 = c13;
     c24 = c12;
-    c21 = getcolor(g_i_x_start, (y > 0)?ylesshalf:0);
+    c21 = row_up_half[g_i_x_start];
     c31 = c21;
     if (yplusblock <= g_i_y_stop)
     {
-        c24 = getcolor(g_i_x_start, yplusblock);
+        c24 = s_row_down_block[g_i_x_start];
     }
     else if (!bottom_guess)
     {
@@ -3805,10 +4408,10 @@ static bool guessrow(bool firstpass, int y, int blocksize)
     {
         if ((x&(maxblock-1)) == 0)  // time for skip flag stuff
         {
-            ++pfxptr;
-            if (!firstpass && (*pfxptr&pfxmask) == 0)  // check for fast skip
+            if (!firstpass && !s_guess_skip.test(x/maxblock + 1, block_row))  // check for fast skip
             {
-                x += maxblock;
+                // on to the next block not to skip
+                x = (s_guess_skip.next_set(x/maxblock + 1, block_row, end_col) - 1)*maxblock;
                 c13 = c22;
                 c12 = c13;
                 c24 = c12;
@@ -3837,16 +4440,16 @@ static bool guessrow(bool firstpass, int y, int blocksize)
         }
         else if (y > 0)
         {
-            c31 = getcolor(xplushalf, ylesshalf);
+            c31 = s_row_up_half[xplushalf];
         }
         if (xplusblock <= g_i_x_stop)
         {
             if (yplusblock <= g_i_y_stop)
             {
-                c44 = getcolor(xplusblock, yplusblock);
+                c44 = s_row_down_block[xplusblock];
             }
-            c41 = getcolor(xplusblock, (y > 0)?ylesshalf:0);
-            c42 = getcolor(xplusblock, y);
+            c41 = row_up_half[xplusblock];
+            c42 = s_row_this[xplusblock];
         }
         else if (!right_guess)
         {
@@ -3916,7 +4519,7 @@ static bool guessrow(bool firstpass, int y, int blocksize)
         {
             if (guessed23 == 0 || guessed32 == 0 || guessed33 == 0)
             {
-                *pfxptr |= pfxmask;
+                s_guess_calc.set(x/maxblock + 1, block_row);
             }
         }
 
@@ -3965,15 +4568,15 @@ static bool guessrow(bool firstpass, int y, int blocksize)
         fix21 = ((c22 != c12 || c22 != c32)
             && c21 == c22 && c21 == c31 && c21 == prev11
             && y > 0
-            && (x == g_i_x_start || c21 == getcolor(x-halfblock, ylessblock))
-            && (xplushalf > g_i_x_stop || c21 == getcolor(xplushalf, ylessblock))
-            && c21 == getcolor(x, ylessblock));
+            && (x == g_i_x_start || c21 == s_row_up_block[x-halfblock])
+            && (xplushalf > g_i_x_stop || c21 == s_row_up_block[xplushalf])
+            && c21 == s_row_up_block[x]);
         fix31 = (c22 != c32
             && c31 == c22 && c31 == c42 && c31 == c21 && c31 == c41
             && y > 0 && xplushalf <= g_i_x_stop
-            && c31 == getcolor(xplushalf, ylessblock)
-            && (xplusblock > g_i_x_stop || c31 == getcolor(xplusblock, ylessblock))
-            && c31 == getcolor(x, ylessblock));
+            && c31 == s_row_up_block[xplushalf]
+            && (xplusblock > g_i_x_stop || c31 == s_row_up_block[xplusblock])
+            && c31 == s_row_up_block[x]);
         prev11 = c31; // for next time around
         if (fix21)
         {
@@ -4037,7 +4640,7 @@ static bool guessrow(bool firstpass, int y, int blocksize)
         j = y+i+halfblock;
         if (j <= g_i_y_stop)
         {
-            put_line(j, g_xx_start, g_i_x_stop, &dstack[g_xx_start+OLD_MAX_PIXELS]);
+            put_line(j, g_xx_start, g_i_x_stop, &dstack[g_xx_start+dstack_row2]);
         }
         if (driver_key_pressed())
         {
@@ -4054,9 +4657,9 @@ static bool guessrow(bool firstpass, int y, int blocksize)
                 j = g_i_x_stop - (i - g_xx_start);
                 dstack[i] = dstack[j];
                 dstack[j] = (BYTE)color;
-                j += OLD_MAX_PIXELS;
-                color = dstack[i + OLD_MAX_PIXELS];
-                dstack[i + OLD_MAX_PIXELS] = dstack[j];
+                j += dstack_row2;
+                color = dstack[i + dstack_row2];
+                dstack[i + dstack_row2] = dstack[j];
                 dstack[j] = (BYTE)color;
             }
         }
@@ -4070,7 +4673,7 @@ static bool guessrow(bool firstpass, int y, int blocksize)
             j = g_yy_stop-(y+i+halfblock-g_yy_start);
             if (j > g_i_y_stop && j < g_logical_screen_y_dots)
             {
-                put_line(j, g_xx_start, g_i_x_stop, &dstack[g_xx_start+OLD_MAX_PIXELS]);
+                put_line(j, g_xx_start, g_i_x_stop, &dstack[g_xx_start+dstack_row2]);
             }
             if (driver_key_pressed())
             {
@@ -4094,11 +4697,11 @@ static void plotblock(int buildrow, int x, int y, int color)
     {
         if (buildrow == 0)
         {
-            std::fill(&dstack[x], &dstack[xlim], (BYTE) color);
+            std::fill_n(&dstack[x], xlim - x, (BYTE) color);
         }
         else
         {
-            std::fill(&dstack[x + OLD_MAX_PIXELS], &dstack[xlim + OLD_MAX_PIXELS], (BYTE) color);
+            std::fill_n(&dstack[x + dstack_row2], xlim - x, (BYTE) color);
         }
         if (x >= g_xx_start)   // when x reduced for alignment, paint those dots too
         {
@@ -4115,6 +4718,28 @@ static void plotblock(int buildrow, int x, int y, int color)
         }
         ylim = g_i_y_stop+1;
     }
+    if (xlim <= x)
+    {
+        return;
+    }
+    if (g_put_color == putcolor_a && (g_plot == putcolor_a || g_plot == symplot2))
+    {
+        // plain or x-axis symmetric plotting, paint whole rows at a time
+        s_block_span.assign(xlim - x, (BYTE)(color & g_and_color));
+        for (int left = x+1; y < ylim; ++y, left = x) // skip 1st dot on 1st row
+        {
+            if (left < xlim)
+            {
+                put_line(y, left, xlim-1, &s_block_span[0]);
+                int const i = g_yy_stop-(y-g_yy_start);
+                if (g_plot == symplot2 && i > g_i_y_stop && i < g_logical_screen_y_dots)
+                {
+                    put_line(i, left, xlim-1, &s_block_span[0]);
+                }
+            }
+        }
+        return;
+    }
     for (int i = x; ++i < xlim;)
     {
         (*g_plot)(i, y, color); // skip 1st dot on 1st row
@@ -4302,9 +4927,9 @@ static void setsymmetry(symmetry_type sym, bool uselist) // set up proper symmet
     {
         return;
     }
-    bool parmszero = (g_param_z1.x == 0.0 && g_param_z1.y == 0.0 && g_use_init_orbit != init_orbit_mode::value);
-    bool parmsnoreal = (g_param_z1.x == 0.0 && g_use_init_orbit != init_orbit_mode::value);
-    bool parmsnoimag = (g_param_z1.y == 0.0 && g_use_init_orbit != init_orbit_mode::value);
+    bool parmszero = (g_ctx.param_z1.x == 0.0 && g_ctx.param_z1.y == 0.0 && g_use_init_orbit != init_orbit_mode::value);
+    bool parmsnoreal = (g_ctx.param_z1.x == 0.0 && g_use_init_orbit != init_orbit_mode::value);
+    bool parmsnoimag = (g_ctx.param_z1.y == 0.0 && g_use_init_orbit != init_orbit_mode::value);
     switch (g_fractal_type)
     {
     case fractal_type::LMANLAMFNFN:      // These need only P1 checked.
@@ -4331,7 +4956,7 @@ static void setsymmetry(symmetry_type sym, bool uselist) // set up proper symmet
             && g_params[7] == 0.0 && g_params[9] == 0.0);
         break;
     default:   // Check P2 for the rest
-        parmszero = (parmszero && g_param_z2.x == 0.0 && g_param_z2.y == 0.0);
+        parmszero = (parmszero && g_ctx.param_z2.x == 0.0 && g_ctx.param_z2.y == 0.0);
     }
     yaxis_col = -1;
     xaxis_row = yaxis_col;
@@ -4526,7 +5151,7 @@ originsym:
         if (!xsym_split(xaxis_row, xaxis_between)
             && !ysym_split(yaxis_col, yaxis_between))
         {
-            if (g_param_z1.y == 0.0)
+            if (g_ctx.param_z1.y == 0.0)
             {
                 g_plot = symPIplot4J; // both axes
             }
@@ -4579,10 +5204,178 @@ struct tess             // one of these per box to be done gets stacked
     int top, bot, lft, rgt;  // edge colors, -1 mixed, -2 unknown
 };
 
+// an area of the window calculated on the calc threads, ready to draw
+struct tess_rect
+{
+    int x1, y1, x2, y2;
+};
+
+static std::vector<BYTE> s_tess_pixels;     // the window, for the calc threads
+static int s_tess_width = 0;
+static tess s_tess_window{};                // the first box, edges as they come
+static std::atomic<int> s_tess_edges(0);    // edges of the first box to go
+static std::mutex s_tess_lock;
+static std::vector<tess_rect> s_tess_done;  // calculated, not yet drawn
+
+static std::size_t tess_offset(int x, int y)
+{
+    return static_cast<std::size_t>(y - g_i_y_start)*s_tess_width + (x - g_i_x_start);
+}
+
+// getcolor() from the calc threads' copy of the window when on one of them
+static int tess_getcolor(int x, int y)
+{
+    return calc_pool_worker() ? s_tess_pixels[tess_offset(x, y)] : getcolor(x, y);
+}
+
+// Check the edges of a box, finding any not known yet, and then its middle
+// line.  Returns their color if they are all the same, otherwise -1.
+static int tess_solid(tess *tp)
+{
+    if (tp->top == -1 || tp->bot == -1 || tp->lft == -1 || tp->rgt == -1)
+    {
+        return -1;
+    }
+    // for any edge whose color is unknown, set it
+    if (tp->top == -2)
+    {
+        tp->top = tesschkrow(tp->x1, tp->x2, tp->y1);
+    }
+    if (tp->top == -1)
+    {
+        return -1;
+    }
+    if (tp->bot == -2)
+    {
+        tp->bot = tesschkrow(tp->x1, tp->x2, tp->y2);
+    }
+    if (tp->bot != tp->top)
+    {
+        return -1;
+    }
+    if (tp->lft == -2)
+    {
+        tp->lft = tesschkcol(tp->x1, tp->y1, tp->y2);
+    }
+    if (tp->lft != tp->top)
+    {
+        return -1;
+    }
+    if (tp->rgt == -2)
+    {
+        tp->rgt = tesschkcol(tp->x2, tp->y1, tp->y2);
+    }
+    if (tp->rgt != tp->top)
+    {
+        return -1;
+    }
+
+    int mid, midcolor;
+    if (tp->x2 - tp->x1 > tp->y2 - tp->y1)
+    {
+        // divide down the middle
+        mid = (tp->x1 + tp->x2) >> 1;           // Find mid point
+        midcolor = tesscol(mid, tp->y1+1, tp->y2-1); // Do mid column
+    }
+    else
+    {
+        // divide across the middle
+        mid = (tp->y1 + tp->y2) >> 1;           // Find mid point
+        midcolor = tessrow(tp->x1+1, tp->x2-1, mid); // Do mid row
+    }
+    return midcolor == tp->top ? tp->top : -1;
+}
+
+// Sub-divide a box not surrounded by one color, calculating the line down or
+// across its middle.  The box becomes the right or bottom part.  Returns 2
+// if the left or top part is left in *other to be done next, 1 if it was too
+// thin to need doing, 0 if nothing is left of the box, or -3 if interrupted.
+static int tess_split(tess *tp, tess *other)
+{
+    int mid, midcolor;
+    if (tp->x2 - tp->x1 > tp->y2 - tp->y1)
+    {
+        // divide down the middle
+        mid = (tp->x1 + tp->x2) >> 1;                // Find mid point
+        midcolor = tesscol(mid, tp->y1+1, tp->y2-1); // Do mid column
+        if (midcolor == -3)
+        {
+            return -3;
+        }
+        if (tp->x2 - mid <= 1)
+        {
+            return 0;
+        }
+        // right part >= 1 column
+        if (tp->top == -1)
+        {
+            tp->top = -2;
+        }
+        if (tp->bot == -1)
+        {
+            tp->bot = -2;
+        }
+        int result = 1;
+        if (mid - tp->x1 > 1)
+        {
+            // left part >= 1 col, stack right
+            std::memcpy(other, tp, sizeof(*tp));
+            other->x2 = mid;
+            other->rgt = midcolor;
+            result = 2;
+        }
+        tp->x1 = mid;
+        tp->lft = midcolor;
+        return result;
+    }
+
+    // divide across the middle
+    mid = (tp->y1 + tp->y2) >> 1;                // Find mid point
+    midcolor = tessrow(tp->x1+1, tp->x2-1, mid); // Do mid row
+    if (midcolor == -3)
+    {
+        return -3;
+    }
+    if (tp->y2 - mid <= 1)
+    {
+        return 0;
+    }
+    // bottom part >= 1 column
+    if (tp->lft == -1)
+    {
+        tp->lft = -2;
+    }
+    if (tp->rgt == -1)
+    {
+        tp->rgt = -2;
+    }
+    int result = 1;
+    if (mid - tp->y1 > 1)
+    {
+        // top also >= 1 col, stack bottom
+        std::memcpy(other, tp, sizeof(*tp));
+        other->y2 = mid;
+        other->bot = midcolor;
+        result = 2;
+    }
+    tp->y1 = mid;
+    tp->top = midcolor;
+    return result;
+}
+
 static int tesseral()
 {
     tess *tp;
 
+    if (g_work_pass == 0) // not resuming
+    {
+        int const status = tesseral_tasks();
+        if (status != 1)
+        {
+            return status;
+        }
+    }
+
     guessplot = (g_plot != g_put_color && g_plot != symplot2);
     tp = (tess *)&dstack[0];
     tp->x1 = g_i_x_start;                              // set up initial box
@@ -4671,67 +5464,10 @@ static int tesseral()
         g_current_column = tp->x1; // for tab_display
         g_current_row = tp->y1;
 
-        if (tp->top == -1 || tp->bot == -1 || tp->lft == -1 || tp->rgt == -1)
+        if (tess_solid(tp) == -1)
         {
             goto tess_split;
         }
-        // for any edge whose color is unknown, set it
-        if (tp->top == -2)
-        {
-            tp->top = tesschkrow(tp->x1, tp->x2, tp->y1);
-        }
-        if (tp->top == -1)
-        {
-            goto tess_split;
-        }
-        if (tp->bot == -2)
-        {
-            tp->bot = tesschkrow(tp->x1, tp->x2, tp->y2);
-        }
-        if (tp->bot != tp->top)
-        {
-            goto tess_split;
-        }
-        if (tp->lft == -2)
-        {
-            tp->lft = tesschkcol(tp->x1, tp->y1, tp->y2);
-        }
-        if (tp->lft != tp->top)
-        {
-            goto tess_split;
-        }
-        if (tp->rgt == -2)
-        {
-            tp->rgt = tesschkcol(tp->x2, tp->y1, tp->y2);
-        }
-        if (tp->rgt != tp->top)
-        {
-            goto tess_split;
-        }
-
-        {
-            int mid, midcolor;
-            if (tp->x2 - tp->x1 > tp->y2 - tp->y1)
-            {
-                // divide down the middle
-                mid = (tp->x1 + tp->x2) >> 1;           // Find mid point
-                midcolor = tesscol(mid, tp->y1+1, tp->y2-1); // Do mid column
-                if (midcolor != tp->top)
-                {
-                    goto tess_split;
-                }
-            }
-            else
-            {
-                // divide across the middle
-                mid = (tp->y1 + tp->y2) >> 1;           // Find mid point
-                midcolor = tessrow(tp->x1+1, tp->x2-1, mid); // Do mid row
-                if (midcolor != tp->top)
-                {
-                    goto tess_split;
-                }
-            }
-        }
 
         {
             // all 4 edges are the same color, fill in
@@ -4765,16 +5501,16 @@ static int tesseral()
                 else
                 {
                     // use put_line for speed
-                    std::memset(&dstack[OLD_MAX_PIXELS], tp->top, j);
+                    std::memset(&dstack[dstack_row2], tp->top, j);
                     for (g_row = tp->y1 + 1; g_row < tp->y2; g_row++)
                     {
-                        put_line(g_row, tp->x1+1, tp->x2-1, &dstack[OLD_MAX_PIXELS]);
+                        put_line(g_row, tp->x1+1, tp->x2-1, &dstack[dstack_row2]);
                         if (g_plot != g_put_color) // symmetry
                         {
                             j = g_yy_stop-(g_row-g_yy_start);
                             if (j > g_i_y_stop && j < g_logical_screen_y_dots)
                             {
-                                put_line(j, tp->x1+1, tp->x2-1, &dstack[OLD_MAX_PIXELS]);
+                                put_line(j, tp->x1+1, tp->x2-1, &dstack[dstack_row2]);
                             }
                         }
                         if (++i > 25)
@@ -4793,84 +5529,18 @@ static int tesseral()
         continue;
 
 tess_split:
+        // box not surrounded by same color, sub-divide
+        switch (tess_split(tp, tp + 1))
         {
-            // box not surrounded by same color, sub-divide
-            int mid, midcolor;
-            tess *tp2;
-            if (tp->x2 - tp->x1 > tp->y2 - tp->y1)
-            {
-                // divide down the middle
-                mid = (tp->x1 + tp->x2) >> 1;                // Find mid point
-                midcolor = tesscol(mid, tp->y1+1, tp->y2-1); // Do mid column
-                if (midcolor == -3)
-                {
-                    goto tess_end;
-                }
-                if (tp->x2 - mid > 1)
-                {
-                    // right part >= 1 column
-                    if (tp->top == -1)
-                    {
-                        tp->top = -2;
-                    }
-                    if (tp->bot == -1)
-                    {
-                        tp->bot = -2;
-                    }
-                    tp2 = tp;
-                    if (mid - tp->x1 > 1)
-                    {
-                        // left part >= 1 col, stack right
-                        std::memcpy(++tp, tp2, sizeof(*tp));
-                        tp->x2 = mid;
-                        tp->rgt = midcolor;
-                    }
-                    tp2->x1 = mid;
-                    tp2->lft = midcolor;
-                }
-                else
-                {
-                    --tp;
-                }
-            }
-            else
-            {
-                // divide across the middle
-                mid = (tp->y1 + tp->y2) >> 1;                // Find mid point
-                midcolor = tessrow(tp->x1+1, tp->x2-1, mid); // Do mid row
-                if (midcolor == -3)
-                {
-                    goto tess_end;
-                }
-                if (tp->y2 - mid > 1)
-                {
-                    // bottom part >= 1 column
-                    if (tp->lft == -1)
-                    {
-                        tp->lft = -2;
-                    }
-                    if (tp->rgt == -1)
-                    {
-                        tp->rgt = -2;
-                    }
-                    tp2 = tp;
-                    if (mid - tp->y1 > 1)
-                    {
-                        // top also >= 1 col, stack bottom
-                        std::memcpy(++tp, tp2, sizeof(*tp));
-                        tp->y2 = mid;
-                        tp->bot = midcolor;
-                    }
-                    tp2->y1 = mid;
-                    tp2->top = midcolor;
-                }
-                else
-                {
-                    --tp;
-                }
-            }
+        case -3:
+            goto tess_end;
+        case 0:
+            --tp;
+            break;
+        case 2:
+            ++tp;
+            break;
         }
-
     }
 
 tess_end:
@@ -4900,13 +5570,204 @@ tess_end:
 
 } // tesseral
 
+// tesseral on the calc threads
+
+// g_plot for tesseral tasks
+static void tess_task_plot(int x, int y, int color)
+{
+    s_tess_pixels[tess_offset(x, y)] = (BYTE)(color & g_and_color);
+}
+
+// hand what a task has calculated over to be drawn
+static void tess_task_done(std::vector<tess_rect> &done)
+{
+    std::lock_guard<std::mutex> lock(s_tess_lock);
+    s_tess_done.insert(s_tess_done.end(), done.begin(), done.end());
+    done.clear();
+}
+
+// Work through a box and the boxes it is split into, starting tasks for the
+// bigger ones so other calc threads can take them.
+static bool tess_box_task(tess box)
+{
+    g_plot = tess_task_plot;
+    std::vector<tess> boxes(1, box);
+    std::vector<tess_rect> done;
+    while (!boxes.empty())
+    {
+        tess *tp = &boxes.back();
+        bool const down = tp->x2 - tp->x1 > tp->y2 - tp->y1;
+        int const mid = down ? (tp->x1 + tp->x2) >> 1 : (tp->y1 + tp->y2) >> 1;
+        int const color = tess_solid(tp);
+        if (color != -1)
+        {
+            if (g_fill_color != 0)
+            {
+                int const fill = g_fill_color > 0 ? g_fill_color % g_colors : color;
+                for (int y = tp->y1 + 1; y < tp->y2; ++y)
+                {
+                    std::fill_n(&s_tess_pixels[tess_offset(tp->x1 + 1, y)], tp->x2 - tp->x1 - 1, (BYTE) fill);
+                }
+                done.push_back(tess_rect{tp->x1 + 1, tp->y1 + 1, tp->x2 - 1, tp->y2 - 1});
+            }
+            else
+            {
+                done.push_back(down ? tess_rect{mid, tp->y1 + 1, mid, tp->y2 - 1}
+                    : tess_rect{tp->x1 + 1, mid, tp->x2 - 1, mid});
+            }
+            boxes.pop_back();
+        }
+        else
+        {
+            tess other;
+            int const split = tess_split(tp, &other);
+            if (split == -3)
+            {
+                return false;
+            }
+            done.push_back(down ? tess_rect{mid, tp->y1 + 1, mid, tp->y2 - 1}
+                : tess_rect{tp->x1 + 1, mid, tp->x2 - 1, mid});
+            if (split == 0)
+            {
+                boxes.pop_back();
+            }
+            else if (split == 2)
+            {
+                if ((other.x2 - other.x1)*(other.y2 - other.y1) >= 1024)
+                {
+                    calc_pool_spawn([other]()
+                    {
+                        return tess_box_task(other);
+                    });
+                }
+                else
+                {
+                    boxes.push_back(other);
+                }
+            }
+        }
+        if (done.size() >= 1024)
+        {
+            tess_task_done(done);
+        }
+    }
+    tess_task_done(done);
+    return true;
+}
+
+// Calculate one edge of the window; the last one done starts on the box.
+static bool tess_edge_task(int edge)
+{
+    g_plot = tess_task_plot;
+    tess_rect line;
+    int color;
+    switch (edge)
+    {
+    case 0:
+        line = tess_rect{g_i_x_start, g_i_y_start, g_i_x_stop, g_i_y_start};
+        color = s_tess_window.top = tessrow(g_i_x_start, g_i_x_stop, g_i_y_start);
+        break;
+    case 1:
+        line = tess_rect{g_i_x_start, g_i_y_stop, g_i_x_stop, g_i_y_stop};
+        color = s_tess_window.bot = tessrow(g_i_x_start, g_i_x_stop, g_i_y_stop);
+        break;
+    case 2:
+        line = tess_rect{g_i_x_start, g_i_y_start+1, g_i_x_start, g_i_y_stop-1};
+        color = s_tess_window.lft = tesscol(g_i_x_start, g_i_y_start+1, g_i_y_stop-1);
+        break;
+    default:
+        line = tess_rect{g_i_x_stop, g_i_y_start+1, g_i_x_stop, g_i_y_stop-1};
+        color = s_tess_window.rgt = tesscol(g_i_x_stop, g_i_y_start+1, g_i_y_stop-1);
+        break;
+    }
+    if (color == -3)
+    {
+        return false;
+    }
+    std::vector<tess_rect> done(1, line);
+    tess_task_done(done);
+    if (--s_tess_edges == 0)
+    {
+        calc_pool_spawn([]()
+        {
+            return tess_box_task(s_tess_window);
+        });
+    }
+    return true;
+}
+
+// draw what the tesseral tasks have calculated so far
+static void tess_drain()
+{
+    std::vector<tess_rect> done;
+    {
+        std::lock_guard<std::mutex> lock(s_tess_lock);
+        done.swap(s_tess_done);
+    }
+    for (tess_rect const &rect : done)
+    {
+        for (int y = rect.y1; y <= rect.y2; ++y)
+        {
+            sym_fill_line(y, rect.x1, rect.x2, &s_tess_pixels[tess_offset(rect.x1, y)]);
+        }
+    }
+}
+
+// Tesseral on the calc threads.  Once its edges are known a box has nothing
+// to do with any other, so each of the bigger ones is a task of its own, and
+// the four edges of the window are tasks too.  The tasks calculate into a
+// copy of the window that is drawn as they go.  Returns 0 when done, -1 if
+// interrupted, or 1 if the calc threads can't be used.
+static int tesseral_tasks()
+{
+    // sym_fill_line() only copes with rows of many colors for these
+    if (!calc_pool_usable()
+        || g_put_color != putcolor_a
+        || (g_plot != putcolor_a && g_plot != symplot2))
+    {
+        return 1;
+    }
+    s_tess_width = g_i_x_stop - g_i_x_start + 1;
+    std::size_t const size = static_cast<std::size_t>(s_tess_width)*(g_i_y_stop - g_i_y_start + 1);
+    if (size > (1U << 27))
+    {
+        return 1;
+    }
+    s_tess_pixels.assign(size, 0);
+    s_tess_window = tess{g_i_x_start, g_i_x_stop, g_i_y_start, g_i_y_stop, -2, -2, -2, -2};
+    s_tess_edges = 4;
+    g_got_status = 4; // for tab_display
+    g_current_column = g_i_x_start;
+    g_current_row = g_i_y_start;
+
+    int const status = calc_pool_tasks([]()
+    {
+        for (int edge = 1; edge < 4; ++edge)
+        {
+            calc_pool_spawn([edge]()
+            {
+                return tess_edge_task(edge);
+            });
+        }
+        return tess_edge_task(0);
+    }, tess_drain);
+    std::vector<tess_rect>().swap(s_tess_done);
+    std::vector<BYTE>().swap(s_tess_pixels);
+    if (status == -1)
+    {
+        // start this one again from the top
+        add_worklist(g_xx_start, g_xx_stop, g_xx_start, g_yy_start, g_yy_stop, g_yy_start, 0, g_work_symmetry);
+    }
+    return status;
+}
+
 static int tesschkcol(int x, int y1, int y2)
 {
     int i;
-    i = getcolor(x, ++y1);
+    i = tess_getcolor(x, ++y1);
     while (--y2 > y1)
     {
-        if (getcolor(x, y2) != i)
+        if (tess_getcolor(x, y2) != i)
         {
             return -1;
         }
@@ -4917,10 +5778,10 @@ static int tesschkcol(int x, int y1, int y2)
 static int tesschkrow(int x1, int x2, int y)
 {
     int i;
-    i = getcolor(x1, y);
+    i = tess_getcolor(x1, y);
     while (x2 > x1)
     {
-        if (getcolor(x2, y) != i)
+        if (tess_getcolor(x2, y) != i)
         {
             return -1;
         }
@@ -4979,6 +5840,255 @@ static int tessrow(int x1, int x2, int y)
     return rowcolor;
 }
 
+// Mariani-Silver rectangle fill: calculate the border of a rectangle and
+// fill it in if the border and the line across its middle are all one
+// color, otherwise cut it in two along that line and do the same with each
+// half.  The colors calculated are kept for the whole window, so the line
+// two halves share is calculated only once and no pixel is iterated twice;
+// only a bit per pixel is kept, the colors are read back off the screen.
+// Unlike tesseral everything is drawn through g_plot and sym_fill_line(), so
+// any symmetry and any inside and outside coloring will do.
+
+struct ms_rect          // one of these per rectangle to be done gets stacked
+{
+    int x1, y1, x2, y2;      // left/top right/bottom x/y coords of the border
+};
+
+static std::vector<bool> s_ms_done;     // window pixels already calculated
+static int s_ms_width = 0;
+
+static std::vector<bool>::reference ms_done(int x, int y)
+{
+    return s_ms_done[static_cast<std::size_t>(y - g_i_y_start)*s_ms_width + (x - g_i_x_start)];
+}
+
+// Calculate the pixels not already known along a row or column from (x1, y1)
+// to (x2, y2).  Returns their color if all the same, -1 if mixed, or -3 if
+// interrupted.
+static int ms_line(int x1, int y1, int x2, int y2)
+{
+    int const dx = x2 > x1 ? 1 : 0;
+    int const dy = y2 > y1 ? 1 : 0;
+    int const count = (x2 - x1) + (y2 - y1) + 1;
+    int linecolor = -2;
+    bool reset = true;
+    for (int i = 0, x = x1, y = y1; i < count; ++i, x += dx, y += dy)
+    {
+        int color;
+        if (!ms_done(x, y))
+        {
+            g_col = x;
+            g_row = y;
+            g_reset_periodicity = reset;
+            color = (*g_calc_type)();
+            g_reset_periodicity = false;
+            if (color < 0)
+            {
+                return -3;
+            }
+            ms_done(x, y) = true;
+            reset = false;
+        }
+        else
+        {
+            color = getcolor(x, y);
+            reset = true;                   // not next to the last one calculated
+        }
+        if (linecolor == -2)
+        {
+            linecolor = color;
+        }
+        else if (color != linecolor)
+        {
+            linecolor = -1;
+        }
+    }
+    return linecolor;
+}
+
+// Calculate the border of a rectangle.  Returns its color if all the same,
+// -1 if mixed, or -3 if interrupted.
+static int ms_border(ms_rect const &rect)
+{
+    int const edges[4] =
+    {
+        ms_line(rect.x1, rect.y1, rect.x2, rect.y1),
+        rect.y2 > rect.y1 ? ms_line(rect.x1, rect.y2, rect.x2, rect.y2) : -2,
+        rect.y2 - rect.y1 > 1 ? ms_line(rect.x1, rect.y1+1, rect.x1, rect.y2-1) : -2,
+        rect.y2 - rect.y1 > 1 && rect.x2 > rect.x1 ? ms_line(rect.x2, rect.y1+1, rect.x2, rect.y2-1) : -2
+    };
+    int bordercolor = edges[0];
+    for (int edge : edges)
+    {
+        if (edge == -3)
+        {
+            return -3;
+        }
+        if (edge != -2 && edge != bordercolor)
+        {
+            bordercolor = -1;
+        }
+    }
+    return bordercolor;
+}
+
+// Calculate the line a rectangle would be cut along, inside its border.
+// Returns its color if all the same, -1 if mixed, or -3 if interrupted.
+static int ms_middle(ms_rect const &rect)
+{
+    if (rect.x2 - rect.x1 >= rect.y2 - rect.y1)
+    {
+        int const mid = (rect.x1 + rect.x2) >> 1;
+        return ms_line(mid, rect.y1+1, mid, rect.y2-1);
+    }
+    int const mid = (rect.y1 + rect.y2) >> 1;
+    return ms_line(rect.x1+1, mid, rect.x2-1, mid);
+}
+
+// cut a rectangle in two across its longer side, sharing the middle line
+static void ms_split(ms_rect const &rect, ms_rect &first, ms_rect &second)
+{
+    first = rect;
+    second = rect;
+    if (rect.x2 - rect.x1 >= rect.y2 - rect.y1)
+    {
+        int const mid = (rect.x1 + rect.x2) >> 1;
+        first.x2 = mid;
+        second.x1 = mid;
+    }
+    else
+    {
+        int const mid = (rect.y1 + rect.y2) >> 1;
+        first.y2 = mid;
+        second.y1 = mid;
+    }
+}
+
+static int mariani_silver()
+{
+    s_ms_width = g_i_x_stop - g_i_x_start + 1;
+    s_ms_done.assign(static_cast<std::size_t>(s_ms_width)*(g_i_y_stop - g_i_y_start + 1), false);
+    std::vector<ms_rect> rects(1, ms_rect{g_i_x_start, g_i_y_start, g_i_x_stop, g_i_y_stop});
+
+    if (g_work_pass != 0) // resuming, cut the window up again as far as where we stopped
+    {
+        ms_rect const resume{g_work_pass & 0xffff, yybegin & 0xffff,
+            (g_work_pass & 0xffff) + (g_work_pass >> 16), (yybegin & 0xffff) + (yybegin >> 16)};
+        while (true)
+        {
+            ms_rect const rect = rects.back();
+            if ((rect.x1 == resume.x1 && rect.y1 == resume.y1 && rect.x2 == resume.x2 && rect.y2 == resume.y2)
+                || rect.x2 - rect.x1 < 4 || rect.y2 - rect.y1 < 4)
+            {
+                break;
+            }
+            ms_rect first, second;
+            ms_split(rect, first, second);
+            rects.back() = second;
+            if (resume.x1 < second.x1 || resume.y1 < second.y1)
+            {
+                rects.push_back(first);
+            }
+        }
+    }
+
+    g_got_status = 7; // for tab_display
+    int status = 0;
+    while (!rects.empty())
+    {
+        // do next rectangle
+        ms_rect const rect = rects.back();
+        g_current_column = rect.x1; // for tab_display
+        g_current_row = rect.y1;
+
+        int bordercolor = ms_border(rect);
+        if (bordercolor >= 0 && rect.x2 - rect.x1 >= 2 && rect.y2 - rect.y1 >= 2)
+        {
+            // an island inside a solid border mostly crosses the middle, and
+            // if it does the halves need that line anyway
+            int const midcolor = ms_middle(rect);
+            if (midcolor != bordercolor)
+            {
+                bordercolor = midcolor == -3 ? -3 : -1;
+            }
+        }
+        if (bordercolor == -3)
+        {
+            status = -1;
+            break;
+        }
+        if (rect.x2 - rect.x1 < 2 || rect.y2 - rect.y1 < 2)
+        {
+            // border is all there is
+            rects.pop_back();
+        }
+        else if (bordercolor >= 0)
+        {
+            // all one color, fill in
+            if (g_fill_color != 0)
+            {
+                int const color = g_fill_color > 0 ? g_fill_color % g_colors : bordercolor;
+                std::memset(&dstack[dstack_row2], color, rect.x2 - rect.x1 - 1);
+                int i = 0;
+                for (int row = rect.y1 + 1; row < rect.y2; row++)
+                {
+                    sym_fill_line(row, rect.x1 + 1, rect.x2 - 1, &dstack[dstack_row2]);
+                    if (++i > 25)
+                    {
+                        if (check_key())
+                        {
+                            status = -1;
+                            break;
+                        }
+                        i = 0;
+                    }
+                }
+                if (status != 0)
+                {
+                    break;
+                }
+            }
+            rects.pop_back();
+        }
+        else if (rect.x2 - rect.x1 < 4 || rect.y2 - rect.y1 < 4)
+        {
+            // too thin to be worth cutting up, calculate the inside
+            int row;
+            for (row = rect.y1 + 1; row < rect.y2; row++)
+            {
+                if (ms_line(rect.x1 + 1, row, rect.x2 - 1, row) == -3)
+                {
+                    break;
+                }
+            }
+            if (row < rect.y2)
+            {
+                status = -1;
+                break;
+            }
+            rects.pop_back();
+        }
+        else
+        {
+            // sub-divide, doing the left or top part first
+            ms_rect first, second;
+            ms_split(rect, first, second);
+            rects.back() = second;
+            rects.push_back(first);
+        }
+    }
+    std::vector<bool>().swap(s_ms_done);
+
+    if (status != 0)
+    {
+        // didn't complete
+        ms_rect const &rect = rects.back();
+        add_worklist(g_xx_start, g_xx_stop, g_xx_start, g_yy_start, g_yy_stop,
+                     ((rect.y2 - rect.y1) << 16) + rect.y1, ((rect.x2 - rect.x1) << 16) + rect.x1, g_work_symmetry);
+    }
+    return status;
+}
+
 // added for testing autologmap()
 // insert at end of CALCFRAC.C
 
@@ -5000,9 +6110,9 @@ static long autologmap()
         {
             goto ack; // key pressed, bailout
         }
-        if (g_real_color_iter < mincolour)
+        if (g_ctx.real_color_iter < mincolour)
         {
-            mincolour = g_real_color_iter ;
+            mincolour = g_ctx.real_color_iter ;
             g_max_iterations = std::max(2L, mincolour); // speedup for when edges overlap lakes
         }
         if (g_col >=32)
@@ -5023,9 +6133,9 @@ static long autologmap()
         {
             goto ack; // key pressed, bailout
         }
-        if (g_real_color_iter < mincolour)
+        if (g_ctx.real_color_iter < mincolour)
         {
-            mincolour = g_real_color_iter ;
+            mincolour = g_ctx.real_color_iter ;
             g_max_iterations = std::max(2L, mincolour); // speedup for when edges overlap lakes
         }
         if (g_row >=32)
@@ -5046,9 +6156,9 @@ static long autologmap()
         {
             goto ack; // key pressed, bailout
         }
-        if (g_real_color_iter < mincolour)
+        if (g_ctx.real_color_iter < mincolour)
         {
-            mincolour = g_real_color_iter ;
+            mincolour = g_ctx.real_color_iter ;
             g_max_iterations = std::max(2L, mincolour); // speedup for when edges overlap lakes
         }
         if (g_row >=32)
@@ -5069,9 +6179,9 @@ static long autologmap()
         {
             goto ack; // key pressed, bailout
         }
-        if (g_real_color_iter < mincolour)
+        if (g_ctx.real_color_iter < mincolour)
         {
-            mincolour = g_real_color_iter ;
+            mincolour = g_ctx.real_color_iter ;
             g_max_iterations = std::max(2L, mincolour); // speedup for when edges overlap lakes
         }
         if (g_col >=32)
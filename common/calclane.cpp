@@ -0,0 +1,1089 @@
+// Lane-parallel orbits for the standard escape-time engine.
+//
+// calc_lanes_batch() iterates a run of pixels of a row side by side, one
+// per lane of a vector, for the floating point types that have a lane version
+// of their orbit routine in s_lane_kernels.  A lane takes the next pixel
+// of the run as soon as its pixel is done.  Each lane runs
+// standard_fractal()'s loop, with the same orbit and bailout arithmetic in
+// the same order and the same periodicity check, so each pixel comes out
+// exactly as it does on its own; standard_fractal()'s coloring then takes
+// over.  A lane version of an orbit routine is a struct with a step()
+// that works on a lane_orbit the way the routine works on a CalcContext,
+// ending with lane_bailout_test() where the routine calls ctx.bailout.
+// Formulas run in FORMULA_LANES lanes by laneFormula() in parserlane.cpp.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "calcfrac.h"
+#include "calclane.h"
+#include "calcpool.h"
+#include "cmdfiles.h"
+#include "fracsuba.h"
+#include "fracsubr.h"
+#include "fractalp.h"
+#include "fractals.h"
+#include "fractint.h"
+#include "fractype.h"
+#include "framain2.h"
+#include "id_data.h"
+#include "parser.h"
+#include "prompts2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(CALC_VECTOR_LANES)
+
+#include <immintrin.h>
+
+#define CALC_LANES 4
+
+#define LANE_INLINE inline __attribute__((always_inline)) LANE_CODE
+
+namespace
+{
+
+template <int N>
+struct lane_vector
+{
+    typedef double real __attribute__((vector_size(N*sizeof(double))));
+    typedef long long integer __attribute__((vector_size(N*sizeof(long long))));
+};
+
+// the floating point bailout routines
+enum class lane_bailout
+{
+    Mod,
+    AsmMod,                             // asmfpMODbailout also checks the components
+    Real,
+    Imag,
+    Or,
+    And,
+    Manh,
+    Manr
+};
+
+// the part of a CalcContext the orbit routines use, a lane per pixel
+template <int N>
+struct lane_orbit
+{
+    typedef typename lane_vector<N>::real real;
+    typedef typename lane_vector<N>::integer integer;
+
+    real old_x, old_y;
+    real new_x, new_y;
+    real temp_sqr_x, temp_sqr_y;
+    real param_x, param_y;              // *float_param
+    real param2_x, param2_y;            // param_z2
+    real marks_x, marks_y;              // marks_coefficient
+    real phoenix_x, phoenix_y;
+    integer escaped;                    // set by lane_bailout_test()
+    real magnitude_limit;
+    real magnitude_limit2;
+    lane_bailout bailout;
+    int exponent;                       // g_c_exponent
+};
+
+// the rest of standard_fractal()'s loop, a lane per pixel; kept apart
+// from lane_orbit so that both stay in registers
+template <int N>
+struct lane_check
+{
+    typedef typename lane_vector<N>::real real;
+    typedef typename lane_vector<N>::integer integer;
+
+    real saved_x, saved_y;
+    integer color_iter;
+    integer check_limit;                // checks periodicity past this iteration
+    integer savedand;
+    integer savedincr;
+    integer active;                     // lane has a pixel
+};
+
+// the vectors of lane_orbit and lane_check, lane by lane
+template <int N>
+struct lane_values
+{
+    double old_x[N], old_y[N];
+    double new_x[N], new_y[N];
+    double temp_sqr_x[N], temp_sqr_y[N];
+    double param_x[N], param_y[N];
+    double param2_x[N], param2_y[N];
+    double marks_x[N], marks_y[N];
+    double phoenix_x[N], phoenix_y[N];
+    double saved_x[N], saved_y[N];
+    long long color_iter[N];
+    long long check_limit[N];
+    long long savedand[N];
+    long long savedincr[N];
+    long long active[N];
+    long long escaped[N];
+};
+
+struct lane_pixel                       // a pixel of the batch
+{
+    int lane;                           // lane iterating it while running
+    bool guessing;                      // previous pixel not done, check is a guess
+    bool running;                       // still iterating
+    bool reset;                         // restart the periodicity check at check_limit
+    bool done;
+    long guess;                         // check limit guessed while guessing
+    long check_limit;
+    bool caught;                        // caught a (guessed) cycle
+    DComplex period_z;
+    bool escaped;
+    long escape_iter;
+    DComplex end_z;                     // new_z when it escaped or reached maxit
+    long old_color_iter;                // left for the next pixel when done
+};
+
+struct lane_batch_state
+{
+    int const *cols;
+    int count;
+    LanePixel *result;
+    lane_pixel pixels[MAX_LANE_BATCH];
+    int loaded;                         // pixels given to a lane so far
+    long first_limit;                   // check limit of the first pixel
+    DComplex saved;                     // first periodicity value of a pixel
+};
+
+} // namespace
+
+// the iteration past which standard_fractal() checks a pixel for
+// periodicity, given how the pixel before it ended
+LANE_CODE static long lane_check_limit(long old_color_iter, bool reset)
+{
+    if (g_periodicity_check == 0 || g_inside_color == ZMAG)
+    {
+        return 2147483647L;             // don't check periodicity at all
+    }
+    if (reset)
+    {
+        old_color_iter = 255;
+    }
+    return std::max(old_color_iter, g_first_saved_and);
+}
+
+// pixel k is done
+LANE_CODE static void take_result(lane_batch_state &batch, int k, long color_iter, DComplex const &new_z, bool caught)
+{
+    lane_pixel &pixel = batch.pixels[k];
+    pixel.running = false;
+    pixel.done = true;
+    pixel.old_color_iter = (color_iter >= g_max_iterations) ? 0 : color_iter + 10;
+    batch.result[k].color_iter = color_iter;
+    batch.result[k].new_z = new_z;
+    batch.result[k].caught_a_cycle = caught;
+}
+
+// pixel k has stopped or caught a cycle, and its periodicity check is right
+LANE_CODE static void finish_pixel(lane_batch_state &batch, int k)
+{
+    lane_pixel const &pixel = batch.pixels[k];
+    if (pixel.caught)
+    {
+        take_result(batch, k, g_max_iterations, pixel.period_z, true);
+    }
+    else if (pixel.escaped)
+    {
+        take_result(batch, k, pixel.escape_iter, pixel.end_z, false);
+    }
+    else
+    {
+        take_result(batch, k, g_max_iterations, pixel.end_z, false);
+    }
+}
+
+// set up g_ctx for pixel k the way standard_fractal() does
+LANE_CODE static void setup_pixel(lane_batch_state const &batch, int k)
+{
+    g_col = batch.cols[k];
+    g_ctx.init.y = g_dy_pixel();
+    g_ctx.color_iter =
+        (g_fractal_type == fractal_type::JULIAFP || g_fractal_type == fractal_type::JULIA) ? -1 : 0;
+    g_overflow = false;
+    if (g_cur_fractal_specific->per_pixel_ctx != nullptr)
+    {
+        g_cur_fractal_specific->per_pixel_ctx(g_ctx);
+    }
+    else
+    {
+        g_cur_fractal_specific->per_pixel();
+    }
+}
+
+// calculate pixel k again one iteration at a time, the way
+// standard_fractal() does, checking periodicity past limit
+LANE_CODE static void recalculate_pixel(lane_batch_state &batch, int k, long limit)
+{
+    setup_pixel(batch, k);
+    DComplex saved = batch.saved;
+    long savedand = g_first_saved_and;
+    int savedincr = 1;
+    bool caught = false;
+    while (++g_ctx.color_iter < g_max_iterations)
+    {
+        if ((g_cur_fractal_specific->orbitcalc_ctx != nullptr
+                ? g_cur_fractal_specific->orbitcalc_ctx(g_ctx)
+                : g_cur_fractal_specific->orbitcalc())
+            || g_overflow)
+        {
+            break;
+        }
+        if (g_ctx.color_iter > limit)
+        {
+            if ((g_ctx.color_iter & savedand) == 0)
+            {
+                saved = g_ctx.new_z;
+                if (--savedincr == 0)
+                {
+                    savedand = (savedand << 1) + 1;
+                    savedincr = g_periodicity_next_saved_incr;
+                }
+            }
+            else if (std::fabs(saved.x - g_ctx.new_z.x) < g_close_enough
+                && std::fabs(saved.y - g_ctx.new_z.y) < g_close_enough)
+            {
+                caught = true;
+                g_ctx.color_iter = g_max_iterations - 1;
+            }
+        }
+    }
+    take_result(batch, k, g_ctx.color_iter, g_ctx.new_z, caught);
+}
+
+// The pixel before pixel k is done: settle pixel k and any following
+// pixels that were waiting on it.  A pixel whose predecessor was not done
+// guessed how the predecessor would end, and so where its periodicity
+// check starts.  If the real check starts later than the pixel has got
+// to, it only has to start its check again; if the pixel has already
+// checked past where the real check starts, it is calculated again one
+// iteration at a time.  color_iter is how far each lane has got.
+LANE_CODE static void settle_pixels(lane_batch_state &batch, int k, long long const *color_iter)
+{
+    for (; k < batch.loaded && batch.pixels[k].guessing; ++k)
+    {
+        lane_pixel &pixel = batch.pixels[k];
+        long const limit = lane_check_limit(batch.pixels[k-1].old_color_iter, false);
+        pixel.guessing = false;
+        if (limit == pixel.guess)
+        {
+            if (pixel.running && !pixel.caught)
+            {
+                return;                 // carries on with the right check
+            }
+            finish_pixel(batch, k);
+            continue;
+        }
+
+        pixel.caught = false;
+        long last_check;                // last iteration the pixel checked at
+        if (pixel.running)
+        {
+            last_check = static_cast<long>(color_iter[pixel.lane]);
+        }
+        else
+        {
+            last_check = (pixel.escaped ? pixel.escape_iter : g_max_iterations) - 1;
+        }
+        if (last_check <= limit)
+        {
+            if (pixel.running)
+            {
+                pixel.reset = true;
+                pixel.check_limit = limit;
+                return;
+            }
+            finish_pixel(batch, k);
+            continue;
+        }
+        recalculate_pixel(batch, k, limit);
+    }
+}
+
+// Pixel k - 1 has escaped but is not done: if pixel k guessed its
+// predecessor would end inside and has not got to where the check would
+// start after the escape, it guesses that instead.
+LANE_CODE static void reguess_pixel(lane_batch_state &batch, int k, long long const *color_iter)
+{
+    if (k >= batch.loaded || !batch.pixels[k].guessing || !batch.pixels[k].running)
+    {
+        return;
+    }
+    lane_pixel &pixel = batch.pixels[k];
+    long const guess = lane_check_limit(batch.pixels[k-1].escape_iter + 10, false);
+    if (guess != pixel.guess && color_iter[pixel.lane] <= guess)
+    {
+        pixel.guess = guess;
+        pixel.check_limit = guess;
+        pixel.caught = false;
+        pixel.reset = true;
+    }
+}
+
+// give the next pixel of the batch to a free lane
+template <int N>
+LANE_CODE static void load_pixel(lane_batch_state &batch, int lane, lane_values<N> &values)
+{
+    int const k = batch.loaded++;
+    lane_pixel &pixel = batch.pixels[k];
+    setup_pixel(batch, k);
+    pixel.lane = lane;
+    pixel.running = true;
+    pixel.reset = false;
+    pixel.done = false;
+    pixel.caught = false;
+    pixel.escaped = false;
+    if (k == 0)
+    {
+        pixel.guessing = false;
+        pixel.check_limit = batch.first_limit;
+    }
+    else
+    {
+        // a predecessor still going is guessed to end inside, as the
+        // lanes taking over from it will be behind it if it escapes
+        lane_pixel const &previous = batch.pixels[k-1];
+        pixel.guessing = !previous.done;
+        if (!pixel.guessing)
+        {
+            pixel.check_limit = lane_check_limit(previous.old_color_iter, false);
+        }
+        else if (previous.escaped)
+        {
+            pixel.check_limit = lane_check_limit(previous.escape_iter + 10, false);
+        }
+        else
+        {
+            pixel.check_limit = lane_check_limit(0, false);
+        }
+    }
+    pixel.guess = pixel.check_limit;
+
+    values.old_x[lane] = g_ctx.old_z.x;
+    values.old_y[lane] = g_ctx.old_z.y;
+    values.new_x[lane] = g_ctx.old_z.x;
+    values.new_y[lane] = g_ctx.old_z.y;
+    values.temp_sqr_x[lane] = g_ctx.temp_sqr_x;
+    values.temp_sqr_y[lane] = g_ctx.temp_sqr_y;
+    if (g_ctx.float_param != nullptr)
+    {
+        values.param_x[lane] = g_ctx.float_param->x;
+        values.param_y[lane] = g_ctx.float_param->y;
+    }
+    values.param2_x[lane] = g_ctx.param_z2.x;
+    values.param2_y[lane] = g_ctx.param_z2.y;
+    values.marks_x[lane] = g_ctx.marks_coefficient.x;
+    values.marks_y[lane] = g_ctx.marks_coefficient.y;
+    values.phoenix_x[lane] = g_ctx.phoenix_y.x;
+    values.phoenix_y[lane] = g_ctx.phoenix_y.y;
+    values.saved_x[lane] = batch.saved.x;
+    values.saved_y[lane] = batch.saved.y;
+    values.color_iter[lane] = g_ctx.color_iter;
+    values.check_limit[lane] = pixel.check_limit;
+    values.savedand[lane] = g_first_saved_and;
+    values.savedincr[lane] = 1;
+    values.active[lane] = -1;
+    if (g_cur_fractal_specific->orbitcalc == dtFormula)
+    {
+        lane_form_per_pixel(lane);
+    }
+}
+
+// a lane with no pixel idles at 0 and is left out of the events
+template <int N>
+LANE_CODE static void idle_lane(int lane, lane_values<N> &values)
+{
+    values.old_x[lane] = 0.0;
+    values.old_y[lane] = 0.0;
+    values.new_x[lane] = 0.0;
+    values.new_y[lane] = 0.0;
+    values.temp_sqr_x[lane] = 0.0;
+    values.temp_sqr_y[lane] = 0.0;
+    values.phoenix_x[lane] = 0.0;
+    values.phoenix_y[lane] = 0.0;
+    values.color_iter[lane] = 0;
+    values.check_limit[lane] = 2147483647L;
+    values.active[lane] = 0;
+}
+
+// take the vectors apart into lanes
+template <int N>
+static LANE_INLINE void lane_unpack(lane_values<N> &values, lane_orbit<N> const &z, lane_check<N> const &c)
+{
+    std::memcpy(values.old_x, &z.old_x, sizeof(values.old_x));
+    std::memcpy(values.old_y, &z.old_y, sizeof(values.old_y));
+    std::memcpy(values.new_x, &z.new_x, sizeof(values.new_x));
+    std::memcpy(values.new_y, &z.new_y, sizeof(values.new_y));
+    std::memcpy(values.temp_sqr_x, &z.temp_sqr_x, sizeof(values.temp_sqr_x));
+    std::memcpy(values.temp_sqr_y, &z.temp_sqr_y, sizeof(values.temp_sqr_y));
+    std::memcpy(values.param_x, &z.param_x, sizeof(values.param_x));
+    std::memcpy(values.param_y, &z.param_y, sizeof(values.param_y));
+    std::memcpy(values.param2_x, &z.param2_x, sizeof(values.param2_x));
+    std::memcpy(values.param2_y, &z.param2_y, sizeof(values.param2_y));
+    std::memcpy(values.marks_x, &z.marks_x, sizeof(values.marks_x));
+    std::memcpy(values.marks_y, &z.marks_y, sizeof(values.marks_y));
+    std::memcpy(values.phoenix_x, &z.phoenix_x, sizeof(values.phoenix_x));
+    std::memcpy(values.phoenix_y, &z.phoenix_y, sizeof(values.phoenix_y));
+    std::memcpy(values.escaped, &z.escaped, sizeof(values.escaped));
+    std::memcpy(values.saved_x, &c.saved_x, sizeof(values.saved_x));
+    std::memcpy(values.saved_y, &c.saved_y, sizeof(values.saved_y));
+    std::memcpy(values.color_iter, &c.color_iter, sizeof(values.color_iter));
+    std::memcpy(values.check_limit, &c.check_limit, sizeof(values.check_limit));
+    std::memcpy(values.savedand, &c.savedand, sizeof(values.savedand));
+    std::memcpy(values.savedincr, &c.savedincr, sizeof(values.savedincr));
+    std::memcpy(values.active, &c.active, sizeof(values.active));
+}
+
+// put the lanes back together into vectors
+template <int N>
+static LANE_INLINE void lane_pack(lane_orbit<N> &z, lane_check<N> &c, lane_values<N> const &values)
+{
+    std::memcpy(&z.old_x, values.old_x, sizeof(z.old_x));
+    std::memcpy(&z.old_y, values.old_y, sizeof(z.old_y));
+    std::memcpy(&z.new_x, values.new_x, sizeof(z.new_x));
+    std::memcpy(&z.new_y, values.new_y, sizeof(z.new_y));
+    std::memcpy(&z.temp_sqr_x, values.temp_sqr_x, sizeof(z.temp_sqr_x));
+    std::memcpy(&z.temp_sqr_y, values.temp_sqr_y, sizeof(z.temp_sqr_y));
+    std::memcpy(&z.param_x, values.param_x, sizeof(z.param_x));
+    std::memcpy(&z.param_y, values.param_y, sizeof(z.param_y));
+    std::memcpy(&z.param2_x, values.param2_x, sizeof(z.param2_x));
+    std::memcpy(&z.param2_y, values.param2_y, sizeof(z.param2_y));
+    std::memcpy(&z.marks_x, values.marks_x, sizeof(z.marks_x));
+    std::memcpy(&z.marks_y, values.marks_y, sizeof(z.marks_y));
+    std::memcpy(&z.phoenix_x, values.phoenix_x, sizeof(z.phoenix_x));
+    std::memcpy(&z.phoenix_y, values.phoenix_y, sizeof(z.phoenix_y));
+    std::memcpy(&z.escaped, values.escaped, sizeof(z.escaped));
+    std::memcpy(&c.saved_x, values.saved_x, sizeof(c.saved_x));
+    std::memcpy(&c.saved_y, values.saved_y, sizeof(c.saved_y));
+    std::memcpy(&c.color_iter, values.color_iter, sizeof(c.color_iter));
+    std::memcpy(&c.check_limit, values.check_limit, sizeof(c.check_limit));
+    std::memcpy(&c.savedand, values.savedand, sizeof(c.savedand));
+    std::memcpy(&c.savedincr, values.savedincr, sizeof(c.savedincr));
+    std::memcpy(&c.active, values.active, sizeof(c.active));
+}
+
+// true if no lane of mask is set
+template <int N>
+static LANE_INLINE bool lane_none(typename lane_vector<N>::integer const &mask)
+{
+    static_assert(N == 4, "a mask is tested as one __m256i");
+    __m256i bits;
+    std::memcpy(&bits, &mask, sizeof(bits));
+    return _mm256_testz_si256(bits, bits) != 0;
+}
+
+template <int N>
+static LANE_INLINE typename lane_vector<N>::real lane_abs(typename lane_vector<N>::real x)
+{
+    typedef typename lane_vector<N>::real real;
+    return (x < real{}) ? -x : x;
+}
+
+// the bailout routines
+template <int N>
+static LANE_INLINE void lane_bailout_test(lane_orbit<N> &z)
+{
+    typedef typename lane_vector<N>::real real;
+    z.temp_sqr_x = z.new_x*z.new_x;
+    z.temp_sqr_y = z.new_y*z.new_y;
+    real const magnitude = z.temp_sqr_x + z.temp_sqr_y;
+    switch (z.bailout)
+    {
+    case lane_bailout::Mod:
+        z.escaped = magnitude >= z.magnitude_limit;
+        break;
+    case lane_bailout::AsmMod:
+        z.escaped = (magnitude > z.magnitude_limit)
+            | (magnitude < real{})
+            | (lane_abs<N>(z.new_x) > z.magnitude_limit2)
+            | (lane_abs<N>(z.new_y) > z.magnitude_limit2);
+        break;
+    case lane_bailout::Real:
+        z.escaped = z.temp_sqr_x >= z.magnitude_limit;
+        break;
+    case lane_bailout::Imag:
+        z.escaped = z.temp_sqr_y >= z.magnitude_limit;
+        break;
+    case lane_bailout::Or:
+        z.escaped = (z.temp_sqr_x >= z.magnitude_limit) | (z.temp_sqr_y >= z.magnitude_limit);
+        break;
+    case lane_bailout::And:
+        z.escaped = (z.temp_sqr_x >= z.magnitude_limit) & (z.temp_sqr_y >= z.magnitude_limit);
+        break;
+    case lane_bailout::Manh:
+    {
+        real const manhmag = lane_abs<N>(z.new_x) + lane_abs<N>(z.new_y);
+        z.escaped = manhmag*manhmag >= z.magnitude_limit;
+        break;
+    }
+    case lane_bailout::Manr:
+    {
+        real const manrmag = z.new_x + z.new_y;
+        z.escaped = manrmag*manrmag >= z.magnitude_limit;
+        break;
+    }
+    }
+    z.old_x = z.escaped ? z.old_x : z.new_x;
+    z.old_y = z.escaped ? z.old_y : z.new_y;
+}
+
+namespace
+{
+
+struct julia_lanes                      // JuliafpFractal
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        z.new_x = z.temp_sqr_x - z.temp_sqr_y + z.param_x;
+        z.new_y = 2.0 * z.old_x * z.old_y + z.param_y;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct lambda_lanes                     // LambdaFPFractal
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        z.temp_sqr_x = z.old_x - z.temp_sqr_x + z.temp_sqr_y;
+        z.temp_sqr_y = -(z.old_y * z.old_x);
+        z.temp_sqr_y += z.temp_sqr_y + z.old_y;
+
+        z.new_x = z.param_x * z.temp_sqr_x - z.param_y * z.temp_sqr_y;
+        z.new_y = z.param_x * z.temp_sqr_y + z.param_y * z.temp_sqr_x;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct marks_lambda_lanes               // MarksLambdafpFractal
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        typedef typename lane_vector<N>::real real;
+        real const tmp_x = z.temp_sqr_x - z.temp_sqr_y;
+        real const tmp_y = z.old_x * z.old_y *2;
+
+        z.new_x = z.marks_x * tmp_x - z.marks_y * tmp_y + z.param_x;
+        z.new_y = z.marks_x * tmp_y + z.marks_y * tmp_x + z.param_y;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct mandel4_lanes                    // Mandel4fpFractal
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        typedef typename lane_vector<N>::real real;
+        typedef typename lane_vector<N>::integer integer;
+        // first, compute (x + iy)**2
+        z.new_x  = z.temp_sqr_x - z.temp_sqr_y;
+        z.new_y = z.old_x*z.old_y*2;
+        lane_bailout_test<N>(z);
+        integer const first = z.escaped;
+        real const first_x = z.new_x;
+        real const first_y = z.new_y;
+
+        // then, compute ((x + iy)**2)**2 + lambda
+        z.new_x  = z.temp_sqr_x - z.temp_sqr_y + z.param_x;
+        z.new_y =  z.old_x*z.old_y*2 + z.param_y;
+        lane_bailout_test<N>(z);
+        z.new_x = first ? first_x : z.new_x;
+        z.new_y = first ? first_y : z.new_y;
+        z.escaped |= first;
+    }
+};
+
+struct zpower_lanes                     // floatZpowerFractal, exponent >= 0
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        typedef typename lane_vector<N>::real real;
+        // cpower()
+        int exp = z.exponent;
+        real xt = z.old_x;
+        real yt = z.old_y;
+        real t2;
+        if (exp & 1)
+        {
+            z.new_x = xt;
+            z.new_y = yt;
+        }
+        else
+        {
+            z.new_x = real{} + 1.0;
+            z.new_y = real{};
+        }
+        exp >>= 1;
+        while (exp)
+        {
+            t2 = xt * xt - yt * yt;
+            yt = 2 * xt * yt;
+            xt = t2;
+
+            if (exp & 1)
+            {
+                t2 = xt * z.new_x - yt * z.new_y;
+                z.new_y = z.new_y * xt + yt * z.new_x;
+                z.new_x = t2;
+            }
+            exp >>= 1;
+        }
+        z.new_x += z.param_x;
+        z.new_y += z.param_y;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct phoenix_lanes                    // PhoenixFractal
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        typedef typename lane_vector<N>::real real;
+        real const tmp = z.old_x * z.old_y;
+        z.new_x = z.temp_sqr_x - z.temp_sqr_y + z.param_x + (z.param_y * z.phoenix_x);
+        z.new_y = (tmp + tmp) + (z.param_y * z.phoenix_y);
+        z.phoenix_x = z.old_x;
+        z.phoenix_y = z.old_y;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct phoenix_cplx_lanes               // PhoenixFractalcplx
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        typedef typename lane_vector<N>::real real;
+        real const tmp = z.old_x * z.old_y;
+        z.new_x = z.temp_sqr_x - z.temp_sqr_y + z.param_x + (z.param2_x * z.phoenix_x) - (z.param2_y * z.phoenix_y);
+        z.new_y = (tmp + tmp) + z.param_y + (z.param2_x * z.phoenix_y) + (z.param2_y * z.phoenix_x);
+        z.phoenix_x = z.old_x;
+        z.phoenix_y = z.old_y;
+        lane_bailout_test<N>(z);
+    }
+};
+
+struct formula_lanes                    // dtFormula
+{
+    template <int N>
+    static LANE_INLINE void step(lane_orbit<N> &z)
+    {
+        static_assert(N == FORMULA_LANES, "laneFormula() runs FORMULA_LANES pixels");
+        double new_x[N];
+        double new_y[N];
+        long long escaped[N];
+        laneFormula(new_x, new_y, escaped);
+        std::memcpy(&z.new_x, new_x, sizeof(new_x));
+        std::memcpy(&z.new_y, new_y, sizeof(new_y));
+        std::memcpy(&z.escaped, escaped, sizeof(escaped));
+    }
+};
+
+} // namespace
+
+// The batch proper, expanded for each orbit.  The vectors are only taken
+// apart into lanes when some lane escapes, catches a cycle or reaches
+// maxit.
+template <int N, typename Orbit>
+static LANE_INLINE long lane_batch(int const *cols, int count, LanePixel *result, lane_bailout bailout)
+{
+    typedef typename lane_vector<N>::real real;
+    typedef typename lane_vector<N>::integer integer;
+
+    lane_batch_state batch;
+    batch.cols = cols;
+    batch.count = count;
+    batch.result = result;
+    batch.loaded = 0;
+    batch.first_limit = lane_check_limit(g_ctx.old_color_iter, g_reset_periodicity);
+    batch.saved = (g_use_init_orbit == init_orbit_mode::value) ? g_init_orbit : DComplex{};
+
+    int lane_pixels[N];                 // pixel in each lane, -1 for none
+    lane_values<N> values = {};
+    lane_orbit<N> z;
+    lane_check<N> c;
+    for (int i = 0; i < N; ++i)
+    {
+        lane_pixels[i] = -1;
+        idle_lane<N>(i, values);
+        if (batch.loaded < count)
+        {
+            lane_pixels[i] = batch.loaded;
+            load_pixel<N>(batch, i, values);
+        }
+    }
+    lane_pack<N>(z, c, values);
+    z.magnitude_limit = real{} + g_ctx.magnitude_limit;
+    z.magnitude_limit2 = real{} + g_magnitude_limit2;
+    z.bailout = bailout;
+    z.exponent = g_c_exponent;
+
+    real const close_enough = real{} + g_close_enough;
+    real const minus_close_enough = real{} - g_close_enough;
+    integer const next_saved_incr = integer{} + g_periodicity_next_saved_incr;
+    integer const last_iter = integer{} + (g_max_iterations - 1);
+    long steps = 0;
+    bool running = true;
+    while (running)
+    {
+        if ((++steps & 2047) == 0 && check_key())
+        {
+            return -1;
+        }
+        c.color_iter += 1;
+        Orbit::template step<N>(z);
+
+        // periodicity check, with masks: save when the iteration count
+        // has no bits in savedand, compare otherwise
+        integer const checking = c.color_iter > c.check_limit;
+        integer const save = checking & ((c.color_iter & c.savedand) == 0);
+        real const dx = c.saved_x - z.new_x;
+        real const dy = c.saved_y - z.new_y;
+        integer const periodic = checking & ~save
+            & (dx < close_enough) & (dx > minus_close_enough)
+            & (dy < close_enough) & (dy > minus_close_enough);
+        c.saved_x = save ? z.new_x : c.saved_x;
+        c.saved_y = save ? z.new_y : c.saved_y;
+        c.savedincr += save;            // save is -1 where set
+        integer const next_and = save & (c.savedincr == 0);
+        c.savedand = next_and ? (c.savedand << 1) + 1 : c.savedand;
+        c.savedincr = next_and ? next_saved_incr : c.savedincr;
+
+        integer const last = c.color_iter >= last_iter;
+        integer const event = (z.escaped | periodic | last) & c.active;
+        if (lane_none<N>(event))
+        {
+            continue;
+        }
+        long long lane_event[N];
+        std::memcpy(lane_event, &event, sizeof(lane_event));
+
+        z.escaped &= c.active;
+        lane_unpack<N>(values, z, c);
+        long long lane_periodic[N];
+        std::memcpy(lane_periodic, &periodic, sizeof(lane_periodic));
+        // in pixel order, so each pixel's predecessor is settled first
+        int order[N];
+        for (int i = 0; i < N; ++i)
+        {
+            int j = i;
+            for (; j > 0 && lane_pixels[order[j-1]] > lane_pixels[i]; --j)
+            {
+                order[j] = order[j-1];
+            }
+            order[j] = i;
+        }
+        for (int i : order)
+        {
+            int const k = lane_pixels[i];
+            if (k < 0 || lane_event[i] == 0 || !batch.pixels[k].running)
+            {
+                continue;
+            }
+            lane_pixel &pixel = batch.pixels[k];
+            long const iter = static_cast<long>(values.color_iter[i]);
+            if (values.escaped[i])
+            {
+                pixel.running = false;
+                pixel.escaped = true;
+                pixel.escape_iter = iter;
+                pixel.end_z.x = values.new_x[i];
+                pixel.end_z.y = values.new_y[i];
+            }
+            else if (lane_periodic[i] && iter > pixel.check_limit)
+            {
+                pixel.caught = true;
+                pixel.period_z.x = values.new_x[i];
+                pixel.period_z.y = values.new_y[i];
+                pixel.check_limit = 2147483647L; // a guess stands or falls with the pixel before
+                pixel.running = pixel.guessing && iter < g_max_iterations - 1;
+            }
+            else if (iter >= g_max_iterations - 1)
+            {
+                pixel.running = false;
+                pixel.end_z.x = values.new_x[i];
+                pixel.end_z.y = values.new_y[i];
+            }
+            if (!pixel.running && !pixel.guessing)
+            {
+                finish_pixel(batch, k);
+                settle_pixels(batch, k + 1, values.color_iter);
+            }
+            else if (pixel.escaped)
+            {
+                reguess_pixel(batch, k + 1, values.color_iter);
+            }
+        }
+
+        // pass stopped lanes the next pixels
+        running = false;
+        for (int i = 0; i < N; ++i)
+        {
+            int const k = lane_pixels[i];
+            if (k >= 0 && !batch.pixels[k].running)
+            {
+                lane_pixels[i] = -1;
+                idle_lane<N>(i, values);
+                if (batch.loaded < count)
+                {
+                    lane_pixels[i] = batch.loaded;
+                    load_pixel<N>(batch, i, values);
+                }
+            }
+            else if (k >= 0)
+            {
+                lane_pixel &pixel = batch.pixels[k];
+                values.check_limit[i] = pixel.check_limit;
+                if (pixel.reset)
+                {
+                    pixel.reset = false;
+                    values.saved_x[i] = batch.saved.x;
+                    values.saved_y[i] = batch.saved.y;
+                    values.savedand[i] = g_first_saved_and;
+                    values.savedincr[i] = 1;
+                }
+            }
+            running = running || lane_pixels[i] >= 0;
+        }
+        lane_pack<N>(z, c, values);
+    }
+    return 0;
+}
+
+template <typename Orbit>
+LANE_CODE static long lane_batch4(int const *cols, int count, LanePixel *result, lane_bailout bailout)
+{
+    return lane_batch<CALC_LANES, Orbit>(cols, count, result, bailout);
+}
+
+LANE_CODE static long lane_batch_formula(int const *cols, int count, LanePixel *result, lane_bailout bailout)
+{
+    return lane_batch<FORMULA_LANES, formula_lanes>(cols, count, result, bailout);
+}
+
+namespace
+{
+
+struct lane_kernel
+{
+    int (*orbitcalc)(CalcContext &ctx);
+    long (*batch)(int const *cols, int count, LanePixel *result, lane_bailout bailout);
+    bool power;                         // only for g_c_exponent >= 0
+};
+
+struct lane_bailout_routine
+{
+    int (*bailout)(CalcContext &ctx);
+    lane_bailout test;
+};
+
+} // namespace
+
+// the orbit routines with a lane version
+static lane_kernel const s_lane_kernels[] =
+{
+    { JuliafpFractal, lane_batch4<julia_lanes>, false },
+    { LambdaFPFractal, lane_batch4<lambda_lanes>, false },
+    { MarksLambdafpFractal, lane_batch4<marks_lambda_lanes>, false },
+    { Mandel4fpFractal, lane_batch4<mandel4_lanes>, false },
+    { floatZpowerFractal, lane_batch4<zpower_lanes>, true },
+    { PhoenixFractal, lane_batch4<phoenix_lanes>, false },
+    { PhoenixFractalcplx, lane_batch4<phoenix_cplx_lanes>, false }
+};
+
+// formulas the parser can run in lanes
+static lane_kernel const s_formula_kernel = { nullptr, lane_batch_formula, false };
+
+static lane_bailout_routine const s_lane_bailouts[] =
+{
+    { fpMODbailout, lane_bailout::Mod },
+    { asmfpMODbailout, lane_bailout::AsmMod },
+    { fpREALbailout, lane_bailout::Real },
+    { asmfpREALbailout, lane_bailout::Real },
+    { fpIMAGbailout, lane_bailout::Imag },
+    { asmfpIMAGbailout, lane_bailout::Imag },
+    { fpORbailout, lane_bailout::Or },
+    { asmfpORbailout, lane_bailout::Or },
+    { fpANDbailout, lane_bailout::And },
+    { asmfpANDbailout, lane_bailout::And },
+    { fpMANHbailout, lane_bailout::Manh },
+    { asmfpMANHbailout, lane_bailout::Manh },
+    { fpMANRbailout, lane_bailout::Manr },
+    { asmfpMANRbailout, lane_bailout::Manr }
+};
+
+static lane_kernel const *find_lane_kernel()
+{
+    if (g_cur_fractal_specific->orbitcalc == dtFormula)
+    {
+        return g_lane_formula ? &s_formula_kernel : nullptr;
+    }
+    for (lane_kernel const &kernel : s_lane_kernels)
+    {
+        if (kernel.orbitcalc == g_cur_fractal_specific->orbitcalc_ctx)
+        {
+            return &kernel;
+        }
+    }
+    return nullptr;
+}
+
+static lane_bailout_routine const *find_lane_bailout()
+{
+    for (lane_bailout_routine const &routine : s_lane_bailouts)
+    {
+        if (routine.bailout == g_ctx.bailout)
+        {
+            return &routine;
+        }
+    }
+    return nullptr;
+}
+
+#endif
+
+static bool s_lanes_off = false;        // bench_lanes() timing without them
+
+// number of pixels calc_lanes_batch() iterates side by side for the
+// current image, 0 if standard_fractal() must calculate them one at a time
+int calc_lanes()
+{
+#if defined(CALC_VECTOR_LANES)
+    lane_kernel const *kernel = find_lane_kernel();
+    if (g_debug_flag == debug_flags::prevent_simd_math
+        || s_lanes_off
+        || !__builtin_cpu_supports("avx2")
+        || g_calc_type != standard_fractal
+        || g_integer_fractal
+        || bf_math != bf_math_type::NONE
+        || g_show_orbit
+        || g_distance_estimator
+        || g_attractors > 0
+        || g_max_iterations < 2
+        || (g_inside_color < ITER && g_inside_color != ZMAG && g_inside_color != ATANI)
+        || g_outside_color == TDIS
+        || g_outside_color == FMOD
+        || kernel == nullptr)
+    {
+        return 0;
+    }
+    if (kernel == &s_formula_kernel)
+    {
+        return FORMULA_LANES;           // formulas test their own bailout
+    }
+    if (g_ctx.float_param == &g_ctx.tmp_z     // the orbit routines write tmp_z
+        || g_cur_fractal_specific->per_pixel_ctx == nullptr
+        || (kernel->power && g_c_exponent < 0)
+        || find_lane_bailout() == nullptr)
+    {
+        return 0;
+    }
+    return CALC_LANES;
+#else
+    return 0;
+#endif
+}
+
+// Iterate the count pixels of row g_row in columns cols like
+// standard_fractal(), up to MAX_LANE_BATCH of them, with
+// g_ctx.old_color_iter left by the pixel before.
+// Returns -1 if interrupted, with g_ctx changed.
+long calc_lanes_batch(int const *cols, int count, LanePixel *result)
+{
+#if defined(CALC_VECTOR_LANES)
+    lane_bailout_routine const *routine = find_lane_bailout();
+    return find_lane_kernel()->batch(cols, count, result,
+        routine != nullptr ? routine->test : lane_bailout::Mod);
+#else
+    return -1;
+#endif
+}
+
+// debugflag=206: in place of calcfract(), draws each floating point type
+// with an orbit routine in s_lane_kernels at its default corners and
+// parameters, with the lanes and then one pixel at a time, from a blank
+// screen each time, and appends the seconds per image and the speedup to
+// "bench".  maxiter=, passes= and threads= are as given.  Then draws the
+// image asked for.
+int bench_lanes()
+{
+    {
+        SavedFractal saved;
+        std::vector<BYTE> const blank(g_logical_screen_x_dots, 0);
+        std::FILE *fp = dir_fopen(g_working_dir.c_str(), "bench", "a");
+#if defined(CALC_VECTOR_LANES)
+        bool const vectors = __builtin_cpu_supports("avx2") != 0;
+        if (fp != nullptr && !vectors)
+        {
+            std::fprintf(fp, "lanes: no AVX2 on this CPU, both times are one pixel at a time\n");
+        }
+        bool interrupted = false;
+        for (lane_kernel const &kernel : s_lane_kernels)
+        {
+            for (int i = 0; i < g_num_fractal_types && !interrupted; ++i)
+            {
+                fractalspecificstuff const &specific = g_fractal_specific[i];
+                if (specific.orbitcalc_ctx != kernel.orbitcalc
+                    || specific.calctype != standard_fractal
+                    || specific.isinteger)
+                {
+                    continue;
+                }
+                saved.use_defaults(static_cast<fractal_type>(i));
+                double seconds[2];
+                for (int off = 0; off < 2 && !interrupted; ++off)
+                {
+                    // draw it over and over for half a second, to time more than the setup
+                    s_lanes_off = off != 0;
+                    double total = 0.0;
+                    int images = 0;
+                    while (!interrupted && (images == 0 || total < 0.5))
+                    {
+                        for (int row = 0; row < g_logical_screen_y_dots; ++row)
+                        {
+                            put_line(row, 0, g_logical_screen_x_dots-1, blank.data());
+                        }
+                        calcfracinit();
+                        auto const start = std::chrono::steady_clock::now();
+                        interrupted = calcfract() != 0;
+                        total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        ++images;
+                    }
+                    seconds[off] = total/images;
+                }
+                s_lanes_off = false;
+                if (fp != nullptr && !interrupted)
+                {
+                    std::fprintf(fp, "%-14s %dx%d maxiter=%ld threads=%u lanes %.3f one at a time %.3f seconds speedup %.2f\n",
+                        specific.name[0] == '*' ? &specific.name[1] : specific.name,
+                        g_logical_screen_x_dots, g_logical_screen_y_dots, g_max_iterations, calc_pool_threads(),
+                        seconds[0], seconds[1], seconds[0] > 0.0 ? seconds[1]/seconds[0] : 0.0);
+                }
+            }
+        }
+#else
+        if (fp != nullptr)
+        {
+            std::fprintf(fp, "lanes: not compiled in, nothing to time\n");
+        }
+#endif
+        if (fp != nullptr)
+        {
+            std::fclose(fp);
+        }
+    }
+    calcfracinit();
+    return calcfract();
+}
@@ -0,0 +1,637 @@
+// Calculation thread pool for the standard escape-time engine.
+//
+// standard_calc() resets periodicity checking at the start of every row, so
+// a row computed on its own comes out exactly as it does in a serial pass.
+// calc_pool_rows() cuts the rows of the current pass into small bands
+// (tiles) and deals them out to the calc threads, which steal bands from
+// each other when they run dry.  The calc threads never touch the driver:
+// their g_plot records each plot, and the calling thread replays the bands
+// through its own g_plot in row order, checking the keyboard as it goes.
+// The per-pixel state lives in the THREAD_LOCAL g_ctx, g_row and g_col, so
+// each calc thread starts from its own copy of the caller's.
+//
+// calc_pool_strips() deals out whole strips of the image the same way, for
+// engines that work on a strip at a time in memory of their own and hand the
+// finished strip back to the calling thread to draw.
+//
+// calc_pool_tasks() is for engines that divide up the work as they go: a
+// task can start more tasks with calc_pool_spawn().  Each calc thread keeps
+// a deque of tasks, running the newest of its own first and stealing the
+// oldest of another thread's when it runs out.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "calcfrac.h"
+#include "calcpool.h"
+#include "cmdfiles.h"
+#include "fractalp.h"
+#include "framain2.h"
+#include "id_data.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+int g_calc_threads = 1;                 // threads= option, 0 for one per cpu
+
+namespace
+{
+
+struct plot_point
+{
+    int x;
+    int y;
+    int color;
+};
+
+struct row_tile
+{
+    int first;                          // index of first row in the tile
+    int last;                           // one past the last row
+    bool done;
+    std::vector<plot_point> plots;      // plots made while calculating the tile
+};
+
+struct tile_queue
+{
+    std::mutex lock;
+    std::deque<int> tiles;
+};
+
+// per-pixel state a calc thread starts out with, copied from the caller
+struct worker_state
+{
+    CalcContext ctx;
+    CalcContext const *caller;          // the context ctx was copied from
+    int keyboard_check_interval;
+};
+
+struct calc_pool
+{
+    int passnum;
+    int (*calc_row)(int passnum);
+    bool (*calc_strip)(int strip);
+    int first_col;
+    std::vector<int> rows;
+    std::vector<row_tile> tiles;
+    std::vector<tile_queue> queues;
+    worker_state state;
+    std::mutex done_lock;
+    std::condition_variable done_cond;
+    int running;
+};
+
+struct task_deque
+{
+    std::mutex lock;
+    std::deque<std::function<bool()>> tasks;
+};
+
+struct task_pool
+{
+    std::vector<task_deque> deques;
+    std::atomic<int> pending;           // tasks queued or running
+    std::mutex idle_lock;
+    std::condition_variable idle_cond;  // signalled when a task is queued
+    worker_state state;
+    std::mutex done_lock;
+    std::condition_variable done_cond;
+    int running;
+};
+
+std::atomic<bool> s_interrupted(false);
+THREAD_LOCAL bool s_worker = false;
+THREAD_LOCAL std::vector<plot_point> *s_plots = nullptr;
+THREAD_LOCAL task_pool *s_task_pool = nullptr;
+THREAD_LOCAL unsigned s_task_deque = 0;
+
+} // namespace
+
+// the number of calc threads the threads= option asks for
+unsigned calc_pool_threads()
+{
+    if (g_calc_threads > 0)
+    {
+        return g_calc_threads;
+    }
+    unsigned const cpus = std::thread::hardware_concurrency();
+    return cpus > 0 ? cpus : 1;
+}
+
+// true if the current image can be calculated by calc_pool_rows()
+bool calc_pool_usable()
+{
+    if (calc_pool_threads() < 2
+        || s_worker
+        || g_quick_calc
+        || g_show_orbit
+        || g_invert != 0
+        || g_integer_fractal
+        || bf_math != bf_math_type::NONE
+        || g_inside_color == STARTRAIL
+        || (g_potential_flag && g_potential_16bit))
+    {
+        return false;
+    }
+    if (g_calc_type == calcmandfp)
+    {
+        return true;
+    }
+    // only the types whose routines work on a CalcContext are reentrant
+    return g_calc_type == standard_fractal
+        && g_cur_fractal_specific->orbitcalc_ctx != nullptr
+        && g_cur_fractal_specific->per_pixel_ctx != nullptr;
+}
+
+// true when running on one of the calc threads
+bool calc_pool_worker()
+{
+    return s_worker;
+}
+
+// check_key() for the calc threads: the calling thread watches the keyboard
+bool calc_pool_interrupted()
+{
+    return s_interrupted.load(std::memory_order_relaxed);
+}
+
+static void save_state(worker_state &state)
+{
+    state.ctx = g_ctx;
+    state.caller = &g_ctx;
+    state.keyboard_check_interval = g_keyboard_check_interval;
+}
+
+// a parameter pointer into the caller's context, moved into ctx
+static DComplex *own_param(CalcContext &ctx, CalcContext const &caller, DComplex *param)
+{
+    if (param == &caller.init)
+    {
+        return &ctx.init;
+    }
+    if (param == &caller.tmp_z)
+    {
+        return &ctx.tmp_z;
+    }
+    if (param == &caller.param_z1)
+    {
+        return &ctx.param_z1;
+    }
+    if (param == &caller.param_z2)
+    {
+        return &ctx.param_z2;
+    }
+    return param;
+}
+
+static void restore_state(worker_state const &state)
+{
+    g_ctx = state.ctx;
+    g_ctx.float_param = own_param(g_ctx, *state.caller, state.ctx.float_param);
+    g_keyboard_check_interval = state.keyboard_check_interval;
+}
+
+static void record_plot(int x, int y, int color)
+{
+    s_plots->push_back(plot_point{x, y, color});
+}
+
+// take a tile from our own queue, or steal the last one from the fullest queue
+static bool next_tile(calc_pool &pool, unsigned id, int &tile)
+{
+    {
+        tile_queue &own = pool.queues[id];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tiles.empty())
+        {
+            tile = own.tiles.front();
+            own.tiles.pop_front();
+            return true;
+        }
+    }
+    while (true)
+    {
+        tile_queue *victim = nullptr;
+        std::size_t most = 0;
+        for (tile_queue &queue : pool.queues)
+        {
+            std::lock_guard<std::mutex> lock(queue.lock);
+            if (queue.tiles.size() > most)
+            {
+                most = queue.tiles.size();
+                victim = &queue;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(victim->lock);
+        if (!victim->tiles.empty())
+        {
+            tile = victim->tiles.back();
+            victim->tiles.pop_back();
+            return true;
+        }
+    }
+}
+
+static void calc_worker(calc_pool &pool, unsigned id)
+{
+    s_worker = true;
+    restore_state(pool.state);
+    g_plot = record_plot;
+
+    int tile;
+    while (!calc_pool_interrupted() && next_tile(pool, id, tile))
+    {
+        row_tile &work = pool.tiles[tile];
+        std::vector<plot_point> plots;
+        plots.reserve((work.last - work.first)*(g_i_x_stop - g_i_x_start + 1)*(pool.passnum == 1 ? 2 : 1));
+        s_plots = &plots;
+        bool finished = true;
+        for (int i = work.first; i < work.last; ++i)
+        {
+            g_row = pool.rows[i];
+            g_col = (i == 0) ? pool.first_col : g_i_x_start;
+            if (pool.calc_row(pool.passnum) == -1)
+            {
+                finished = false;
+                break;
+            }
+        }
+        if (!finished)
+        {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(pool.done_lock);
+        work.plots.swap(plots);
+        work.done = true;
+        pool.done_cond.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(pool.done_lock);
+    --pool.running;
+    pool.done_cond.notify_one();
+}
+
+static void strip_worker(calc_pool &pool, unsigned id)
+{
+    s_worker = true;
+    restore_state(pool.state);
+
+    int tile;
+    while (!calc_pool_interrupted() && next_tile(pool, id, tile))
+    {
+        if (!pool.calc_strip(pool.tiles[tile].first))
+        {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(pool.done_lock);
+        pool.tiles[tile].done = true;
+        pool.done_cond.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(pool.done_lock);
+    --pool.running;
+    pool.done_cond.notify_one();
+}
+
+// deal the tiles out round robin so they finish roughly in order
+static void deal_tiles(calc_pool &pool, unsigned num_threads)
+{
+    std::vector<tile_queue> queues(num_threads);
+    pool.queues.swap(queues);
+    for (std::size_t i = 0; i < pool.tiles.size(); ++i)
+    {
+        pool.queues[i % num_threads].tiles.push_back(static_cast<int>(i));
+    }
+}
+
+// Run worker on a calc thread per queue and hand the finished tiles to
+// tile_done in order, watching the keyboard meanwhile.  Returns the number
+// of tiles handed over, or -1 if no calc thread could be started.
+template <typename TileDone>
+static int run_tiles(calc_pool &pool, void (*worker)(calc_pool &, unsigned), TileDone tile_done)
+{
+    save_state(pool.state);
+    g_resuming = false;                 // quick_calc is off, nothing to skip
+    s_interrupted = false;
+
+    std::vector<std::thread> threads;
+    pool.running = 0;
+    for (unsigned id = 0; id < pool.queues.size(); ++id)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(pool.done_lock);
+            threads.emplace_back(worker, std::ref(pool), id);
+            ++pool.running;
+        }
+        catch (std::system_error const &)
+        {
+            break;
+        }
+    }
+    if (threads.empty())
+    {
+        return -1;
+    }
+
+    std::size_t next = 0;
+    auto flush = [&]()
+    {
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(pool.done_lock);
+                if (next >= pool.tiles.size() || !pool.tiles[next].done)
+                {
+                    return;
+                }
+            }
+            // the calc threads are done with a tile once it is marked done
+            tile_done(pool.tiles[next]);
+            ++next;
+        }
+    };
+    while (next < pool.tiles.size())
+    {
+        {
+            std::unique_lock<std::mutex> lock(pool.done_lock);
+            pool.done_cond.wait_for(lock, std::chrono::milliseconds(50), [&]()
+            {
+                return pool.tiles[next].done || pool.running == 0;
+            });
+        }
+        flush();
+        if (next < pool.tiles.size() && check_key())
+        {
+            s_interrupted = true;
+            break;
+        }
+        std::lock_guard<std::mutex> lock(pool.done_lock);
+        if (pool.running == 0)
+        {
+            break;
+        }
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    flush();
+    s_interrupted = false;
+    return static_cast<int>(next);
+}
+
+// Calculate the rows of standard_calc() from g_row, g_col on the calc threads.
+// Returns 0 when done, -1 if interrupted with g_row, g_col set for resuming
+// like standard_calc(), or 1 if no calc thread could be started.  If given,
+// rows_done is called with the last row of each band once it is plotted.
+int calc_pool_rows(int passnum, int (*calc_row)(int passnum), void (*rows_done)(int row))
+{
+    calc_pool pool;
+    pool.passnum = passnum;
+    pool.calc_row = calc_row;
+    pool.first_col = g_col;
+    int end_row = g_row;
+    while (end_row <= g_i_y_stop)
+    {
+        pool.rows.push_back(end_row);
+        if (passnum == 1 && (end_row&1) == 0)
+        {
+            ++end_row;
+        }
+        ++end_row;
+    }
+    if (pool.rows.empty())
+    {
+        return 0;
+    }
+
+    int const num_rows = static_cast<int>(pool.rows.size());
+    unsigned const num_threads = std::min(calc_pool_threads(), static_cast<unsigned>(num_rows));
+    int const tile_rows = std::max(1, std::min(16, num_rows/static_cast<int>(num_threads*8)));
+    for (int first = 0; first < num_rows; first += tile_rows)
+    {
+        pool.tiles.push_back(row_tile{first, std::min(first + tile_rows, num_rows), false, {}});
+    }
+    deal_tiles(pool, num_threads);
+
+    // replay the plots of the finished tiles in order
+    int const done = run_tiles(pool, calc_worker, [&](row_tile &tile)
+    {
+        for (plot_point const &pt : tile.plots)
+        {
+            (*g_plot)(pt.x, pt.y, pt.color);
+        }
+        std::vector<plot_point>().swap(tile.plots);
+        g_current_row = pool.rows[tile.last - 1];
+        if (rows_done != nullptr)
+        {
+            (*rows_done)(g_current_row);
+        }
+    });
+    if (done < 0)
+    {
+        return 1;
+    }
+    if (done < static_cast<int>(pool.tiles.size()))
+    {
+        int const first = pool.tiles[done].first;
+        g_row = pool.rows[first];
+        g_col = (first == 0) ? pool.first_col : g_i_x_start;
+        return -1;
+    }
+    g_row = end_row;
+    g_col = g_i_x_start;
+    return 0;
+}
+
+// Run calc_strip(strip) for strips 0 to num_strips-1 on the calc threads.
+// calc_strip returns false if interrupted, and must leave the screen and
+// g_plot alone; strip_done(strip) is called on this thread for each finished
+// strip, in order.  Returns the number of strips done, which is less than
+// num_strips if interrupted, or -1 if no calc thread could be started.
+int calc_pool_strips(int num_strips, bool (*calc_strip)(int strip), void (*strip_done)(int strip))
+{
+    calc_pool pool;
+    pool.calc_strip = calc_strip;
+    for (int strip = 0; strip < num_strips; ++strip)
+    {
+        pool.tiles.push_back(row_tile{strip, strip + 1, false, {}});
+    }
+    deal_tiles(pool, std::min(calc_pool_threads(), static_cast<unsigned>(num_strips)));
+    return run_tiles(pool, strip_worker, [&](row_tile const &tile)
+    {
+        (*strip_done)(tile.first);
+    });
+}
+
+// queue a task on deque id of pool
+static void push_task(task_pool &pool, unsigned id, std::function<bool()> task)
+{
+    ++pool.pending;
+    {
+        std::lock_guard<std::mutex> lock(pool.deques[id].lock);
+        pool.deques[id].tasks.push_back(std::move(task));
+    }
+    std::lock_guard<std::mutex> lock(pool.idle_lock);
+    pool.idle_cond.notify_one();
+}
+
+// take the newest task from our own deque, or steal the oldest one from the
+// fullest deque
+static bool next_task(task_pool &pool, unsigned id, std::function<bool()> &task)
+{
+    {
+        task_deque &own = pool.deques[id];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    while (true)
+    {
+        task_deque *victim = nullptr;
+        std::size_t most = 0;
+        for (task_deque &deque : pool.deques)
+        {
+            std::lock_guard<std::mutex> lock(deque.lock);
+            if (deque.tasks.size() > most)
+            {
+                most = deque.tasks.size();
+                victim = &deque;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(victim->lock);
+        if (!victim->tasks.empty())
+        {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+}
+
+static void task_worker(task_pool &pool, unsigned id)
+{
+    s_worker = true;
+    s_task_pool = &pool;
+    s_task_deque = id;
+    restore_state(pool.state);
+
+    while (!calc_pool_interrupted() && pool.pending > 0)
+    {
+        std::function<bool()> task;
+        if (!next_task(pool, id, task))
+        {
+            // wait for a running task to queue some more, or finish
+            std::unique_lock<std::mutex> lock(pool.idle_lock);
+            pool.idle_cond.wait_for(lock, std::chrono::milliseconds(1));
+            continue;
+        }
+        if (!task())
+        {
+            break;
+        }
+        if (--pool.pending == 0)
+        {
+            std::lock_guard<std::mutex> lock(pool.idle_lock);
+            pool.idle_cond.notify_all();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(pool.done_lock);
+    --pool.running;
+    pool.done_cond.notify_one();
+}
+
+// Run task on the calc threads, along with the tasks it starts with
+// calc_pool_spawn(), and so on.  A task returns false if interrupted, and
+// must leave the screen and g_plot alone; drain() is called on this thread
+// every so often to draw what the tasks have done, and once more at the
+// end.  Returns 0 when all the tasks are done, -1 if interrupted, or 1 if no
+// calc thread could be started.
+int calc_pool_tasks(std::function<bool()> task, void (*drain)())
+{
+    task_pool pool;
+    std::vector<task_deque> deques(calc_pool_threads());
+    pool.deques.swap(deques);
+    pool.pending = 0;
+    push_task(pool, 0, std::move(task));
+    save_state(pool.state);
+    g_resuming = false;
+    s_interrupted = false;
+
+    std::vector<std::thread> threads;
+    pool.running = 0;
+    for (unsigned id = 0; id < pool.deques.size(); ++id)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(pool.done_lock);
+            threads.emplace_back(task_worker, std::ref(pool), id);
+            ++pool.running;
+        }
+        catch (std::system_error const &)
+        {
+            break;
+        }
+    }
+    if (threads.empty())
+    {
+        return 1;
+    }
+
+    bool interrupted = false;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pool.done_lock);
+            if (pool.done_cond.wait_for(lock, std::chrono::milliseconds(50), [&]()
+                {
+                    return pool.running == 0;
+                }))
+            {
+                break;
+            }
+        }
+        (*drain)();
+        if (check_key())
+        {
+            s_interrupted = true;
+            interrupted = true;
+            break;
+        }
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    (*drain)();
+    s_interrupted = false;
+    return interrupted || pool.pending > 0 ? -1 : 0;
+}
+
+// Queue another task from a task running under calc_pool_tasks()
+void calc_pool_spawn(std::function<bool()> task)
+{
+    push_task(*s_task_pool, s_task_deque, std::move(task));
+}
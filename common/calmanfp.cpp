@@ -8,62 +8,80 @@
 #include "prototyp.h"
 
 #include "calcfrac.h"
+#include "calcpool.h"
 #include "calmanfp.h"
 #include "cmdfiles.h"
 #include "drivers.h"
 #include "fracsubr.h"
 #include "fractals.h"
+#include "fractint.h"
 #include "fractype.h"
 #include "id_data.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+
+// the batch kernel uses GCC vector extensions, compiled for AVX2 and used
+// when the CPU has it; elsewhere calcmandfpasm_lanes() is 0
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MANDFP_VECTOR_LANES
+#endif
 
 static int inside_color, periodicity_color;
+static int mandfp_lanes = 0;
+static long (*mandfp_batch)(DComplex const *init, int count, MandelFPPixel *result) = nullptr;
+
+#if defined(MANDFP_VECTOR_LANES)
+__attribute__((target("avx2")))
+static long mandfp_batch4(DComplex const *init, int count, MandelFPPixel *result);
+#endif
 
 void calcmandfpasmstart()
 {
     inside_color = (g_inside_color < COLOR_BLACK) ? g_max_iterations : g_inside_color;
     periodicity_color = (g_periodicity_check < 0) ? 7 : inside_color;
-    g_old_color_iter = 0;
-}
-
-#define ABS(x) ((x) < 0?-(x):(x))
+    g_ctx.old_color_iter = 0;
 
-long calcmandfpasm()
-{
-    long cx;
-    long savedand;
-    int savedincr;
-    long tmpfsd;
-    double x, y, x2, y2, xy, Cx, Cy, savedx, savedy;
-
-    if (g_periodicity_check == 0)
+    mandfp_lanes = 0;
+    mandfp_batch = nullptr;
+#if defined(MANDFP_VECTOR_LANES)
+    if (g_debug_flag != debug_flags::prevent_simd_math)
     {
-        g_old_color_iter = 0;      // don't check periodicity
-    }
-    else if (g_reset_periodicity)
-    {
-        g_old_color_iter = g_max_iterations - 255;
+        if (__builtin_cpu_supports("avx2"))
+        {
+            mandfp_lanes = 4;
+            mandfp_batch = mandfp_batch4;
+        }
     }
+#endif
+}
 
-    tmpfsd = g_max_iterations - g_first_saved_and;
-    if (g_old_color_iter > tmpfsd) // this defeats checking periodicity immediately
-    {
-        g_old_color_iter = tmpfsd; // but matches the code in standard_fractal()
-    }
+// number of pixels calcmandfpasm_batch() calculates at once, 0 if the
+// pixels must be calculated one at a time with calcmandfpasm()
+int calcmandfpasm_lanes()
+{
+    return mandfp_lanes;
+}
 
-    // initparms
-    savedx = 0;
-    savedy = 0;
-    g_orbit_save_index = 0;
-    savedand = g_first_saved_and;
-    savedincr = 1;             // start checking the very first time
-    g_keyboard_check_interval--;                // Only check the keyboard sometimes
+#define ABS(x) ((x) < 0?-(x):(x))
+
+// Only check the keyboard sometimes; true if the calculation is interrupted
+static bool mandfp_key_interrupt()
+{
+    g_keyboard_check_interval--;
     if (g_keyboard_check_interval < 0)
     {
         int key;
         g_keyboard_check_interval = 1000;
-        key = driver_key_pressed();
+        if (calc_pool_worker())
+        {
+            key = calc_pool_interrupted() ? FIK_ESC : 0;
+        }
+        else
+        {
+            key = driver_key_pressed();
+        }
         if (key)
         {
             if (key == 'o' || key == 'O')
@@ -73,34 +91,129 @@ long calcmandfpasm()
             }
             else
             {
-                g_color_iter = -1;
-                return -1;
+                return true;
             }
         }
     }
+    return false;
+}
 
-    cx = g_max_iterations;
-    if (g_fractal_type != fractal_type::JULIAFP && g_fractal_type != fractal_type::JULIA)
+// periodicity check limit for a pixel following one that left old_color_iter
+static long mandfp_check_limit(long old_color_iter, bool reset)
+{
+    if (g_periodicity_check == 0)
     {
-        // Mandelbrot_87
-        Cx = g_init.x;
-        Cy = g_init.y;
-        x = g_param_z1.x+Cx;
-        y = g_param_z1.y+Cy;
+        old_color_iter = 0;             // don't check periodicity
+    }
+    else if (reset)
+    {
+        old_color_iter = g_max_iterations - 255;
+    }
+
+    long const tmpfsd = g_max_iterations - g_first_saved_and;
+    if (old_color_iter > tmpfsd)        // this defeats checking periodicity immediately
+    {
+        old_color_iter = tmpfsd;        // but matches the code in standard_fractal()
+    }
+    return old_color_iter;
+}
+
+// caught a cycle at cx
+static void mandfp_periodic(long cx)
+{
+    //          oldcoloriter = 65535;
+    g_ctx.old_color_iter = g_max_iterations;
+    g_ctx.real_color_iter = g_max_iterations;
+    g_keyboard_check_interval = g_keyboard_check_interval -(g_max_iterations-cx);
+    g_ctx.color_iter = periodicity_color;
+}
+
+// reached maxit
+static void mandfp_inside()
+{
+    // check periodicity immediately next time, remember we count down from maxit
+    g_ctx.old_color_iter = g_max_iterations;
+    g_keyboard_check_interval -= g_max_iterations;
+    g_ctx.real_color_iter = g_max_iterations;
+    g_ctx.color_iter = inside_color;
+}
+
+// over_bailout_87: escaped at x, y with cx iterations left
+static void mandfp_escaped(long cx, double x, double y)
+{
+    if (g_outside_color <= REAL)
+    {
+        g_ctx.new_z.x = x;
+        g_ctx.new_z.y = y;
+    }
+    if (cx-10 > 0)
+    {
+        g_ctx.old_color_iter = cx-10;
     }
     else
     {
-        // dojulia_87
-        Cx = g_param_z1.x;
-        Cy = g_param_z1.y;
-        x = g_init.x;
-        y = g_init.y;
-        x2 = x*x;
-        y2 = y*y;
-        xy = x*y;
-        x = x2-y2+Cx;
-        y = 2*xy+Cy;
+        g_ctx.old_color_iter = 0;
     }
+    g_ctx.real_color_iter = g_max_iterations-cx;
+    g_ctx.color_iter = g_ctx.real_color_iter;
+    if (g_ctx.color_iter == 0)
+    {
+        g_ctx.color_iter = 1;
+    }
+    g_keyboard_check_interval -= g_ctx.real_color_iter;
+    if (g_outside_color == ITER)
+    {
+    }
+    else if (g_outside_color > REAL)
+    {
+        g_ctx.color_iter = g_outside_color;
+    }
+    else
+    {
+        // special_outside
+        if (g_outside_color == REAL)
+        {
+            g_ctx.color_iter += (long) g_ctx.new_z.x + 7;
+        }
+        else if (g_outside_color == IMAG)
+        {
+            g_ctx.color_iter += (long) g_ctx.new_z.y + 7;
+        }
+        else if (g_outside_color == MULT && g_ctx.new_z.y != 0.0)
+        {
+            g_ctx.color_iter = (long)((double) g_ctx.color_iter * (g_ctx.new_z.x/g_ctx.new_z.y));
+        }
+        else if (g_outside_color == SUM)
+        {
+            g_ctx.color_iter += (long)(g_ctx.new_z.x + g_ctx.new_z.y);
+        }
+        else if (g_outside_color == ATAN)
+        {
+            g_ctx.color_iter = (long) std::fabs(std::atan2(g_ctx.new_z.y, g_ctx.new_z.x)*g_atan_colors/PI);
+        }
+        // check_color
+        if ((g_ctx.color_iter <= 0 || g_ctx.color_iter > g_max_iterations) && g_outside_color != FMOD)
+        {
+            g_ctx.color_iter = 1;
+        }
+    }
+}
+
+// iterate from x, y with c = Cx, Cy, checking periodicity once cx drops
+// below g_ctx.old_color_iter
+static void mandfp_orbit(double Cx, double Cy, double x, double y)
+{
+    long cx;
+    long savedand;
+    int savedincr;
+    double x2, y2, xy, savedx, savedy;
+
+    // initparms
+    savedx = 0;
+    savedy = 0;
+    savedand = g_first_saved_and;
+    savedincr = 1;             // start checking the very first time
+    cx = g_max_iterations;
     x2 = x*x;
     y2 = y*y;
     xy = x*y;
@@ -113,15 +226,16 @@ long calcmandfpasm()
         x2 = x*x;
         y2 = y*y;
         xy = x*y;
-        g_magnitude = x2+y2;
+        g_ctx.magnitude = x2+y2;
 
-        if (g_magnitude >= g_magnitude_limit)
+        if (g_ctx.magnitude >= g_ctx.magnitude_limit)
         {
-            goto over_bailout_87;
+            mandfp_escaped(cx, x, y);
+            return;
         }
 
         // no_save_new_xy_87
-        if (cx < g_old_color_iter)  // check periodicity
+        if (cx < g_ctx.old_color_iter)  // check periodicity
         {
             if (((g_max_iterations - cx) & savedand) == 0)
             {
@@ -138,12 +252,8 @@ long calcmandfpasm()
             {
                 if (ABS(savedx-x) < g_close_enough && ABS(savedy-y) < g_close_enough)
                 {
-                    //          oldcoloriter = 65535;
-                    g_old_color_iter = g_max_iterations;
-                    g_real_color_iter = g_max_iterations;
-                    g_keyboard_check_interval = g_keyboard_check_interval -(g_max_iterations-cx);
-                    g_color_iter = periodicity_color;
-                    goto pop_stack;
+                    mandfp_periodic(cx);
+                    return;
                 }
             }
         }
@@ -155,77 +265,433 @@ long calcmandfpasm()
         // no_show_orbit_87
     } // while (--cx > 0)
 
-    // reached maxit
-    // check periodicity immediately next time, remember we count down from maxit
-    g_old_color_iter = g_max_iterations;
-    g_keyboard_check_interval -= g_max_iterations;
-    g_real_color_iter = g_max_iterations;
-    g_color_iter = inside_color;
+    mandfp_inside();
+}
 
-pop_stack:
+long calcmandfpasm()
+{
+    double x, y, Cx, Cy;
+
+    g_ctx.old_color_iter = mandfp_check_limit(g_ctx.old_color_iter, g_reset_periodicity);
+
+    g_orbit_save_index = 0;
+    if (mandfp_key_interrupt())
+    {
+        g_ctx.color_iter = -1;
+        return -1;
+    }
+
+    if (g_fractal_type != fractal_type::JULIAFP && g_fractal_type != fractal_type::JULIA)
+    {
+        // Mandelbrot_87
+        Cx = g_ctx.init.x;
+        Cy = g_ctx.init.y;
+        x = g_ctx.param_z1.x+Cx;
+        y = g_ctx.param_z1.y+Cy;
+    }
+    else
+    {
+        // dojulia_87
+        Cx = g_ctx.param_z1.x;
+        Cy = g_ctx.param_z1.y;
+        x = g_ctx.init.x;
+        y = g_ctx.init.y;
+        double const x2 = x*x;
+        double const y2 = y*y;
+        double const xy = x*y;
+        x = x2-y2+Cx;
+        y = 2*xy+Cy;
+    }
+    mandfp_orbit(Cx, Cy, x, y);
+
+    // pop_stack
     if (g_orbit_save_index)
     {
         scrub_orbit();
     }
-    return g_color_iter;
+    return g_ctx.color_iter;
+}
 
-over_bailout_87:
-    if (g_outside_color <= REAL)
+// Calculate count adjacent pixels, starting at init[], as count calls of
+// calcmandfpasm() would, filling in result[].  Returns -1 if interrupted
+// before the first pixel, else 0.  g_ctx is left as the last call would
+// leave it.
+long calcmandfpasm_batch(DComplex const *init, int count, MandelFPPixel *result)
+{
+    return (*mandfp_batch)(init, count, result);
+}
+
+#if defined(MANDFP_VECTOR_LANES)
+
+// The pixels of a batch iterate side by side, one per lane.  The iterations
+// are independent, but the periodicity check is not: when a pixel starts
+// checking depends on how the pixel before it ended.  So a lane whose
+// previous pixel is still iterating guesses that it will end inside, which
+// is the common case next to a pixel that is still going, and checks
+// periodicity accordingly.  When the previous pixel ends, the lane is
+// settled: the guess was right and its results stand, or the real check
+// starts later than where the lane has got to and the lane carries on with
+// it, or (rarely) the lane has already gone past the real start and the
+// pixel is calculated again with calcmandfpasm()'s loop.  Either way each
+// pixel comes out exactly as it does on its own.
+namespace
+{
+
+struct mandfp_lane
+{
+    DComplex c;
+    DComplex start;                     // z before the first iteration
+    bool guessing;                      // previous pixel not done, check is a guess
+    bool running;                       // still iterating
+    bool reset;                         // restart the periodicity check at check_limit
+    long check_limit;
+    long period_cx;                     // cx of the (guessed) cycle, 0 if none
+    double period_magnitude;
+    long end_cx;                        // cx it escaped at, 0 if reached maxit
+    DComplex end_z;
+    double end_magnitude;
+    long old_color_iter;                // left for the next pixel when done
+    bool done;
+};
+
+struct mandfp_batch_state
+{
+    mandfp_lane *lanes;
+    int count;
+    MandelFPPixel *result;
+    long guess;                         // check limit after a pixel ending inside
+};
+
+} // namespace
+
+// lane k's pixel is done, with its result in g_ctx
+static void take_result(mandfp_batch_state &batch, int k)
+{
+    mandfp_lane &lane = batch.lanes[k];
+    lane.running = false;
+    lane.done = true;
+    lane.old_color_iter = g_ctx.old_color_iter;
+    batch.result[k].color_iter = g_ctx.color_iter;
+    batch.result[k].real_color_iter = g_ctx.real_color_iter;
+    batch.result[k].magnitude = g_ctx.magnitude;
+}
+
+// lane k has stopped or caught a cycle, and its periodicity check is right
+static void finish_lane(mandfp_batch_state &batch, int k)
+{
+    mandfp_lane &lane = batch.lanes[k];
+    if (lane.period_cx > 0)
     {
-        g_new_z.x = x;
-        g_new_z.y = y;
+        g_ctx.magnitude = lane.period_magnitude;
+        mandfp_periodic(lane.period_cx);
     }
-    if (cx-10 > 0)
+    else if (lane.end_cx > 0)
     {
-        g_old_color_iter = cx-10;
+        g_ctx.magnitude = lane.end_magnitude;
+        mandfp_escaped(lane.end_cx, lane.end_z.x, lane.end_z.y);
     }
     else
     {
-        g_old_color_iter = 0;
+        g_ctx.magnitude = lane.end_magnitude;
+        mandfp_inside();
     }
-    g_real_color_iter = g_max_iterations-cx;
-    g_color_iter = g_real_color_iter;
-    if (g_color_iter == 0)
+    take_result(batch, k);
+}
+
+// the pixel before lane k is done and the lanes have iterated down to cx:
+// settle lane k and any following lanes that were waiting on it
+static void settle_lanes(mandfp_batch_state &batch, int k, long cx)
+{
+    for (; k < batch.count && batch.lanes[k].guessing; ++k)
     {
-        g_color_iter = 1;
+        mandfp_lane &lane = batch.lanes[k];
+        long const limit = mandfp_check_limit(batch.lanes[k-1].old_color_iter, false);
+        lane.guessing = false;
+        if (limit == batch.guess)
+        {
+            if (lane.running && lane.period_cx == 0)
+            {
+                return;                 // carries on with the right check
+            }
+            finish_lane(batch, k);
+            continue;
+        }
+
+        // the check starts later than guessed; the lane is only right so
+        // far if it hasn't checked where the real check would not have
+        lane.period_cx = 0;
+        long last_cx;                   // last cx the lane checked at
+        if (lane.running)
+        {
+            last_cx = cx;
+        }
+        else
+        {
+            last_cx = (lane.end_cx > 0) ? lane.end_cx + 1 : 1;
+        }
+        if (last_cx >= limit)
+        {
+            if (lane.running)
+            {
+                lane.reset = true;
+                lane.check_limit = limit;
+                return;
+            }
+            finish_lane(batch, k);
+            continue;
+        }
+        g_ctx.old_color_iter = limit;
+        mandfp_orbit(lane.c.x, lane.c.y, lane.start.x, lane.start.y);
+        take_result(batch, k);
     }
-    g_keyboard_check_interval -= g_real_color_iter;
-    if (g_outside_color == ITER)
+}
+
+namespace
+{
+
+template <int N>
+struct mandfp_vector
+{
+    typedef double real __attribute__((vector_size(N*sizeof(double))));
+    typedef long long integer __attribute__((vector_size(N*sizeof(long long))));
+};
+
+} // namespace
+
+// The kernel proper, expanded into a function for each vector unit.  Each
+// lane does its operations in the same order as calcmandfpasm()'s loop, so
+// the orbits are the same to the last bit.  The vectors are only taken
+// apart into lanes when some lane escapes or catches a cycle.
+template <int N>
+static inline __attribute__((always_inline))
+long mandfp_batch_lanes(DComplex const *init, int count, MandelFPPixel *result)
+{
+    typedef typename mandfp_vector<N>::real real;
+    typedef typename mandfp_vector<N>::integer integer;
+
+    if (mandfp_key_interrupt())
     {
+        return -1;
     }
-    else if (g_outside_color > REAL)
+    g_keyboard_check_interval -= count - 1;
+    g_orbit_save_index = 0;
+
+    bool const julia = g_fractal_type == fractal_type::JULIAFP || g_fractal_type == fractal_type::JULIA;
+    mandfp_lane lanes[N];
+    mandfp_batch_state batch{lanes, count, result, mandfp_check_limit(g_max_iterations, false)};
+
+    // the vectors, a lane at a time
+    double lane_x[N] = {}, lane_y[N] = {}, lane_cx[N] = {}, lane_cy[N] = {};
+    double lane_savedx[N] = {}, lane_savedy[N] = {}, lane_magnitude[N];
+    long long lane_savedand[N] = {}, lane_savedincr[N] = {}, lane_limit[N] = {};
+    long long lane_escaped[N], lane_periodic[N];
+    for (int i = 0; i < count; ++i)
     {
-        g_color_iter = g_outside_color;
+        mandfp_lane &lane = lanes[i];
+        if (!julia)
+        {
+            // Mandelbrot_87
+            lane.c = init[i];
+            lane.start.x = g_ctx.param_z1.x + lane.c.x;
+            lane.start.y = g_ctx.param_z1.y + lane.c.y;
+        }
+        else
+        {
+            // dojulia_87
+            lane.c = g_ctx.param_z1;
+            double const x2 = init[i].x*init[i].x;
+            double const y2 = init[i].y*init[i].y;
+            double const xy = init[i].x*init[i].y;
+            lane.start.x = x2 - y2 + lane.c.x;
+            lane.start.y = 2*xy + lane.c.y;
+        }
+        lane.guessing = i > 0 && g_periodicity_check != 0;
+        lane.running = true;
+        lane.reset = false;
+        lane.check_limit = (i == 0) ? mandfp_check_limit(g_ctx.old_color_iter, g_reset_periodicity) : batch.guess;
+        lane.period_cx = 0;
+        lane.end_cx = 0;
+        lane.done = false;
+        lane_x[i] = lane.start.x;
+        lane_y[i] = lane.start.y;
+        lane_cx[i] = lane.c.x;
+        lane_cy[i] = lane.c.y;
+        lane_savedand[i] = g_first_saved_and;
+        lane_savedincr[i] = 1;
+        lane_limit[i] = lane.check_limit;
     }
-    else
+
+    real x, y, Cx, Cy, savedx, savedy;
+    integer savedand, savedincr, check_limit;
+    std::memcpy(&x, lane_x, sizeof(x));
+    std::memcpy(&y, lane_y, sizeof(y));
+    std::memcpy(&Cx, lane_cx, sizeof(Cx));
+    std::memcpy(&Cy, lane_cy, sizeof(Cy));
+    std::memcpy(&savedx, lane_savedx, sizeof(savedx));
+    std::memcpy(&savedy, lane_savedy, sizeof(savedy));
+    std::memcpy(&savedand, lane_savedand, sizeof(savedand));
+    std::memcpy(&savedincr, lane_savedincr, sizeof(savedincr));
+    std::memcpy(&check_limit, lane_limit, sizeof(check_limit));
+    real x2 = x*x;
+    real y2 = y*y;
+    real xy = x*y;
+    real magnitude = real{} + g_ctx.magnitude;
+
+    real const limit = real{} + g_ctx.magnitude_limit;
+    real const close_enough = real{} + g_close_enough;
+    real const minus_close_enough = real{} - g_close_enough;
+    integer const next_saved_incr = integer{} + g_periodicity_next_saved_incr;
+    int running = count;
+    long cx = g_max_iterations;
+    while (running > 0 && --cx > 0)
     {
-        // special_outside
-        if (g_outside_color == REAL)
+        x = x2 - y2 + Cx;
+        y = 2.0*xy + Cy;
+        x2 = x*x;
+        y2 = y*y;
+        xy = x*y;
+        magnitude = x2 + y2;
+        integer const escaped = magnitude >= limit;
+
+        // periodicity check, with masks: save when the iteration count
+        // has no bits outside savedand, compare otherwise
+        integer const checking = (integer{} + cx) < check_limit;
+        integer const save = checking & (((integer{} + (g_max_iterations - cx)) & savedand) == 0);
+        real const dx = savedx - x;
+        real const dy = savedy - y;
+        integer const periodic = checking & ~save
+            & (dx < close_enough) & (dx > minus_close_enough)
+            & (dy < close_enough) & (dy > minus_close_enough);
+        savedx = save ? x : savedx;
+        savedy = save ? y : savedy;
+        savedincr += save;              // save is -1 where set
+        integer const next_and = save & (savedincr == 0);
+        savedand = next_and ? (savedand << 1) + 1 : savedand;
+        savedincr = next_and ? next_saved_incr : savedincr;
+
+        integer const event = escaped | periodic;
+        long long lane_event[N];
+        std::memcpy(lane_event, &event, sizeof(lane_event));
+        long long any = 0;
+        for (int i = 0; i < N; ++i)
         {
-            g_color_iter += (long) g_new_z.x + 7;
+            any |= lane_event[i];
         }
-        else if (g_outside_color == IMAG)
+        if (any == 0)
         {
-            g_color_iter += (long) g_new_z.y + 7;
+            continue;
         }
-        else if (g_outside_color == MULT && g_new_z.y != 0.0)
+
+        std::memcpy(lane_x, &x, sizeof(lane_x));
+        std::memcpy(lane_y, &y, sizeof(lane_y));
+        std::memcpy(lane_magnitude, &magnitude, sizeof(lane_magnitude));
+        std::memcpy(lane_escaped, &escaped, sizeof(lane_escaped));
+        std::memcpy(lane_periodic, &periodic, sizeof(lane_periodic));
+        // in pixel order, so each lane's predecessor is settled first
+        for (int i = 0; i < count; ++i)
         {
-            g_color_iter = (long)((double) g_color_iter * (g_new_z.x/g_new_z.y));
+            mandfp_lane &lane = lanes[i];
+            if (lane.running && lane_escaped[i])
+            {
+                lane.running = false;
+                lane.end_cx = cx;
+                lane.end_z.x = lane_x[i];
+                lane.end_z.y = lane_y[i];
+                lane.end_magnitude = lane_magnitude[i];
+                if (!lane.guessing)
+                {
+                    finish_lane(batch, i);
+                    settle_lanes(batch, i + 1, cx);
+                }
+            }
+            else if (lane.running && lane_periodic[i] && cx < lane.check_limit)
+            {
+                lane.period_cx = cx;
+                lane.period_magnitude = lane_magnitude[i];
+                if (!lane.guessing)
+                {
+                    finish_lane(batch, i);
+                    settle_lanes(batch, i + 1, cx);
+                }
+                else
+                {
+                    lane.check_limit = 0;   // it stands or falls with the guess
+                }
+            }
         }
-        else if (g_outside_color == SUM)
+
+        // put the lanes back together
+        std::memcpy(lane_savedx, &savedx, sizeof(lane_savedx));
+        std::memcpy(lane_savedy, &savedy, sizeof(lane_savedy));
+        std::memcpy(lane_savedand, &savedand, sizeof(lane_savedand));
+        std::memcpy(lane_savedincr, &savedincr, sizeof(lane_savedincr));
+        running = 0;
+        for (int i = 0; i < count; ++i)
         {
-            g_color_iter += (long)(g_new_z.x + g_new_z.y);
+            mandfp_lane &lane = lanes[i];
+            if (lane.running)
+            {
+                ++running;
+            }
+            else
+            {
+                // a stopped lane stays at 0, which never escapes
+                lane_x[i] = 0.0;
+                lane_y[i] = 0.0;
+                lane_cx[i] = 0.0;
+                lane_cy[i] = 0.0;
+                lane.check_limit = 0;
+            }
+            if (lane.reset)
+            {
+                lane.reset = false;
+                lane_savedx[i] = 0.0;
+                lane_savedy[i] = 0.0;
+                lane_savedand[i] = g_first_saved_and;
+                lane_savedincr[i] = 1;
+            }
+            lane_limit[i] = lane.check_limit;
         }
-        else if (g_outside_color == ATAN)
+        std::memcpy(&x, lane_x, sizeof(x));
+        std::memcpy(&y, lane_y, sizeof(y));
+        std::memcpy(&Cx, lane_cx, sizeof(Cx));
+        std::memcpy(&Cy, lane_cy, sizeof(Cy));
+        std::memcpy(&savedx, lane_savedx, sizeof(savedx));
+        std::memcpy(&savedy, lane_savedy, sizeof(savedy));
+        std::memcpy(&savedand, lane_savedand, sizeof(savedand));
+        std::memcpy(&savedincr, lane_savedincr, sizeof(savedincr));
+        std::memcpy(&check_limit, lane_limit, sizeof(check_limit));
+        x2 = x*x;                       // as they were, for the lanes still running
+        y2 = y*y;
+        xy = x*y;
+    }
+
+    // what is still running reached maxit
+    std::memcpy(lane_magnitude, &magnitude, sizeof(lane_magnitude));
+    for (int i = 0; i < count; ++i)
+    {
+        mandfp_lane &lane = lanes[i];
+        if (lane.running)
         {
-            g_color_iter = (long) std::fabs(std::atan2(g_new_z.y, g_new_z.x)*g_atan_colors/PI);
+            lane.running = false;
+            lane.end_magnitude = lane_magnitude[i];
         }
-        // check_color
-        if ((g_color_iter <= 0 || g_color_iter > g_max_iterations) && g_outside_color != FMOD)
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        if (!lanes[i].done && !lanes[i].guessing)
         {
-            g_color_iter = 1;
+            finish_lane(batch, i);
+            settle_lanes(batch, i + 1, 0);
         }
     }
+    return 0;
+}
 
-    goto pop_stack;
+__attribute__((target("avx2")))
+static long mandfp_batch4(DComplex const *init, int count, MandelFPPixel *result)
+{
+    return mandfp_batch_lanes<4>(init, count, result);
 }
+
+#endif
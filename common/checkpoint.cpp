@@ -0,0 +1,460 @@
+// Checkpoint file for long calculations with the escape-time engines.
+//
+// checkpoint=<file> keeps the progress of the calculation in a file a later
+// run can carry on from.  The file starts with a header identifying the image;
+// after that it is only ever appended to.  Each record holds the rows of the
+// screen that changed since the previous record, then the worklist as it would
+// be if the calculation were interrupted right there.  Records are made every
+// savetime= minutes (every minute without savetime=) as the rows of a 1 or 2
+// pass calculation finish, whenever a worklist entry finishes or is
+// interrupted, and when the image is done.  The rows are copied on the
+// calculating thread but written out by a thread of their own, so the
+// calculation carries on while the disk catches up.
+//
+// When perform_worklist() starts on the same image without resuming it, the
+// rows are put back on the screen and the last worklist recorded picks up
+// from there.  Rows recorded after that worklist, or in a record cut short,
+// only cover work still on the worklist, which is calculated over again.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "calcfrac.h"
+#include "checkpoint.h"
+#include "cmdfiles.h"
+#include "diskvid.h"
+#include "encoder.h"
+#include "fracsubr.h"
+#include "id_data.h"
+#include "loadfile.h"
+#include "miscovl.h"
+#include "realdos.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+std::string g_checkpoint_filename;      // checkpoint= option, empty for none
+
+namespace
+{
+
+char const CHECKPOINT_ID[8] = "idchk01";
+
+struct file_header
+{
+    char id[8];
+    int width;
+    int height;
+    FRACTAL_INFO info;
+};
+
+enum
+{
+    ROWS_RECORD = 'R',                  // first row, row count, then the rows
+    WORK_RECORD = 'W'                   // entries, calctime, then the worklist
+};
+
+struct record_header
+{
+    int tag;
+    int first;
+    int count;
+};
+
+// Appends records to the checkpoint file from a thread of its own.
+class checkpoint_writer
+{
+public:
+    explicit checkpoint_writer(std::FILE *fp);
+    ~checkpoint_writer();
+
+    void write(std::vector<BYTE> &&record);
+
+private:
+    void run();
+    void put(std::vector<BYTE> const &record);
+
+    std::FILE *m_fp;
+    bool m_failed{};
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    std::deque<std::vector<BYTE>> m_queue;
+    bool m_closing{};
+    std::thread m_thread;
+};
+
+checkpoint_writer::checkpoint_writer(std::FILE *fp) :
+    m_fp(fp)
+{
+    try
+    {
+        m_thread = std::thread(&checkpoint_writer::run, this);
+    }
+    catch (std::system_error const &)
+    {
+        // write() writes the records itself
+    }
+}
+
+// Waits for the records still queued to be written.
+checkpoint_writer::~checkpoint_writer()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closing = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+    }
+    std::fclose(m_fp);
+}
+
+void checkpoint_writer::write(std::vector<BYTE> &&record)
+{
+    if (!m_thread.joinable())
+    {
+        put(record);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_queue.push_back(std::move(record));
+    }
+    m_cond.notify_one();
+}
+
+void checkpoint_writer::run()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true)
+    {
+        m_cond.wait(lock, [this]()
+        {
+            return m_closing || !m_queue.empty();
+        });
+        if (m_queue.empty())
+        {
+            break;
+        }
+        std::vector<BYTE> record;
+        record.swap(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        put(record);
+        lock.lock();
+    }
+}
+
+// After a failed write the file ends part way through a record, which the
+// next run finds and starts the file afresh.
+void checkpoint_writer::put(std::vector<BYTE> const &record)
+{
+    if (m_failed)
+    {
+        return;
+    }
+    if (std::fwrite(&record[0], 1, record.size(), m_fp) != record.size()
+        || std::fflush(m_fp) != 0)
+    {
+        m_failed = true;
+    }
+}
+
+std::unique_ptr<checkpoint_writer> s_writer;
+std::vector<char> s_dirty;              // rows changed since the last record
+int s_pass_row = 0;                     // next row of the pass to finish
+bool s_rows_marked = false;             // the entry's rows are marked as they finish
+std::chrono::steady_clock::time_point s_start;
+std::chrono::steady_clock::time_point s_last_record;
+long s_start_calc_time = 0;             // g_calc_time when s_start was taken
+
+} // namespace
+
+static void make_header(file_header &header)
+{
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.id, CHECKPOINT_ID, sizeof(header.id));
+    header.width = g_logical_screen_x_dots;
+    header.height = g_logical_screen_y_dots;
+    setup_save_info(&header.info);
+    header.info.calc_status = 0;        // these change as the image is calculated
+    header.info.calctime = 0;
+    if (!header.info.rflag)
+    {
+        header.info.rseed = 0;          // picked afresh by each run
+    }
+}
+
+// Reads the records following the header, putting the rows back on the
+// screen and taking up the last worklist when restore is set.  Returns true
+// if the file ends with a whole record.
+static bool read_records(std::FILE *fp, bool restore, bool &restored)
+{
+    std::vector<BYTE> pixels(g_logical_screen_x_dots);
+    while (true)
+    {
+        record_header record;
+        std::size_t const got = std::fread(&record, 1, sizeof(record), fp);
+        if (got != sizeof(record))
+        {
+            return got == 0 && std::feof(fp);
+        }
+        if (record.tag == ROWS_RECORD)
+        {
+            if (record.first < 0 || record.count < 0
+                || record.count > g_logical_screen_y_dots - record.first)
+            {
+                return false;
+            }
+            for (int row = record.first; row < record.first + record.count; ++row)
+            {
+                if (std::fread(&pixels[0], pixels.size(), 1, fp) != 1)
+                {
+                    return false;
+                }
+                if (restore)
+                {
+                    put_line(row, 0, g_logical_screen_x_dots - 1, &pixels[0]);
+                }
+            }
+        }
+        else if (record.tag == WORK_RECORD)
+        {
+            if (record.first < 0 || record.first > MAX_CALC_WORK)
+            {
+                return false;
+            }
+            WORKLIST work[MAX_CALC_WORK];
+            if (record.first > 0
+                && std::fread(work, sizeof(WORKLIST), record.first, fp) != static_cast<std::size_t>(record.first))
+            {
+                return false;
+            }
+            if (restore)
+            {
+                g_num_work_list = record.first;
+                std::copy(work, work + record.first, g_work_list);
+                g_calc_time = record.count;
+                restored = true;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
+
+static void append(std::vector<BYTE> &record, void const *data, std::size_t size)
+{
+    BYTE const *bytes = static_cast<BYTE const *>(data);
+    record.insert(record.end(), bytes, bytes + size);
+}
+
+// Queues the rows changed since the last record and the worklist given.
+static void write_record(WORKLIST const *work, int num_work)
+{
+    auto const now = std::chrono::steady_clock::now();
+    int const width = g_logical_screen_x_dots;
+    int const height = static_cast<int>(s_dirty.size());
+    std::vector<BYTE> record;
+    int row = 0;
+    while (row < height)
+    {
+        if (!s_dirty[row])
+        {
+            ++row;
+            continue;
+        }
+        int const first = row;
+        while (row < height && s_dirty[row])
+        {
+            s_dirty[row++] = 0;
+        }
+        record_header const rows{ROWS_RECORD, first, row - first};
+        append(record, &rows, sizeof(rows));
+        std::size_t at = record.size();
+        record.resize(at + static_cast<std::size_t>(row - first)*width);
+        for (int y = first; y < row; ++y, at += width)
+        {
+            get_line(y, 0, width - 1, &record[at]);
+        }
+    }
+    long const elapsed = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - s_start).count()/10);
+    record_header const state{WORK_RECORD, num_work, static_cast<int>(s_start_calc_time + elapsed)};
+    append(record, &state, sizeof(state));
+    append(record, work, num_work*sizeof(WORKLIST));
+    s_writer->write(std::move(record));
+    s_last_record = now;
+}
+
+static bool record_due()
+{
+    int const minutes = std::max(1, std::abs(g_init_save_time));
+    return std::chrono::steady_clock::now() - s_last_record >= std::chrono::minutes(minutes);
+}
+
+// Mark rows first to last of the current worklist entry changed, with the
+// rows symmetry plotted from them.
+static void mark_rows(int first, int last)
+{
+    int const height = static_cast<int>(s_dirty.size());
+    for (int row = std::max(first, 0); row <= last && row < height; ++row)
+    {
+        s_dirty[row] = 1;
+        if (g_i_y_stop != g_yy_stop)
+        {
+            int const mirror = g_yy_stop - (row - g_yy_start);
+            if (mirror > g_i_y_stop && mirror < height)
+            {
+                s_dirty[mirror] = 1;
+            }
+        }
+    }
+}
+
+// Called by perform_worklist() with the worklist set up.  Starts the
+// checkpoint file if checkpoint= is in use, first taking up the progress
+// recorded in it when it holds this image.
+void checkpoint_start()
+{
+    s_writer.reset();
+    if (g_checkpoint_filename.empty()
+        || g_three_pass
+        || g_std_calc_mode == 'o'       // plots anywhere, whatever the worklist
+        || g_disk_16_bit
+        || g_truecolor
+        || g_is_true_color)
+    {
+        return;
+    }
+
+    file_header header;
+    make_header(header);
+    bool restored = false;
+    bool whole = false;                 // the file holds this image and whole records
+    if (std::FILE *fp = std::fopen(g_checkpoint_filename.c_str(), "rb"))
+    {
+        file_header old;
+        if (std::fread(&old, sizeof(old), 1, fp) == 1
+            && std::memcmp(&old, &header, sizeof(header)) == 0)
+        {
+            whole = read_records(fp, !g_resuming, restored);
+        }
+        std::fclose(fp);
+    }
+
+    std::FILE *fp = std::fopen(g_checkpoint_filename.c_str(), whole ? "ab" : "wb");
+    if (fp != nullptr && !whole && std::fwrite(&header, sizeof(header), 1, fp) != 1)
+    {
+        std::fclose(fp);
+        fp = nullptr;
+    }
+    if (fp == nullptr)
+    {
+        stopmsg(STOPMSG_NONE, ("Can't write checkpoint file " + g_checkpoint_filename).c_str());
+        return;
+    }
+    s_writer.reset(new checkpoint_writer(fp));
+    s_start = std::chrono::steady_clock::now();
+    s_last_record = s_start;
+    s_start_calc_time = g_calc_time;
+    s_dirty.assign(g_logical_screen_y_dots, 0);
+    if (!whole && (restored || g_resuming))
+    {
+        // a new file needs whatever is already on the screen
+        std::fill(s_dirty.begin(), s_dirty.end(), 1);
+        write_record(g_work_list, g_num_work_list);
+    }
+}
+
+// standard_calc() is starting a pass at row.
+void checkpoint_pass_start(int row)
+{
+    s_pass_row = row;
+    s_rows_marked = true;
+}
+
+// Rows of the pass up to row are finished; if a record is due, record the
+// worklist one_or_two_pass() would leave if interrupted at the next row.
+void checkpoint_rows_done(int row)
+{
+    if (!s_writer)
+    {
+        return;
+    }
+    int const next = (g_current_pass == 1 && (row&1) == 0) ? row + 2 : row + 1;
+    mark_rows(s_pass_row, std::min(next, g_i_y_stop + 1) - 1);
+    s_pass_row = next;
+    if (next > g_i_y_stop || !record_due())
+    {
+        return;
+    }
+    int const num_work = g_num_work_list;
+    WORKLIST work[MAX_CALC_WORK];
+    std::copy(g_work_list, g_work_list + num_work, work);
+    int added;
+    if (g_current_pass == 1)
+    {
+        added = add_worklist(g_xx_start, g_xx_stop, g_xx_start, g_yy_start, g_yy_stop, next, 0, g_work_symmetry);
+    }
+    else
+    {
+        int stop = g_yy_stop;
+        if (g_i_y_stop != g_yy_stop)    // must be due to symmetry
+        {
+            stop -= next - g_i_y_start;
+        }
+        added = add_worklist(g_xx_start, g_xx_stop, g_xx_start, next, stop, next, g_work_pass, g_work_symmetry);
+    }
+    if (added == 0)
+    {
+        write_record(g_work_list, g_num_work_list);
+    }
+    g_num_work_list = num_work;
+    std::copy(work, work + num_work, g_work_list);
+}
+
+// The current worklist entry is finished or interrupted, leaving the rest of
+// it on the worklist.  force records it whether or not a record is due.
+void checkpoint_work_done(bool force)
+{
+    if (!s_writer)
+    {
+        return;
+    }
+    if (s_rows_marked)
+    {
+        // an interrupted pass resumes part way along its next row
+        mark_rows(s_pass_row, std::min(s_pass_row + 1, g_i_y_stop));
+    }
+    else
+    {
+        mark_rows(g_yy_start, g_yy_stop);
+    }
+    s_rows_marked = false;
+    if (force || record_due())
+    {
+        write_record(g_work_list, g_num_work_list);
+    }
+}
+
+// Waits for the records made to be written and closes the file.
+void checkpoint_end()
+{
+    s_writer.reset();
+    s_dirty.clear();
+}
@@ -5,7 +5,10 @@
 
 #include "biginit.h"
 #include "calcfrac.h"
+#include "calcpool.h"
+#include "checkpoint.h"
 #include "cmdfiles.h"
+#include "density.h"
 #include "drivers.h"
 #include "fracsuba.h"
 #include "fracsubr.h"
@@ -23,6 +26,7 @@
 #include "lorenz.h"
 #include "miscovl.h"
 #include "miscres.h"
+#include "orbitsave.h"
 #include "os.h"
 #include "parser.h"
 #include "plot3d.h"
@@ -447,6 +451,7 @@ static void initvars_restart()          // <ins> key init
     g_init_batch = batch_modes::NONE;                      // not in batch mode
     g_check_cur_dir = false;                // flag to check current dire for files
     g_init_save_time = 0;                   // no auto-save
+    g_checkpoint_filename.clear();          // no checkpoint file
     g_init_mode = -1;                   // no initial video mode
     g_view_window = false;                 // no view window
     g_view_reduction = 4.2F;
@@ -459,6 +464,7 @@ static void initvars_restart()          // <ins> key init
     g_z_scroll = true;                     // relaxed screen scrolling
     g_orbit_delay = 0;                    // full speed orbits
     g_orbit_interval = 1;                 // plot all orbits
+    g_calc_threads = 1;                   // calculate on one thread
     g_debug_flag = debug_flags::none;      // debugging flag(s) are off
     g_timer_flag = false;                  // timer flags are off
     g_formula_filename = "fractint.frm";      // default formula file
@@ -538,6 +544,7 @@ static void initvars_fractal()          // init vars affecting calculation
     g_potential_16bit = false;
     g_potential_flag = false;
     g_log_map_flag = 0;                         // no logarithmic palette
+    g_density_gamma = 0.0;                      // no hit-count density
     set_trig_array(0, "sin");             // trigfn defaults
     set_trig_array(1, "sqr");
     set_trig_array(2, "sinh");
@@ -555,6 +562,8 @@ static void initvars_fractal()          // init vars affecting calculation
     g_color_cycle_range_hi = 255;      // color cycling default range
     g_orbit_delay = 0;                     // full speed orbits
     g_orbit_interval = 1;                  // plot all orbits
+    g_orbit_trajectories = 1;              // one trajectory at a time
+    g_orbit_rk4 = false;                   // stepped by Euler's method
     g_keep_screen_coords = false;
     g_draw_mode = 'r';                      // passes=orbits draw mode
     g_set_orbit_corners = false;
@@ -574,6 +583,7 @@ static void initvars_fractal()          // init vars affecting calculation
     g_old_demm_colors = false;
     g_bail_out_test    = bailouts::Mod;
     floatbailout  = fpMODbailout;
+    g_ctx.bailout = fpMODbailout;
     longbailout   = asmlMODbailout;
     bignumbailout = bnMODbailout;
     bigfltbailout = bfMODbailout;
@@ -1633,7 +1643,8 @@ int cmdarg(char *curarg, cmd_file mode) // process a single argument
         if (charval[0] != '1' && charval[0] != '2' && charval[0] != '3'
             && charval[0] != 'g' && charval[0] != 'b'
             && charval[0] != 't' && charval[0] != 's'
-            && charval[0] != 'd' && charval[0] != 'o')
+            && charval[0] != 'd' && charval[0] != 'o'
+            && charval[0] != 'm')
         {
             goto badarg;
         }
@@ -1780,6 +1791,16 @@ int cmdarg(char *curarg, cmd_file mode) // process a single argument
         return CMDARG_NONE;
     }
 
+    if (variable == "checkpoint")      // checkpoint=?
+    {
+        if (valuelen > (FILE_MAX_PATH-1))
+        {
+            goto badarg;
+        }
+        g_checkpoint_filename = value;
+        return CMDARG_NONE;
+    }
+
     if (variable == "tweaklzw")      // tweaklzw=?
     {
         // TODO: deprecated
@@ -2489,11 +2510,25 @@ int cmdarg(char *curarg, cmd_file mode) // process a single argument
 
     if (variable == "orbitsave")
     {
-        // orbitsave=?
+        // orbitsave=yes|no|sound|float|double[/delta]
+        g_orbit_save_format = orbit_save_format::text;
+        g_orbit_save_delta = false;
         if (charval[0] == 's')
         {
             g_orbit_save_flags |= osf_midi;
         }
+        else if (charval[0] == 'f' || charval[0] == 'd')
+        {
+            g_orbit_save_format = charval[0] == 'f' ? orbit_save_format::float32 : orbit_save_format::float64;
+            if (totparms > 1)
+            {
+                if (totparms > 2 || charval[1] != 'd')
+                {
+                    goto badarg;
+                }
+                g_orbit_save_delta = true;
+            }
+        }
         else if (yesnoval[0] < 0)
         {
             goto badarg;
@@ -2886,6 +2921,33 @@ int cmdarg(char *curarg, cmd_file mode) // process a single argument
         return CMDARG_FRACTAL_PARAM;
     }
 
+    if (variable == "threads")
+    {
+        if (numval == NONNUMERIC || numval < 0)
+        {
+            goto badarg;
+        }
+        g_calc_threads = numval;
+        return CMDARG_NONE;
+    }
+
+    if (variable == "density")      // density=no|yes|<gamma>
+    {
+        if (yesnoval[0] >= 0)
+        {
+            g_density_gamma = yesnoval[0];
+        }
+        else if (totparms == 1 && floatparms == 1 && floatval[0] > 0.0)
+        {
+            g_density_gamma = floatval[0];
+        }
+        else
+        {
+            goto badarg;
+        }
+        return CMDARG_FRACTAL_PARAM;
+    }
+
     if (variable == "orbitdelay")
     {
         g_orbit_delay = numval;
@@ -2906,6 +2968,28 @@ int cmdarg(char *curarg, cmd_file mode) // process a single argument
         return CMDARG_NONE;
     }
 
+    if (variable == "trajectories")     // trajectories=nnn[/euler|rk4]
+    {
+        if (numval == NONNUMERIC || numval < 1 || numval > 1000000 || totparms > 2)
+        {
+            goto badarg;
+        }
+        g_orbit_trajectories = numval;
+        g_orbit_rk4 = false;
+        if (totparms > 1)
+        {
+            if (charval[1] == 'r')
+            {
+                g_orbit_rk4 = true;
+            }
+            else if (charval[1] != 'e')
+            {
+                goto badarg;
+            }
+        }
+        return CMDARG_FRACTAL_PARAM;
+    }
+
     if (variable == "showdot")
     {
         g_show_dot = 15;
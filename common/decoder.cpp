@@ -19,11 +19,18 @@
 #include "port.h"
 #include "prototyp.h"
 
+#include "cmdfiles.h"
 #include "drivers.h"
 #include "gifview.h"
 #include "loadfile.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 static short get_next_code();
+static short decode_spans(short size, short linewidth);
 
 // extern short out_line(pixels, linelen)
 //     UBYTE pixels[];
@@ -159,6 +166,10 @@ short decoder(short linewidth)
     {
         return BAD_CODE_SIZE;
     }
+    if (g_debug_flag != debug_flags::force_old_decoder)
+    {
+        return decode_spans(size, linewidth);
+    }
 
     curr_size = (short)(size + 1);
     top_slot = (short)(1 << curr_size);
@@ -373,6 +384,300 @@ short decoder(short linewidth)
     return 0;
 }
 
+// decode_spans(size, linewidth)
+//
+// - A faster decoder for whole images, used unless debugflag=4040.  The data
+// blocks are read a large chunk at a time into one run of bytes, and the
+// codes are taken from a 64 bit window of it, several codes per refill.
+// Rather than a prefix list, the code table keeps where each string was
+// output: a new code is the string of the code before it plus the next
+// character, and that character follows it in the pixels.  So each code is
+// decoded with one copy from the pixels decoded since the clear code, and a
+// whole line is passed to out_line() as soon as it is complete.  If the table
+// fills and no clear code follows, only the table's strings are kept.  Bad
+// codes are handled like decoder() does.
+//
+
+namespace
+{
+
+// the data blocks of an image, read a chunk at a time
+class code_window
+{
+public:
+    code_window() :
+        bytes(CHUNK + 255 + 8, 0),
+        filled(0),
+        bit_pos(0),
+        at_end(false)
+    {
+    }
+
+    // next bits of the codes in the low bits of window, the number in count;
+    // false past the end of the data
+    bool next(std::uint64_t &window, int &count)
+    {
+        if (!at_end && (bit_pos >> 3) + 8 > filled)
+        {
+            refill();
+        }
+        std::size_t const end_pos = filled*8;
+        if (bit_pos >= end_pos)
+        {
+            return false;
+        }
+        BYTE const *p = &bytes[bit_pos >> 3];
+        window = (std::uint64_t) p[0]
+            | (std::uint64_t) p[1] << 8
+            | (std::uint64_t) p[2] << 16
+            | (std::uint64_t) p[3] << 24
+            | (std::uint64_t) p[4] << 32
+            | (std::uint64_t) p[5] << 40
+            | (std::uint64_t) p[6] << 48
+            | (std::uint64_t) p[7] << 56;
+        int const offset = static_cast<int>(bit_pos & 7);
+        window >>= offset;
+        count = static_cast<int>(std::min<std::size_t>(64 - offset, end_pos - bit_pos));
+        return true;
+    }
+
+    // the codes taken from the window
+    void consume(int bits)
+    {
+        bit_pos += bits;
+    }
+
+private:
+    enum
+    {
+        CHUNK = 1 << 16
+    };
+
+    void refill()
+    {
+        std::size_t const done = bit_pos >> 3;
+        std::memmove(&bytes[0], &bytes[done], filled - done);
+        filled -= done;
+        bit_pos &= 7;
+        while (filled < CHUNK)
+        {
+            int const count = get_byte();
+            if (count <= 0)
+            {
+                if (count == 0)
+                {
+                    unget_byte(count);  // gifview() reads the terminator
+                }
+                at_end = true;
+                break;
+            }
+            int const got = get_bytes(&bytes[filled], count);
+            filled += std::max(got, 0);
+            if (got != count)
+            {
+                at_end = true;
+                break;
+            }
+        }
+        std::fill(&bytes[filled], &bytes[filled] + 8, 0);
+    }
+
+    std::vector<BYTE> bytes;
+    std::size_t filled;
+    std::size_t bit_pos;
+    bool at_end;
+};
+
+} // namespace
+
+static short decode_spans(short size, short linewidth)
+{
+    std::size_t where[MAX_CODES + 1];   // position of each string in pixels
+    U16 length[MAX_CODES + 1];
+    short const clear = (short)(1 << size);
+    short const ending = (short)(clear + 1);
+    short const newcodes = (short)(ending + 1);
+    short curr_size = (short)(size + 1);
+    short top_slot = (short)(1 << curr_size);
+    short slot = newcodes;
+    int old_code = -1;                  // no code since the clear code
+    std::size_t old_where = 0;
+    int yskip = 0;
+    for (short i = 0; i < clear; i++)
+    {
+        length[i] = 1;
+    }
+
+    // the pixels decoded since the clear code, from the start of a line
+    std::vector<BYTE> pixels(std::max<std::size_t>(1 << 20, 4*(linewidth + MAX_CODES + 1)));
+    std::size_t fill = 0;
+    std::size_t line_start = 0;
+    std::size_t rebased = 0;            // fill after the last rebase
+    code_window codes;
+    std::uint64_t window = 0;
+    int count = 0;
+    while (true)
+    {
+        if (count < curr_size)
+        {
+            if (!codes.next(window, count) || count < curr_size)
+            {
+                return 0;               // ran out of data
+            }
+        }
+        int c = static_cast<int>(window & code_mask[curr_size]);
+        window >>= curr_size;
+        count -= curr_size;
+        codes.consume(curr_size);
+
+        if (c == ending)
+        {
+            break;
+        }
+        if (c == clear)
+        {
+            curr_size = (short)(size + 1);
+            top_slot = (short)(1 << curr_size);
+            slot = newcodes;
+            old_code = -1;
+            fill -= line_start;
+            std::memmove(&pixels[0], &pixels[line_start], fill);
+            line_start = 0;
+            rebased = 0;
+            continue;
+        }
+
+        if (pixels.size() < fill + MAX_CODES + 1)
+        {
+            if (fill - rebased > (1 << 20) && slot == MAX_CODES + 1)
+            {
+                // a full table and no clear code; keep only its strings
+                std::vector<BYTE> strings;
+                strings.reserve(1 << 20);
+                auto keep = [&pixels, &strings](std::size_t from, std::size_t len)
+                {
+                    std::size_t const pos = strings.size();
+                    strings.insert(strings.end(), &pixels[from], &pixels[from] + len);
+                    return pos;
+                };
+                for (int code = newcodes; code < slot; ++code)
+                {
+                    where[code] = keep(where[code], length[code]);
+                }
+                // the last string and the line so far end the pixels
+                std::size_t const tail = std::min(old_where, line_start);
+                std::size_t const pos = keep(tail, fill - tail);
+                old_where += pos - tail;
+                line_start += pos - tail;
+                fill = strings.size();
+                rebased = fill;
+                strings.resize(2*fill + MAX_CODES + 1);
+                pixels.swap(strings);
+            }
+            else
+            {
+                pixels.resize(2*pixels.size());
+            }
+        }
+
+        std::size_t const here = fill;
+        if (old_code < 0)
+        {
+            if (c >= slot)
+            {
+                c = 0;
+            }
+            pixels[fill++] = (BYTE) c;
+        }
+        else
+        {
+            int len;
+            if (c >= slot)
+            {
+                // the code being defined: the previous string and its first
+                // character
+                if (c > slot)
+                {
+                    ++bad_code_count;
+                }
+                len = length[old_code];
+                std::memcpy(&pixels[fill], &pixels[old_where], len);
+                pixels[fill + len] = pixels[old_where];
+                ++len;
+                c = slot < top_slot ? slot : old_code;
+            }
+            else if (c < clear)
+            {
+                len = 1;
+                pixels[fill] = (BYTE) c;
+            }
+            else
+            {
+                len = length[c];
+                BYTE const *from = &pixels[where[c]];
+                BYTE *to = &pixels[fill];
+                if (len <= 16)
+                {
+                    BYTE run[16];       // copy short strings as a block
+                    std::memcpy(run, from, sizeof(run));
+                    std::memcpy(to, run, sizeof(run));
+                }
+                else
+                {
+                    std::memcpy(to, from, len);
+                }
+            }
+            fill += len;
+            if (slot < top_slot)
+            {
+                where[slot] = old_where;
+                length[slot] = (U16)(length[old_code] + 1);
+                slot++;
+            }
+            if (slot >= top_slot && curr_size < 12)
+            {
+                top_slot <<= 1;
+                ++curr_size;
+            }
+        }
+        old_code = c;
+        old_where = here;
+
+        while (fill - line_start >= (std::size_t) linewidth)       // finished an input row?
+        {
+            if (--yskip < 0)
+            {
+                int len = linewidth;
+                BYTE const *line = &pixels[line_start];
+                if (g_skip_x_dots > 0)
+                {
+                    len = 0;
+                    for (int x = 0; x < linewidth; x += g_skip_x_dots + 1)
+                    {
+                        decoderline[len++] = line[x];
+                    }
+                }
+                else
+                {
+                    std::memcpy(decoderline, line, len);
+                }
+                int const ret = (*g_out_line)(decoderline, len);
+                if (ret < 0)
+                {
+                    return (short) ret;
+                }
+                yskip = g_skip_y_dots;
+            }
+            if (driver_key_pressed())
+            {
+                return -1;
+            }
+            line_start += linewidth;
+        }
+    }
+    return 0;
+}
+
 // get_next_code()
 // - gets the next code from the GIF file.  Returns the code, or else
 // a negative number in case of file errors...
@@ -0,0 +1,201 @@
+// Hit counts for the orbit and IFS types, kept off the screen.
+//
+// With density= on, the float orbit engines and the IFS count the hits on
+// each pixel in a 32 bit counter of their own instead of stepping the color
+// of the pixel on the screen, so the counts neither wrap nor stick at the
+// last color, and no point costs a trip through the driver.  The counters
+// are kept in 16x16 tiles, so the hits of an orbit, which tend to land near
+// each other, share cache lines.
+//
+// The screen shows the counts through a log curve, brightened by the gamma
+// given with density=.  The mapping is only done now and then while the
+// image is calculated, and once more when the engine returns, so the image
+// saved is the one mapped from the final counts.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "density.h"
+#include "id_data.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+double g_density_gamma = 0.0;
+
+namespace
+{
+int const TILE_SHIFT = 4;                       // tiles of 16x16 counters
+int const TILE_MASK = (1 << TILE_SHIFT) - 1;
+unsigned long const HITS_PER_CHECK = 1UL << 20; // hits between looks at the clock
+std::size_t const TABLE_SIZE = 1U << 16;        // counts with their color tabulated
+
+std::vector<std::atomic<std::uint32_t>> s_counts;
+bool s_active = false;
+int s_width = 0;
+int s_height = 0;
+int s_tiles_across = 0;
+unsigned long s_hits = 0;
+std::chrono::steady_clock::time_point s_last_show;
+std::chrono::steady_clock::duration s_show_interval;
+}
+
+static std::size_t density_index(int x, int y)
+{
+    return ((std::size_t) ((y >> TILE_SHIFT)*s_tiles_across + (x >> TILE_SHIFT)) << (2*TILE_SHIFT))
+        + ((y & TILE_MASK) << TILE_SHIFT) + (x & TILE_MASK);
+}
+
+// Start counting hits on a cleared logical screen, unless the counts for this
+// image were already started.  Returns false, and the engine draws as it
+// always has, if density= is off or there's no memory for the counts.
+bool density_start()
+{
+    if (s_active)
+    {
+        return true;
+    }
+    if (g_density_gamma <= 0.0)
+    {
+        return false;
+    }
+    s_width = g_logical_screen_x_dots;
+    s_height = g_logical_screen_y_dots;
+    s_tiles_across = (s_width + TILE_MASK) >> TILE_SHIFT;
+    int const tiles_down = (s_height + TILE_MASK) >> TILE_SHIFT;
+    try
+    {
+        std::vector<std::atomic<std::uint32_t>>(
+            (std::size_t) s_tiles_across*tiles_down << (2*TILE_SHIFT)).swap(s_counts);
+    }
+    catch (std::bad_alloc const &)
+    {
+        std::vector<std::atomic<std::uint32_t>>().swap(s_counts);
+        return false;
+    }
+    s_hits = 0;
+    s_last_show = std::chrono::steady_clock::now();
+    s_show_interval = std::chrono::milliseconds(500);
+    s_active = true;
+    return true;
+}
+
+// Count a hit from the calling thread, the only one counting.
+void density_hit(int x, int y)
+{
+    if ((unsigned) x >= (unsigned) s_width || (unsigned) y >= (unsigned) s_height)
+    {
+        return;
+    }
+    std::atomic<std::uint32_t> &count = s_counts[density_index(x, y)];
+    std::uint32_t const n = count.load(std::memory_order_relaxed);
+    if (n != UINT32_MAX)
+    {
+        count.store(n + 1, std::memory_order_relaxed);
+    }
+    if (++s_hits >= HITS_PER_CHECK)
+    {
+        s_hits = 0;
+        density_update();
+    }
+}
+
+// Count a hit from one of several threads counting at once.  These never
+// show the counts; the thread that started them calls density_update().
+void density_hit_shared(int x, int y)
+{
+    if ((unsigned) x >= (unsigned) s_width || (unsigned) y >= (unsigned) s_height)
+    {
+        return;
+    }
+    std::atomic<std::uint32_t> &count = s_counts[density_index(x, y)];
+    if (count.load(std::memory_order_relaxed) != UINT32_MAX)
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// a g_plot for engines that plot with a count in mind
+void density_plot(int x, int y, int /*color*/)
+{
+    density_hit(x, y);
+}
+
+// Show the counts if it's been a while.  The while is at least half a
+// second, and ten times as long as the last showing took, so a big screen
+// doesn't spend its time being redrawn.
+void density_update()
+{
+    if (std::chrono::steady_clock::now() - s_last_show >= s_show_interval)
+    {
+        density_show();
+    }
+}
+
+// Map the counts onto the screen.  The highest count gets the last color and
+// a single hit the first after the background, with the log of the counts
+// raised to 1/gamma in between.
+void density_show()
+{
+    if (!s_active)
+    {
+        return;
+    }
+    auto const start = std::chrono::steady_clock::now();
+    std::uint32_t most = 0;
+    for (std::atomic<std::uint32_t> const &count : s_counts)
+    {
+        most = std::max(most, count.load(std::memory_order_relaxed));
+    }
+    double const scale = most > 1 ? 1.0/std::log1p((double) most) : 1.0;
+    double const exponent = 1.0/g_density_gamma;
+    int const span = std::max(g_colors - 2, 0);
+    auto const color = [=](std::uint32_t n)
+    {
+        if (n == 0)
+        {
+            return (BYTE) 0;
+        }
+        double const level = std::pow(std::log1p((double) n)*scale, exponent);
+        return (BYTE) (1 + std::min((int) (level*span + 0.5), span));
+    };
+    std::vector<BYTE> table(std::min<std::size_t>(TABLE_SIZE, (std::size_t) most + 1));
+    for (std::size_t n = 0; n < table.size(); ++n)
+    {
+        table[n] = color((std::uint32_t) n);
+    }
+    std::vector<BYTE> line(s_width);
+    for (int y = 0; y < s_height; ++y)
+    {
+        std::size_t const row_start = density_index(0, y);
+        for (int x = 0; x < s_width; ++x)
+        {
+            std::size_t const tile = (std::size_t) (x >> TILE_SHIFT) << (2*TILE_SHIFT);
+            std::uint32_t const n = s_counts[row_start + tile + (x & TILE_MASK)].load(std::memory_order_relaxed);
+            line[x] = n < table.size() ? table[n] : color(n);
+        }
+        put_line(y, 0, s_width - 1, line.data());
+    }
+    s_last_show = std::chrono::steady_clock::now();
+    s_show_interval = std::max<std::chrono::steady_clock::duration>(
+        std::chrono::milliseconds(500), 10*(s_last_show - start));
+}
+
+// Show the final counts and let them go.  Called once the engine returns,
+// whether it used the counts or not.  Returns true if it did.
+bool density_end()
+{
+    if (!s_active)
+    {
+        return false;
+    }
+    density_show();
+    s_active = false;
+    std::vector<std::atomic<std::uint32_t>>().swap(s_counts);
+    return true;
+}
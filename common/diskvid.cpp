@@ -1,6 +1,16 @@
 //
 // "Disk-Video" routines
 //
+// The 'screen' is one byte per pixel in tiles of 256 x 256 pixels (fewer
+// rows when the 'screen' isn't that tall), so that pixels near each other
+// down the screen are near each other in memory too.  Tiles are addressed
+// with 64 bit offsets and only allocated when first written; one that
+// never is costs nothing and reads as 0.  Where the system can map it, the
+// tiles are in a sparse temporary file that the system pages in and out.
+//
+// A targa file is kept row by row in place, after its header, where the
+// system can map it.  Otherwise it's written through a cache.
+//
 // Caution when modifying any code in here:  bugs are possible which
 // slow the cache substantially but don't cause incorrect results.
 // Do timing tests for a variety of situations after any change.
@@ -16,8 +26,12 @@
 #include "memory.h"
 #include "realdos.h"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 #include <vector>
 
 #define BOXROW   6
@@ -63,12 +77,28 @@ static int headerlength;
 static int rowsize = 0;   // doubles as a disk video not ok flag
 static int colsize;       // sydots, *2 when pot16bit
 
+#define TILESHIFT 8     // tiles are 1 << TILESHIFT pixels across
+#define TILEWIDTH (1 << TILESHIFT)
+
+static bool tiled = false;              // pixels in tiles, not targa
+static std::vector<std::unique_ptr<BYTE[]>> tiles; // by tile row then column, until written
+static BYTE *tile_map = nullptr;        // all the tiles mapped, instead of allocated
+static int tile_rowshift;               // tiles are 1 << tile_rowshift pixels down
+static int tiles_across;
+static std::size_t cur_tile_base;       // index of the first tile of cur_row
+static int cur_tile_row_offset;         // offset of cur_row within its tiles
+
 static std::vector<BYTE> membuf;
+static BYTE *mapped_pixels = nullptr;  // targa pixels in place, nullptr to use the cache
 static U16 dv_handle = 0;
 static long memoffset = 0;
 static long oldmemoffset = 0;
 static BYTE *membufptr;
 
+static BYTE *map_pixels(std::int64_t);
+static void start_tiles(long, long);
+static BYTE *find_tile(std::size_t, bool);
+static void tile_span(int, int, int, BYTE *, bool);
 static void findload_cache(long);
 static cache *find_cache(long);
 static void  write_cache_lru();
@@ -180,6 +210,50 @@ int common_startdisk(long newrowsize, long newcolsize, int colors)
     }
     timetodisplay = bf_math != bf_math_type::NONE ? 10 : 1000;  // time-to-g_driver-status counter
 
+    membuf.resize(BLOCKLEN);
+    if (g_disk_targa)
+    {
+        // Retrieve the header information first
+        fseek(fp, 0L, SEEK_SET);
+        for (int i = 0; i < headerlength; i++)
+        {
+            membuf[i] = (BYTE)fgetc(fp);
+        }
+        std::fclose(fp);
+        fp = nullptr;
+    }
+
+    if (!g_disk_targa)
+    {
+        start_tiles(newrowsize, newcolsize);
+        if (driver_diskp())
+        {
+            char buf[50];
+            std::snprintf(buf, NUM_OF(buf), "Pixels in tiles of %d x %d", TILEWIDTH, 1 << tile_rowshift);
+            driver_put_string(BOXROW+6, BOXCOL+4, C_DVID_LO, buf);
+            driver_put_string(BOXROW+2, BOXCOL+23, C_DVID_LO,
+                              (tile_map != nullptr && MemoryType(dv_handle) == DISK) ? "Using your Disk Drive" : "Using your memory");
+            dvid_status(0, "");
+        }
+        return 0;
+    }
+
+    mapped_pixels = map_pixels((std::int64_t) newrowsize*newcolsize);
+    if (mapped_pixels != nullptr)
+    {
+        g_disk_flag = true;
+        rowsize = (unsigned int) newrowsize;
+        colsize = (unsigned int) newcolsize;
+        if (driver_diskp())
+        {
+            driver_put_string(BOXROW+6, BOXCOL+4, C_DVID_LO, "Pixels mapped in place");
+            driver_put_string(BOXROW+2, BOXCOL+23, C_DVID_LO,
+                              (MemoryType(dv_handle) == DISK) ? "Using your Disk Drive" : "Using your memory");
+            dvid_status(0, "");
+        }
+        return 0;
+    }
+
     cache_size = CACHEMAX;
     longtmp = (long)cache_size << 10;
     cache_start = (cache *)malloc(longtmp);
@@ -189,7 +263,6 @@ int common_startdisk(long newrowsize, long newcolsize, int colors)
     }
     cache_lru = cache_start;
     cache_end = cache_lru + longtmp/sizeof(*cache_start);
-    membuf.resize(BLOCKLEN);
     if (cache_start == nullptr)
     {
         stopmsg(STOPMSG_NONE,
@@ -232,21 +305,7 @@ int common_startdisk(long newrowsize, long newcolsize, int colors)
     rowsize = (unsigned int) newrowsize;
     colsize = (unsigned int) newcolsize;
 
-    if (g_disk_targa)
-    {
-        // Retrieve the header information first
-        fseek(fp, 0L, SEEK_SET);
-        for (int i = 0; i < headerlength; i++)
-        {
-            membuf[i] = (BYTE)fgetc(fp);
-        }
-        std::fclose(fp);
-        dv_handle = MemoryAlloc((U16)BLOCKLEN, memorysize, DISK);
-    }
-    else
-    {
-        dv_handle = MemoryAlloc((U16)BLOCKLEN, memorysize, MEMORY);
-    }
+    dv_handle = MemoryAlloc((U16)BLOCKLEN, memorysize, DISK);
     if (dv_handle == 0)
     {
         stopmsg(STOPMSG_NONE, "*** insufficient free memory/disk space ***");
@@ -263,54 +322,135 @@ int common_startdisk(long newrowsize, long newcolsize, int colors)
 
     membufptr = &membuf[0];
 
+    // Put header information in the file
+    CopyFromMemoryToHandle(&membuf[0], (U16)headerlength, 1L, 0, dv_handle);
+
+    if (driver_diskp())
+    {
+        dvid_status(0, "");
+    }
+    return 0;
+}
+
+// Allocate and map memory for bytes bytes after headerlength bytes of
+// header, which it is set up with.  Returns a pointer to the first byte
+// after the header, or nullptr if the memory can't be mapped.
+static BYTE *map_pixels(std::int64_t bytes)
+{
+    std::int64_t const blocks = (bytes + headerlength + BLOCKLEN - 1) >> BLOCKSHIFT;
+    if (blocks > LONG_MAX/BLOCKLEN)
+    {
+        return nullptr;
+    }
+    dv_handle = MemoryAlloc((U16)BLOCKLEN, (long) blocks, DISK);
+    if (dv_handle == 0)
+    {
+        return nullptr;
+    }
+    BYTE *start = MemoryMap(dv_handle);
+    if (start == nullptr)
+    {
+        MemoryRelease(dv_handle);
+        dv_handle = 0;
+        return nullptr;
+    }
     if (g_disk_targa)
     {
-        // Put header information in the file
-        CopyFromMemoryToHandle(&membuf[0], (U16)headerlength, 1L, 0, dv_handle);
+        std::memcpy(start, &membuf[0], headerlength);
     }
-    else
+    else if (MemoryType(dv_handle) == MEMORY) // a new disk file is already zeros
     {
-        for (long offset = 0; offset < memorysize; offset++)
-        {
-            SetMemory(0, (U16)BLOCKLEN, 1L, offset, dv_handle);
-            if (driver_key_pressed())           // user interrupt
-            {
-                // esc to cancel, else continue
-                if (stopmsg(STOPMSG_CANCEL, "Disk Video initialization interrupted:\n"))
-                {
-                    enddisk();
-                    g_good_mode = false;
-                    return -2;            // -1 == failed, -2 == cancel
-                }
-            }
-        }
+        std::memset(start, 0, (std::size_t) blocks << BLOCKSHIFT);
     }
+    return start + headerlength;
+}
 
-    if (driver_diskp())
+// Set up the tiles for a newrowsize x newcolsize 'screen', in a mapping if
+// there can be one and otherwise to be allocated as they're written.
+static void start_tiles(long newrowsize, long newcolsize)
+{
+    tile_rowshift = 0;
+    while (tile_rowshift < TILESHIFT && (1L << tile_rowshift) < newcolsize)
     {
-        dvid_status(0, "");
+        ++tile_rowshift;
+    }
+    tiles_across = (int)((newrowsize + TILEWIDTH - 1) >> TILESHIFT);
+    long const tiles_down = (newcolsize + (1L << tile_rowshift) - 1) >> tile_rowshift;
+    std::size_t const count = (std::size_t) tiles_across*tiles_down;
+    tile_map = map_pixels((std::int64_t) count << (TILESHIFT + tile_rowshift));
+    if (tile_map == nullptr)
+    {
+        tiles.resize(count);
+    }
+    tiled = true;
+    g_disk_flag = true;
+    rowsize = (unsigned int) newrowsize;
+    colsize = (unsigned int) newcolsize;
+}
+
+// the tile at index, nullptr if it hasn't been written unless write
+static BYTE *find_tile(std::size_t index, bool write)
+{
+    if (tile_map != nullptr)
+    {
+        return tile_map + ((std::int64_t) index << (TILESHIFT + tile_rowshift));
+    }
+    if (tiles[index] == nullptr && write)
+    {
+        tiles[index].reset(new BYTE[(std::size_t) 1 << (TILESHIFT + tile_rowshift)]());
+    }
+    return tiles[index].get();
+}
+
+// Copy pixels col through lastcol of row, which are on the 'screen', to
+// pixels, or from them if write.
+static void tile_span(int row, int col, int lastcol, BYTE *pixels, bool write)
+{
+    std::size_t const base = (std::size_t)(row >> tile_rowshift)*tiles_across;
+    int const row_offset = (row & ((1 << tile_rowshift) - 1)) << TILESHIFT;
+    while (col <= lastcol)
+    {
+        int const count = std::min(lastcol, col | (TILEWIDTH - 1)) - col + 1;
+        BYTE *tile = find_tile(base + (col >> TILESHIFT), write);
+        if (tile == nullptr)
+        {
+            std::memset(pixels, 0, count);
+        }
+        else if (write)
+        {
+            std::memcpy(&tile[row_offset + (col & (TILEWIDTH - 1))], pixels, count);
+        }
+        else
+        {
+            std::memcpy(pixels, &tile[row_offset + (col & (TILEWIDTH - 1))], count);
+        }
+        pixels += count;
+        col += count;
     }
-    return 0;
 }
 
 void enddisk()
 {
-    if (fp != nullptr)
+    if (g_disk_targa && cache_start != nullptr) // flush the cache
     {
-        if (g_disk_targa) // flush the cache
+        for (cache_lru = cache_start; cache_lru < cache_end; ++cache_lru)
         {
-            for (cache_lru = cache_start; cache_lru < cache_end; ++cache_lru)
+            if (cache_lru->dirty)
             {
-                if (cache_lru->dirty)
-                {
-                    write_cache_lru();
-                }
+                write_cache_lru();
             }
         }
+    }
+    if (fp != nullptr)
+    {
         std::fclose(fp);
         fp = nullptr;
     }
 
+    mapped_pixels = nullptr;
+    tile_map = nullptr;
+    tiles.clear();
+    tiled = false;
     if (dv_handle != 0)
     {
         MemoryRelease(dv_handle);
@@ -351,18 +491,29 @@ int readdisk(int col, int row)
     }
     if (row != cur_row) // try to avoid ghastly code generated for multiply
     {
-        if (row >= colsize) // while we're at it avoid this test if not needed
+        if (row < 0 || row >= colsize) // while we're at it avoid this test if not needed
         {
             return 0;
         }
         cur_row = row;
         cur_row_base = (long) cur_row * rowsize;
+        cur_tile_base = (std::size_t)(cur_row >> tile_rowshift)*tiles_across;
+        cur_tile_row_offset = (cur_row & ((1 << tile_rowshift) - 1)) << TILESHIFT;
     }
-    if (col >= rowsize)
+    if (col < 0 || col >= rowsize)
     {
         return 0;
     }
+    if (tiled)
+    {
+        BYTE const *tile = find_tile(cur_tile_base + (col >> TILESHIFT), false);
+        return tile == nullptr ? 0 : tile[cur_tile_row_offset + (col & (TILEWIDTH - 1))];
+    }
     offset = cur_row_base + col;
+    if (mapped_pixels != nullptr)
+    {
+        return mapped_pixels[offset];
+    }
     col_subscr = (short) offset & (BLOCKLEN-1); // offset within cache entry
     if (cur_offset != (offset & (0L-BLOCKLEN))) // same entry as last ref?
     {
@@ -373,6 +524,25 @@ int readdisk(int col, int row)
 
 int FromMemDisk(long offset, int size, void *dest)
 {
+    if (tiled)
+    {
+        if (offset < 0 || offset % rowsize + size > rowsize || offset / rowsize >= colsize)
+        {
+            return 0;
+        }
+        tile_span((int)(offset / rowsize), (int)(offset % rowsize), (int)(offset % rowsize) + size - 1,
+                  (BYTE *) dest, false);
+        return 1;
+    }
+    if (mapped_pixels != nullptr)
+    {
+        if (offset < 0 || offset + size > (long) rowsize*colsize)
+        {
+            return 0;
+        }
+        std::memcpy(dest, &mapped_pixels[offset], size);
+        return 1;
+    }
     int col_subscr = (int)(offset & (BLOCKLEN - 1));
     if (col_subscr + size > BLOCKLEN)            // access violates  a
     {
@@ -414,18 +584,30 @@ void writedisk(int col, int row, int color)
     }
     if (row != (unsigned int) cur_row)     // try to avoid ghastly code generated for multiply
     {
-        if (row >= colsize) // while we're at it avoid this test if not needed
+        if (row < 0 || row >= colsize) // while we're at it avoid this test if not needed
         {
             return;
         }
         cur_row = row;
         cur_row_base = (long) cur_row*rowsize;
+        cur_tile_base = (std::size_t)(cur_row >> tile_rowshift)*tiles_across;
+        cur_tile_row_offset = (cur_row & ((1 << tile_rowshift) - 1)) << TILESHIFT;
     }
-    if (col >= rowsize)
+    if (col < 0 || col >= rowsize)
     {
         return;
     }
+    if (tiled)
+    {
+        find_tile(cur_tile_base + (col >> TILESHIFT), true)[cur_tile_row_offset + (col & (TILEWIDTH - 1))] = (BYTE) color;
+        return;
+    }
     offset = cur_row_base + col;
+    if (mapped_pixels != nullptr)
+    {
+        mapped_pixels[offset] = (BYTE) color;
+        return;
+    }
     col_subscr = (short) offset & (BLOCKLEN-1);
     if (cur_offset != (offset & (0L-BLOCKLEN))) // same entry as last ref?
     {
@@ -440,6 +622,25 @@ void writedisk(int col, int row, int color)
 
 bool ToMemDisk(long offset, int size, void *src)
 {
+    if (tiled)
+    {
+        if (offset < 0 || offset % rowsize + size > rowsize || offset / rowsize >= colsize)
+        {
+            return false;
+        }
+        tile_span((int)(offset / rowsize), (int)(offset % rowsize), (int)(offset % rowsize) + size - 1,
+                  (BYTE *) src, true);
+        return true;
+    }
+    if (mapped_pixels != nullptr)
+    {
+        if (offset < 0 || offset + size > (long) rowsize*colsize)
+        {
+            return false;
+        }
+        std::memcpy(&mapped_pixels[offset], src, size);
+        return true;
+    }
     int col_subscr = (int)(offset & (BLOCKLEN - 1));
 
     if (col_subscr + size > BLOCKLEN)           // access violates  a
@@ -465,6 +666,77 @@ void targa_writedisk(unsigned int col, unsigned int row,
     writedisk(col+1, row, red);
 }
 
+// the part of row from col to lastcol that is on the 'screen', returning
+// false if there's none of it
+static bool clip_span(int row, int col, int &lastcol)
+{
+    if (row < 0 || row >= colsize || col < 0)
+    {
+        return false;
+    }
+    if (lastcol >= rowsize)
+    {
+        lastcol = rowsize - 1;
+    }
+    return col <= lastcol;
+}
+
+// read pixels col through lastcol of row, as readdisk() would each
+void readdisk_span(int row, int col, int lastcol, BYTE *pixels)
+{
+    int last = lastcol;
+    if ((!tiled && mapped_pixels == nullptr) || !clip_span(row, col, last))
+    {
+        for (int i = 0; col + i <= lastcol; ++i)
+        {
+            pixels[i] = (BYTE) readdisk(col + i, row);
+        }
+        return;
+    }
+    if (tiled)
+    {
+        tile_span(row, col, last, pixels, false);
+    }
+    else
+    {
+        std::memcpy(pixels, &mapped_pixels[(long) row*rowsize + col], last - col + 1);
+    }
+    if (last < lastcol)
+    {
+        std::memset(&pixels[last - col + 1], 0, lastcol - last);
+    }
+}
+
+// write pixels col through lastcol of row, as writedisk() would each
+void writedisk_span(int row, int col, int lastcol, BYTE const *pixels)
+{
+    if ((!tiled && mapped_pixels == nullptr) || !clip_span(row, col, lastcol))
+    {
+        for (int i = 0; col + i <= lastcol; ++i)
+        {
+            writedisk(col + i, row, pixels[i]);
+        }
+        return;
+    }
+    timetodisplay -= lastcol - col + 1;
+    if (timetodisplay < 0 && driver_diskp())
+    {
+        char buf[41];
+        std::snprintf(buf, NUM_OF(buf), " writing line %4d",
+                (row >= g_screen_y_dots) ? row-g_screen_y_dots : row); // adjust when potfile
+        dvid_status(0, buf);
+        timetodisplay = 1000;
+    }
+    if (tiled)
+    {
+        tile_span(row, col, lastcol, const_cast<BYTE *>(pixels), true);
+    }
+    else
+    {
+        std::memcpy(&mapped_pixels[(long) row*rowsize + col], pixels, lastcol - col + 1);
+    }
+}
+
 static void findload_cache(long offset) // used by read/write
 {
     unsigned int tbloffset;
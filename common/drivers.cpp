@@ -8,6 +8,7 @@
 
 #include <cstring>
 
+extern Driver *headless_driver;
 extern Driver *x11_driver;
 extern Driver *gdi_driver;
 extern Driver *disk_driver;
@@ -45,6 +46,10 @@ load_driver(Driver *drv, int *argc, char **argv)
 //
 int init_drivers(int *argc, char **argv)
 {
+#if HAVE_HEADLESS_DRIVER
+    load_driver(headless_driver, argc, argv);
+#endif
+
 #if HAVE_X11_DRIVER
     load_driver(x11_driver, argc, argv);
 #endif
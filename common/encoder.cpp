@@ -5,6 +5,7 @@
 #include "prototyp.h"
 
 #include "calcfrac.h"
+#include "calcpool.h"
 #include "cmdfiles.h"
 #include "diskvid.h"
 #include "drivers.h"
@@ -31,17 +32,25 @@
 #include "slideshw.h"
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
+static void bit_sizes(BYTE &bitsperpixel, int &start_bits);
 static bool compress(int rowlimit);
 static int shftwrite(BYTE const *color, int numcolors);
 static int extend_blk_len(int datalen);
 static int put_extend_blk(int block_id, int block_len, char const *block_data);
 static int store_item_name(char const *name);
-static void setup_save_info(FRACTAL_INFO *save_info);
 
 //                        Save-To-Disk Routines (GIF)
 //
@@ -56,12 +65,12 @@ static void setup_save_info(FRACTAL_INFO *save_info);
 //
 // MEMORY ALLOCATION
 //
-// There are two large arrays:
+// Each strip being compressed has two arrays:
 //
-//    long htab[HSIZE]              (5003*4 = 20012 bytes)
+//    long htab[HSIZE]              (5003*8 = 40024 bytes, 20012 with 32 bit longs)
 //    unsigned short codetab[HSIZE] (5003*2 = 10006 bytes)
 //
-// At the moment these arrays reuse extraseg and strlocn, respectively.
+// plus its rows and codes, about a megabyte each with more than one thread.
 //
 //
 
@@ -348,30 +357,7 @@ bool encoder()
 
     setup_save_info(&save_info);
 
-#ifndef XFRACT
-    bitsperpixel = 0;            // calculate bits / pixel
-    for (int i = g_colors; i >= 2; i /= 2)
-    {
-        bitsperpixel++;
-    }
-
-    startbits = bitsperpixel + 1;// start coding with this many bits
-    if (g_colors == 2)
-    {
-        startbits++;    // B&W Klooge
-    }
-#else
-    if (g_colors == 2)
-    {
-        bitsperpixel = 1;
-        startbits = 3;
-    }
-    else
-    {
-        bitsperpixel = 8;
-        startbits = 9;
-    }
-#endif
+    bit_sizes(bitsperpixel, startbits);
 
     int i = 0;
     if (g_gif87a_flag)
@@ -400,6 +386,11 @@ bool encoder()
         rowlimit <<= 1;
         width <<= 1;
     }
+    if (width > 0xffff || g_logical_screen_y_dots > 0xffff)
+    {
+        stopmsg(STOPMSG_NONE, "A GIF image can't be more than 65535 pixels across or down");
+        return true;
+    }
     if (write2(&width, 2, 1, g_outfile) != 1)
     {
         goto oops;                // screen descriptor
@@ -843,7 +834,7 @@ static int store_item_name(char const *nameptr)
     return extend_blk_len(sizeof(fsave_info));
 }
 
-static void setup_save_info(FRACTAL_INFO *save_info)
+void setup_save_info(FRACTAL_INFO *save_info)
 {
     if (g_fractal_type != fractal_type::FORMULA && g_fractal_type != fractal_type::FFORMULA)
     {
@@ -1037,41 +1028,12 @@ static void setup_save_info(FRACTAL_INFO *save_info)
 //              Joe Orost               (decvax!vax135!petsd!joe)
 //
 
-// prototypes
-
-static void output(int code);
-static void char_out(int c);
-static void flush_char();
-static void cl_block();
-
-static int n_bits;                        // number of bits/code
 static int maxbits = BITSF;                // user settable max # bits/code
-static int maxcode;                  // maximum code, given n_bits
 static int maxmaxcode = (int)1 << BITSF; // should NEVER generate this code
 # define MAXCODE(n_bits)        (((int) 1 << (n_bits)) - 1)
 
 BYTE g_block[4096] = { 0 };
 
-static long htab[HSIZE];
-static unsigned short codetab[10240] = { 0 };
-
-// To save much memory, we overlay the table used by compress() with those
-// used by decompress().  The tab_prefix table is the same size and type
-// as the codetab.  The tab_suffix table needs 2**BITSF characters.  We
-// get this from the beginning of htab.  The output stack uses the rest
-// of htab, and contains characters.  There is plenty of room for any
-// possible stack (stack used to be 8000 characters).
-
-#define tab_prefixof(i)   codetab[i]
-#define tab_suffixof(i)   ((char_type *)(htab))[i]
-#define de_stack          ((char_type *)&tab_suffixof((int)1 << BITSF))
-
-static int free_ent;                  // first unused entry
-
-// block compression parameters -- after all codes are used up,
-// and compression rate changes, start over.
-static bool clear_flg = false;
-
 //
 // compress stdin to stdout
 //
@@ -1087,182 +1049,159 @@ static bool clear_flg = false;
 // file size for noticeable speed improvement on small files.  Please direct
 // questions about this implementation to ames!jaw.
 //
-
-static int ClearCode;
-static int EOFCode;
-static int a_count; // Number of characters so far in this 'packet'
-static unsigned long cur_accum = 0;
-static int  cur_bits = 0;
-
-//
-// Define the storage for the packet accumulator
+// The image is compressed in strips of rows, each with its own code table.
+// A strip ends with a CLEAR code, which the next strip's table starts from,
+// or with the EOF code if it is the last one; the first one starts with a
+// CLEAR code.  The strips' codes, joined bit to bit, are a single GIF image.
+// With one calc thread the whole image is one strip and is compressed a row
+// at a time as it is read.  With more, strips of about a million pixels are
+// compressed on worker threads, and a batch save can start on the rows of
+// the final pass of a 1 or 2 pass calculation while it is still running.
 //
-static char accum[256];
 
-static bool compress(int rowlimit)
+namespace
 {
-    int outcolor1, outcolor2;
-    int ent;
-    int disp;
-    int hsize_reg;
-    int hshift;
-    int color;
-    int in_count = 0;
-    bool interrupted = false;
-    int tempkey;
-
-    outcolor1 = 0;               // use these colors to show progress
-    outcolor2 = 1;               // (this has nothing to do with GIF)
 
-    if (g_colors > 2)
-    {
-        outcolor1 = 2;
-        outcolor2 = 3;
-    }
-    if (((++numsaves) & 1) == 0)
-    {
-        // reverse the colors on alt saves
-        int i = outcolor1;
-        outcolor1 = outcolor2;
-        outcolor2 = i;
-    }
-    outcolor1s = outcolor1;
-    outcolor2s = outcolor2;
-
-    // Set up the necessary values
-    cur_accum = 0;
-    cur_bits = 0;
-    clear_flg = false;
-    ent = 0;
-    n_bits = startbits;
-    maxcode = MAXCODE(n_bits);
-
-    ClearCode = (1 << (startbits - 1));
-    EOFCode = ClearCode + 1;
-    free_ent = ClearCode + 2;
+// The codes for a strip of rows.
+class lzw_strip
+{
+public:
+    lzw_strip(int start_bits, bool first);
+
+    void compress(BYTE const *pixels, int count);
+    void finish(bool last);
+
+    std::vector<BYTE> bytes;            // the codes, packed low bits first
+    unsigned long accum;                // the bits past the last whole byte
+    int bits;
+
+private:
+    void output(int code);
+
+    std::vector<long> htab;
+    std::vector<unsigned short> codetab;
+    int start_bits;
+    int n_bits;                         // number of bits/code
+    int maxcode;                        // maximum code, given n_bits
+    int free_ent;                       // first unused entry
+    bool clear_flg;                     // block compression parameters -- after all codes are used up,
+                                        // and compression rate changes, start over.
+    int clear_code;
+    int eof_code;
+    int hshift;
+    int ent;
+    bool started;                       // ent holds a pixel
+};
 
-    a_count = 0;
-    hshift = 0;
+lzw_strip::lzw_strip(int start_bits_, bool first) :
+    accum(0),
+    bits(0),
+    htab(HSIZE, -1L),
+    codetab(HSIZE, 0),
+    start_bits(start_bits_),
+    n_bits(start_bits_),
+    maxcode(MAXCODE(start_bits_)),
+    clear_flg(false),
+    clear_code(1 << (start_bits_ - 1)),
+    eof_code((1 << (start_bits_ - 1)) + 1),
+    hshift(0),
+    ent(0),
+    started(false)
+{
+    free_ent = clear_code + 2;
     for (long fcode = (long) HSIZE;  fcode < 65536L; fcode *= 2L)
     {
         hshift++;
     }
     hshift = 8 - hshift;                // set hash code range bound
+    if (first)
+    {
+        output(clear_code);
+    }
+}
 
-    std::memset(htab, 0xff, (unsigned)HSIZE*sizeof(long));
-    hsize_reg = HSIZE;
-
-    output((int)ClearCode);
-
-    for (int rownum = 0; rownum < g_logical_screen_y_dots; rownum++)
+void lzw_strip::compress(BYTE const *pixels, int count)
+{
+    int const hsize_reg = HSIZE;
+    for (int n = 0; n < count; n++)
     {
-        // scan through the dots
-        for (int ydot = rownum; ydot < rowlimit; ydot += g_logical_screen_y_dots)
+        int const color = pixels[n];
+        if (!started)
         {
-            for (int xdot = 0; xdot < g_logical_screen_x_dots; xdot++)
-            {
-                if (save16bit == 0 || ydot < g_logical_screen_y_dots)
-                {
-                    color = getcolor(xdot, ydot);
-                }
-                else
-                {
-                    color = readdisk(xdot + g_logical_screen_x_offset, ydot + g_logical_screen_y_offset);
-                }
-                if (in_count == 0)
-                {
-                    in_count = 1;
-                    ent = color;
-                    continue;
-                }
-                long fcode = (long)(((long) color << maxbits) + ent);
-                int i = (((int)color << hshift) ^ ent);    // xor hashing
+            started = true;
+            ent = color;
+            continue;
+        }
+        long fcode = (long)(((long) color << maxbits) + ent);
+        int i = (((int)color << hshift) ^ ent);    // xor hashing
 
-                if (htab[i] == fcode)
-                {
-                    ent = codetab[i];
-                    continue;
-                }
-                else if ((long)htab[i] < 0)        // empty slot
-                {
-                    goto nomatch;
-                }
-                disp = hsize_reg - i;           // secondary hash (after G. Knott)
-                if (i == 0)
-                {
-                    disp = 1;
-                }
+        if (htab[i] == fcode)
+        {
+            ent = codetab[i];
+            continue;
+        }
+        else if ((long)htab[i] < 0)        // empty slot
+        {
+            goto nomatch;
+        }
+        {
+            int disp = hsize_reg - i;      // secondary hash (after G. Knott)
+            if (i == 0)
+            {
+                disp = 1;
+            }
 probe:
-                if ((i -= disp) < 0)
-                {
-                    i += hsize_reg;
-                }
-
-                if (htab[i] == fcode)
-                {
-                    ent = codetab[i];
-                    continue;
-                }
-                if ((long)htab[i] > 0)
-                {
-                    goto probe;
-                }
-nomatch:
-                output((int) ent);
-                ent = color;
-                if (free_ent < maxmaxcode)
-                {
-                    // code -> hashtable
-                    codetab[i] = (unsigned short)free_ent++;
-                    htab[i] = fcode;
-                }
-                else
-                {
-                    cl_block();
-                }
-            } // end for xdot
-            if (! driver_diskp()       // supress this on disk-video
-                && ydot == rownum)
+            if ((i -= disp) < 0)
             {
-                if ((ydot & 4) == 0)
-                {
-                    if (++outcolor1 >= g_colors)
-                    {
-                        outcolor1 = 0;
-                    }
-                    if (++outcolor2 >= g_colors)
-                    {
-                        outcolor2 = 0;
-                    }
-                }
-                for (int i = 0; 250*i < g_logical_screen_x_dots; i++)
-                {
-                    // display vert status bars
-                    // (this is NOT GIF-related)
-                    g_put_color(i, ydot, getcolor(i, ydot) ^ outcolor1);
-                    g_put_color(g_logical_screen_x_dots - 1 - i, ydot,
-                             getcolor(g_logical_screen_x_dots - 1 - i, ydot) ^ outcolor2);
-                }
-                last_colorbar = ydot;
-            } // end if !driver_diskp()
-            tempkey = driver_key_pressed();
-            if (tempkey && (tempkey != 's'))  // keyboard hit - bail out
+                i += hsize_reg;
+            }
+
+            if (htab[i] == fcode)
             {
-                interrupted = true;
-                rownum = g_logical_screen_y_dots;
-                break;
+                ent = codetab[i];
+                continue;
             }
-            if (tempkey == 's')
+            if ((long)htab[i] > 0)
             {
-                driver_get_key();   // eat the keystroke
+                goto probe;
             }
-        } // end for ydot
-    } // end for rownum
+        }
+nomatch:
+        output((int) ent);
+        ent = color;
+        if (free_ent < maxmaxcode)
+        {
+            // code -> hashtable
+            codetab[i] = (unsigned short)free_ent++;
+            htab[i] = fcode;
+        }
+        else
+        {
+            // table clear for block compress
+            std::fill(htab.begin(), htab.end(), -1L);
+            free_ent = clear_code + 2;
+            clear_flg = true;
+            output(clear_code);
+        }
+    }
+}
 
-    // Put out the final code.
-    output((int)ent);
-    output((int) EOFCode);
-    return interrupted;
+// Put out the final code and the EOF code, or CLEAR if a strip follows.
+void lzw_strip::finish(bool last)
+{
+    if (started)
+    {
+        output(ent);
+    }
+    if (last)
+    {
+        output(eof_code);
+    }
+    else
+    {
+        clear_flg = true;
+        output(clear_code);
+    }
 }
 
 //****************************************************************
@@ -1273,7 +1212,7 @@ nomatch:
 //      code:   A n_bits-bit integer.  If == -1, then EOF.  This assumes
 //              that n_bits =< (long)wordsize - 1.
 // Outputs:
-//      Outputs code to the file.
+//      Outputs code to the strip's bytes.
 // Assumptions:
 //      Chars are 8 bits long.
 // Algorithm:
@@ -1281,36 +1220,16 @@ nomatch:
 // fit in it exactly).  Use the VAX insv instruction to insert each
 // code in turn.  When the buffer fills up empty it and start over.
 //
-
-
-static void output(int code)
+void lzw_strip::output(int code)
 {
-    static unsigned long masks[] =
-    {
-        0x0000, 0x0001, 0x0003, 0x0007, 0x000F,
-        0x001F, 0x003F, 0x007F, 0x00FF,
-        0x01FF, 0x03FF, 0x07FF, 0x0FFF,
-        0x1FFF, 0x3FFF, 0x7FFF, 0xFFFF
-    };
-
-    cur_accum &= masks[ cur_bits ];
+    accum |= (unsigned long) code << bits;
+    bits += n_bits;
 
-    if (cur_bits > 0)
-    {
-        cur_accum |= ((long)code << cur_bits);
-    }
-    else
-    {
-        cur_accum = code;
-    }
-
-    cur_bits += n_bits;
-
-    while (cur_bits >= 8)
+    while (bits >= 8)
     {
-        char_out((unsigned int)(cur_accum & 0xff));
-        cur_accum >>= 8;
-        cur_bits -= 8;
+        bytes.push_back((BYTE)(accum & 0xff));
+        accum >>= 8;
+        bits -= 8;
     }
 
     // If the next entry is going to be too big for the code size,
@@ -1319,7 +1238,7 @@ static void output(int code)
     {
         if (clear_flg)
         {
-            n_bits = startbits;
+            n_bits = start_bits;
             maxcode = MAXCODE(n_bits);
             clear_flg = false;
         }
@@ -1336,32 +1255,463 @@ static void output(int code)
             }
         }
     }
+}
+
+struct strip_job
+{
+    std::vector<BYTE> pixels;           // rows read for the strip
+    std::unique_ptr<lzw_strip> codes;   // set when compressed
+};
+
+// Compresses strips of rows on worker threads.  The rows are added in
+// order; each strip is queued for the workers when its last row is in.
+class strip_encoder
+{
+public:
+    strip_encoder(int start_bits, int width, int rows);
+    ~strip_encoder();
+
+    bool matches(int start_bits_, int width_, int rows_) const
+    {
+        return start_bits == start_bits_ && width == width_ && rows == rows_;
+    }
+    int rows_added() const
+    {
+        return added;
+    }
+    int num_strips() const
+    {
+        return static_cast<int>(jobs.size());
+    }
+    int first_row(int strip) const
+    {
+        return strip*strip_rows;
+    }
+    void add_row(BYTE const *pixels);
+    lzw_strip *wait(int strip, int ms);
+
+private:
+    void run(int strip);
+    void work();
+
+    int start_bits;
+    int width;
+    int rows;
+    int strip_rows;
+    int added;
+    std::vector<strip_job> jobs;
+    std::deque<int> queue;
+    std::mutex lock;
+    std::condition_variable work_cond;
+    std::condition_variable done_cond;
+    bool stopping;
+    std::vector<std::thread> threads;
+};
+
+strip_encoder::strip_encoder(int start_bits_, int width_, int rows_) :
+    start_bits(start_bits_),
+    width(width_),
+    rows(rows_),
+    strip_rows(std::max(1, (1 << 20)/width_)),
+    added(0),
+    jobs((rows_ + strip_rows - 1)/strip_rows),
+    stopping(false)
+{
+    unsigned const num_threads = std::min(calc_pool_threads(), static_cast<unsigned>(jobs.size()));
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        try
+        {
+            threads.emplace_back(&strip_encoder::work, this);
+        }
+        catch (std::system_error const &)
+        {
+            break;                      // the strips are compressed by add_row()
+        }
+    }
+}
+
+strip_encoder::~strip_encoder()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    work_cond.notify_all();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void strip_encoder::add_row(BYTE const *pixels)
+{
+    int const strip = added/strip_rows;
+    std::vector<BYTE> &input = jobs[strip].pixels;
+    if (input.empty())
+    {
+        input.reserve((std::size_t) std::min(strip_rows, rows - first_row(strip))*width);
+    }
+    input.insert(input.end(), pixels, pixels + width);
+    ++added;
+    if (added == rows || added % strip_rows == 0)
+    {
+        if (threads.empty())
+        {
+            run(strip);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back(strip);
+        }
+        work_cond.notify_one();
+    }
+}
+
+// compress a strip whose rows are all in
+void strip_encoder::run(int strip)
+{
+    strip_job &job = jobs[strip];
+    std::unique_ptr<lzw_strip> codes(new lzw_strip(start_bits, strip == 0));
+    codes->compress(&job.pixels[0], static_cast<int>(job.pixels.size()));
+    codes->finish(strip == num_strips() - 1);
+    std::vector<BYTE>().swap(job.pixels);
+    std::lock_guard<std::mutex> guard(lock);
+    job.codes.swap(codes);
+    done_cond.notify_all();
+}
+
+void strip_encoder::work()
+{
+    while (true)
+    {
+        int strip;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            work_cond.wait(guard, [this]()
+            {
+                return stopping || !queue.empty();
+            });
+            if (stopping)
+            {
+                return;
+            }
+            strip = queue.front();
+            queue.pop_front();
+        }
+        run(strip);
+    }
+}
+
+// the codes of a strip, or nullptr if not compressed within ms milliseconds
+lzw_strip *strip_encoder::wait(int strip, int ms)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    done_cond.wait_for(guard, std::chrono::milliseconds(ms), [this, strip]()
+    {
+        return jobs[strip].codes != nullptr;
+    });
+    return jobs[strip].codes.get();
+}
+
+} // namespace
+
+static void char_out(int c);
+static void flush_char();
+
+static int a_count; // Number of characters so far in this 'packet'
+static unsigned long cur_accum = 0;
+static int  cur_bits = 0;
+
+//
+// Define the storage for the packet accumulator
+//
+static char accum[256];
+
+// rows of the final pass compressed while it is being calculated
+static std::unique_ptr<strip_encoder> s_ahead;
+
+static void bit_sizes(BYTE &bitsperpixel, int &start_bits)
+{
+#ifndef XFRACT
+    bitsperpixel = 0;            // calculate bits / pixel
+    for (int i = g_colors; i >= 2; i /= 2)
+    {
+        bitsperpixel++;
+    }
 
-    if (code == EOFCode)
+    start_bits = bitsperpixel + 1;// start coding with this many bits
+    if (g_colors == 2)
     {
-        // At EOF, write the rest of the buffer.
-        while (cur_bits > 0)
+        start_bits++;    // B&W Klooge
+    }
+#else
+    if (g_colors == 2)
+    {
+        bitsperpixel = 1;
+        start_bits = 3;
+    }
+    else
+    {
+        bitsperpixel = 8;
+        start_bits = 9;
+    }
+#endif
+}
+
+// Called before the final pass of a 1 or 2 pass calculation of the whole
+// image; in batch mode its rows are compressed as they are finished.
+void encoder_start_ahead()
+{
+    s_ahead.reset();
+    if (g_init_batch != batch_modes::NORMAL
+        || calc_pool_threads() < 2
+        || g_disk_16_bit)                       // saved with the potential
+    {
+        return;
+    }
+    BYTE bitsperpixel;
+    int start_bits;
+    bit_sizes(bitsperpixel, start_bits);
+    s_ahead.reset(new strip_encoder(start_bits, g_logical_screen_x_dots, g_logical_screen_y_dots));
+}
+
+// Rows up to and including row won't change again.
+void encoder_rows_done(int row)
+{
+    if (!s_ahead)
+    {
+        return;
+    }
+    std::vector<BYTE> pixels(g_logical_screen_x_dots);
+    while (s_ahead->rows_added() <= row)
+    {
+        get_line(s_ahead->rows_added(), 0, g_logical_screen_x_dots - 1, &pixels[0]);
+        s_ahead->add_row(&pixels[0]);
+    }
+}
+
+void encoder_cancel_ahead()
+{
+    s_ahead.reset();
+}
+
+// Read row L of the rows compressed: rownum L/passes, with the 16 bit
+// potential's low bytes following each row when passes is 2.
+static void read_save_row(int row, int passes, BYTE *pixels)
+{
+    int const ydot = row/passes + (row % passes)*g_logical_screen_y_dots;
+    if (ydot < g_logical_screen_y_dots)
+    {
+        get_line(ydot, 0, g_logical_screen_x_dots - 1, pixels);
+    }
+    else
+    {
+        readdisk_span(ydot + g_logical_screen_y_offset, g_logical_screen_x_offset,
+                      g_logical_screen_x_offset + g_logical_screen_x_dots - 1, pixels);
+    }
+}
+
+// display vert status bars on a row saved
+// (this is NOT GIF-related)
+static void show_colorbar(int ydot, int &outcolor1, int &outcolor2)
+{
+    if (driver_diskp())        // supress this on disk-video
+    {
+        return;
+    }
+    if ((ydot & 4) == 0)
+    {
+        if (++outcolor1 >= g_colors)
+        {
+            outcolor1 = 0;
+        }
+        if (++outcolor2 >= g_colors)
+        {
+            outcolor2 = 0;
+        }
+    }
+    for (int i = 0; 250*i < g_logical_screen_x_dots; i++)
+    {
+        g_put_color(i, ydot, getcolor(i, ydot) ^ outcolor1);
+        g_put_color(g_logical_screen_x_dots - 1 - i, ydot,
+                 getcolor(g_logical_screen_x_dots - 1 - i, ydot) ^ outcolor2);
+    }
+    last_colorbar = ydot;
+}
+
+// true if a key other than 's' was hit
+static bool save_interrupted()
+{
+    int const tempkey = driver_key_pressed();
+    if (tempkey == 's')
+    {
+        driver_get_key();   // eat the keystroke
+    }
+    return tempkey && tempkey != 's';
+}
+
+// add the codes of a strip to the packets
+static void put_codes(lzw_strip &codes, bool all)
+{
+    if (cur_bits == 0)
+    {
+        for (BYTE code_byte : codes.bytes)
+        {
+            char_out(code_byte);
+        }
+    }
+    else
+    {
+        for (BYTE code_byte : codes.bytes)
+        {
+            cur_accum |= (unsigned long) code_byte << cur_bits;
+            char_out((unsigned int)(cur_accum & 0xff));
+            cur_accum >>= 8;
+        }
+    }
+    codes.bytes.clear();
+    if (all)
+    {
+        cur_accum |= codes.accum << cur_bits;
+        cur_bits += codes.bits;
+        if (cur_bits >= 8)
         {
             char_out((unsigned int)(cur_accum & 0xff));
             cur_accum >>= 8;
             cur_bits -= 8;
         }
+    }
+}
 
-        flush_char();
+// Compress the rows in strips on worker threads, reading the rows not
+// already compressed ahead.
+static bool compress_strips(int rowlimit, int passes, int &outcolor1, int &outcolor2)
+{
+    std::unique_ptr<strip_encoder> strips;
+    if (s_ahead && s_ahead->matches(startbits, g_logical_screen_x_dots, rowlimit)
+        && s_ahead->rows_added() == rowlimit)
+    {
+        strips.swap(s_ahead);
+    }
+    else
+    {
+        s_ahead.reset();
+        strips.reset(new strip_encoder(startbits, g_logical_screen_x_dots, rowlimit));
+    }
 
-        fflush(g_outfile);
+    int const read_ahead = 2*static_cast<int>(calc_pool_threads());
+    std::vector<BYTE> pixels(g_logical_screen_x_dots);
+    bool interrupted = false;
+    int strip = 0;
+    for (; strip < strips->num_strips() && !interrupted; ++strip)
+    {
+        int const end = strip + 1 < strips->num_strips() ? strips->first_row(strip + 1) : rowlimit;
+        int const read_end = std::min(rowlimit,
+            strips->first_row(std::min(strip + read_ahead, strips->num_strips() - 1) + 1));
+        lzw_strip *codes;
+        while ((codes = strips->wait(strip, strips->rows_added() < read_end ? 0 : 50)) == nullptr)
+        {
+            if (strips->rows_added() < read_end)
+            {
+                read_save_row(strips->rows_added(), passes, &pixels[0]);
+                strips->add_row(&pixels[0]);
+            }
+            else if (save_interrupted())
+            {
+                interrupted = true;
+                break;
+            }
+        }
+        if (codes == nullptr)
+        {
+            break;
+        }
+        put_codes(*codes, true);
+        for (int row = strips->first_row(strip); row < end; row += passes)
+        {
+            show_colorbar(row/passes, outcolor1, outcolor2);
+        }
+        interrupted = save_interrupted();
     }
+    if (interrupted)
+    {
+        // the strips written end with a CLEAR code; end the partial image
+        lzw_strip codes(startbits, strip == 0);
+        codes.finish(true);
+        put_codes(codes, true);
+    }
+    return interrupted;
 }
 
-//
-// Clear out the hash table
-//
-static void cl_block()             // table clear for block compress
+static bool compress(int rowlimit)
 {
-    std::memset(htab, 0xff, (unsigned)HSIZE*sizeof(long));
-    free_ent = ClearCode + 2;
-    clear_flg = true;
-    output((int)ClearCode);
+    int outcolor1, outcolor2;
+    bool interrupted = false;
+    std::vector<BYTE> pixels(g_logical_screen_x_dots);
+
+    outcolor1 = 0;               // use these colors to show progress
+    outcolor2 = 1;               // (this has nothing to do with GIF)
+
+    if (g_colors > 2)
+    {
+        outcolor1 = 2;
+        outcolor2 = 3;
+    }
+    if (((++numsaves) & 1) == 0)
+    {
+        // reverse the colors on alt saves
+        int i = outcolor1;
+        outcolor1 = outcolor2;
+        outcolor2 = i;
+    }
+    outcolor1s = outcolor1;
+    outcolor2s = outcolor2;
+
+    // Set up the necessary values
+    cur_accum = 0;
+    cur_bits = 0;
+    a_count = 0;
+
+    int const passes = rowlimit/g_logical_screen_y_dots;
+    if (calc_pool_threads() > 1)
+    {
+        interrupted = compress_strips(rowlimit, passes, outcolor1, outcolor2);
+    }
+    else
+    {
+        lzw_strip codes(startbits, true);
+        for (int row = 0; row < rowlimit; row++)
+        {
+            // scan through the dots
+            read_save_row(row, passes, &pixels[0]);
+            codes.compress(&pixels[0], g_logical_screen_x_dots);
+            put_codes(codes, false);
+            if (row % passes == 0)
+            {
+                show_colorbar(row/passes, outcolor1, outcolor2);
+            }
+            if (save_interrupted())  // keyboard hit - bail out
+            {
+                interrupted = true;
+                break;
+            }
+        }
+        codes.finish(true);
+        put_codes(codes, true);
+    }
+
+    // At EOF, write the rest of the buffer.
+    if (cur_bits > 0)
+    {
+        char_out((unsigned int)(cur_accum & 0xff));
+        cur_accum = 0;
+        cur_bits = 0;
+    }
+    flush_char();
+    fflush(g_outfile);
+    return interrupted;
 }
 
 //
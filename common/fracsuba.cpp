@@ -81,8 +81,8 @@ int asmlMANHbailout()
 {
     g_l_temp_sqr_x = lsqr(g_l_new_z.x);
     g_l_temp_sqr_y = lsqr(g_l_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x) + std::fabs(g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    g_ctx.magnitude = std::fabs(g_ctx.new_z.x) + std::fabs(g_ctx.new_z.y);
+    if (g_ctx.magnitude*g_ctx.magnitude >= g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -94,8 +94,8 @@ int asmlMANRbailout()
 {
     g_l_temp_sqr_x = lsqr(g_l_new_z.x);
     g_l_temp_sqr_y = lsqr(g_l_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x + g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    g_ctx.magnitude = std::fabs(g_ctx.new_z.x + g_ctx.new_z.y);
+    if (g_ctx.magnitude*g_ctx.magnitude >= g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -177,8 +177,8 @@ int asm386lMANHbailout()
 {
     g_l_temp_sqr_x = lsqr(g_l_new_z.x);
     g_l_temp_sqr_y = lsqr(g_l_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x) + std::fabs(g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    g_ctx.magnitude = std::fabs(g_ctx.new_z.x) + std::fabs(g_ctx.new_z.y);
+    if (g_ctx.magnitude*g_ctx.magnitude >= g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -190,8 +190,8 @@ int asm386lMANRbailout()
 {
     g_l_temp_sqr_x = lsqr(g_l_new_z.x);
     g_l_temp_sqr_y = lsqr(g_l_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x + g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    g_ctx.magnitude = std::fabs(g_ctx.new_z.x + g_ctx.new_z.y);
+    if (g_ctx.magnitude*g_ctx.magnitude >= g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -225,25 +225,30 @@ int asm386lMANRbailout()
 //         ret
 // asmfpMODbailout endp
 //
-int asmfpMODbailout()
+int asmfpMODbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_magnitude > g_magnitude_limit
-        || g_magnitude < 0.0
-        || std::fabs(g_new_z.x) > g_magnitude_limit2
-        || std::fabs(g_new_z.y) > g_magnitude_limit2
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.magnitude > ctx.magnitude_limit
+        || ctx.magnitude < 0.0
+        || std::fabs(ctx.new_z.x) > g_magnitude_limit2
+        || std::fabs(ctx.new_z.y) > g_magnitude_limit2
         || g_overflow)
     {
         g_overflow = false;
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpMODbailout()
+{
+    return asmfpMODbailout(g_ctx);
+}
+
 // asmfpREALbailout proc near uses si di
 //         fld     qword ptr new
 //         fmul    st,st                   ; nx2
@@ -270,20 +275,25 @@ int asmfpMODbailout()
 //         ret
 // asmfpREALbailout endp
 //
-int asmfpREALbailout()
+int asmfpREALbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    if (g_temp_sqr_x >= g_magnitude_limit || g_overflow)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    if (ctx.temp_sqr_x >= ctx.magnitude_limit || g_overflow)
     {
         g_overflow = false;
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpREALbailout()
+{
+    return asmfpREALbailout(g_ctx);
+}
+
 // asmfpIMAGbailout proc near uses si di
 //         fld     qword ptr new+8
 //         fmul    st,st                   ; ny2
@@ -310,20 +320,25 @@ int asmfpREALbailout()
 //         ret
 // asmfpIMAGbailout endp
 //
-int asmfpIMAGbailout()
+int asmfpIMAGbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    if (g_temp_sqr_y >= g_magnitude_limit || g_overflow)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    if (ctx.temp_sqr_y >= ctx.magnitude_limit || g_overflow)
     {
         g_overflow = false;
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpIMAGbailout()
+{
+    return asmfpIMAGbailout(g_ctx);
+}
+
 // asmfpORbailout proc near uses si di
 //         fld     qword ptr new+8
 //         fmul    st,st                   ; ny2
@@ -357,20 +372,25 @@ int asmfpIMAGbailout()
 //         ret
 // asmfpORbailout endp
 //
-int asmfpORbailout()
+int asmfpORbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    if (g_temp_sqr_x >= g_magnitude_limit || g_temp_sqr_y >= g_magnitude_limit || g_overflow)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    if (ctx.temp_sqr_x >= ctx.magnitude_limit || ctx.temp_sqr_y >= ctx.magnitude_limit || g_overflow)
     {
         g_overflow = false;
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpORbailout()
+{
+    return asmfpORbailout(g_ctx);
+}
+
 // asmfpANDbailout proc near uses si di
 //         fld     qword ptr new+8
 //         fmul    st,st                   ; ny2
@@ -406,20 +426,25 @@ int asmfpORbailout()
 //         ret
 // asmfpANDbailout endp
 //
-int asmfpANDbailout()
+int asmfpANDbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    if ((g_temp_sqr_x >= g_magnitude_limit && g_temp_sqr_y >= g_magnitude_limit) || g_overflow)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    if ((ctx.temp_sqr_x >= ctx.magnitude_limit && ctx.temp_sqr_y >= ctx.magnitude_limit) || g_overflow)
     {
         g_overflow = false;
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpANDbailout()
+{
+    return asmfpANDbailout(g_ctx);
+}
+
 // asmfpMANHbailout proc near uses si di
 //         fld     qword ptr new+8
 //         fld     st
@@ -458,20 +483,25 @@ int asmfpANDbailout()
 //         ret
 // asmfpMANHbailout endp
 //
-int asmfpMANHbailout()
+int asmfpMANHbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x) + std::fabs(g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = std::fabs(ctx.new_z.x) + std::fabs(ctx.new_z.y);
+    if (ctx.magnitude*ctx.magnitude >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int asmfpMANHbailout()
+{
+    return asmfpMANHbailout(g_ctx);
+}
+
 // asmfpMANRbailout proc near uses si di
 //         fld     qword ptr new+8
 //         fld     st
@@ -507,16 +537,21 @@ int asmfpMANHbailout()
 //         ret
 // asmfpMANRbailout endp
 //
-int asmfpMANRbailout()
+int asmfpMANRbailout(CalcContext &ctx)
 {
     // TODO: verify this code is correct
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = std::fabs(g_new_z.x + g_new_z.y);
-    if (g_magnitude*g_magnitude >= g_magnitude_limit)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = std::fabs(ctx.new_z.x + ctx.new_z.y);
+    if (ctx.magnitude*ctx.magnitude >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
+
+int asmfpMANRbailout()
+{
+    return asmfpMANRbailout(g_ctx);
+}
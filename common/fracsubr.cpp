@@ -162,8 +162,8 @@ bool g_use_grid = false;
 
 void calcfracinit() // initialize a *pile* of stuff for fractal calculation
 {
-    g_old_color_iter = 0L;
-    g_color_iter = g_old_color_iter;
+    g_ctx.old_color_iter = 0L;
+    g_ctx.color_iter = g_ctx.old_color_iter;
     for (int i = 0; i < 10; i++)
     {
         g_rhombus_stack[i] = 0;
@@ -368,25 +368,25 @@ init_restart:
 
     if (g_potential_flag && g_potential_params[2] != 0.0)
     {
-        g_magnitude_limit = g_potential_params[2];
+        g_ctx.magnitude_limit = g_potential_params[2];
     }
     else if (g_bail_out)     // user input bailout
     {
-        g_magnitude_limit = g_bail_out;
+        g_ctx.magnitude_limit = g_bail_out;
     }
     else if (g_biomorph != -1)     // biomorph benefits from larger bailout
     {
-        g_magnitude_limit = 100;
+        g_ctx.magnitude_limit = 100;
     }
     else
     {
-        g_magnitude_limit = g_cur_fractal_specific->orbit_bailout;
+        g_ctx.magnitude_limit = g_cur_fractal_specific->orbit_bailout;
     }
     if (g_integer_fractal)   // the bailout limit mustn't be too high here
     {
-        if (g_magnitude_limit > 127.0)
+        if (g_ctx.magnitude_limit > 127.0)
         {
-            g_magnitude_limit = 127.0;
+            g_ctx.magnitude_limit = 127.0;
         }
     }
 
@@ -440,7 +440,7 @@ init_restart:
             && (g_params[1] > -2.0 && g_params[1] < 2.0)
             && (g_invert == 0)                        // and not inverting
             && g_biomorph == -1                     // and not biomorphing
-            && g_magnitude_limit <= 4.0                         // and bailout not too high
+            && g_ctx.magnitude_limit <= 4.0                         // and bailout not too high
             && (g_outside_color > REAL || g_outside_color < ATAN)   // and no funny outside stuff
             && g_debug_flag != debug_flags::force_smaller_bitshift // and not debugging
             && g_close_proximity <= 2.0             // and g_close_proximity not too large
@@ -1888,15 +1888,15 @@ void get_julia_attractor(double real, double imag)
     savper = g_periodicity_check;
     savmaxit = g_max_iterations;
     g_periodicity_check = 0;
-    g_old_z.x = real;                    // prepare for f.p orbit calc
-    g_old_z.y = imag;
-    g_temp_sqr_x = sqr(g_old_z.x);
-    g_temp_sqr_y = sqr(g_old_z.y);
+    g_ctx.old_z.x = real;                    // prepare for f.p orbit calc
+    g_ctx.old_z.y = imag;
+    g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+    g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
 
     g_l_old_z.x = (long)real;     // prepare for int orbit calc
     g_l_old_z.y = (long)imag;
-    g_l_temp_sqr_x = (long)g_temp_sqr_x;
-    g_l_temp_sqr_y = (long)g_temp_sqr_y;
+    g_l_temp_sqr_x = (long)g_ctx.temp_sqr_x;
+    g_l_temp_sqr_y = (long)g_ctx.temp_sqr_y;
 
     g_l_old_z.x = g_l_old_z.x << g_bit_shift;
     g_l_old_z.y = g_l_old_z.y << g_bit_shift;
@@ -1907,16 +1907,16 @@ void get_julia_attractor(double real, double imag)
     {
         g_max_iterations = 500;
     }
-    g_color_iter = 0;
+    g_ctx.color_iter = 0;
     g_overflow = false;
-    while (++g_color_iter < g_max_iterations)
+    while (++g_ctx.color_iter < g_max_iterations)
     {
         if (g_cur_fractal_specific->orbitcalc() || g_overflow)
         {
             break;
         }
     }
-    if (g_color_iter >= g_max_iterations)      // if orbit stays in the lake
+    if (g_ctx.color_iter >= g_max_iterations)      // if orbit stays in the lake
     {
         if (g_integer_fractal)     // remember where it went to
         {
@@ -1924,7 +1924,7 @@ void get_julia_attractor(double real, double imag)
         }
         else
         {
-            result =  g_new_z;
+            result =  g_ctx.new_z;
         }
         for (int i = 0; i < 10; i++)
         {
@@ -1945,10 +1945,10 @@ void get_julia_attractor(double real, double imag)
                 }
                 else
                 {
-                    if (std::fabs(result.x-g_new_z.x) < g_close_enough
-                        && std::fabs(result.y-g_new_z.y) < g_close_enough)
+                    if (std::fabs(result.x-g_ctx.new_z.x) < g_close_enough
+                        && std::fabs(result.y-g_ctx.new_z.y) < g_close_enough)
                     {
-                        g_attractor[g_attractors] = g_new_z;
+                        g_attractor[g_attractors] = g_ctx.new_z;
                         g_attractor_period[g_attractors] = i+1;
                         g_attractors++;   // another attractor - coloured lakes !
                         break;
@@ -1969,8 +1969,6 @@ void get_julia_attractor(double real, double imag)
 }
 
 
-#define maxyblk 7    // must match calcfrac.c
-#define maxxblk 202  // must match calcfrac.c
 int ssg_blocksize() // used by solidguessing and by zoom panning
 {
     int blocksize, i;
@@ -1982,10 +1980,5 @@ int ssg_blocksize() // used by solidguessing and by zoom panning
         blocksize += blocksize;
         i += i;
     }
-    // increase blocksize if prefix array not big enough
-    while (blocksize*(maxxblk-2) < g_logical_screen_x_dots || blocksize*(maxyblk-2)*16 < g_logical_screen_y_dots)
-    {
-        blocksize += blocksize;
-    }
     return blocksize;
 }
@@ -294,7 +294,7 @@ int  bnMODbailout()
     add_bn(bntmp, bntmpsqrx+shiftfactor, bntmpsqry+shiftfactor);
 
     longmagnitude = bntoint(bntmp);  // works with any fractal type
-    if (longmagnitude >= (long)g_magnitude_limit)
+    if (longmagnitude >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -310,7 +310,7 @@ int  bnREALbailout()
     square_bn(bntmpsqrx, bnnew.x);
     square_bn(bntmpsqry, bnnew.y);
     longtempsqrx = bntoint(bntmpsqrx+shiftfactor);
-    if (longtempsqrx >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -327,7 +327,7 @@ int  bnIMAGbailout()
     square_bn(bntmpsqrx, bnnew.x);
     square_bn(bntmpsqry, bnnew.y);
     longtempsqry = bntoint(bntmpsqry+shiftfactor);
-    if (longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -344,7 +344,7 @@ int  bnORbailout()
     square_bn(bntmpsqry, bnnew.y);
     longtempsqrx = bntoint(bntmpsqrx+shiftfactor);
     longtempsqry = bntoint(bntmpsqry+shiftfactor);
-    if (longtempsqrx >= (long)g_magnitude_limit || longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit || longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -361,7 +361,7 @@ int  bnANDbailout()
     square_bn(bntmpsqry, bnnew.y);
     longtempsqrx = bntoint(bntmpsqrx+shiftfactor);
     longtempsqry = bntoint(bntmpsqry+shiftfactor);
-    if (longtempsqrx >= (long)g_magnitude_limit && longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit && longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -382,7 +382,7 @@ int  bnMANHbailout()
     add_bn(bntmp, bnold.x, bnold.y);
     square_bn(bnold.x, bntmp);
     longtempmag = bntoint(bnold.x+shiftfactor);
-    if (longtempmag >= (long)g_magnitude_limit)
+    if (longtempmag >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -401,7 +401,7 @@ int  bnMANRbailout()
     // note: in next two lines, bnold is just used as a temporary variable
     square_bn(bnold.x, bntmp);
     longtempmag = bntoint(bnold.x+shiftfactor);
-    if (longtempmag >= (long)g_magnitude_limit)
+    if (longtempmag >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -419,7 +419,7 @@ int  bfMODbailout()
     add_bf(bftmp, bftmpsqrx, bftmpsqry);
 
     longmagnitude = bftoint(bftmp);
-    if (longmagnitude >= (long)g_magnitude_limit)
+    if (longmagnitude >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -435,7 +435,7 @@ int  bfREALbailout()
     square_bf(bftmpsqrx, bfnew.x);
     square_bf(bftmpsqry, bfnew.y);
     longtempsqrx = bftoint(bftmpsqrx);
-    if (longtempsqrx >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -452,7 +452,7 @@ int  bfIMAGbailout()
     square_bf(bftmpsqrx, bfnew.x);
     square_bf(bftmpsqry, bfnew.y);
     longtempsqry = bftoint(bftmpsqry);
-    if (longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -469,7 +469,7 @@ int  bfORbailout()
     square_bf(bftmpsqry, bfnew.y);
     longtempsqrx = bftoint(bftmpsqrx);
     longtempsqry = bftoint(bftmpsqry);
-    if (longtempsqrx >= (long)g_magnitude_limit || longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit || longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -486,7 +486,7 @@ int  bfANDbailout()
     square_bf(bftmpsqry, bfnew.y);
     longtempsqrx = bftoint(bftmpsqrx);
     longtempsqry = bftoint(bftmpsqry);
-    if (longtempsqrx >= (long)g_magnitude_limit && longtempsqry >= (long)g_magnitude_limit)
+    if (longtempsqrx >= (long)g_ctx.magnitude_limit && longtempsqry >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -507,7 +507,7 @@ int  bfMANHbailout()
     add_bf(bftmp, bfold.x, bfold.y);
     square_bf(bfold.x, bftmp);
     longtempmag = bftoint(bfold.x);
-    if (longtempmag >= (long)g_magnitude_limit)
+    if (longtempmag >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -526,7 +526,7 @@ int  bfMANRbailout()
     // note: in next two lines, bfold is just used as a temporary variable
     square_bf(bfold.x, bftmp);
     longtempmag = bftoint(bfold.x);
-    if (longtempmag >= (long)g_magnitude_limit)
+    if (longtempmag >= (long)g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -741,7 +741,7 @@ int mandelbn_per_pixel()
            Mandelbrot iteration with init rather than 0 */
         floattobn(bnold.x, g_params[0]); // initial pertubation of parameters set
         floattobn(bnold.y, g_params[1]);
-        g_color_iter = -1;
+        g_ctx.color_iter = -1;
     }
     else
     {
@@ -787,7 +787,7 @@ int mandelbf_per_pixel()
            Mandelbrot iteration with init rather than 0 */
         floattobf(bfold.x, g_params[0]); // initial pertubation of parameters set
         floattobf(bfold.y, g_params[1]);
-        g_color_iter = -1;
+        g_ctx.color_iter = -1;
     }
     else
     {
@@ -297,7 +297,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.5F, 1.5F, -1.5F, 1.5F,
         0, fractal_type::JULIAFP, fractal_type::NOFRACTAL, fractal_type::MANDEL, symmetry_type::X_AXIS_NO_PARAM,
         JuliafpFractal, mandelfp_per_pixel, MandelfpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        JuliafpFractal, mandelfp_per_pixel
     },
 
     {
@@ -319,7 +320,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.0F, 2.0F, -1.5F, 1.5F,
         0, fractal_type::NOFRACTAL, fractal_type::MANDELFP, fractal_type::JULIA, symmetry_type::ORIGIN,
         JuliafpFractal, juliafp_per_pixel,  JuliafpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        JuliafpFractal, juliafp_per_pixel
     },
 
     {
@@ -867,7 +869,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::FPJULIAZPOWER, fractal_type::NOFRACTAL, fractal_type::LMANDELZPOWER, symmetry_type::X_AXIS_NO_IMAG,
         floatZpowerFractal, othermandelfp_per_pixel, MandelfpSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        floatZpowerFractal, othermandelfp_per_pixel
     },
 
     {
@@ -879,7 +882,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::NOFRACTAL, fractal_type::FPMANDELZPOWER, fractal_type::LJULIAZPOWER, symmetry_type::ORIGIN,
         floatZpowerFractal, otherjuliafp_per_pixel, JuliafpSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        floatZpowerFractal, otherjuliafp_per_pixel
     },
 
     {
@@ -1108,7 +1112,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::NOFRACTAL, fractal_type::NOFRACTAL, fractal_type::SIERPINSKI, symmetry_type::NONE,
         SierpinskiFPFractal, otherjuliafp_per_pixel, SierpinskiFPSetup,
         standard_fractal,
-        127
+        127,
+        SierpinskiFPFractal, otherjuliafp_per_pixel
     },
 
     {
@@ -1119,7 +1124,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.0F, 2.0F, -1.5F, 1.5F,
         0, fractal_type::NOFRACTAL, fractal_type::MANDELLAMBDAFP, fractal_type::LAMBDA, symmetry_type::NONE,
         LambdaFPFractal, juliafp_per_pixel, JuliafpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        LambdaFPFractal, juliafp_per_pixel
     },
 
     {
@@ -1202,7 +1208,8 @@ fractalspecificstuff g_fractal_specific[] =
         -3.0F, 5.0F, -3.0F, 3.0F,
         0, fractal_type::LAMBDAFP, fractal_type::NOFRACTAL, fractal_type::MANDELLAMBDA, symmetry_type::X_AXIS_NO_PARAM,
         LambdaFPFractal, mandelfp_per_pixel, MandelfpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        LambdaFPFractal, mandelfp_per_pixel
     },
 
     {
@@ -1979,7 +1986,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.0F, 2.0F, -1.5F, 1.5F,
         0, fractal_type::NOFRACTAL, fractal_type::MANDPHOENIXFP, fractal_type::PHOENIX, symmetry_type::X_AXIS,
         PhoenixFractal, phoenix_per_pixel, PhoenixSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        PhoenixFractal, phoenix_per_pixel
     },
 
     {
@@ -2003,7 +2011,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::PHOENIXFP, fractal_type::NOFRACTAL, fractal_type::MANDPHOENIX, symmetry_type::NONE,
         PhoenixFractal, mandphoenix_per_pixel, MandPhoenixSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        PhoenixFractal, mandphoenix_per_pixel
     },
 
     {
@@ -2060,7 +2069,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.0F, 2.0F, -1.5F, 1.5F,
         0, fractal_type::JULIA4FP, fractal_type::NOFRACTAL, fractal_type::MANDEL4, symmetry_type::X_AXIS_NO_PARAM,
         Mandel4fpFractal, mandelfp_per_pixel, MandelfpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        Mandel4fpFractal, mandelfp_per_pixel
     },
 
     {
@@ -2071,7 +2081,8 @@ fractalspecificstuff g_fractal_specific[] =
         -2.0F, 2.0F, -1.5F, 1.5F,
         0, fractal_type::NOFRACTAL, fractal_type::MANDEL4FP, fractal_type::JULIA4, symmetry_type::ORIGIN,
         Mandel4fpFractal, juliafp_per_pixel, JuliafpSetup, standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        Mandel4fpFractal, juliafp_per_pixel
     },
 
     {
@@ -2083,7 +2094,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::MARKSJULIAFP, fractal_type::NOFRACTAL, fractal_type::MARKSMANDEL, symmetry_type::NONE,
         MarksLambdafpFractal, marksmandelfp_per_pixel, MandelfpSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        MarksLambdafpFractal, marksmandelfp_per_pixel
     },
 
     {
@@ -2095,7 +2107,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::NOFRACTAL, fractal_type::MARKSMANDELFP, fractal_type::MARKSJULIA, symmetry_type::ORIGIN,
         MarksLambdafpFractal, juliafp_per_pixel, MarksJuliafpSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        MarksLambdafpFractal, juliafp_per_pixel
     },
 
     {
@@ -2141,7 +2154,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::NOFRACTAL, fractal_type::MANDPHOENIXFPCPLX, fractal_type::PHOENIXCPLX, symmetry_type::ORIGIN,
         PhoenixFractalcplx, phoenix_per_pixel, PhoenixCplxSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        PhoenixFractalcplx, phoenix_per_pixel
     },
 
     {
@@ -2165,7 +2179,8 @@ fractalspecificstuff g_fractal_specific[] =
         0, fractal_type::PHOENIXFPCPLX, fractal_type::NOFRACTAL, fractal_type::MANDPHOENIXCPLX, symmetry_type::X_AXIS,
         PhoenixFractalcplx, mandphoenix_per_pixel, MandPhoenixCplxSetup,
         standard_fractal,
-        STDBAILOUT
+        STDBAILOUT,
+        PhoenixFractalcplx, mandphoenix_per_pixel
     },
 
     {
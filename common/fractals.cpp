@@ -83,15 +83,13 @@ int g_basin;
 double g_newton_r_over_d;
 double g_degree_minus_1_over_degree;
 double g_threshold;
-static DComplex tmp2;
-DComplex g_marks_coefficient;
 static DComplex  staticroots[16]; // roots array for degree 16 or less
 std::vector<DComplex> g_roots;
 std::vector<MPC> g_mpc_roots;
 long g_fudge_half;
 DComplex g_power_z;
 int     g_bit_shift_less_1;                  // bit shift less 1
-bool g_overflow = false;
+THREAD_LOCAL bool g_overflow = false;
 
 #define modulus(z)       (sqr((z).x)+sqr((z).y))
 #define conjugate(pz)   ((pz)->y = 0.0 - (pz)->y)
@@ -103,9 +101,6 @@ int g_c_exponent;
 
 
 // These are local but I don't want to pass them as parameters
-DComplex g_param_z1;
-DComplex g_param_z2;
-DComplex *g_float_param;
 LComplex *g_long_param; // used here and in jb.c
 
 // --------------------------------------------------------------------
@@ -117,8 +112,6 @@ double g_cos_x;
 static double siny;
 static double cosy;
 static double tmpexp;
-double g_temp_sqr_x;
-double g_temp_sqr_y;
 
 static double foldxinitx;
 static double foldyinity;
@@ -155,10 +148,10 @@ static DComplex  T_Cm1Cm2;     // (floatparm - 1) * (floatparm - 2)
 
 void FloatPreCalcMagnet2() // precalculation for Magnet2 (M & J) for speed
 {
-    T_Cm1.x = g_float_param->x - 1.0;
-    T_Cm1.y = g_float_param->y;
-    T_Cm2.x = g_float_param->x - 2.0;
-    T_Cm2.y = g_float_param->y;
+    T_Cm1.x = g_ctx.float_param->x - 1.0;
+    T_Cm1.y = g_ctx.float_param->y;
+    T_Cm2.x = g_ctx.float_param->x - 2.0;
+    T_Cm2.y = g_ctx.float_param->y;
     T_Cm1Cm2.x = (T_Cm1.x * T_Cm2.x) - (T_Cm1.y * T_Cm2.y);
     T_Cm1Cm2.y = (T_Cm1.x * T_Cm2.y) + (T_Cm1.y * T_Cm2.x);
     T_Cm1.x += T_Cm1.x + T_Cm1.x;
@@ -176,103 +169,138 @@ int (*longbailout)();
 int (*bignumbailout)();
 int (*bigfltbailout)();
 
+int  fpMODbailout(CalcContext &ctx)
+{
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.magnitude >= ctx.magnitude_limit)
+    {
+        return 1;
+    }
+    ctx.old_z = ctx.new_z;
+    return 0;
+}
+
 int  fpMODbailout()
 {
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_magnitude >= g_magnitude_limit)
+    return fpMODbailout(g_ctx);
+}
+
+int  fpREALbailout(CalcContext &ctx)
+{
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.temp_sqr_x >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
 int  fpREALbailout()
 {
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_temp_sqr_x >= g_magnitude_limit)
+    return fpREALbailout(g_ctx);
+}
+
+int  fpIMAGbailout(CalcContext &ctx)
+{
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.temp_sqr_y >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
 int  fpIMAGbailout()
 {
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_temp_sqr_y >= g_magnitude_limit)
+    return fpIMAGbailout(g_ctx);
+}
+
+int  fpORbailout(CalcContext &ctx)
+{
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.temp_sqr_x >= ctx.magnitude_limit || ctx.temp_sqr_y >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
 int  fpORbailout()
 {
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_temp_sqr_x >= g_magnitude_limit || g_temp_sqr_y >= g_magnitude_limit)
+    return fpORbailout(g_ctx);
+}
+
+int  fpANDbailout(CalcContext &ctx)
+{
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    if (ctx.temp_sqr_x >= ctx.magnitude_limit && ctx.temp_sqr_y >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
 int  fpANDbailout()
 {
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_temp_sqr_x >= g_magnitude_limit && g_temp_sqr_y >= g_magnitude_limit)
-    {
-        return 1;
-    }
-    g_old_z = g_new_z;
-    return 0;
+    return fpANDbailout(g_ctx);
 }
 
-int  fpMANHbailout()
+int  fpMANHbailout(CalcContext &ctx)
 {
     double manhmag;
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    manhmag = std::fabs(g_new_z.x) + std::fabs(g_new_z.y);
-    if ((manhmag * manhmag) >= g_magnitude_limit)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    manhmag = std::fabs(ctx.new_z.x) + std::fabs(ctx.new_z.y);
+    if ((manhmag * manhmag) >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
-int  fpMANRbailout()
+int  fpMANHbailout()
+{
+    return fpMANHbailout(g_ctx);
+}
+
+int  fpMANRbailout(CalcContext &ctx)
 {
     double manrmag;
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    manrmag = g_new_z.x + g_new_z.y; // don't need abs() since we square it next
-    if ((manrmag * manrmag) >= g_magnitude_limit)
+    ctx.temp_sqr_x = sqr(ctx.new_z.x);
+    ctx.temp_sqr_y = sqr(ctx.new_z.y);
+    ctx.magnitude = ctx.temp_sqr_x + ctx.temp_sqr_y;
+    manrmag = ctx.new_z.x + ctx.new_z.y; // don't need abs() since we square it next
+    if ((manrmag * manrmag) >= ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    ctx.old_z = ctx.new_z;
     return 0;
 }
 
+int  fpMANRbailout()
+{
+    return fpMANRbailout(g_ctx);
+}
+
 #define FLOATTRIGBAILOUT()  \
-    if (std::fabs(g_old_z.y) >= g_magnitude_limit2) \
+    if (std::fabs(g_ctx.old_z.y) >= g_magnitude_limit2) \
         return 1;
 
 #define LONGTRIGBAILOUT()  \
@@ -286,11 +314,11 @@ int  fpMANRbailout()
         { return 1;}
 
 #define FLOATXYTRIGBAILOUT()  \
-    if (std::fabs(g_old_z.x) >= g_magnitude_limit2 || fabs(g_old_z.y) >= g_magnitude_limit2) \
+    if (std::fabs(g_ctx.old_z.x) >= g_magnitude_limit2 || fabs(g_ctx.old_z.y) >= g_magnitude_limit2) \
         return 1;
 
 #define FLOATHTRIGBAILOUT()  \
-    if (std::fabs(g_old_z.x) >= g_magnitude_limit2) \
+    if (std::fabs(g_ctx.old_z.x) >= g_magnitude_limit2) \
         return 1;
 
 #define LONGHTRIGBAILOUT()  \
@@ -306,15 +334,15 @@ int  fpMANRbailout()
     }
 
 #define OLD_FLOATEXPBAILOUT()  \
-    if (std::fabs(g_old_z.y) >= 1.0e8) \
+    if (std::fabs(g_ctx.old_z.y) >= 1.0e8) \
         return 1;\
-    if (std::fabs(g_old_z.x) >= 6.4e2) \
+    if (std::fabs(g_ctx.old_z.x) >= 6.4e2) \
         return 1;
 
 #define FLOATEXPBAILOUT()  \
-    if (std::fabs(g_old_z.y) >= 1.0e3) \
+    if (std::fabs(g_ctx.old_z.y) >= 1.0e3) \
         return 1;\
-    if (std::fabs(g_old_z.x) >= 8) \
+    if (std::fabs(g_ctx.old_z.x) >= 8) \
         return 1;
 
 #define LONGEXPBAILOUT()  \
@@ -336,11 +364,11 @@ int  fpMANRbailout()
  
 static int  Halleybailout()
 {
-    if (std::fabs(modulus(g_new_z)-modulus(g_old_z)) < g_param_z2.x)
+    if (std::fabs(modulus(g_ctx.new_z)-modulus(g_ctx.old_z)) < g_ctx.param_z2.x)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -368,10 +396,6 @@ static int  MPCHalleybailout()
 // --------------------------------------------------------------------
 //              Fractal (once per iteration) routines
 // --------------------------------------------------------------------
-static double xt;
-static double yt;
-static double t2;
-
 /* Raise complex number (base) to the (exp) power, storing the result
 ** in complex (result).
 */
@@ -384,8 +408,9 @@ void cpower(DComplex *base, int exp, DComplex *result)
         return;
     }
 
-    xt = base->x;
-    yt = base->y;
+    double xt = base->x;
+    double yt = base->y;
+    double t2;
 
     if (exp & 1)
     {
@@ -486,10 +511,10 @@ int NewtonFractal2()
     {
         start = 0;
     }
-    cpower(&g_old_z, g_degree-1, &g_tmp_z);
-    complex_mult(g_tmp_z, g_old_z, &g_new_z);
+    cpower(&g_ctx.old_z, g_degree-1, &g_ctx.tmp_z);
+    complex_mult(g_ctx.tmp_z, g_ctx.old_z, &g_ctx.new_z);
 
-    if (DIST1(g_new_z) < g_threshold)
+    if (DIST1(g_ctx.new_z) < g_threshold)
     {
         if (g_fractal_type == fractal_type::NEWTBASIN || g_fractal_type == fractal_type::MPNEWTBASIN)
         {
@@ -502,11 +527,11 @@ int NewtonFractal2()
             {
                 /* color in alternating shades with iteration according to
                    which root of 1 it converged to */
-                if (distance(g_roots[i], g_old_z) < g_threshold)
+                if (distance(g_roots[i], g_ctx.old_z) < g_threshold)
                 {
                     if (g_basin == 2)
                     {
-                        tmpcolor = 1+(i&7)+((g_color_iter&1) << 3);
+                        tmpcolor = 1+(i&7)+((g_ctx.color_iter&1) << 3);
                     }
                     else
                     {
@@ -517,20 +542,20 @@ int NewtonFractal2()
             }
             if (tmpcolor == -1)
             {
-                g_color_iter = g_max_color;
+                g_ctx.color_iter = g_max_color;
             }
             else
             {
-                g_color_iter = tmpcolor;
+                g_ctx.color_iter = tmpcolor;
             }
         }
         return 1;
     }
-    g_new_z.x = g_degree_minus_1_over_degree * g_new_z.x + g_newton_r_over_d;
-    g_new_z.y *= g_degree_minus_1_over_degree;
+    g_ctx.new_z.x = g_degree_minus_1_over_degree * g_ctx.new_z.x + g_newton_r_over_d;
+    g_ctx.new_z.y *= g_degree_minus_1_over_degree;
 
     // Watch for divide underflow
-    t2 = g_tmp_z.x*g_tmp_z.x + g_tmp_z.y*g_tmp_z.y;
+    double t2 = g_ctx.tmp_z.x*g_ctx.tmp_z.x + g_ctx.tmp_z.y*g_ctx.tmp_z.y;
     if (t2 < FLT_MIN)
     {
         return 1;
@@ -538,8 +563,8 @@ int NewtonFractal2()
     else
     {
         t2 = 1.0 / t2;
-        g_old_z.x = t2 * (g_new_z.x * g_tmp_z.x + g_new_z.y * g_tmp_z.y);
-        g_old_z.y = t2 * (g_new_z.y * g_tmp_z.x - g_new_z.x * g_tmp_z.y);
+        g_ctx.old_z.x = t2 * (g_ctx.new_z.x * g_ctx.tmp_z.x + g_ctx.new_z.y * g_ctx.tmp_z.y);
+        g_ctx.old_z.y = t2 * (g_ctx.new_z.y * g_ctx.tmp_z.x - g_ctx.new_z.x * g_ctx.tmp_z.y);
     }
     return 0;
 }
@@ -594,7 +619,7 @@ int MPCNewtonFractal()
                 {
                     if (g_basin == 2)
                     {
-                        tmpcolor = 1+(i&7) + ((g_color_iter&1) << 3);
+                        tmpcolor = 1+(i&7) + ((g_ctx.color_iter&1) << 3);
                     }
                     else
                     {
@@ -604,11 +629,11 @@ int MPCNewtonFractal()
                 }
             if (tmpcolor == -1)
             {
-                g_color_iter = g_max_color;
+                g_ctx.color_iter = g_max_color;
             }
             else
             {
-                g_color_iter = tmpcolor;
+                g_ctx.color_iter = tmpcolor;
             }
         }
         return 1;
@@ -620,8 +645,8 @@ int MPCNewtonFractal()
     g_mp_temp2 = *pMPdiv(g_mp_one, g_mp_temp2);
     mpcold.x = *pMPmul(g_mp_temp2, (*pMPadd(*pMPmul(mpcnew.x, mpctmp.x), *pMPmul(mpcnew.y, mpctmp.y))));
     mpcold.y = *pMPmul(g_mp_temp2, (*pMPsub(*pMPmul(mpcnew.y, mpctmp.x), *pMPmul(mpcnew.x, mpctmp.y))));
-    g_new_z.x = *pMP2d(mpcold.x);
-    g_new_z.y = *pMP2d(mpcold.y);
+    g_ctx.new_z.x = *pMP2d(mpcold.x);
+    g_ctx.new_z.y = *pMP2d(mpcold.y);
     return g_mp_overflow;
 #else
     return 0;
@@ -663,20 +688,20 @@ int Barnsley1FPFractal()
     // note that fast >= 287 equiv in fracsuba.asm must be kept in step
 
     // calculate intermediate products
-    foldxinitx = g_old_z.x * g_float_param->x;
-    foldyinity = g_old_z.y * g_float_param->y;
-    foldxinity = g_old_z.x * g_float_param->y;
-    foldyinitx = g_old_z.y * g_float_param->x;
+    foldxinitx = g_ctx.old_z.x * g_ctx.float_param->x;
+    foldyinity = g_ctx.old_z.y * g_ctx.float_param->y;
+    foldxinity = g_ctx.old_z.x * g_ctx.float_param->y;
+    foldyinitx = g_ctx.old_z.y * g_ctx.float_param->x;
     // orbit calculation
-    if (g_old_z.x >= 0)
+    if (g_ctx.old_z.x >= 0)
     {
-        g_new_z.x = (foldxinitx - g_float_param->x - foldyinity);
-        g_new_z.y = (foldyinitx - g_float_param->y + foldxinity);
+        g_ctx.new_z.x = (foldxinitx - g_ctx.float_param->x - foldyinity);
+        g_ctx.new_z.y = (foldyinitx - g_ctx.float_param->y + foldxinity);
     }
     else
     {
-        g_new_z.x = (foldxinitx + g_float_param->x - foldyinity);
-        g_new_z.y = (foldyinitx + g_float_param->y + foldxinity);
+        g_ctx.new_z.x = (foldxinitx + g_ctx.float_param->x - foldyinity);
+        g_ctx.new_z.y = (foldyinitx + g_ctx.float_param->y + foldxinity);
     }
     return floatbailout();
 }
@@ -717,21 +742,21 @@ int Barnsley2FPFractal()
     Everywhere" by Michael Barnsley, p. 331, example 4.2 */
 
     // calculate intermediate products
-    foldxinitx = g_old_z.x * g_float_param->x;
-    foldyinity = g_old_z.y * g_float_param->y;
-    foldxinity = g_old_z.x * g_float_param->y;
-    foldyinitx = g_old_z.y * g_float_param->x;
+    foldxinitx = g_ctx.old_z.x * g_ctx.float_param->x;
+    foldyinity = g_ctx.old_z.y * g_ctx.float_param->y;
+    foldxinity = g_ctx.old_z.x * g_ctx.float_param->y;
+    foldyinitx = g_ctx.old_z.y * g_ctx.float_param->x;
 
     // orbit calculation
     if (foldxinity + foldyinitx >= 0)
     {
-        g_new_z.x = foldxinitx - g_float_param->x - foldyinity;
-        g_new_z.y = foldyinitx - g_float_param->y + foldxinity;
+        g_ctx.new_z.x = foldxinitx - g_ctx.float_param->x - foldyinity;
+        g_ctx.new_z.y = foldyinitx - g_ctx.float_param->y + foldxinity;
     }
     else
     {
-        g_new_z.x = foldxinitx + g_float_param->x - foldyinity;
-        g_new_z.y = foldyinitx + g_float_param->y + foldxinity;
+        g_ctx.new_z.x = foldxinitx + g_ctx.float_param->x - foldyinity;
+        g_ctx.new_z.y = foldyinitx + g_ctx.float_param->y + foldxinity;
     }
     return floatbailout();
 }
@@ -759,27 +784,37 @@ int JuliaFractal()
 #endif
 }
 
-int JuliafpFractal()
+int JuliafpFractal(CalcContext &ctx)
 {
     // floating point version of classical Mandelbrot/Julia
     // note that fast >= 287 equiv in fracsuba.asm must be kept in step
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y + g_float_param->x;
-    g_new_z.y = 2.0 * g_old_z.x * g_old_z.y + g_float_param->y;
-    return floatbailout();
+    ctx.new_z.x = ctx.temp_sqr_x - ctx.temp_sqr_y + ctx.float_param->x;
+    ctx.new_z.y = 2.0 * ctx.old_z.x * ctx.old_z.y + ctx.float_param->y;
+    return ctx.bailout(ctx);
 }
 
-int LambdaFPFractal()
+int JuliafpFractal()
+{
+    return JuliafpFractal(g_ctx);
+}
+
+int LambdaFPFractal(CalcContext &ctx)
 {
     // variation of classical Mandelbrot/Julia
     // note that fast >= 287 equiv in fracsuba.asm must be kept in step
 
-    g_temp_sqr_x = g_old_z.x - g_temp_sqr_x + g_temp_sqr_y;
-    g_temp_sqr_y = -(g_old_z.y * g_old_z.x);
-    g_temp_sqr_y += g_temp_sqr_y + g_old_z.y;
+    ctx.temp_sqr_x = ctx.old_z.x - ctx.temp_sqr_x + ctx.temp_sqr_y;
+    ctx.temp_sqr_y = -(ctx.old_z.y * ctx.old_z.x);
+    ctx.temp_sqr_y += ctx.temp_sqr_y + ctx.old_z.y;
 
-    g_new_z.x = g_float_param->x * g_temp_sqr_x - g_float_param->y * g_temp_sqr_y;
-    g_new_z.y = g_float_param->x * g_temp_sqr_y + g_float_param->y * g_temp_sqr_x;
-    return floatbailout();
+    ctx.new_z.x = ctx.float_param->x * ctx.temp_sqr_x - ctx.float_param->y * ctx.temp_sqr_y;
+    ctx.new_z.y = ctx.float_param->x * ctx.temp_sqr_y + ctx.float_param->y * ctx.temp_sqr_x;
+    return ctx.bailout(ctx);
+}
+
+int LambdaFPFractal()
+{
+    return LambdaFPFractal(g_ctx);
 }
 
 int LambdaFractal()
@@ -824,44 +859,49 @@ int SierpinskiFractal()
 #endif
 }
 
-int SierpinskiFPFractal()
+int SierpinskiFPFractal(CalcContext &ctx)
 {
     /* following code translated from basic - see "Fractals
     Everywhere" by Michael Barnsley, p. 251, Program 7.1.1 */
 
-    g_new_z.x = g_old_z.x + g_old_z.x;
-    g_new_z.y = g_old_z.y + g_old_z.y;
-    if (g_old_z.y > .5)
+    ctx.new_z.x = ctx.old_z.x + ctx.old_z.x;
+    ctx.new_z.y = ctx.old_z.y + ctx.old_z.y;
+    if (ctx.old_z.y > .5)
     {
-        g_new_z.y = g_new_z.y - 1;
+        ctx.new_z.y = ctx.new_z.y - 1;
     }
-    else if (g_old_z.x > .5)
+    else if (ctx.old_z.x > .5)
     {
-        g_new_z.x = g_new_z.x - 1;
+        ctx.new_z.x = ctx.new_z.x - 1;
     }
 
     // end barnsley code
-    return floatbailout();
+    return ctx.bailout(ctx);
+}
+
+int SierpinskiFPFractal()
+{
+    return SierpinskiFPFractal(g_ctx);
 }
 
 int LambdaexponentFractal()
 {
     // found this in  "Science of Fractal Images"
     FLOATEXPBAILOUT();
-    FPUsincos(&g_old_z.y, &siny, &cosy);
+    FPUsincos(&g_ctx.old_z.y, &siny, &cosy);
 
-    if (g_old_z.x >= g_magnitude_limit && cosy >= 0.0)
+    if (g_ctx.old_z.x >= g_ctx.magnitude_limit && cosy >= 0.0)
     {
         return 1;
     }
-    tmpexp = std::exp(g_old_z.x);
-    g_tmp_z.x = tmpexp*cosy;
-    g_tmp_z.y = tmpexp*siny;
+    tmpexp = std::exp(g_ctx.old_z.x);
+    g_ctx.tmp_z.x = tmpexp*cosy;
+    g_ctx.tmp_z.y = tmpexp*siny;
 
     //multiply by lamda
-    g_new_z.x = g_float_param->x*g_tmp_z.x - g_float_param->y*g_tmp_z.y;
-    g_new_z.y = g_float_param->y*g_tmp_z.x + g_float_param->x*g_tmp_z.y;
-    g_old_z = g_new_z;
+    g_ctx.new_z.x = g_ctx.float_param->x*g_ctx.tmp_z.x - g_ctx.float_param->y*g_ctx.tmp_z.y;
+    g_ctx.new_z.y = g_ctx.float_param->y*g_ctx.tmp_z.x + g_ctx.float_param->x*g_ctx.tmp_z.y;
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -898,17 +938,17 @@ int FloatTrigPlusExponentFractal()
     // another Scientific American biomorph type
     // z(n+1) = e**z(n) + trig(z(n)) + C
 
-    if (std::fabs(g_old_z.x) >= 6.4e2)
+    if (std::fabs(g_ctx.old_z.x) >= 6.4e2)
     {
         return 1; // DOMAIN errors
     }
-    tmpexp = std::exp(g_old_z.x);
-    FPUsincos(&g_old_z.y, &siny, &cosy);
-    CMPLXtrig0(g_old_z, g_new_z);
+    tmpexp = std::exp(g_ctx.old_z.x);
+    FPUsincos(&g_ctx.old_z.y, &siny, &cosy);
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
 
     //new =   trig(old) + e**old + C
-    g_new_z.x += tmpexp*cosy + g_float_param->x;
-    g_new_z.y += tmpexp*siny + g_float_param->y;
+    g_ctx.new_z.x += tmpexp*cosy + g_ctx.float_param->x;
+    g_ctx.new_z.y += tmpexp*siny + g_ctx.float_param->y;
     return floatbailout();
 }
 
@@ -952,18 +992,23 @@ int MarksLambdaFractal()
 #endif
 }
 
-int MarksLambdafpFractal()
+int MarksLambdafpFractal(CalcContext &ctx)
 {
     // Mark Peterson's variation of "lambda" function
 
     // Z1 = (C^(exp-1) * Z**2) + C
-    g_tmp_z.x = g_temp_sqr_x - g_temp_sqr_y;
-    g_tmp_z.y = g_old_z.x * g_old_z.y *2;
+    ctx.tmp_z.x = ctx.temp_sqr_x - ctx.temp_sqr_y;
+    ctx.tmp_z.y = ctx.old_z.x * ctx.old_z.y *2;
 
-    g_new_z.x = g_marks_coefficient.x * g_tmp_z.x - g_marks_coefficient.y * g_tmp_z.y + g_float_param->x;
-    g_new_z.y = g_marks_coefficient.x * g_tmp_z.y + g_marks_coefficient.y * g_tmp_z.x + g_float_param->y;
+    ctx.new_z.x = ctx.marks_coefficient.x * ctx.tmp_z.x - ctx.marks_coefficient.y * ctx.tmp_z.y + ctx.float_param->x;
+    ctx.new_z.y = ctx.marks_coefficient.x * ctx.tmp_z.y + ctx.marks_coefficient.y * ctx.tmp_z.x + ctx.float_param->y;
 
-    return floatbailout();
+    return ctx.bailout(ctx);
+}
+
+int MarksLambdafpFractal()
+{
+    return MarksLambdafpFractal(g_ctx);
 }
 
 
@@ -991,14 +1036,14 @@ int UnityFractal()
 int UnityfpFractal()
 {
     double XXOne;
-    XXOne = sqr(g_old_z.x) + sqr(g_old_z.y);
+    XXOne = sqr(g_ctx.old_z.x) + sqr(g_ctx.old_z.y);
     if ((XXOne > 2.0) || (std::fabs(XXOne - 1.0) < g_delta_min))
     {
         return 1;
     }
-    g_old_z.y = (2.0 - XXOne)* g_old_z.x;
-    g_old_z.x = (2.0 - XXOne)* g_old_z.y;
-    g_new_z = g_old_z;
+    g_ctx.old_z.y = (2.0 - XXOne)* g_ctx.old_z.x;
+    g_ctx.old_z.x = (2.0 - XXOne)* g_ctx.old_z.y;
+    g_ctx.new_z = g_ctx.old_z;
     return 0;
 }
 
@@ -1027,28 +1072,33 @@ int Mandel4Fractal()
 #endif
 }
 
-int Mandel4fpFractal()
+int Mandel4fpFractal(CalcContext &ctx)
 {
     // first, compute (x + iy)**2
-    g_new_z.x  = g_temp_sqr_x - g_temp_sqr_y;
-    g_new_z.y = g_old_z.x*g_old_z.y*2;
-    if (floatbailout())
+    ctx.new_z.x  = ctx.temp_sqr_x - ctx.temp_sqr_y;
+    ctx.new_z.y = ctx.old_z.x*ctx.old_z.y*2;
+    if (ctx.bailout(ctx))
     {
         return 1;
     }
 
     // then, compute ((x + iy)**2)**2 + lambda
-    g_new_z.x  = g_temp_sqr_x - g_temp_sqr_y + g_float_param->x;
-    g_new_z.y =  g_old_z.x*g_old_z.y*2 + g_float_param->y;
-    return floatbailout();
+    ctx.new_z.x  = ctx.temp_sqr_x - ctx.temp_sqr_y + ctx.float_param->x;
+    ctx.new_z.y =  ctx.old_z.x*ctx.old_z.y*2 + ctx.float_param->y;
+    return ctx.bailout(ctx);
+}
+
+int Mandel4fpFractal()
+{
+    return Mandel4fpFractal(g_ctx);
 }
 
 int floatZtozPluszpwrFractal()
 {
-    cpower(&g_old_z, (int)g_params[2], &g_new_z);
-    g_old_z = ComplexPower(g_old_z, g_old_z);
-    g_new_z.x = g_new_z.x + g_old_z.x +g_float_param->x;
-    g_new_z.y = g_new_z.y + g_old_z.y +g_float_param->y;
+    cpower(&g_ctx.old_z, (int)g_params[2], &g_ctx.new_z);
+    g_ctx.old_z = ComplexPower(g_ctx.old_z, g_ctx.old_z);
+    g_ctx.new_z.x = g_ctx.new_z.x + g_ctx.old_z.x +g_ctx.float_param->x;
+    g_ctx.new_z.y = g_ctx.new_z.y + g_ctx.old_z.y +g_ctx.float_param->y;
     return floatbailout();
 }
 
@@ -1095,20 +1145,30 @@ int longCmplxZpowerFractal()
 #endif
 }
 
+int floatZpowerFractal(CalcContext &ctx)
+{
+    cpower(&ctx.old_z, g_c_exponent, &ctx.new_z);
+    ctx.new_z.x += ctx.float_param->x;
+    ctx.new_z.y += ctx.float_param->y;
+    return ctx.bailout(ctx);
+}
+
 int floatZpowerFractal()
 {
-    cpower(&g_old_z, g_c_exponent, &g_new_z);
-    g_new_z.x += g_float_param->x;
-    g_new_z.y += g_float_param->y;
-    return floatbailout();
+    return floatZpowerFractal(g_ctx);
+}
+
+int floatCmplxZpowerFractal(CalcContext &ctx)
+{
+    ctx.new_z = ComplexPower(ctx.old_z, ctx.param_z2);
+    ctx.new_z.x += ctx.float_param->x;
+    ctx.new_z.y += ctx.float_param->y;
+    return ctx.bailout(ctx);
 }
 
 int floatCmplxZpowerFractal()
 {
-    g_new_z = ComplexPower(g_old_z, g_param_z2);
-    g_new_z.x += g_float_param->x;
-    g_new_z.y += g_float_param->y;
-    return floatbailout();
+    return floatCmplxZpowerFractal(g_ctx);
 }
 
 int Barnsley3Fractal()
@@ -1152,25 +1212,25 @@ int Barnsley3FPFractal()
 
 
     // calculate intermediate products
-    foldxinitx  = g_old_z.x * g_old_z.x;
-    foldyinity  = g_old_z.y * g_old_z.y;
-    foldxinity  = g_old_z.x * g_old_z.y;
+    foldxinitx  = g_ctx.old_z.x * g_ctx.old_z.x;
+    foldyinity  = g_ctx.old_z.y * g_ctx.old_z.y;
+    foldxinity  = g_ctx.old_z.x * g_ctx.old_z.y;
 
     // orbit calculation
-    if (g_old_z.x > 0)
+    if (g_ctx.old_z.x > 0)
     {
-        g_new_z.x = foldxinitx - foldyinity - 1.0;
-        g_new_z.y = foldxinity * 2;
+        g_ctx.new_z.x = foldxinitx - foldyinity - 1.0;
+        g_ctx.new_z.y = foldxinity * 2;
     }
     else
     {
-        g_new_z.x = foldxinitx - foldyinity -1.0 + g_float_param->x * g_old_z.x;
-        g_new_z.y = foldxinity * 2;
+        g_ctx.new_z.x = foldxinitx - foldyinity -1.0 + g_ctx.float_param->x * g_ctx.old_z.x;
+        g_ctx.new_z.y = foldxinity * 2;
 
         /* This term added by Tim Wegner to make dependent on the
            imaginary part of the parameter. (Otherwise Mandelbrot
            is uninteresting. */
-        g_new_z.y += g_float_param->y * g_old_z.x;
+        g_ctx.new_z.y += g_ctx.float_param->y * g_ctx.old_z.x;
     }
     return floatbailout();
 }
@@ -1196,18 +1256,18 @@ int TrigPlusZsquaredfpFractal()
     // A Biomorph
     // z(n+1) = trig(z(n))+z(n)**2+C
 
-    CMPLXtrig0(g_old_z, g_new_z);
-    g_new_z.x += g_temp_sqr_x - g_temp_sqr_y + g_float_param->x;
-    g_new_z.y += 2.0 * g_old_z.x * g_old_z.y + g_float_param->y;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
+    g_ctx.new_z.x += g_ctx.temp_sqr_x - g_ctx.temp_sqr_y + g_ctx.float_param->x;
+    g_ctx.new_z.y += 2.0 * g_ctx.old_z.x * g_ctx.old_z.y + g_ctx.float_param->y;
     return floatbailout();
 }
 
 int Richard8fpFractal()
 {
     //  Richard8 {c = z = pixel: z=sin(z)+sin(pixel),|z|<=50}
-    CMPLXtrig0(g_old_z, g_new_z);
-    g_new_z.x += g_tmp_z.x;
-    g_new_z.y += g_tmp_z.y;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
+    g_ctx.new_z.x += g_ctx.tmp_z.x;
+    g_ctx.new_z.y += g_ctx.tmp_z.y;
     return floatbailout();
 }
 
@@ -1226,64 +1286,64 @@ int Richard8Fractal()
 
 int PopcornFractal_Old()
 {
-    g_tmp_z = g_old_z;
-    g_tmp_z.x *= 3.0;
-    g_tmp_z.y *= 3.0;
-    FPUsincos(&g_tmp_z.x, &g_sin_x, &g_cos_x);
-    FPUsincos(&g_tmp_z.y, &siny, &cosy);
-    g_tmp_z.x = g_sin_x/g_cos_x + g_old_z.x;
-    g_tmp_z.y = siny/cosy + g_old_z.y;
-    FPUsincos(&g_tmp_z.x, &g_sin_x, &g_cos_x);
-    FPUsincos(&g_tmp_z.y, &siny, &cosy);
-    g_new_z.x = g_old_z.x - g_param_z1.x*siny;
-    g_new_z.y = g_old_z.y - g_param_z1.x*g_sin_x;
+    g_ctx.tmp_z = g_ctx.old_z;
+    g_ctx.tmp_z.x *= 3.0;
+    g_ctx.tmp_z.y *= 3.0;
+    FPUsincos(&g_ctx.tmp_z.x, &g_sin_x, &g_cos_x);
+    FPUsincos(&g_ctx.tmp_z.y, &siny, &cosy);
+    g_ctx.tmp_z.x = g_sin_x/g_cos_x + g_ctx.old_z.x;
+    g_ctx.tmp_z.y = siny/cosy + g_ctx.old_z.y;
+    FPUsincos(&g_ctx.tmp_z.x, &g_sin_x, &g_cos_x);
+    FPUsincos(&g_ctx.tmp_z.y, &siny, &cosy);
+    g_ctx.new_z.x = g_ctx.old_z.x - g_ctx.param_z1.x*siny;
+    g_ctx.new_z.y = g_ctx.old_z.y - g_ctx.param_z1.x*g_sin_x;
     if (g_plot == noplot)
     {
-        plot_orbit(g_new_z.x, g_new_z.y, 1+g_row%g_colors);
-        g_old_z = g_new_z;
+        plot_orbit(g_ctx.new_z.x, g_ctx.new_z.y, 1+g_row%g_colors);
+        g_ctx.old_z = g_ctx.new_z;
     }
     else
     {
-        g_temp_sqr_x = sqr(g_new_z.x);
+        g_ctx.temp_sqr_x = sqr(g_ctx.new_z.x);
     }
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_magnitude >= g_magnitude_limit)
+    g_ctx.temp_sqr_y = sqr(g_ctx.new_z.y);
+    g_ctx.magnitude = g_ctx.temp_sqr_x + g_ctx.temp_sqr_y;
+    if (g_ctx.magnitude >= g_ctx.magnitude_limit)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
 int PopcornFractal()
 {
-    g_tmp_z = g_old_z;
-    g_tmp_z.x *= 3.0;
-    g_tmp_z.y *= 3.0;
-    FPUsincos(&g_tmp_z.x, &g_sin_x, &g_cos_x);
-    FPUsincos(&g_tmp_z.y, &siny, &cosy);
-    g_tmp_z.x = g_sin_x/g_cos_x + g_old_z.x;
-    g_tmp_z.y = siny/cosy + g_old_z.y;
-    FPUsincos(&g_tmp_z.x, &g_sin_x, &g_cos_x);
-    FPUsincos(&g_tmp_z.y, &siny, &cosy);
-    g_new_z.x = g_old_z.x - g_param_z1.x*siny;
-    g_new_z.y = g_old_z.y - g_param_z1.x*g_sin_x;
+    g_ctx.tmp_z = g_ctx.old_z;
+    g_ctx.tmp_z.x *= 3.0;
+    g_ctx.tmp_z.y *= 3.0;
+    FPUsincos(&g_ctx.tmp_z.x, &g_sin_x, &g_cos_x);
+    FPUsincos(&g_ctx.tmp_z.y, &siny, &cosy);
+    g_ctx.tmp_z.x = g_sin_x/g_cos_x + g_ctx.old_z.x;
+    g_ctx.tmp_z.y = siny/cosy + g_ctx.old_z.y;
+    FPUsincos(&g_ctx.tmp_z.x, &g_sin_x, &g_cos_x);
+    FPUsincos(&g_ctx.tmp_z.y, &siny, &cosy);
+    g_ctx.new_z.x = g_ctx.old_z.x - g_ctx.param_z1.x*siny;
+    g_ctx.new_z.y = g_ctx.old_z.y - g_ctx.param_z1.x*g_sin_x;
     if (g_plot == noplot)
     {
-        plot_orbit(g_new_z.x, g_new_z.y, 1+g_row%g_colors);
-        g_old_z = g_new_z;
+        plot_orbit(g_ctx.new_z.x, g_ctx.new_z.y, 1+g_row%g_colors);
+        g_ctx.old_z = g_ctx.new_z;
     }
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_magnitude >= g_magnitude_limit
-        || std::fabs(g_new_z.x) > g_magnitude_limit2
-        || std::fabs(g_new_z.y) > g_magnitude_limit2)
+    g_ctx.temp_sqr_x = sqr(g_ctx.new_z.x);
+    g_ctx.temp_sqr_y = sqr(g_ctx.new_z.y);
+    g_ctx.magnitude = g_ctx.temp_sqr_x + g_ctx.temp_sqr_y;
+    if (g_ctx.magnitude >= g_ctx.magnitude_limit
+        || std::fabs(g_ctx.new_z.x) > g_magnitude_limit2
+        || std::fabs(g_ctx.new_z.y) > g_magnitude_limit2)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -1379,39 +1439,39 @@ int PopcornFractalFn()
     DComplex tmpy;
 
     // tmpx contains the generalized value of the old real "x" equation
-    g_tmp_z = g_param_z2*g_old_z.y;  // tmp = (C * old.y)
-    CMPLXtrig1(g_tmp_z, tmpx);             // tmpx = trig1(tmp)
-    tmpx.x += g_old_z.y;                  // tmpx = old.y + trig1(tmp)
-    CMPLXtrig0(tmpx, g_tmp_z);             // tmp = trig0(tmpx)
-    CMPLXmult(g_tmp_z, g_param_z1, tmpx);         // tmpx = tmp * h
+    g_ctx.tmp_z = g_ctx.param_z2*g_ctx.old_z.y;  // tmp = (C * old.y)
+    CMPLXtrig1(g_ctx.tmp_z, tmpx);             // tmpx = trig1(tmp)
+    tmpx.x += g_ctx.old_z.y;                  // tmpx = old.y + trig1(tmp)
+    CMPLXtrig0(tmpx, g_ctx.tmp_z);             // tmp = trig0(tmpx)
+    CMPLXmult(g_ctx.tmp_z, g_ctx.param_z1, tmpx);         // tmpx = tmp * h
 
     // tmpy contains the generalized value of the old real "y" equation
-    g_tmp_z = g_param_z2*g_old_z.x;  // tmp = (C * old.x)
-    CMPLXtrig3(g_tmp_z, tmpy);             // tmpy = trig3(tmp)
-    tmpy.x += g_old_z.x;                  // tmpy = old.x + trig1(tmp)
-    CMPLXtrig2(tmpy, g_tmp_z);             // tmp = trig2(tmpy)
+    g_ctx.tmp_z = g_ctx.param_z2*g_ctx.old_z.x;  // tmp = (C * old.x)
+    CMPLXtrig3(g_ctx.tmp_z, tmpy);             // tmpy = trig3(tmp)
+    tmpy.x += g_ctx.old_z.x;                  // tmpy = old.x + trig1(tmp)
+    CMPLXtrig2(tmpy, g_ctx.tmp_z);             // tmp = trig2(tmpy)
 
-    CMPLXmult(g_tmp_z, g_param_z1, tmpy);         // tmpy = tmp * h
+    CMPLXmult(g_ctx.tmp_z, g_ctx.param_z1, tmpy);         // tmpy = tmp * h
 
-    g_new_z.x = g_old_z.x - tmpx.x - tmpy.y;
-    g_new_z.y = g_old_z.y - tmpy.x - tmpx.y;
+    g_ctx.new_z.x = g_ctx.old_z.x - tmpx.x - tmpy.y;
+    g_ctx.new_z.y = g_ctx.old_z.y - tmpy.x - tmpx.y;
 
     if (g_plot == noplot)
     {
-        plot_orbit(g_new_z.x, g_new_z.y, 1+g_row%g_colors);
-        g_old_z = g_new_z;
+        plot_orbit(g_ctx.new_z.x, g_ctx.new_z.y, 1+g_row%g_colors);
+        g_ctx.old_z = g_ctx.new_z;
     }
 
-    g_temp_sqr_x = sqr(g_new_z.x);
-    g_temp_sqr_y = sqr(g_new_z.y);
-    g_magnitude = g_temp_sqr_x + g_temp_sqr_y;
-    if (g_magnitude >= g_magnitude_limit
-        || std::fabs(g_new_z.x) > g_magnitude_limit2
-        || std::fabs(g_new_z.y) > g_magnitude_limit2)
+    g_ctx.temp_sqr_x = sqr(g_ctx.new_z.x);
+    g_ctx.temp_sqr_y = sqr(g_ctx.new_z.y);
+    g_ctx.magnitude = g_ctx.temp_sqr_x + g_ctx.temp_sqr_y;
+    if (g_ctx.magnitude >= g_ctx.magnitude_limit
+        || std::fabs(g_ctx.new_z.x) > g_magnitude_limit2
+        || std::fabs(g_ctx.new_z.y) > g_magnitude_limit2)
     {
         return 1;
     }
-    g_old_z = g_new_z;
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -1475,21 +1535,21 @@ int LPopcornFractalFn()
 
 int MarksCplxMand()
 {
-    g_tmp_z.x = g_temp_sqr_x - g_temp_sqr_y;
-    g_tmp_z.y = 2*g_old_z.x*g_old_z.y;
-    FPUcplxmul(&g_tmp_z, &g_marks_coefficient, &g_new_z);
-    g_new_z.x += g_float_param->x;
-    g_new_z.y += g_float_param->y;
+    g_ctx.tmp_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y;
+    g_ctx.tmp_z.y = 2*g_ctx.old_z.x*g_ctx.old_z.y;
+    FPUcplxmul(&g_ctx.tmp_z, &g_ctx.marks_coefficient, &g_ctx.new_z);
+    g_ctx.new_z.x += g_ctx.float_param->x;
+    g_ctx.new_z.y += g_ctx.float_param->y;
     return floatbailout();
 }
 
 int SpiderfpFractal()
 {
     // Spider(XAXIS) { c=z=pixel: z=z*z+c; c=c/2+z, |z|<=4 }
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y + g_tmp_z.x;
-    g_new_z.y = 2 * g_old_z.x * g_old_z.y + g_tmp_z.y;
-    g_tmp_z.x = g_tmp_z.x/2 + g_new_z.x;
-    g_tmp_z.y = g_tmp_z.y/2 + g_new_z.y;
+    g_ctx.new_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y + g_ctx.tmp_z.x;
+    g_ctx.new_z.y = 2 * g_ctx.old_z.x * g_ctx.old_z.y + g_ctx.tmp_z.y;
+    g_ctx.tmp_z.x = g_ctx.tmp_z.x/2 + g_ctx.new_z.x;
+    g_ctx.tmp_z.y = g_ctx.tmp_z.y/2 + g_ctx.new_z.y;
     return floatbailout();
 }
 
@@ -1510,7 +1570,7 @@ int SpiderFractal()
 int TetratefpFractal()
 {
     // Tetrate(XAXIS) { c=z=pixel: z=c^z, |z|<=(P1+3) }
-    g_new_z = ComplexPower(*g_float_param, g_old_z);
+    g_ctx.new_z = ComplexPower(*g_ctx.float_param, g_ctx.old_z);
     return floatbailout();
 }
 
@@ -1558,29 +1618,30 @@ int SkinnerZXTrigSubZFractal()
 int ZXTrigPlusZfpFractal()
 {
     // z = (p1*z*trig(z))+p2*z
-    CMPLXtrig0(g_old_z, g_tmp_z);          // tmp  = trig(old)
-    CMPLXmult(g_param_z1, g_tmp_z, g_tmp_z);      // tmp  = p1*trig(old)
-    CMPLXmult(g_old_z, g_tmp_z, tmp2);      // tmp2 = p1*old*trig(old)
-    CMPLXmult(g_param_z2, g_old_z, g_tmp_z);     // tmp  = p2*old
-    g_new_z = tmp2 + g_tmp_z;       // new  = p1*trig(old) + p2*old
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);          // tmp  = trig(old)
+    CMPLXmult(g_ctx.param_z1, g_ctx.tmp_z, g_ctx.tmp_z);      // tmp  = p1*trig(old)
+    DComplex tmp2;
+    CMPLXmult(g_ctx.old_z, g_ctx.tmp_z, tmp2);      // tmp2 = p1*old*trig(old)
+    CMPLXmult(g_ctx.param_z2, g_ctx.old_z, g_ctx.tmp_z);     // tmp  = p2*old
+    g_ctx.new_z = tmp2 + g_ctx.tmp_z;       // new  = p1*trig(old) + p2*old
     return floatbailout();
 }
 
 int ScottZXTrigPlusZfpFractal()
 {
     // z = (z*trig(z))+z
-    CMPLXtrig0(g_old_z, g_tmp_z);         // tmp  = trig(old)
-    CMPLXmult(g_old_z, g_tmp_z, g_new_z);       // new  = old*trig(old)
-    g_new_z += g_old_z;        // new  = trig(old) + old
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);         // tmp  = trig(old)
+    CMPLXmult(g_ctx.old_z, g_ctx.tmp_z, g_ctx.new_z);       // new  = old*trig(old)
+    g_ctx.new_z += g_ctx.old_z;        // new  = trig(old) + old
     return floatbailout();
 }
 
 int SkinnerZXTrigSubZfpFractal()
 {
     // z = (z*trig(z))-z
-    CMPLXtrig0(g_old_z, g_tmp_z);         // tmp  = trig(old)
-    CMPLXmult(g_old_z, g_tmp_z, g_new_z);       // new  = old*trig(old)
-    g_new_z -= g_old_z;        // new  = trig(old) - old
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);         // tmp  = trig(old)
+    CMPLXmult(g_ctx.old_z, g_ctx.tmp_z, g_ctx.new_z);       // new  = old*trig(old)
+    g_ctx.new_z -= g_ctx.old_z;        // new  = trig(old) - old
     return floatbailout();
 }
 
@@ -1600,9 +1661,9 @@ int Sqr1overTrigFractal()
 int Sqr1overTrigfpFractal()
 {
     // z = sqr(1/trig(z))
-    CMPLXtrig0(g_old_z, g_old_z);
-    CMPLXrecip(g_old_z, g_old_z);
-    CMPLXsqr(g_old_z, g_new_z);
+    CMPLXtrig0(g_ctx.old_z, g_ctx.old_z);
+    CMPLXrecip(g_ctx.old_z, g_ctx.old_z);
+    CMPLXsqr(g_ctx.old_z, g_ctx.new_z);
     return floatbailout();
 }
 
@@ -1624,11 +1685,11 @@ int TrigPlusTrigFractal()
 int TrigPlusTrigfpFractal()
 {
     // z = trig0(z)*p1+trig1(z)*p2
-    CMPLXtrig0(g_old_z, g_tmp_z);
-    CMPLXmult(g_param_z1, g_tmp_z, g_tmp_z);
-    CMPLXtrig1(g_old_z, g_old_z);
-    CMPLXmult(g_param_z2, g_old_z, g_old_z);
-    g_new_z = g_tmp_z + g_old_z;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);
+    CMPLXmult(g_ctx.param_z1, g_ctx.tmp_z, g_ctx.tmp_z);
+    CMPLXtrig1(g_ctx.old_z, g_ctx.old_z);
+    CMPLXmult(g_ctx.param_z2, g_ctx.old_z, g_ctx.old_z);
+    g_ctx.new_z = g_ctx.tmp_z + g_ctx.old_z;
     return floatbailout();
 }
 
@@ -1661,15 +1722,15 @@ int LambdaTrigOrTrigfpFractal()
 {
     /* z = trig0(z)*p1 if mod(old) < p2.x and
            trig1(z)*p1 if mod(old) >= p2.x */
-    if (CMPLXmod(g_old_z) < g_param_z2.x)
+    if (CMPLXmod(g_ctx.old_z) < g_ctx.param_z2.x)
     {
-        CMPLXtrig0(g_old_z, g_old_z);
-        FPUcplxmul(g_float_param, &g_old_z, &g_new_z);
+        CMPLXtrig0(g_ctx.old_z, g_ctx.old_z);
+        FPUcplxmul(g_ctx.float_param, &g_ctx.old_z, &g_ctx.new_z);
     }
     else
     {
-        CMPLXtrig1(g_old_z, g_old_z);
-        FPUcplxmul(g_float_param, &g_old_z, &g_new_z);
+        CMPLXtrig1(g_ctx.old_z, g_ctx.old_z);
+        FPUcplxmul(g_ctx.float_param, &g_ctx.old_z, &g_ctx.new_z);
     }
     return floatbailout();
 }
@@ -1699,15 +1760,15 @@ int JuliaTrigOrTrigfpFractal()
 {
     /* z = trig0(z)+p1 if mod(old) < p2.x and
            trig1(z)+p1 if mod(old) >= p2.x */
-    if (CMPLXmod(g_old_z) < g_param_z2.x)
+    if (CMPLXmod(g_ctx.old_z) < g_ctx.param_z2.x)
     {
-        CMPLXtrig0(g_old_z, g_old_z);
-        g_new_z = *g_float_param + g_old_z;
+        CMPLXtrig0(g_ctx.old_z, g_ctx.old_z);
+        g_ctx.new_z = *g_ctx.float_param + g_ctx.old_z;
     }
     else
     {
-        CMPLXtrig1(g_old_z, g_old_z);
-        g_new_z = *g_float_param + g_old_z;
+        CMPLXtrig1(g_ctx.old_z, g_ctx.old_z);
+        g_ctx.new_z = *g_ctx.float_param + g_ctx.old_z;
     }
     return floatbailout();
 }
@@ -1768,7 +1829,7 @@ int MPCHalleyFractal()
     mpctmp   =  MPCmul(g_mpc_temp_param, mpcHalnumer2);  // mpctmpparm is
     // relaxation coef.
     mpcnew = MPCsub(mpcold, mpctmp);
-    g_new_z    = MPC2cmplx(mpcnew);
+    g_ctx.new_z    = MPC2cmplx(mpcnew);
     return MPCHalleybailout() || g_mp_overflow;
 #else
     return 0;
@@ -1783,15 +1844,15 @@ int HalleyFractal()
     DComplex FX, F1prime, F2prime, Halnumer1, Halnumer2, Haldenom;
     DComplex relax;
 
-    XtoAlessOne = g_old_z;
+    XtoAlessOne = g_ctx.old_z;
     for (int ihal = 2; ihal < g_degree; ihal++)
     {
-        FPUcplxmul(&g_old_z, &XtoAlessOne, &XtoAlessOne);
+        FPUcplxmul(&g_ctx.old_z, &XtoAlessOne, &XtoAlessOne);
     }
-    FPUcplxmul(&g_old_z, &XtoAlessOne, &XtoA);
-    FPUcplxmul(&g_old_z, &XtoA, &XtoAplusOne);
+    FPUcplxmul(&g_ctx.old_z, &XtoAlessOne, &XtoA);
+    FPUcplxmul(&g_ctx.old_z, &XtoA, &XtoAplusOne);
 
-    FX = XtoAplusOne - g_old_z;        // FX = X^(a+1) - X  = F
+    FX = XtoAplusOne - g_ctx.old_z;        // FX = X^(a+1) - X  = F
     F2prime.x = g_halley_a_plus_one_times_degree * XtoAlessOne.x; // g_halley_a_plus_one_times_degree in setup
     F2prime.y = g_halley_a_plus_one_times_degree * XtoAlessOne.y;        // F"
 
@@ -1806,11 +1867,11 @@ int HalleyFractal()
     Halnumer2 = F1prime - Halnumer1;          //  F' - F"F/2F'
     FPUcplxdiv(&FX, &Halnumer2, &Halnumer2);
     // parm.y is relaxation coef.
-    relax.x = g_param_z1.y;
+    relax.x = g_ctx.param_z1.y;
     relax.y = g_params[3];
     FPUcplxmul(&relax, &Halnumer2, &Halnumer2);
-    g_new_z.x = g_old_z.x - Halnumer2.x;
-    g_new_z.y = g_old_z.y - Halnumer2.y;
+    g_ctx.new_z.x = g_ctx.old_z.x - Halnumer2.x;
+    g_ctx.new_z.y = g_ctx.old_z.y - Halnumer2.y;
     return Halleybailout();
 }
 
@@ -1828,14 +1889,19 @@ int LongPhoenixFractal()
 #endif
 }
 
-int PhoenixFractal()
+int PhoenixFractal(CalcContext &ctx)
 {
     // z(n+1) = z(n)^2 + p + qy(n),  y(n+1) = z(n)
-    g_tmp_z.x = g_old_z.x * g_old_z.y;
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y + g_float_param->x + (g_float_param->y * tmp2.x);
-    g_new_z.y = (g_tmp_z.x + g_tmp_z.x) + (g_float_param->y * tmp2.y);
-    tmp2 = g_old_z; // set tmp2 to Y value
-    return floatbailout();
+    ctx.tmp_z.x = ctx.old_z.x * ctx.old_z.y;
+    ctx.new_z.x = ctx.temp_sqr_x - ctx.temp_sqr_y + ctx.float_param->x + (ctx.float_param->y * ctx.phoenix_y.x);
+    ctx.new_z.y = (ctx.tmp_z.x + ctx.tmp_z.x) + (ctx.float_param->y * ctx.phoenix_y.y);
+    ctx.phoenix_y = ctx.old_z; // set phoenix_y to Y value
+    return ctx.bailout(ctx);
+}
+
+int PhoenixFractal()
+{
+    return PhoenixFractal(g_ctx);
 }
 
 int LongPhoenixFractalcplx()
@@ -1852,14 +1918,19 @@ int LongPhoenixFractalcplx()
 #endif
 }
 
-int PhoenixFractalcplx()
+int PhoenixFractalcplx(CalcContext &ctx)
 {
     // z(n+1) = z(n)^2 + p1 + p2*y(n),  y(n+1) = z(n)
-    g_tmp_z.x = g_old_z.x * g_old_z.y;
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y + g_float_param->x + (g_param_z2.x * tmp2.x) - (g_param_z2.y * tmp2.y);
-    g_new_z.y = (g_tmp_z.x + g_tmp_z.x) + g_float_param->y + (g_param_z2.x * tmp2.y) + (g_param_z2.y * tmp2.x);
-    tmp2 = g_old_z; // set tmp2 to Y value
-    return floatbailout();
+    ctx.tmp_z.x = ctx.old_z.x * ctx.old_z.y;
+    ctx.new_z.x = ctx.temp_sqr_x - ctx.temp_sqr_y + ctx.float_param->x + (ctx.param_z2.x * ctx.phoenix_y.x) - (ctx.param_z2.y * ctx.phoenix_y.y);
+    ctx.new_z.y = (ctx.tmp_z.x + ctx.tmp_z.x) + ctx.float_param->y + (ctx.param_z2.x * ctx.phoenix_y.y) + (ctx.param_z2.y * ctx.phoenix_y.x);
+    ctx.phoenix_y = ctx.old_z; // set phoenix_y to Y value
+    return ctx.bailout(ctx);
+}
+
+int PhoenixFractalcplx()
+{
+    return PhoenixFractalcplx(g_ctx);
 }
 
 int LongPhoenixPlusFractal()
@@ -1885,23 +1956,28 @@ int LongPhoenixPlusFractal()
 #endif
 }
 
-int PhoenixPlusFractal()
+int PhoenixPlusFractal(CalcContext &ctx)
 {
     // z(n+1) = z(n)^(degree-1) * (z(n) + p) + qy(n),  y(n+1) = z(n)
     DComplex oldplus, newminus;
-    oldplus = g_old_z;
-    g_tmp_z = g_old_z;
+    oldplus = ctx.old_z;
+    ctx.tmp_z = ctx.old_z;
     for (int i = 1; i < g_degree; i++)
     {
         // degree >= 2, degree=degree-1 in setup
-        FPUcplxmul(&g_old_z, &g_tmp_z, &g_tmp_z); // = old^(degree-1)
+        FPUcplxmul(&ctx.old_z, &ctx.tmp_z, &ctx.tmp_z); // = old^(degree-1)
     }
-    oldplus.x += g_float_param->x;
-    FPUcplxmul(&g_tmp_z, &oldplus, &newminus);
-    g_new_z.x = newminus.x + (g_float_param->y * tmp2.x);
-    g_new_z.y = newminus.y + (g_float_param->y * tmp2.y);
-    tmp2 = g_old_z; // set tmp2 to Y value
-    return floatbailout();
+    oldplus.x += ctx.float_param->x;
+    FPUcplxmul(&ctx.tmp_z, &oldplus, &newminus);
+    ctx.new_z.x = newminus.x + (ctx.float_param->y * ctx.phoenix_y.x);
+    ctx.new_z.y = newminus.y + (ctx.float_param->y * ctx.phoenix_y.y);
+    ctx.phoenix_y = ctx.old_z; // set phoenix_y to Y value
+    return ctx.bailout(ctx);
+}
+
+int PhoenixPlusFractal()
+{
+    return PhoenixPlusFractal(g_ctx);
 }
 
 int LongPhoenixMinusFractal()
@@ -1927,23 +2003,28 @@ int LongPhoenixMinusFractal()
 #endif
 }
 
-int PhoenixMinusFractal()
+int PhoenixMinusFractal(CalcContext &ctx)
 {
     // z(n+1) = z(n)^(degree-2) * (z(n)^2 + p) + qy(n),  y(n+1) = z(n)
     DComplex oldsqr, newminus;
-    FPUcplxmul(&g_old_z, &g_old_z, &oldsqr);
-    g_tmp_z = g_old_z;
+    FPUcplxmul(&ctx.old_z, &ctx.old_z, &oldsqr);
+    ctx.tmp_z = ctx.old_z;
     for (int i = 1; i < g_degree; i++)
     {
         // degree >= 3, degree=degree-2 in setup
-        FPUcplxmul(&g_old_z, &g_tmp_z, &g_tmp_z); // = old^(degree-2)
+        FPUcplxmul(&ctx.old_z, &ctx.tmp_z, &ctx.tmp_z); // = old^(degree-2)
     }
-    oldsqr.x += g_float_param->x;
-    FPUcplxmul(&g_tmp_z, &oldsqr, &newminus);
-    g_new_z.x = newminus.x + (g_float_param->y * tmp2.x);
-    g_new_z.y = newminus.y + (g_float_param->y * tmp2.y);
-    tmp2 = g_old_z; // set tmp2 to Y value
-    return floatbailout();
+    oldsqr.x += ctx.float_param->x;
+    FPUcplxmul(&ctx.tmp_z, &oldsqr, &newminus);
+    ctx.new_z.x = newminus.x + (ctx.float_param->y * ctx.phoenix_y.x);
+    ctx.new_z.y = newminus.y + (ctx.float_param->y * ctx.phoenix_y.y);
+    ctx.phoenix_y = ctx.old_z; // set phoenix_y to Y value
+    return ctx.bailout(ctx);
+}
+
+int PhoenixMinusFractal()
+{
+    return PhoenixMinusFractal(g_ctx);
 }
 
 int LongPhoenixCplxPlusFractal()
@@ -1975,20 +2056,20 @@ int PhoenixCplxPlusFractal()
 {
     // z(n+1) = z(n)^(degree-1) * (z(n) + p) + qy(n),  y(n+1) = z(n)
     DComplex oldplus, newminus;
-    oldplus = g_old_z;
-    g_tmp_z = g_old_z;
+    oldplus = g_ctx.old_z;
+    g_ctx.tmp_z = g_ctx.old_z;
     for (int i = 1; i < g_degree; i++)
     {
         // degree >= 2, degree=degree-1 in setup
-        FPUcplxmul(&g_old_z, &g_tmp_z, &g_tmp_z); // = old^(degree-1)
-    }
-    oldplus.x += g_float_param->x;
-    oldplus.y += g_float_param->y;
-    FPUcplxmul(&g_tmp_z, &oldplus, &newminus);
-    FPUcplxmul(&g_param_z2, &tmp2, &g_tmp_z);
-    g_new_z.x = newminus.x + g_tmp_z.x;
-    g_new_z.y = newminus.y + g_tmp_z.y;
-    tmp2 = g_old_z; // set tmp2 to Y value
+        FPUcplxmul(&g_ctx.old_z, &g_ctx.tmp_z, &g_ctx.tmp_z); // = old^(degree-1)
+    }
+    oldplus.x += g_ctx.float_param->x;
+    oldplus.y += g_ctx.float_param->y;
+    FPUcplxmul(&g_ctx.tmp_z, &oldplus, &newminus);
+    FPUcplxmul(&g_ctx.param_z2, &g_ctx.phoenix_y, &g_ctx.tmp_z);
+    g_ctx.new_z.x = newminus.x + g_ctx.tmp_z.x;
+    g_ctx.new_z.y = newminus.y + g_ctx.tmp_z.y;
+    g_ctx.phoenix_y = g_ctx.old_z; // set phoenix_y to Y value
     return floatbailout();
 }
 
@@ -2021,20 +2102,20 @@ int PhoenixCplxMinusFractal()
 {
     // z(n+1) = z(n)^(degree-2) * (z(n)^2 + p) + qy(n),  y(n+1) = z(n)
     DComplex oldsqr, newminus;
-    FPUcplxmul(&g_old_z, &g_old_z, &oldsqr);
-    g_tmp_z = g_old_z;
+    FPUcplxmul(&g_ctx.old_z, &g_ctx.old_z, &oldsqr);
+    g_ctx.tmp_z = g_ctx.old_z;
     for (int i = 1; i < g_degree; i++)
     {
         // degree >= 3, degree=degree-2 in setup
-        FPUcplxmul(&g_old_z, &g_tmp_z, &g_tmp_z); // = old^(degree-2)
-    }
-    oldsqr.x += g_float_param->x;
-    oldsqr.y += g_float_param->y;
-    FPUcplxmul(&g_tmp_z, &oldsqr, &newminus);
-    FPUcplxmul(&g_param_z2, &tmp2, &g_tmp_z);
-    g_new_z.x = newminus.x + g_tmp_z.x;
-    g_new_z.y = newminus.y + g_tmp_z.y;
-    tmp2 = g_old_z; // set tmp2 to Y value
+        FPUcplxmul(&g_ctx.old_z, &g_ctx.tmp_z, &g_ctx.tmp_z); // = old^(degree-2)
+    }
+    oldsqr.x += g_ctx.float_param->x;
+    oldsqr.y += g_ctx.float_param->y;
+    FPUcplxmul(&g_ctx.tmp_z, &oldsqr, &newminus);
+    FPUcplxmul(&g_ctx.param_z2, &g_ctx.phoenix_y, &g_ctx.tmp_z);
+    g_ctx.new_z.x = newminus.x + g_ctx.tmp_z.x;
+    g_ctx.new_z.y = newminus.y + g_ctx.tmp_z.y;
+    g_ctx.phoenix_y = g_ctx.old_z; // set phoenix_y to Y value
     return floatbailout();
 }
 
@@ -2054,9 +2135,10 @@ int ScottTrigPlusTrigFractal()
 int ScottTrigPlusTrigfpFractal()
 {
     // z = trig0(z)+trig1(z)
-    CMPLXtrig0(g_old_z, g_tmp_z);
-    CMPLXtrig1(g_old_z, tmp2);
-    g_new_z = g_tmp_z + tmp2;
+    DComplex tmp2;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);
+    CMPLXtrig1(g_ctx.old_z, tmp2);
+    g_ctx.new_z = g_ctx.tmp_z + tmp2;
     return floatbailout();
 }
 
@@ -2076,18 +2158,19 @@ int SkinnerTrigSubTrigFractal()
 int SkinnerTrigSubTrigfpFractal()
 {
     // z = trig0(z)-trig1(z)
-    CMPLXtrig0(g_old_z, g_tmp_z);
-    CMPLXtrig1(g_old_z, tmp2);
-    g_new_z = g_tmp_z - tmp2;
+    DComplex tmp2;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);
+    CMPLXtrig1(g_ctx.old_z, tmp2);
+    g_ctx.new_z = g_ctx.tmp_z - tmp2;
     return floatbailout();
 }
 
 int TrigXTrigfpFractal()
 {
     // z = trig0(z)*trig1(z)
-    CMPLXtrig0(g_old_z, g_tmp_z);
-    CMPLXtrig1(g_old_z, g_old_z);
-    CMPLXmult(g_tmp_z, g_old_z, g_new_z);
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);
+    CMPLXtrig1(g_ctx.old_z, g_ctx.old_z);
+    CMPLXmult(g_ctx.tmp_z, g_ctx.old_z, g_ctx.new_z);
     return floatbailout();
 }
 
@@ -2097,15 +2180,15 @@ static int TryFloatFractal(int (*fpFractal)())
 {
     g_overflow = false;
     // lold had better not be changed!
-    g_old_z.x = g_l_old_z.x;
-    g_old_z.x /= g_fudge_factor;
-    g_old_z.y = g_l_old_z.y;
-    g_old_z.y /= g_fudge_factor;
-    g_temp_sqr_x = sqr(g_old_z.x);
-    g_temp_sqr_y = sqr(g_old_z.y);
+    g_ctx.old_z.x = g_l_old_z.x;
+    g_ctx.old_z.x /= g_fudge_factor;
+    g_ctx.old_z.y = g_l_old_z.y;
+    g_ctx.old_z.y /= g_fudge_factor;
+    g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+    g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
     fpFractal();
-    g_l_new_z.x = (long)(g_new_z.x*g_fudge_factor);
-    g_l_new_z.y = (long)(g_new_z.y*g_fudge_factor);
+    g_l_new_z.x = (long)(g_ctx.new_z.x*g_fudge_factor);
+    g_l_new_z.y = (long)(g_ctx.new_z.y*g_fudge_factor);
     return 0;
 }
 #endif
@@ -2151,11 +2234,12 @@ int TrigPlusSqrFractal() // generalization of Scott and Skinner types
 int TrigPlusSqrfpFractal() // generalization of Scott and Skinner types
 {
     // { z=pixel: z=(p1,p2)*trig(z)+(p3,p4)*sqr(z), |z|<BAILOUT }
-    CMPLXtrig0(g_old_z, g_tmp_z);     // tmp = trig(old)
-    CMPLXmult(g_param_z1, g_tmp_z, g_new_z); // new = parm*trig(old)
-    CMPLXsqr_old(g_tmp_z);        // tmp = sqr(old)
-    CMPLXmult(g_param_z2, g_tmp_z, tmp2); // tmp = parm2*sqr(old)
-    g_new_z += tmp2;    // new = parm*trig(old)+parm2*sqr(old)
+    DComplex tmp2;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);     // tmp = trig(old)
+    CMPLXmult(g_ctx.param_z1, g_ctx.tmp_z, g_ctx.new_z); // new = parm*trig(old)
+    CMPLXsqr_old(g_ctx.tmp_z);        // tmp = sqr(old)
+    CMPLXmult(g_ctx.param_z2, g_ctx.tmp_z, tmp2); // tmp = parm2*sqr(old)
+    g_ctx.new_z += tmp2;    // new = parm*trig(old)+parm2*sqr(old)
     return floatbailout();
 }
 
@@ -2175,9 +2259,9 @@ int ScottTrigPlusSqrFractal()
 int ScottTrigPlusSqrfpFractal() // float version
 {
     // { z=pixel: z=sin(z)+sqr(z), |z|<BAILOUT }
-    CMPLXtrig0(g_old_z, g_new_z);       // new = trig(old)
-    CMPLXsqr_old(g_tmp_z);          // tmp = sqr(old)
-    g_new_z += g_tmp_z;      // new = trig(old)+sqr(old)
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);       // new = trig(old)
+    CMPLXsqr_old(g_ctx.tmp_z);          // tmp = sqr(old)
+    g_ctx.new_z += g_ctx.tmp_z;      // new = trig(old)+sqr(old)
     return floatbailout();
 }
 
@@ -2197,17 +2281,17 @@ int SkinnerTrigSubSqrFractal()
 int SkinnerTrigSubSqrfpFractal()
 {
     // { z=pixel: z=sin(z)-sqr(z), |z|<BAILOUT }
-    CMPLXtrig0(g_old_z, g_new_z);   // new = trig(old)
-    CMPLXsqr_old(g_tmp_z);          // old = sqr(old)
-    g_new_z -= g_tmp_z;             // new = trig(old)-sqr(old)
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);   // new = trig(old)
+    CMPLXsqr_old(g_ctx.tmp_z);          // old = sqr(old)
+    g_ctx.new_z -= g_ctx.tmp_z;             // new = trig(old)-sqr(old)
     return floatbailout();
 }
 
 int TrigZsqrdfpFractal()
 {
     // { z=pixel: z=trig(z*z), |z|<TEST }
-    CMPLXsqr_old(g_tmp_z);
-    CMPLXtrig0(g_tmp_z, g_new_z);
+    CMPLXsqr_old(g_ctx.tmp_z);
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.new_z);
     return floatbailout();
 }
 
@@ -2250,8 +2334,8 @@ int SqrTrigFractal()
 int SqrTrigfpFractal()
 {
     // SZSB(XYAXIS) { z=pixel, TEST=(p1+3): z=sin(z)*sin(z), |z|<TEST}
-    CMPLXtrig0(g_old_z, g_tmp_z);
-    CMPLXsqr(g_tmp_z, g_new_z);
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);
+    CMPLXsqr(g_ctx.tmp_z, g_ctx.new_z);
     return floatbailout();
 }
 
@@ -2261,12 +2345,12 @@ int Magnet1Fractal()    //    Z = ((Z**2 + C - 1)/(2Z + C - 2))**2
     DComplex top, bot, tmp;
     double div;
 
-    top.x = g_temp_sqr_x - g_temp_sqr_y + g_float_param->x - 1; // top = Z**2+C-1
-    top.y = g_old_z.x * g_old_z.y;
-    top.y = top.y + top.y + g_float_param->y;
+    top.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y + g_ctx.float_param->x - 1; // top = Z**2+C-1
+    top.y = g_ctx.old_z.x * g_ctx.old_z.y;
+    top.y = top.y + top.y + g_ctx.float_param->y;
 
-    bot.x = g_old_z.x + g_old_z.x + g_float_param->x - 2;       // bot = 2*Z+C-2
-    bot.y = g_old_z.y + g_old_z.y + g_float_param->y;
+    bot.x = g_ctx.old_z.x + g_ctx.old_z.x + g_ctx.float_param->x - 2;       // bot = 2*Z+C-2
+    bot.y = g_ctx.old_z.y + g_ctx.old_z.y + g_ctx.float_param->y;
 
     div = bot.x*bot.x + bot.y*bot.y;                // tmp = top/bot
     if (div < FLT_MIN)
@@ -2276,9 +2360,9 @@ int Magnet1Fractal()    //    Z = ((Z**2 + C - 1)/(2Z + C - 2))**2
     tmp.x = (top.x*bot.x + top.y*bot.y)/div;
     tmp.y = (top.y*bot.x - top.x*bot.y)/div;
 
-    g_new_z.x = (tmp.x + tmp.y) * (tmp.x - tmp.y);      // Z = tmp**2
-    g_new_z.y = tmp.x * tmp.y;
-    g_new_z.y += g_new_z.y;
+    g_ctx.new_z.x = (tmp.x + tmp.y) * (tmp.x - tmp.y);      // Z = tmp**2
+    g_ctx.new_z.y = tmp.x * tmp.y;
+    g_ctx.new_z.y += g_ctx.new_z.y;
 
     return floatbailout();
 }
@@ -2290,19 +2374,19 @@ int Magnet2Fractal()  // Z = ((Z**3 + 3(C-1)Z + (C-1)(C-2)  ) /
     DComplex top, bot, tmp;
     double div;
 
-    top.x = g_old_z.x * (g_temp_sqr_x-g_temp_sqr_y-g_temp_sqr_y-g_temp_sqr_y + T_Cm1.x)
-            - g_old_z.y * T_Cm1.y + T_Cm1Cm2.x;
-    top.y = g_old_z.y * (g_temp_sqr_x+g_temp_sqr_x+g_temp_sqr_x-g_temp_sqr_y + T_Cm1.x)
-            + g_old_z.x * T_Cm1.y + T_Cm1Cm2.y;
+    top.x = g_ctx.old_z.x * (g_ctx.temp_sqr_x-g_ctx.temp_sqr_y-g_ctx.temp_sqr_y-g_ctx.temp_sqr_y + T_Cm1.x)
+            - g_ctx.old_z.y * T_Cm1.y + T_Cm1Cm2.x;
+    top.y = g_ctx.old_z.y * (g_ctx.temp_sqr_x+g_ctx.temp_sqr_x+g_ctx.temp_sqr_x-g_ctx.temp_sqr_y + T_Cm1.x)
+            + g_ctx.old_z.x * T_Cm1.y + T_Cm1Cm2.y;
 
-    bot.x = g_temp_sqr_x - g_temp_sqr_y;
+    bot.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y;
     bot.x = bot.x + bot.x + bot.x
-            + g_old_z.x * T_Cm2.x - g_old_z.y * T_Cm2.y
+            + g_ctx.old_z.x * T_Cm2.x - g_ctx.old_z.y * T_Cm2.y
             + T_Cm1Cm2.x + 1.0;
-    bot.y = g_old_z.x * g_old_z.y;
+    bot.y = g_ctx.old_z.x * g_ctx.old_z.y;
     bot.y += bot.y;
     bot.y = bot.y + bot.y + bot.y
-            + g_old_z.x * T_Cm2.y + g_old_z.y * T_Cm2.x
+            + g_ctx.old_z.x * T_Cm2.y + g_ctx.old_z.y * T_Cm2.x
             + T_Cm1Cm2.y;
 
     div = bot.x*bot.x + bot.y*bot.y;                // tmp = top/bot
@@ -2313,9 +2397,9 @@ int Magnet2Fractal()  // Z = ((Z**3 + 3(C-1)Z + (C-1)(C-2)  ) /
     tmp.x = (top.x*bot.x + top.y*bot.y)/div;
     tmp.y = (top.y*bot.x - top.x*bot.y)/div;
 
-    g_new_z.x = (tmp.x + tmp.y) * (tmp.x - tmp.y);      // Z = tmp**2
-    g_new_z.y = tmp.x * tmp.y;
-    g_new_z.y += g_new_z.y;
+    g_ctx.new_z.x = (tmp.x + tmp.y) * (tmp.x - tmp.y);      // Z = tmp**2
+    g_ctx.new_z.y = tmp.x * tmp.y;
+    g_ctx.new_z.y += g_ctx.new_z.y;
 
     return floatbailout();
 }
@@ -2336,9 +2420,9 @@ int LambdaTrigFractal()
 int LambdaTrigfpFractal()
 {
     FLOATXYTRIGBAILOUT();
-    CMPLXtrig0(g_old_z, g_tmp_z);              // tmp = trig(old)
-    CMPLXmult(*g_float_param, g_tmp_z, g_new_z);   // new = longparm*trig(old)
-    g_old_z = g_new_z;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);              // tmp = trig(old)
+    CMPLXmult(*g_ctx.float_param, g_ctx.tmp_z, g_ctx.new_z);   // new = longparm*trig(old)
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -2359,9 +2443,9 @@ int LambdaTrigFractal1()
 int LambdaTrigfpFractal1()
 {
     FLOATTRIGBAILOUT(); // sin,cos
-    CMPLXtrig0(g_old_z, g_tmp_z);              // tmp = trig(old)
-    CMPLXmult(*g_float_param, g_tmp_z, g_new_z);   // new = longparm*trig(old)
-    g_old_z = g_new_z;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);              // tmp = trig(old)
+    CMPLXmult(*g_ctx.float_param, g_ctx.tmp_z, g_ctx.new_z);   // new = longparm*trig(old)
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 }
 
@@ -2382,9 +2466,9 @@ int LambdaTrigfpFractal2()
 {
 #if !defined(XFRACT)
     FLOATHTRIGBAILOUT(); // sinh,cosh
-    CMPLXtrig0(g_old_z, g_tmp_z);              // tmp = trig(old)
-    CMPLXmult(*g_float_param, g_tmp_z, g_new_z);   // new = longparm*trig(old)
-    g_old_z = g_new_z;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.tmp_z);              // tmp = trig(old)
+    CMPLXmult(*g_ctx.float_param, g_ctx.tmp_z, g_ctx.new_z);   // new = longparm*trig(old)
+    g_ctx.old_z = g_ctx.new_z;
     return 0;
 #else
     return 0;
@@ -2408,9 +2492,9 @@ int ManOWarfpFractal()
 {
     // From Art Matrix via Lee Skinner
     // note that fast >= 287 equiv in fracsuba.asm must be kept in step
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y + g_tmp_z.x + g_float_param->x;
-    g_new_z.y = 2.0 * g_old_z.x * g_old_z.y + g_tmp_z.y + g_float_param->y;
-    g_tmp_z = g_old_z;
+    g_ctx.new_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y + g_ctx.tmp_z.x + g_ctx.float_param->x;
+    g_ctx.new_z.y = 2.0 * g_ctx.old_z.x * g_ctx.old_z.y + g_ctx.tmp_z.y + g_ctx.float_param->y;
+    g_ctx.tmp_z = g_ctx.old_z;
     return floatbailout();
 }
 
@@ -2424,10 +2508,10 @@ int ManOWarfpFractal()
 
 int MarksMandelPwrfpFractal()
 {
-    CMPLXtrig0(g_old_z, g_new_z);
-    CMPLXmult(g_tmp_z, g_new_z, g_new_z);
-    g_new_z.x += g_float_param->x;
-    g_new_z.y += g_float_param->y;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
+    CMPLXmult(g_ctx.tmp_z, g_ctx.new_z, g_ctx.new_z);
+    g_ctx.new_z.x += g_ctx.float_param->x;
+    g_ctx.new_z.y += g_ctx.float_param->y;
     return floatbailout();
 }
 
@@ -2451,11 +2535,11 @@ int MarksMandelPwrFractal()
 
 int TimsErrorfpFractal()
 {
-    CMPLXtrig0(g_old_z, g_new_z);
-    g_new_z.x = g_new_z.x * g_tmp_z.x - g_new_z.y * g_tmp_z.y;
-    g_new_z.y = g_new_z.x * g_tmp_z.y - g_new_z.y * g_tmp_z.x;
-    g_new_z.x += g_float_param->x;
-    g_new_z.y += g_float_param->y;
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
+    g_ctx.new_z.x = g_ctx.new_z.x * g_ctx.tmp_z.x - g_ctx.new_z.y * g_ctx.tmp_z.y;
+    g_ctx.new_z.y = g_ctx.new_z.x * g_ctx.tmp_z.y - g_ctx.new_z.y * g_ctx.tmp_z.x;
+    g_ctx.new_z.x += g_ctx.float_param->x;
+    g_ctx.new_z.y += g_ctx.float_param->y;
     return floatbailout();
 }
 
@@ -2476,8 +2560,8 @@ int TimsErrorFractal()
 int CirclefpFractal()
 {
     long i;
-    i = (long)(g_params[0]*(g_temp_sqr_x+g_temp_sqr_y));
-    g_color_iter = i%g_colors;
+    i = (long)(g_params[0]*(g_ctx.temp_sqr_x+g_ctx.temp_sqr_y));
+    g_ctx.color_iter = i%g_colors;
     return 1;
 }
 /*
@@ -2486,7 +2570,7 @@ CirclelongFractal()
    long i;
    i = multiply(lparm.x,(g_l_temp_sqr_x+g_l_temp_sqr_y),g_bit_shift);
    i = i >> g_bit_shift;
-   g_color_iter = i%colors);
+   g_ctx.color_iter = i%colors);
    return 1;
 }
 */
@@ -2504,17 +2588,17 @@ void invertz2(DComplex *z)
     z->x -= g_f_x_center;
     z->y -= g_f_y_center;  // Normalize values to center of circle
 
-    g_temp_sqr_x = sqr(z->x) + sqr(z->y);  // Get old radius
-    if (std::fabs(g_temp_sqr_x) > FLT_MIN)
+    g_ctx.temp_sqr_x = sqr(z->x) + sqr(z->y);  // Get old radius
+    if (std::fabs(g_ctx.temp_sqr_x) > FLT_MIN)
     {
-        g_temp_sqr_x = g_f_radius / g_temp_sqr_x;
+        g_ctx.temp_sqr_x = g_f_radius / g_ctx.temp_sqr_x;
     }
     else
     {
-        g_temp_sqr_x = FLT_MAX;   // a big number, but not TOO big
+        g_ctx.temp_sqr_x = FLT_MAX;   // a big number, but not TOO big
     }
-    z->x *= g_temp_sqr_x;
-    z->y *= g_temp_sqr_x;      // Perform inversion
+    z->x *= g_ctx.temp_sqr_x;
+    z->y *= g_ctx.temp_sqr_x;      // Perform inversion
     z->x += g_f_x_center;
     z->y += g_f_y_center; // Renormalize
 }
@@ -2530,18 +2614,18 @@ int long_julia_per_pixel()
     if (g_invert != 0)
     {
         // invert
-        invertz2(&g_old_z);
+        invertz2(&g_ctx.old_z);
 
         // watch out for overflow
-        if (sqr(g_old_z.x)+sqr(g_old_z.y) >= 127)
+        if (sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y) >= 127)
         {
-            g_old_z.x = 8;  // value to bail out in one iteration
-            g_old_z.y = 8;
+            g_ctx.old_z.x = 8;  // value to bail out in one iteration
+            g_ctx.old_z.y = 8;
         }
 
         // convert to fudged longs
-        g_l_old_z.x = (long)(g_old_z.x*g_fudge_factor);
-        g_l_old_z.y = (long)(g_old_z.y*g_fudge_factor);
+        g_l_old_z.x = (long)(g_ctx.old_z.x*g_fudge_factor);
+        g_l_old_z.y = (long)(g_ctx.old_z.y*g_fudge_factor);
     }
     else
     {
@@ -2578,18 +2662,18 @@ int long_mandel_per_pixel()
     if (g_invert != 0)
     {
         // invert
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
 
         // watch out for overflow
-        if (sqr(g_init.x)+sqr(g_init.y) >= 127)
+        if (sqr(g_ctx.init.x)+sqr(g_ctx.init.y) >= 127)
         {
-            g_init.x = 8;  // value to bail out in one iteration
-            g_init.y = 8;
+            g_ctx.init.x = 8;  // value to bail out in one iteration
+            g_ctx.init.y = 8;
         }
 
         // convert to fudged longs
-        g_l_init.x = (long)(g_init.x*g_fudge_factor);
-        g_l_init.y = (long)(g_init.y*g_fudge_factor);
+        g_l_init.x = (long)(g_ctx.init.x*g_fudge_factor);
+        g_l_init.y = (long)(g_ctx.init.y*g_fudge_factor);
     }
 
     if (g_use_init_orbit == init_orbit_mode::value)
@@ -2616,29 +2700,29 @@ int julia_per_pixel()
     if (g_invert != 0)
     {
         // invert
-        invertz2(&g_old_z);
+        invertz2(&g_ctx.old_z);
 
         // watch out for overflow
         if (g_bit_shift <= 24)
         {
-            if (sqr(g_old_z.x)+sqr(g_old_z.y) >= 127)
+            if (sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y) >= 127)
             {
-                g_old_z.x = 8;  // value to bail out in one iteration
-                g_old_z.y = 8;
+                g_ctx.old_z.x = 8;  // value to bail out in one iteration
+                g_ctx.old_z.y = 8;
             }
         }
         if (g_bit_shift >  24)
         {
-            if (sqr(g_old_z.x)+sqr(g_old_z.y) >= 4.0)
+            if (sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y) >= 4.0)
             {
-                g_old_z.x = 2;  // value to bail out in one iteration
-                g_old_z.y = 2;
+                g_ctx.old_z.x = 2;  // value to bail out in one iteration
+                g_ctx.old_z.y = 2;
             }
         }
 
         // convert to fudged longs
-        g_l_old_z.x = (long)(g_old_z.x*g_fudge_factor);
-        g_l_old_z.y = (long)(g_old_z.y*g_fudge_factor);
+        g_l_old_z.x = (long)(g_ctx.old_z.x*g_fudge_factor);
+        g_l_old_z.y = (long)(g_ctx.old_z.y*g_fudge_factor);
     }
     else
     {
@@ -2671,29 +2755,29 @@ int mandel_per_pixel()
 
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
 
         // watch out for overflow
         if (g_bit_shift <= 24)
         {
-            if (sqr(g_init.x)+sqr(g_init.y) >= 127)
+            if (sqr(g_ctx.init.x)+sqr(g_ctx.init.y) >= 127)
             {
-                g_init.x = 8;  // value to bail out in one iteration
-                g_init.y = 8;
+                g_ctx.init.x = 8;  // value to bail out in one iteration
+                g_ctx.init.y = 8;
             }
         }
         if (g_bit_shift >  24)
         {
-            if (sqr(g_init.x)+sqr(g_init.y) >= 4)
+            if (sqr(g_ctx.init.x)+sqr(g_ctx.init.y) >= 4)
             {
-                g_init.x = 2;  // value to bail out in one iteration
-                g_init.y = 2;
+                g_ctx.init.x = 2;  // value to bail out in one iteration
+                g_ctx.init.y = 2;
             }
         }
 
         // convert to fudged longs
-        g_l_init.x = (long)(g_init.x*g_fudge_factor);
-        g_l_init.y = (long)(g_init.y*g_fudge_factor);
+        g_l_init.x = (long)(g_ctx.init.x*g_fudge_factor);
+        g_l_init.y = (long)(g_ctx.init.y*g_fudge_factor);
     }
     else
     {
@@ -2727,7 +2811,7 @@ int mandel_per_pixel()
            Mandelbrot iteration with init rather than 0 */
         g_l_old_z.x = g_l_param.x; // initial pertubation of parameters set
         g_l_old_z.y = g_l_param.y;
-        g_color_iter = -1;
+        g_ctx.color_iter = -1;
     }
     else
     {
@@ -2746,18 +2830,18 @@ int marksmandel_per_pixel()
     // marksmandel
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
 
         // watch out for overflow
-        if (sqr(g_init.x)+sqr(g_init.y) >= 127)
+        if (sqr(g_ctx.init.x)+sqr(g_ctx.init.y) >= 127)
         {
-            g_init.x = 8;  // value to bail out in one iteration
-            g_init.y = 8;
+            g_ctx.init.x = 8;  // value to bail out in one iteration
+            g_ctx.init.y = 8;
         }
 
         // convert to fudged longs
-        g_l_init.x = (long)(g_init.x*g_fudge_factor);
-        g_l_init.y = (long)(g_init.y*g_fudge_factor);
+        g_l_init.x = (long)(g_ctx.init.x*g_fudge_factor);
+        g_l_init.y = (long)(g_ctx.init.y*g_fudge_factor);
     }
     else
     {
@@ -2803,145 +2887,160 @@ int marksmandel_per_pixel()
     return 1; // 1st iteration has been done
 }
 
-int marksmandelfp_per_pixel()
+int marksmandelfp_per_pixel(CalcContext &ctx)
 {
     // marksmandel
 
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        ctx.init.x = g_dx_pixel();
+        ctx.init.y = g_dy_pixel();
     }
 
     if (g_use_init_orbit == init_orbit_mode::value)
     {
-        g_old_z = g_init_orbit;
+        ctx.old_z = g_init_orbit;
     }
     else
     {
-        g_old_z = g_init;
+        ctx.old_z = ctx.init;
     }
 
-    g_old_z.x += g_param_z1.x;      // initial pertubation of parameters set
-    g_old_z.y += g_param_z1.y;
+    ctx.old_z.x += ctx.param_z1.x;      // initial pertubation of parameters set
+    ctx.old_z.y += ctx.param_z1.y;
 
-    g_temp_sqr_x = sqr(g_old_z.x);
-    g_temp_sqr_y = sqr(g_old_z.y);
+    ctx.temp_sqr_x = sqr(ctx.old_z.x);
+    ctx.temp_sqr_y = sqr(ctx.old_z.y);
 
     if (g_c_exponent > 3)
     {
-        cpower(&g_old_z, g_c_exponent-1, &g_marks_coefficient);
+        cpower(&ctx.old_z, g_c_exponent-1, &ctx.marks_coefficient);
     }
     else if (g_c_exponent == 3)
     {
-        g_marks_coefficient.x = g_temp_sqr_x - g_temp_sqr_y;
-        g_marks_coefficient.y = g_old_z.x * g_old_z.y * 2;
+        ctx.marks_coefficient.x = ctx.temp_sqr_x - ctx.temp_sqr_y;
+        ctx.marks_coefficient.y = ctx.old_z.x * ctx.old_z.y * 2;
     }
     else if (g_c_exponent == 2)
     {
-        g_marks_coefficient = g_old_z;
+        ctx.marks_coefficient = ctx.old_z;
     }
     else if (g_c_exponent < 2)
     {
-        g_marks_coefficient.x = 1.0;
-        g_marks_coefficient.y = 0.0;
+        ctx.marks_coefficient.x = 1.0;
+        ctx.marks_coefficient.y = 0.0;
     }
 
     return 1; // 1st iteration has been done
 }
 
+int marksmandelfp_per_pixel()
+{
+    return marksmandelfp_per_pixel(g_ctx);
+}
+
 int marks_mandelpwrfp_per_pixel()
 {
     mandelfp_per_pixel();
-    g_tmp_z = g_old_z;
-    g_tmp_z.x -= 1;
-    CMPLXpwr(g_old_z, g_tmp_z, g_tmp_z);
+    g_ctx.tmp_z = g_ctx.old_z;
+    g_ctx.tmp_z.x -= 1;
+    CMPLXpwr(g_ctx.old_z, g_ctx.tmp_z, g_ctx.tmp_z);
     return 1;
 }
 
-int mandelfp_per_pixel()
+int mandelfp_per_pixel(CalcContext &ctx)
 {
     // floating point mandelbrot
     // mandelfp
 
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        ctx.init.x = g_dx_pixel();
+        ctx.init.y = g_dy_pixel();
     }
     switch (g_fractal_type)
     {
     case fractal_type::MAGNET2M:
         FloatPreCalcMagnet2();
     case fractal_type::MAGNET1M:
-        g_old_z.y = 0.0;        // Critical Val Zero both, but neither
-        g_old_z.x = g_old_z.y;      // is of the form f(Z,C) = Z*g(Z)+C
+        ctx.old_z.y = 0.0;        // Critical Val Zero both, but neither
+        ctx.old_z.x = ctx.old_z.y;      // is of the form f(Z,C) = Z*g(Z)+C
         break;
     case fractal_type::MANDELLAMBDAFP:            // Critical Value 0.5 + 0.0i
-        g_old_z.x = 0.5;
-        g_old_z.y = 0.0;
+        ctx.old_z.x = 0.5;
+        ctx.old_z.y = 0.0;
         break;
     default:
-        g_old_z = g_init;
+        ctx.old_z = ctx.init;
         break;
     }
 
     // alter init value
     if (g_use_init_orbit == init_orbit_mode::value)
     {
-        g_old_z = g_init_orbit;
+        ctx.old_z = g_init_orbit;
     }
     else if (g_use_init_orbit == init_orbit_mode::pixel)
     {
-        g_old_z = g_init;
+        ctx.old_z = ctx.init;
     }
 
     if ((g_inside_color == BOF60 || g_inside_color == BOF61) && g_bof_match_book_images)
     {
         /* kludge to match "Beauty of Fractals" picture since we start
            Mandelbrot iteration with init rather than 0 */
-        g_old_z.x = g_param_z1.x; // initial pertubation of parameters set
-        g_old_z.y = g_param_z1.y;
-        g_color_iter = -1;
+        ctx.old_z.x = ctx.param_z1.x; // initial pertubation of parameters set
+        ctx.old_z.y = ctx.param_z1.y;
+        ctx.color_iter = -1;
     }
     else
     {
-        g_old_z.x += g_param_z1.x;
-        g_old_z.y += g_param_z1.y;
+        ctx.old_z.x += ctx.param_z1.x;
+        ctx.old_z.y += ctx.param_z1.y;
     }
-    g_tmp_z = g_init; // for spider
-    g_temp_sqr_x = sqr(g_old_z.x);  // precalculated value for regular Mandelbrot
-    g_temp_sqr_y = sqr(g_old_z.y);
+    ctx.tmp_z = ctx.init; // for spider
+    ctx.temp_sqr_x = sqr(ctx.old_z.x);  // precalculated value for regular Mandelbrot
+    ctx.temp_sqr_y = sqr(ctx.old_z.y);
     return 1; // 1st iteration has been done
 }
 
-int juliafp_per_pixel()
+int mandelfp_per_pixel()
+{
+    return mandelfp_per_pixel(g_ctx);
+}
+
+int juliafp_per_pixel(CalcContext &ctx)
 {
     // floating point julia
     // juliafp
     if (g_invert != 0)
     {
-        invertz2(&g_old_z);
+        invertz2(&ctx.old_z);
     }
     else
     {
-        g_old_z.x = g_dx_pixel();
-        g_old_z.y = g_dy_pixel();
+        ctx.old_z.x = g_dx_pixel();
+        ctx.old_z.y = g_dy_pixel();
     }
-    g_temp_sqr_x = sqr(g_old_z.x);  // precalculated value for regular Julia
-    g_temp_sqr_y = sqr(g_old_z.y);
-    g_tmp_z = g_old_z;
+    ctx.temp_sqr_x = sqr(ctx.old_z.x);  // precalculated value for regular Julia
+    ctx.temp_sqr_y = sqr(ctx.old_z.y);
+    ctx.tmp_z = ctx.old_z;
     return 0;
 }
 
+int juliafp_per_pixel()
+{
+    return juliafp_per_pixel(g_ctx);
+}
+
 int MPCjulia_per_pixel()
 {
 #if !defined(XFRACT)
@@ -2949,15 +3048,15 @@ int MPCjulia_per_pixel()
     // juliafp
     if (g_invert != 0)
     {
-        invertz2(&g_old_z);
+        invertz2(&g_ctx.old_z);
     }
     else
     {
-        g_old_z.x = g_dx_pixel();
-        g_old_z.y = g_dy_pixel();
+        g_ctx.old_z.x = g_dx_pixel();
+        g_ctx.old_z.y = g_dy_pixel();
     }
-    mpcold.x = *pd2MP(g_old_z.x);
-    mpcold.y = *pd2MP(g_old_z.y);
+    mpcold.x = *pd2MP(g_ctx.old_z.x);
+    mpcold.y = *pd2MP(g_ctx.old_z.y);
     return 0;
 #else
     return 0;
@@ -2967,54 +3066,59 @@ int MPCjulia_per_pixel()
 int otherrichard8fp_per_pixel()
 {
     othermandelfp_per_pixel();
-    CMPLXtrig1(*g_float_param, g_tmp_z);
-    CMPLXmult(g_tmp_z, g_param_z2, g_tmp_z);
+    CMPLXtrig1(*g_ctx.float_param, g_ctx.tmp_z);
+    CMPLXmult(g_ctx.tmp_z, g_ctx.param_z2, g_ctx.tmp_z);
     return 1;
 }
 
-int othermandelfp_per_pixel()
+int othermandelfp_per_pixel(CalcContext &ctx)
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        ctx.init.x = g_dx_pixel();
+        ctx.init.y = g_dy_pixel();
     }
 
     if (g_use_init_orbit == init_orbit_mode::value)
     {
-        g_old_z = g_init_orbit;
+        ctx.old_z = g_init_orbit;
     }
     else
     {
-        g_old_z = g_init;
+        ctx.old_z = ctx.init;
     }
 
-    g_old_z.x += g_param_z1.x;      // initial pertubation of parameters set
-    g_old_z.y += g_param_z1.y;
+    ctx.old_z.x += ctx.param_z1.x;      // initial pertubation of parameters set
+    ctx.old_z.y += ctx.param_z1.y;
 
     return 1; // 1st iteration has been done
 }
 
+int othermandelfp_per_pixel()
+{
+    return othermandelfp_per_pixel(g_ctx);
+}
+
 int MPCHalley_per_pixel()
 {
 #if !defined(XFRACT)
     // MPC halley
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        g_ctx.init.x = g_dx_pixel();
+        g_ctx.init.y = g_dy_pixel();
     }
 
-    mpcold.x = *pd2MP(g_init.x);
-    mpcold.y = *pd2MP(g_init.y);
+    mpcold.x = *pd2MP(g_ctx.init.x);
+    mpcold.y = *pd2MP(g_ctx.init.y);
 
     return 0;
 #else
@@ -3026,42 +3130,47 @@ int Halley_per_pixel()
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        g_ctx.init.x = g_dx_pixel();
+        g_ctx.init.y = g_dy_pixel();
     }
 
-    g_old_z = g_init;
+    g_ctx.old_z = g_ctx.init;
 
     return 0; // 1st iteration is not done
 }
 
-int otherjuliafp_per_pixel()
+int otherjuliafp_per_pixel(CalcContext &ctx)
 {
     if (g_invert != 0)
     {
-        invertz2(&g_old_z);
+        invertz2(&ctx.old_z);
     }
     else
     {
-        g_old_z.x = g_dx_pixel();
-        g_old_z.y = g_dy_pixel();
+        ctx.old_z.x = g_dx_pixel();
+        ctx.old_z.y = g_dy_pixel();
     }
     return 0;
 }
 
+int otherjuliafp_per_pixel()
+{
+    return otherjuliafp_per_pixel(g_ctx);
+}
+
 #define Q0 0
 #define Q1 0
 
 int quaternionjulfp_per_pixel()
 {
-    g_old_z.x = g_dx_pixel();
-    g_old_z.y = g_dy_pixel();
-    g_float_param->x = g_params[4];
-    g_float_param->y = g_params[5];
+    g_ctx.old_z.x = g_dx_pixel();
+    g_ctx.old_z.y = g_dy_pixel();
+    g_ctx.float_param->x = g_params[4];
+    g_ctx.float_param->y = g_params[5];
     g_quaternion_c  = g_params[0];
     g_quaternion_ci = g_params[1];
     g_quaternion_cj = g_params[2];
@@ -3071,10 +3180,10 @@ int quaternionjulfp_per_pixel()
 
 int quaternionfp_per_pixel()
 {
-    g_old_z.x = 0;
-    g_old_z.y = 0;
-    g_float_param->x = 0;
-    g_float_param->y = 0;
+    g_ctx.old_z.x = 0;
+    g_ctx.old_z.y = 0;
+    g_ctx.float_param->x = 0;
+    g_ctx.float_param->y = 0;
     g_quaternion_c  = g_dx_pixel();
     g_quaternion_ci = g_dy_pixel();
     g_quaternion_cj = g_params[2];
@@ -3086,18 +3195,18 @@ int MarksCplxMandperp()
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        g_ctx.init.x = g_dx_pixel();
+        g_ctx.init.y = g_dy_pixel();
     }
-    g_old_z.x = g_init.x + g_param_z1.x; // initial pertubation of parameters set
-    g_old_z.y = g_init.y + g_param_z1.y;
-    g_temp_sqr_x = sqr(g_old_z.x);  // precalculated value
-    g_temp_sqr_y = sqr(g_old_z.y);
-    g_marks_coefficient = ComplexPower(g_init, g_power_z);
+    g_ctx.old_z.x = g_ctx.init.x + g_ctx.param_z1.x; // initial pertubation of parameters set
+    g_ctx.old_z.y = g_ctx.init.y + g_ctx.param_z1.y;
+    g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);  // precalculated value
+    g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
+    g_ctx.marks_coefficient = ComplexPower(g_ctx.init, g_power_z);
     return 1;
 }
 
@@ -3107,18 +3216,18 @@ int long_phoenix_per_pixel()
     if (g_invert != 0)
     {
         // invert
-        invertz2(&g_old_z);
+        invertz2(&g_ctx.old_z);
 
         // watch out for overflow
-        if (sqr(g_old_z.x)+sqr(g_old_z.y) >= 127)
+        if (sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y) >= 127)
         {
-            g_old_z.x = 8;  // value to bail out in one iteration
-            g_old_z.y = 8;
+            g_ctx.old_z.x = 8;  // value to bail out in one iteration
+            g_ctx.old_z.y = 8;
         }
 
         // convert to fudged longs
-        g_l_old_z.x = (long)(g_old_z.x*g_fudge_factor);
-        g_l_old_z.y = (long)(g_old_z.y*g_fudge_factor);
+        g_l_old_z.x = (long)(g_ctx.old_z.x*g_fudge_factor);
+        g_l_old_z.y = (long)(g_ctx.old_z.y*g_fudge_factor);
     }
     else
     {
@@ -3135,24 +3244,29 @@ int long_phoenix_per_pixel()
 #endif
 }
 
-int phoenix_per_pixel()
+int phoenix_per_pixel(CalcContext &ctx)
 {
     if (g_invert != 0)
     {
-        invertz2(&g_old_z);
+        invertz2(&ctx.old_z);
     }
     else
     {
-        g_old_z.x = g_dx_pixel();
-        g_old_z.y = g_dy_pixel();
+        ctx.old_z.x = g_dx_pixel();
+        ctx.old_z.y = g_dy_pixel();
     }
-    g_temp_sqr_x = sqr(g_old_z.x);  // precalculated value
-    g_temp_sqr_y = sqr(g_old_z.y);
-    tmp2.x = 0; // use tmp2 as the complex Y value
-    tmp2.y = 0;
+    ctx.temp_sqr_x = sqr(ctx.old_z.x);  // precalculated value
+    ctx.temp_sqr_y = sqr(ctx.old_z.y);
+    ctx.phoenix_y.x = 0; // use phoenix_y as the complex Y value
+    ctx.phoenix_y.y = 0;
     return 0;
 }
 
+int phoenix_per_pixel()
+{
+    return phoenix_per_pixel(g_ctx);
+}
+
 int long_mandphoenix_per_pixel()
 {
 #if !defined(XFRACT)
@@ -3162,18 +3276,18 @@ int long_mandphoenix_per_pixel()
     if (g_invert != 0)
     {
         // invert
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
 
         // watch out for overflow
-        if (sqr(g_init.x)+sqr(g_init.y) >= 127)
+        if (sqr(g_ctx.init.x)+sqr(g_ctx.init.y) >= 127)
         {
-            g_init.x = 8;  // value to bail out in one iteration
-            g_init.y = 8;
+            g_ctx.init.x = 8;  // value to bail out in one iteration
+            g_ctx.init.y = 8;
         }
 
         // convert to fudged longs
-        g_l_init.x = (long)(g_init.x*g_fudge_factor);
-        g_l_init.y = (long)(g_init.y*g_fudge_factor);
+        g_l_init.x = (long)(g_ctx.init.x*g_fudge_factor);
+        g_l_init.y = (long)(g_ctx.init.y*g_fudge_factor);
     }
 
     if (g_use_init_orbit == init_orbit_mode::value)
@@ -3197,70 +3311,75 @@ int long_mandphoenix_per_pixel()
 #endif
 }
 
-int mandphoenix_per_pixel()
+int mandphoenix_per_pixel(CalcContext &ctx)
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        ctx.init.x = g_dx_pixel();
+        ctx.init.y = g_dy_pixel();
     }
 
     if (g_use_init_orbit == init_orbit_mode::value)
     {
-        g_old_z = g_init_orbit;
+        ctx.old_z = g_init_orbit;
     }
     else
     {
-        g_old_z = g_init;
+        ctx.old_z = ctx.init;
     }
 
-    g_old_z.x += g_param_z1.x;      // initial pertubation of parameters set
-    g_old_z.y += g_param_z1.y;
-    g_temp_sqr_x = sqr(g_old_z.x);  // precalculated value
-    g_temp_sqr_y = sqr(g_old_z.y);
-    tmp2.x = 0;
-    tmp2.y = 0;
+    ctx.old_z.x += ctx.param_z1.x;      // initial pertubation of parameters set
+    ctx.old_z.y += ctx.param_z1.y;
+    ctx.temp_sqr_x = sqr(ctx.old_z.x);  // precalculated value
+    ctx.temp_sqr_y = sqr(ctx.old_z.y);
+    ctx.phoenix_y.x = 0;
+    ctx.phoenix_y.y = 0;
     return 1; // 1st iteration has been done
 }
 
+int mandphoenix_per_pixel()
+{
+    return mandphoenix_per_pixel(g_ctx);
+}
+
 int QuaternionFPFractal()
 {
     double a0, a1, a2, a3, n0, n1, n2, n3;
-    a0 = g_old_z.x;
-    a1 = g_old_z.y;
-    a2 = g_float_param->x;
-    a3 = g_float_param->y;
+    a0 = g_ctx.old_z.x;
+    a1 = g_ctx.old_z.y;
+    a2 = g_ctx.float_param->x;
+    a3 = g_ctx.float_param->y;
 
     n0 = a0*a0-a1*a1-a2*a2-a3*a3 + g_quaternion_c;
     n1 = 2*a0*a1 + g_quaternion_ci;
     n2 = 2*a0*a2 + g_quaternion_cj;
     n3 = 2*a0*a3 + g_quaternino_ck;
     // Check bailout
-    g_magnitude = a0*a0+a1*a1+a2*a2+a3*a3;
-    if (g_magnitude > g_magnitude_limit)
+    g_ctx.magnitude = a0*a0+a1*a1+a2*a2+a3*a3;
+    if (g_ctx.magnitude > g_ctx.magnitude_limit)
     {
         return 1;
     }
-    g_new_z.x = n0;
-    g_old_z.x = g_new_z.x;
-    g_new_z.y = n1;
-    g_old_z.y = g_new_z.y;
-    g_float_param->x = n2;
-    g_float_param->y = n3;
+    g_ctx.new_z.x = n0;
+    g_ctx.old_z.x = g_ctx.new_z.x;
+    g_ctx.new_z.y = n1;
+    g_ctx.old_z.y = g_ctx.new_z.y;
+    g_ctx.float_param->x = n2;
+    g_ctx.float_param->y = n3;
     return 0;
 }
 
 int HyperComplexFPFractal()
 {
     DHyperComplex hold, hnew;
-    hold.x = g_old_z.x;
-    hold.y = g_old_z.y;
-    hold.z = g_float_param->x;
-    hold.t = g_float_param->y;
+    hold.x = g_ctx.old_z.x;
+    hold.y = g_ctx.old_z.y;
+    hold.z = g_ctx.float_param->x;
+    hold.t = g_ctx.float_param->y;
 
     HComplexTrig0(&hold, &hnew);
 
@@ -3269,16 +3388,16 @@ int HyperComplexFPFractal()
     hnew.z += g_quaternion_cj;
     hnew.t += g_quaternino_ck;
 
-    g_new_z.x = hnew.x;
-    g_old_z.x = g_new_z.x;
-    g_new_z.y = hnew.y;
-    g_old_z.y = g_new_z.y;
-    g_float_param->x = hnew.z;
-    g_float_param->y = hnew.t;
+    g_ctx.new_z.x = hnew.x;
+    g_ctx.old_z.x = g_ctx.new_z.x;
+    g_ctx.new_z.y = hnew.y;
+    g_ctx.old_z.y = g_ctx.new_z.y;
+    g_ctx.float_param->x = hnew.z;
+    g_ctx.float_param->y = hnew.t;
 
     // Check bailout
-    g_magnitude = sqr(g_old_z.x)+sqr(g_old_z.y)+sqr(g_float_param->x)+sqr(g_float_param->y);
-    if (g_magnitude > g_magnitude_limit)
+    g_ctx.magnitude = sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y)+sqr(g_ctx.float_param->x)+sqr(g_ctx.float_param->y);
+    if (g_ctx.magnitude > g_ctx.magnitude_limit)
     {
         return 1;
     }
@@ -3290,14 +3409,14 @@ int VLfpFractal() // Beauty of Fractals pp. 125 - 127
     double a, b, ab, half, u, w, xy;
 
     half = g_params[0] / 2.0;
-    xy = g_old_z.x * g_old_z.y;
-    u = g_old_z.x - xy;
-    w = -g_old_z.y + xy;
-    a = g_old_z.x + g_params[1] * u;
-    b = g_old_z.y + g_params[1] * w;
+    xy = g_ctx.old_z.x * g_ctx.old_z.y;
+    u = g_ctx.old_z.x - xy;
+    w = -g_ctx.old_z.y + xy;
+    a = g_ctx.old_z.x + g_params[1] * u;
+    b = g_ctx.old_z.y + g_params[1] * w;
     ab = a * b;
-    g_new_z.x = g_old_z.x + half * (u + (a - ab));
-    g_new_z.y = g_old_z.y + half * (w + (-b + ab));
+    g_ctx.new_z.x = g_ctx.old_z.x + half * (u + (a - ab));
+    g_ctx.new_z.y = g_ctx.old_z.y + half * (w + (-b + ab));
     return floatbailout();
 }
 
@@ -3307,13 +3426,13 @@ int EscherfpFractal() // Science of Fractal Images pp. 185, 187
     double testsize = 0.0;
     long testiter = 0;
 
-    g_new_z.x = g_temp_sqr_x - g_temp_sqr_y; // standard Julia with C == (0.0, 0.0i)
-    g_new_z.y = 2.0 * g_old_z.x * g_old_z.y;
-    oldtest.x = g_new_z.x * 15.0;    // scale it
-    oldtest.y = g_new_z.y * 15.0;
+    g_ctx.new_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y; // standard Julia with C == (0.0, 0.0i)
+    g_ctx.new_z.y = 2.0 * g_ctx.old_z.x * g_ctx.old_z.y;
+    oldtest.x = g_ctx.new_z.x * 15.0;    // scale it
+    oldtest.y = g_ctx.new_z.y * 15.0;
     testsqr.x = sqr(oldtest.x);  // set up to test with user-specified ...
     testsqr.y = sqr(oldtest.y);  //    ... Julia as the target set
-    while (testsize <= g_magnitude_limit && testiter < g_max_iterations) // nested Julia loop
+    while (testsize <= g_ctx.magnitude_limit && testiter < g_max_iterations) // nested Julia loop
     {
         newtest.x = testsqr.x - testsqr.y + g_params[0];
         newtest.y = 2.0 * oldtest.x * oldtest.y + g_params[1];
@@ -3323,13 +3442,13 @@ int EscherfpFractal() // Science of Fractal Images pp. 185, 187
         oldtest = newtest;
         testiter++;
     }
-    if (testsize > g_magnitude_limit)
+    if (testsize > g_ctx.magnitude_limit)
     {
         return floatbailout(); // point not in target set
     }
     else   // make distinct level sets if point stayed in target set
     {
-        g_color_iter = ((3L * g_color_iter) % 255L) + 1L;
+        g_ctx.color_iter = ((3L * g_ctx.color_iter) % 255L) + 1L;
         return 1;
     }
 }
@@ -3366,12 +3485,12 @@ bool MandelbrotMix4Setup()
     L.y = 0.0;    // l=imag(p3)+100,
     CMPLXrecip(F, G);                // g=1/f,
     CMPLXrecip(D, H);                // h=1/d,
-    g_tmp_z = F - B;              // tmp = f-b
-    CMPLXrecip(g_tmp_z, J);              // j = 1/(f-b)
-    g_tmp_z = -A;
-    CMPLXmult(g_tmp_z, B, g_tmp_z);           // z=(-a*b*g*h)^j,
-    CMPLXmult(g_tmp_z, G, g_tmp_z);
-    CMPLXmult(g_tmp_z, H, g_tmp_z);
+    g_ctx.tmp_z = F - B;              // tmp = f-b
+    CMPLXrecip(g_ctx.tmp_z, J);              // j = 1/(f-b)
+    g_ctx.tmp_z = -A;
+    CMPLXmult(g_ctx.tmp_z, B, g_ctx.tmp_z);           // z=(-a*b*g*h)^j,
+    CMPLXmult(g_ctx.tmp_z, G, g_ctx.tmp_z);
+    CMPLXmult(g_ctx.tmp_z, H, g_ctx.tmp_z);
 
     /*
        This code kludge attempts to duplicate the behavior
@@ -3401,7 +3520,7 @@ bool MandelbrotMix4Setup()
     {
         sign_array += 1;
     }
-    if (g_tmp_z.y == 0.0) // we know tmp.y IS zero but ...
+    if (g_ctx.tmp_z.y == 0.0) // we know tmp.y IS zero but ...
     {
         switch (sign_array)
         {
@@ -3415,28 +3534,28 @@ bool MandelbrotMix4Setup()
         case  5: // 0101
         case  3: // 0011
         case  0: // 0000
-            g_tmp_z.y = -g_tmp_z.y; // swap sign bit
+            g_ctx.tmp_z.y = -g_ctx.tmp_z.y; // swap sign bit
         default: // do nothing - remaining cases already OK
             ;
         }
         // in case our kludge failed, let the user fix it
         if (g_debug_flag == debug_flags::mandelbrot_mix4_flip_sign)
         {
-            g_tmp_z.y = -g_tmp_z.y;
+            g_ctx.tmp_z.y = -g_ctx.tmp_z.y;
         }
     }
 
-    CMPLXpwr(g_tmp_z, J, g_tmp_z);   // note: z is old
+    CMPLXpwr(g_ctx.tmp_z, J, g_ctx.tmp_z);   // note: z is old
     // in case our kludge failed, let the user fix it
     if (g_params[6] < 0.0)
     {
-        g_tmp_z.y = -g_tmp_z.y;
+        g_ctx.tmp_z.y = -g_ctx.tmp_z.y;
     }
 
     if (g_bail_out == 0)
     {
-        g_magnitude_limit = L.x;
-        g_magnitude_limit2 = g_magnitude_limit*g_magnitude_limit;
+        g_ctx.magnitude_limit = L.x;
+        g_magnitude_limit2 = g_ctx.magnitude_limit*g_ctx.magnitude_limit;
     }
     return true;
 }
@@ -3445,15 +3564,15 @@ int MandelbrotMix4fp_per_pixel()
 {
     if (g_invert != 0)
     {
-        invertz2(&g_init);
+        invertz2(&g_ctx.init);
     }
     else
     {
-        g_init.x = g_dx_pixel();
-        g_init.y = g_dy_pixel();
+        g_ctx.init.x = g_dx_pixel();
+        g_ctx.init.y = g_dy_pixel();
     }
-    g_old_z = g_tmp_z;
-    CMPLXtrig0(g_init, C);        // c=fn1(pixel):
+    g_ctx.old_z = g_ctx.tmp_z;
+    CMPLXtrig0(g_ctx.init, C);        // c=fn1(pixel):
     return 0; // 1st iteration has been NOT been done
 }
 
@@ -3461,10 +3580,10 @@ int MandelbrotMix4fpFractal() // from formula by Jim Muth
 {
     // z=k*((a*(z^b))+(d*(z^f)))+c,
     DComplex z_b, z_f;
-    CMPLXpwr(g_old_z, B, z_b);     // (z^b)
-    CMPLXpwr(g_old_z, F, z_f);     // (z^f)
-    g_new_z.x = K.x*A.x*z_b.x + K.x*D.x*z_f.x + C.x;
-    g_new_z.y = K.x*A.x*z_b.y + K.x*D.x*z_f.y + C.y;
+    CMPLXpwr(g_ctx.old_z, B, z_b);     // (z^b)
+    CMPLXpwr(g_ctx.old_z, F, z_f);     // (z^f)
+    g_ctx.new_z.x = K.x*A.x*z_b.x + K.x*D.x*z_f.x + C.x;
+    g_ctx.new_z.y = K.x*A.x*z_b.y + K.x*D.x*z_f.y + C.y;
     return floatbailout();
 }
 #undef A
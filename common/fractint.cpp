@@ -5,7 +5,9 @@
 #include "port.h"
 #include "prototyp.h"
 
+#include "biginit.h"
 #include "calcfrac.h"
+#include "calcpool.h"
 #include "cmdfiles.h"
 #include "decoder.h"
 #include "drivers.h"
@@ -229,6 +231,11 @@ static void main_restart(int const argc, char const *const argv[], bool &stacked
 
     history_init();
 
+    if (g_debug_flag == debug_flags::benchmark_big_math)
+    {
+        bench_big_math();
+        goodbye();
+    }
     if (g_debug_flag == debug_flags::prevent_overwrite_savename && g_init_batch == batch_modes::NORMAL)   // abort if savename already exists
     {
         check_same_name();
@@ -616,6 +623,10 @@ resumeloop:
 
 bool check_key()
 {
+    if (calc_pool_worker())
+    {
+        return calc_pool_interrupted();
+    }
     int key = driver_key_pressed();
     if (key != 0)
     {
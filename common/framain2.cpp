@@ -3,6 +3,7 @@
 
 #include "ant.h"
 #include "calcfrac.h"
+#include "calclane.h"
 #include "cmdfiles.h"
 #include "decoder.h"
 #include "diskvid.h"
@@ -609,7 +610,18 @@ done:
             // end of evolution loop
             else
             {
-                i = calcfract();       // draw the fractal using "C"
+                if (g_debug_flag == debug_flags::benchmark_lanes)
+                {
+                    i = bench_lanes();
+                }
+                else if (g_debug_flag == debug_flags::check_formula_parsers)
+                {
+                    i = check_formulas();
+                }
+                else
+                {
+                    i = calcfract();       // draw the fractal using "C"
+                }
                 if (i == 0)
                 {
                     driver_buzzer(buzzer_codes::COMPLETE); // finished!!
@@ -1026,6 +1038,7 @@ main_state main_menu_switch(int *kbdchar, bool *frommandel, bool *kbdmore, bool
             && !g_log_map_flag
             && !g_truecolor     // recalc not yet implemented with truecolor
             && !(g_user_std_calc_mode == 't' && g_fill_color > -1) // tesseral with fill doesn't work
+            && !(g_user_std_calc_mode == 'm' && g_fill_color > -1) // nor does mariani-silver
             && !(g_user_std_calc_mode == 'o')
             && i == 1 // nothing else changed
             && g_outside_color != ATAN)
@@ -33,7 +33,7 @@ MandelSetup()           // Mandelbrot Routine
     if (g_debug_flag != debug_flags::force_standard_fractal
         && (g_invert == 0)
         && g_decomp[0] == 0
-        && g_magnitude_limit == 4.0
+        && g_ctx.magnitude_limit == 4.0
         && g_bit_shift == 29
         && !g_potential_flag
         && g_biomorph == -1
@@ -61,7 +61,7 @@ JuliaSetup()            // Julia Routine
     if (g_debug_flag != debug_flags::force_standard_fractal
         && (g_invert == 0)
         && g_decomp[0] == 0
-        && g_magnitude_limit == 4.0
+        && g_ctx.magnitude_limit == 4.0
         && g_bit_shift == 29
         && !g_potential_flag
         && g_biomorph == -1
@@ -113,7 +113,7 @@ NewtonSetup()           // Newton/NewtBasin Routines
     g_cur_fractal_specific = &g_fractal_specific[static_cast<int>(g_fractal_type)];
 #endif
     // set up table of roots of 1 along unit circle
-    g_degree = (int)g_param_z1.x;
+    g_degree = (int)g_ctx.param_z1.x;
     if (g_degree < 2)
     {
         g_degree = 3;   // defaults to 3, but 2 is possible
@@ -138,7 +138,7 @@ NewtonSetup()           // Newton/NewtBasin Routines
     g_roots.resize(16);
     if (g_fractal_type == fractal_type::NEWTBASIN)
     {
-        if (g_param_z1.y)
+        if (g_ctx.param_z1.y)
         {
             g_basin = 2; //stripes
         }
@@ -158,7 +158,7 @@ NewtonSetup()           // Newton/NewtBasin Routines
 #if !defined(XFRACT)
     else if (g_fractal_type == fractal_type::MPNEWTBASIN)
     {
-        if (g_param_z1.y)
+        if (g_ctx.param_z1.y)
         {
             g_basin = 2;    //stripes
         }
@@ -222,7 +222,7 @@ MandelfpSetup()
     g_c_exponent = (int)g_params[2];
     g_power_z.x = g_params[2] - 1.0;
     g_power_z.y = g_params[3];
-    g_float_param = &g_init;
+    g_ctx.float_param = &g_ctx.init;
     switch (g_fractal_type)
     {
     case fractal_type::MARKSMANDELFP:
@@ -280,10 +280,12 @@ MandelfpSetup()
         if (g_params[3] == 0.0 && g_debug_flag != debug_flags::force_complex_power && (double)g_c_exponent == g_params[2])
         {
             g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc = floatZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc_ctx = floatZpowerFractal;
         }
         else
         {
             g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc = floatCmplxZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc_ctx = floatCmplxZpowerFractal;
         }
         break;
     case fractal_type::MAGNET1M:
@@ -304,7 +306,7 @@ MandelfpSetup()
         break;
     case fractal_type::FPMANTRIGPLUSEXP:
     case fractal_type::FPMANTRIGPLUSZSQRD:
-        if (g_param_z1.y == 0.0)
+        if (g_ctx.param_z1.y == 0.0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -318,12 +320,12 @@ MandelfpSetup()
         }
         break;
     case fractal_type::QUATFP:
-        g_float_param = &g_tmp_z;
+        g_ctx.float_param = &g_ctx.tmp_z;
         g_attractors = 0;
         g_periodicity_check = 0;
         break;
     case fractal_type::HYPERCMPLXFP:
-        g_float_param = &g_tmp_z;
+        g_ctx.float_param = &g_ctx.tmp_z;
         g_attractors = 0;
         g_periodicity_check = 0;
         if (g_params[2] != 0)
@@ -357,12 +359,12 @@ bool
 JuliafpSetup()
 {
     g_c_exponent = (int)g_params[2];
-    g_float_param = &g_param_z1;
+    g_ctx.float_param = &g_ctx.param_z1;
     if (g_fractal_type == fractal_type::COMPLEXMARKSJUL)
     {
         g_power_z.x = g_params[2] - 1.0;
         g_power_z.y = g_params[3];
-        g_marks_coefficient = ComplexPower(*g_float_param, g_power_z);
+        g_ctx.marks_coefficient = ComplexPower(*g_ctx.float_param, g_power_z);
     }
     switch (g_fractal_type)
     {
@@ -404,10 +406,12 @@ JuliafpSetup()
         if (g_params[3] == 0.0 && g_debug_flag != debug_flags::force_complex_power && (double)g_c_exponent == g_params[2])
         {
             g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc = floatZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc_ctx = floatZpowerFractal;
         }
         else
         {
             g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc = floatCmplxZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_fractal_type)].orbitcalc_ctx = floatCmplxZpowerFractal;
         }
         get_julia_attractor(g_params[0], g_params[1]);  // another attractor?
         break;
@@ -425,7 +429,7 @@ JuliafpSetup()
         get_julia_attractor(0.5, 0.0);    // another attractor?
         break;
     case fractal_type::LAMBDAEXP:
-        if (g_param_z1.y == 0.0)
+        if (g_ctx.param_z1.y == 0.0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -433,7 +437,7 @@ JuliafpSetup()
         break;
     case fractal_type::FPJULTRIGPLUSEXP:
     case fractal_type::FPJULTRIGPLUSZSQRD:
-        if (g_param_z1.y == 0.0)
+        if (g_ctx.param_z1.y == 0.0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -472,9 +476,9 @@ JuliafpSetup()
             && g_trig_index[1] == trig_fn::TAN
             && g_trig_index[2] == trig_fn::SIN
             && g_trig_index[3] == trig_fn::TAN
-            && std::fabs(g_param_z2.x - 3.0) < .0001
-            && g_param_z2.y == 0
-            && g_param_z1.y == 0)
+            && std::fabs(g_ctx.param_z2.x - 3.0) < .0001
+            && g_ctx.param_z2.y == 0
+            && g_ctx.param_z1.y == 0)
         {
             default_functions = true;
             if (g_fractal_type == fractal_type::FPPOPCORNJUL)
@@ -549,7 +553,7 @@ MandellongSetup()
     }
     if ((g_fractal_type == fractal_type::LMANTRIGPLUSEXP) || (g_fractal_type == fractal_type::LMANTRIGPLUSZSQRD))
     {
-        if (g_param_z1.y == 0.0)
+        if (g_ctx.param_z1.y == 0.0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -612,7 +616,7 @@ JulialongSetup()
         break;
     case fractal_type::LJULTRIGPLUSEXP:
     case fractal_type::LJULTRIGPLUSZSQRD:
-        if (g_param_z1.y == 0.0)
+        if (g_ctx.param_z1.y == 0.0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -634,9 +638,9 @@ JulialongSetup()
             && g_trig_index[1] == trig_fn::TAN
             && g_trig_index[2] == trig_fn::SIN
             && g_trig_index[3] == trig_fn::TAN
-            && std::fabs(g_param_z2.x - 3.0) < .0001
-            && g_param_z2.y == 0
-            && g_param_z1.y == 0)
+            && std::fabs(g_ctx.param_z2.x - 3.0) < .0001
+            && g_ctx.param_z2.y == 0
+            && g_ctx.param_z1.y == 0)
         {
             default_functions = true;
             if (g_fractal_type == fractal_type::LPOPCORNJUL)
@@ -687,13 +691,13 @@ TrigPlusSqrfpSetup()
 {
     g_cur_fractal_specific->per_pixel =  juliafp_per_pixel;
     g_cur_fractal_specific->orbitcalc =  TrigPlusSqrfpFractal;
-    if (g_param_z1.x == 1.0 && g_param_z1.y == 0.0 && g_param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
+    if (g_ctx.param_z1.x == 1.0 && g_ctx.param_z1.y == 0.0 && g_ctx.param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
     {
-        if (g_param_z2.x == 1.0)          // Scott variant
+        if (g_ctx.param_z2.x == 1.0)          // Scott variant
         {
             g_cur_fractal_specific->orbitcalc =  ScottTrigPlusSqrfpFractal;
         }
-        else if (g_param_z2.x == -1.0)      // Skinner variant
+        else if (g_ctx.param_z2.x == -1.0)      // Skinner variant
         {
             g_cur_fractal_specific->orbitcalc =  SkinnerTrigSubSqrfpFractal;
         }
@@ -735,13 +739,13 @@ TrigPlusTrigfpSetup()
     }
     g_cur_fractal_specific->per_pixel =  otherjuliafp_per_pixel;
     g_cur_fractal_specific->orbitcalc =  TrigPlusTrigfpFractal;
-    if (g_param_z1.x == 1.0 && g_param_z1.y == 0.0 && g_param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
+    if (g_ctx.param_z1.x == 1.0 && g_ctx.param_z1.y == 0.0 && g_ctx.param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
     {
-        if (g_param_z2.x == 1.0)          // Scott variant
+        if (g_ctx.param_z2.x == 1.0)          // Scott variant
         {
             g_cur_fractal_specific->orbitcalc =  ScottTrigPlusTrigfpFractal;
         }
-        else if (g_param_z2.x == -1.0)      // Skinner variant
+        else if (g_ctx.param_z2.x == -1.0)      // Skinner variant
         {
             g_cur_fractal_specific->orbitcalc =  SkinnerTrigSubTrigfpFractal;
         }
@@ -764,7 +768,7 @@ FnPlusFnSym() // set symmetry matrix for fn+fn type
         /* log */ {symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS, symmetry_type::X_AXIS, symmetry_type::X_AXIS},
         /* sqr */ {symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS,  symmetry_type::X_AXIS, symmetry_type::X_AXIS, symmetry_type::XY_AXIS}
     };
-    if (g_param_z1.y == 0.0 && g_param_z2.y == 0.0)
+    if (g_ctx.param_z1.y == 0.0 && g_ctx.param_z2.y == 0.0)
     {
         if (g_trig_index[0] <= trig_fn::SQR && g_trig_index[1] < trig_fn::SQR)    // bounds of array
         {
@@ -787,7 +791,7 @@ LambdaTrigOrTrigSetup()
 {
     // default symmetry is ORIGIN
     g_long_param = &g_l_param;
-    g_float_param = &g_param_z1;
+    g_ctx.float_param = &g_ctx.param_z1;
     if ((g_trig_index[0] == trig_fn::EXP) || (g_trig_index[1] == trig_fn::EXP))
     {
         g_symmetry = symmetry_type::NONE;
@@ -805,8 +809,8 @@ JuliaTrigOrTrigSetup()
 {
     // default symmetry is X_AXIS
     g_long_param = &g_l_param;
-    g_float_param = &g_param_z1;
-    if (g_param_z1.y != 0.0)
+    g_ctx.float_param = &g_ctx.param_z1;
+    if (g_ctx.param_z1.y != 0.0)
     {
         g_symmetry = symmetry_type::NONE;
     }
@@ -824,7 +828,7 @@ ManlamTrigOrTrigSetup()
     // psuedo
     // default symmetry is X_AXIS
     g_long_param = &g_l_init;
-    g_float_param = &g_init;
+    g_ctx.float_param = &g_ctx.init;
     if (g_trig_index[0] == trig_fn::SQR)
     {
         g_symmetry = symmetry_type::NONE;
@@ -841,7 +845,7 @@ MandelTrigOrTrigSetup()
 {
     // default symmetry is X_AXIS_NO_PARAM
     g_long_param = &g_l_init;
-    g_float_param = &g_init;
+    g_ctx.float_param = &g_ctx.init;
     if ((g_trig_index[0] == trig_fn::FLIP) || (g_trig_index[1] == trig_fn::FLIP))
     {
         g_symmetry = symmetry_type::NONE;
@@ -920,13 +924,13 @@ ZXTrigPlusZSetup()
     else
     {
         g_cur_fractal_specific->orbitcalc =  ZXTrigPlusZfpFractal;
-        if (g_param_z1.x == 1.0 && g_param_z1.y == 0.0 && g_param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
+        if (g_ctx.param_z1.x == 1.0 && g_ctx.param_z1.y == 0.0 && g_ctx.param_z2.y == 0.0 && g_debug_flag != debug_flags::force_standard_fractal)
         {
-            if (g_param_z2.x == 1.0)       // Scott variant
+            if (g_ctx.param_z2.x == 1.0)       // Scott variant
             {
                 g_cur_fractal_specific->orbitcalc =  ScottZXTrigPlusZfpFractal;
             }
-            else if (g_param_z2.x == -1.0)           // Skinner variant
+            else if (g_ctx.param_z2.x == -1.0)           // Skinner variant
             {
                 g_cur_fractal_specific->orbitcalc =  SkinnerZXTrigSubZfpFractal;
             }
@@ -1225,25 +1229,25 @@ MarksJuliafpSetup()
         g_params[2] = 1;
     }
     g_c_exponent = (int)g_params[2];
-    g_float_param = &g_param_z1;
-    g_old_z = *g_float_param;
+    g_ctx.float_param = &g_ctx.param_z1;
+    g_ctx.old_z = *g_ctx.float_param;
     if (g_c_exponent > 3)
     {
-        cpower(&g_old_z, g_c_exponent-1, &g_marks_coefficient);
+        cpower(&g_ctx.old_z, g_c_exponent-1, &g_ctx.marks_coefficient);
     }
     else if (g_c_exponent == 3)
     {
-        g_marks_coefficient.x = sqr(g_old_z.x) - sqr(g_old_z.y);
-        g_marks_coefficient.y = g_old_z.x * g_old_z.y * 2;
+        g_ctx.marks_coefficient.x = sqr(g_ctx.old_z.x) - sqr(g_ctx.old_z.y);
+        g_ctx.marks_coefficient.y = g_ctx.old_z.x * g_ctx.old_z.y * 2;
     }
     else if (g_c_exponent == 2)
     {
-        g_marks_coefficient = g_old_z;
+        g_ctx.marks_coefficient = g_ctx.old_z;
     }
     else if (g_c_exponent < 2)
     {
-        g_marks_coefficient.x = 1.0;
-        g_marks_coefficient.y = 0.0;
+        g_ctx.marks_coefficient.x = 1.0;
+        g_ctx.marks_coefficient.y = 0.0;
     }
     get_julia_attractor(0.0, 0.0);       // an attractor?
     return true;
@@ -1265,8 +1269,8 @@ SierpinskiFPSetup()
 {
     // sierpinski
     g_periodicity_check = 0;                // disable periodicity checks
-    g_tmp_z.x = 1;
-    g_tmp_z.y = 0.5;
+    g_ctx.tmp_z.x = 1;
+    g_ctx.tmp_z.y = 0.5;
     return true;
 }
 
@@ -1287,7 +1291,7 @@ HalleySetup()
 
     g_cur_fractal_specific = &g_fractal_specific[static_cast<int>(g_fractal_type)];
 
-    g_degree = (int)g_param_z1.x;
+    g_degree = (int)g_ctx.param_z1.x;
     if (g_degree < 2)
     {
         g_degree = 2;
@@ -1304,9 +1308,9 @@ HalleySetup()
         setMPfunctions();
         g_halley_mp_a_plus_one = *pd2MP((double)g_halley_a_plus_one);
         g_halley_mp_a_plus_one_times_degree = *pd2MP((double)g_halley_a_plus_one_times_degree);
-        g_mpc_temp_param.x = *pd2MP(g_param_z1.y);
-        g_mpc_temp_param.y = *pd2MP(g_param_z2.y);
-        g_mp_temp_param2_x = *pd2MP(g_param_z2.x);
+        g_mpc_temp_param.x = *pd2MP(g_ctx.param_z1.y);
+        g_mpc_temp_param.y = *pd2MP(g_ctx.param_z2.y);
+        g_mp_temp_param2_x = *pd2MP(g_ctx.param_z2.x);
         g_mp_one        = *pd2MP(1.0);
     }
 #endif
@@ -1326,8 +1330,8 @@ bool
 PhoenixSetup()
 {
     g_long_param = &g_l_param;
-    g_float_param = &g_param_z1;
-    g_degree = (int)g_param_z2.x;
+    g_ctx.float_param = &g_ctx.param_z1;
+    g_degree = (int)g_ctx.param_z2.x;
     if (g_degree < 2 && g_degree > -3)
     {
         g_degree = 0;
@@ -1338,6 +1342,7 @@ PhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixFractal;
         }
         else
         {
@@ -1350,6 +1355,7 @@ PhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixPlusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixPlusFractal;
         }
         else
         {
@@ -1362,6 +1368,7 @@ PhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixMinusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixMinusFractal;
         }
         else
         {
@@ -1376,7 +1383,7 @@ bool
 PhoenixCplxSetup()
 {
     g_long_param = &g_l_param;
-    g_float_param = &g_param_z1;
+    g_ctx.float_param = &g_ctx.param_z1;
     g_degree = (int)g_params[4];
     if (g_degree < 2 && g_degree > -3)
     {
@@ -1385,7 +1392,7 @@ PhoenixCplxSetup()
     g_params[4] = (double)g_degree;
     if (g_degree == 0)
     {
-        if (g_param_z2.x != 0 || g_param_z2.y != 0)
+        if (g_ctx.param_z2.x != 0 || g_ctx.param_z2.y != 0)
         {
             g_symmetry = symmetry_type::NONE;
         }
@@ -1393,13 +1400,14 @@ PhoenixCplxSetup()
         {
             g_symmetry = symmetry_type::ORIGIN;
         }
-        if (g_param_z1.y == 0 && g_param_z2.y == 0)
+        if (g_ctx.param_z1.y == 0 && g_ctx.param_z2.y == 0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixFractalcplx;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixFractalcplx;
         }
         else
         {
@@ -1409,7 +1417,7 @@ PhoenixCplxSetup()
     if (g_degree >= 2)
     {
         g_degree = g_degree - 1;
-        if (g_param_z1.y == 0 && g_param_z2.y == 0)
+        if (g_ctx.param_z1.y == 0 && g_ctx.param_z2.y == 0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -1420,6 +1428,7 @@ PhoenixCplxSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixCplxPlusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  nullptr;
         }
         else
         {
@@ -1429,7 +1438,7 @@ PhoenixCplxSetup()
     if (g_degree <= -3)
     {
         g_degree = std::abs(g_degree) - 2;
-        if (g_param_z1.y == 0 && g_param_z2.y == 0)
+        if (g_ctx.param_z1.y == 0 && g_ctx.param_z2.y == 0)
         {
             g_symmetry = symmetry_type::X_AXIS;
         }
@@ -1440,6 +1449,7 @@ PhoenixCplxSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixCplxMinusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  nullptr;
         }
         else
         {
@@ -1454,8 +1464,8 @@ bool
 MandPhoenixSetup()
 {
     g_long_param = &g_l_init;
-    g_float_param = &g_init;
-    g_degree = (int)g_param_z2.x;
+    g_ctx.float_param = &g_ctx.init;
+    g_degree = (int)g_ctx.param_z2.x;
     if (g_degree < 2 && g_degree > -3)
     {
         g_degree = 0;
@@ -1466,6 +1476,7 @@ MandPhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixFractal;
         }
         else
         {
@@ -1478,6 +1489,7 @@ MandPhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixPlusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixPlusFractal;
         }
         else
         {
@@ -1490,6 +1502,7 @@ MandPhoenixSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixMinusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixMinusFractal;
         }
         else
         {
@@ -1504,14 +1517,14 @@ bool
 MandPhoenixCplxSetup()
 {
     g_long_param = &g_l_init;
-    g_float_param = &g_init;
+    g_ctx.float_param = &g_ctx.init;
     g_degree = (int)g_params[4];
     if (g_degree < 2 && g_degree > -3)
     {
         g_degree = 0;
     }
     g_params[4] = (double)g_degree;
-    if (g_param_z1.y != 0 || g_param_z2.y != 0)
+    if (g_ctx.param_z1.y != 0 || g_ctx.param_z2.y != 0)
     {
         g_symmetry = symmetry_type::NONE;
     }
@@ -1520,6 +1533,7 @@ MandPhoenixCplxSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixFractalcplx;
+            g_cur_fractal_specific->orbitcalc_ctx =  PhoenixFractalcplx;
         }
         else
         {
@@ -1532,6 +1546,7 @@ MandPhoenixCplxSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixCplxPlusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  nullptr;
         }
         else
         {
@@ -1544,6 +1559,7 @@ MandPhoenixCplxSetup()
         if (g_user_float_flag)
         {
             g_cur_fractal_specific->orbitcalc =  PhoenixCplxMinusFractal;
+            g_cur_fractal_specific->orbitcalc_ctx =  nullptr;
         }
         else
         {
@@ -1583,6 +1599,6 @@ VLSetup()
     {
         g_params[1] = 1.0;
     }
-    g_float_param = &g_param_z1;
+    g_ctx.float_param = &g_ctx.param_z1;
     return true;
 }
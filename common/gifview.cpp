@@ -61,6 +61,11 @@ int get_bytes(BYTE *where, int how_many)
     return (int) fread((char *)where, 1, how_many, fpin); // EOF is -1, as desired
 }
 
+void unget_byte(int c)
+{
+    ungetc(c, fpin);
+}
+
 /*
  * DECODERLINEWIDTH is the width of the pixel buffer used by the decoder. A
  * larger buffer gives better performance. However, this buffer does not
@@ -532,10 +537,8 @@ int pot_line(BYTE *pixels, int linelen)
     {
         out_line(pixels, linelen);
     }
-    for (int col = 0; col < g_logical_screen_x_dots; ++col)
-    {
-        writedisk(col+g_logical_screen_x_offset, row+g_logical_screen_y_offset, *(pixels+col));
-    }
+    writedisk_span(row+g_logical_screen_y_offset, g_logical_screen_x_offset,
+                   g_logical_screen_x_offset+g_logical_screen_x_dots-1, pixels);
     g_row_count = saverowcount + 1;
     return 0;
 }
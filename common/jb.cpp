@@ -127,7 +127,7 @@ bool JulibrotSetup()
     yoffsetfp = (g_y_max + g_y_min) / 2;     // Calculate average
     dmxfp = (g_julibrot_x_max - g_julibrot_x_min) / g_julibrot_z_dots;
     dmyfp = (g_julibrot_y_max - g_julibrot_y_min) / g_julibrot_z_dots;
-    g_float_param = &jbcfp;
+    g_ctx.float_param = &jbcfp;
     x_per_inchfp = (g_x_min - g_x_max) / g_julibrot_width_fp;
     y_per_inchfp = (g_y_max - g_y_min) / g_julibrot_height_fp;
     inch_per_xdotfp = g_julibrot_width_fp / g_logical_screen_x_dots;
@@ -392,8 +392,8 @@ int zlinefp(double x, double y)
         // Special initialization for Mandelbrot types
         if (g_new_orbit_type == fractal_type::QUATFP || g_new_orbit_type == fractal_type::HYPERCMPLXFP)
         {
-            g_old_z.x = 0.0;
-            g_old_z.y = 0.0;
+            g_ctx.old_z.x = 0.0;
+            g_ctx.old_z.y = 0.0;
             jbcfp.x = 0.0;
             jbcfp.y = 0.0;
             g_quaternion_c = jxfp;
@@ -403,8 +403,8 @@ int zlinefp(double x, double y)
         }
         else
         {
-            g_old_z.x = jxfp;
-            g_old_z.y = jyfp;
+            g_ctx.old_z.x = jxfp;
+            g_ctx.old_z.y = jyfp;
             jbcfp.x = mxfp;
             jbcfp.y = myfp;
             g_quaternion_c = g_params[0];
@@ -427,8 +427,8 @@ int zlinefp(double x, double y)
             return -1;
         }
 #endif
-        g_temp_sqr_x = sqr(g_old_z.x);
-        g_temp_sqr_y = sqr(g_old_z.y);
+        g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+        g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
 
         for (n = 0; n < g_max_iterations; n++)
         {
@@ -541,10 +541,12 @@ int Std4dfpFractal()
         if (g_params[3] == 0.0 && g_debug_flag != debug_flags::force_complex_power && (double)g_c_exponent == g_params[2])
         {
             g_fractal_specific[static_cast<int>(g_new_orbit_type)].orbitcalc = floatZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_new_orbit_type)].orbitcalc_ctx = floatZpowerFractal;
         }
         else
         {
             g_fractal_specific[static_cast<int>(g_new_orbit_type)].orbitcalc = floatCmplxZpowerFractal;
+            g_fractal_specific[static_cast<int>(g_new_orbit_type)].orbitcalc_ctx = floatCmplxZpowerFractal;
         }
         get_julia_attractor(g_params[0], g_params[1]);  // another attractor?
     }
@@ -909,14 +909,14 @@ void Jiim(jiim_types which)
             iter = 1;
             g_l_old_z.y = 0;
             g_l_old_z.x = g_l_old_z.y;
-            g_old_z.y = g_l_old_z.x;
-            g_old_z.x = g_old_z.y;
-            g_init.x = cr;
-            g_save_c.x = g_init.x;
-            g_init.y = ci;
-            g_save_c.y = g_init.y;
-            g_l_init.x = (long)(g_init.x*g_fudge_factor);
-            g_l_init.y = (long)(g_init.y*g_fudge_factor);
+            g_ctx.old_z.y = g_l_old_z.x;
+            g_ctx.old_z.x = g_ctx.old_z.y;
+            g_ctx.init.x = cr;
+            g_save_c.x = g_ctx.init.x;
+            g_ctx.init.y = ci;
+            g_save_c.y = g_ctx.init.y;
+            g_l_init.x = (long)(g_ctx.init.x*g_fudge_factor);
+            g_l_init.y = (long)(g_ctx.init.y*g_fudge_factor);
 
             old_y = -1;
             old_x = old_y;
@@ -993,18 +993,18 @@ void Jiim(jiim_types which)
                     {
                         lmax = 0;
                         lsize = lmax;
-                        g_new_z.x = luckyx;
-                        g_old_z.x = g_new_z.x;
-                        g_new_z.y = luckyy;
-                        g_old_z.y = g_new_z.y;
+                        g_ctx.new_z.x = luckyx;
+                        g_ctx.old_z.x = g_ctx.new_z.x;
+                        g_ctx.new_z.y = luckyy;
+                        g_ctx.old_z.y = g_ctx.new_z.y;
                         luckyy = 0.0F;
                         luckyx = luckyy;
                         for (int i = 0; i < 199; i++)
                         {
-                            g_old_z = ComplexSqrtFloat(g_old_z.x - cr, g_old_z.y - ci);
-                            g_new_z = ComplexSqrtFloat(g_new_z.x - cr, g_new_z.y - ci);
-                            EnQueueFloat((float)g_new_z.x, (float)g_new_z.y);
-                            EnQueueFloat((float)-g_old_z.x, (float)-g_old_z.y);
+                            g_ctx.old_z = ComplexSqrtFloat(g_ctx.old_z.x - cr, g_ctx.old_z.y - ci);
+                            g_ctx.new_z = ComplexSqrtFloat(g_ctx.new_z.x - cr, g_ctx.new_z.y - ci);
+                            EnQueueFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
+                            EnQueueFloat((float)-g_ctx.old_z.x, (float)-g_ctx.old_z.y);
                         }
                         maxhits++;
                     }
@@ -1014,17 +1014,17 @@ void Jiim(jiim_types which)
                     }
                 }
 
-                g_old_z = DeQueueFloat();
+                g_ctx.old_z = DeQueueFloat();
 
-                x = (int)(g_old_z.x * xfactor * zoom + xoff);
-                y = (int)(g_old_z.y * yfactor * zoom + yoff);
+                x = (int)(g_ctx.old_z.x * xfactor * zoom + xoff);
+                y = (int)(g_ctx.old_z.y * yfactor * zoom + yoff);
                 color = c_getcolor(x, y);
                 if (color < maxhits)
                 {
                     c_putcolor(x, y, color + 1);
-                    g_new_z = ComplexSqrtFloat(g_old_z.x - cr, g_old_z.y - ci);
-                    EnQueueFloat((float)g_new_z.x, (float)g_new_z.y);
-                    EnQueueFloat((float)-g_new_z.x, (float)-g_new_z.y);
+                    g_ctx.new_z = ComplexSqrtFloat(g_ctx.old_z.x - cr, g_ctx.old_z.y - ci);
+                    EnQueueFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
+                    EnQueueFloat((float)-g_ctx.new_z.x, (float)-g_ctx.new_z.y);
                 }
             }
             else
@@ -1032,13 +1032,13 @@ void Jiim(jiim_types which)
                 /*
                  * end Msnyder code, commence if not MIIM code.
                  */
-                g_old_z.x -= cr;
-                g_old_z.y -= ci;
-                r = g_old_z.x*g_old_z.x + g_old_z.y*g_old_z.y;
+                g_ctx.old_z.x -= cr;
+                g_ctx.old_z.y -= ci;
+                r = g_ctx.old_z.x*g_ctx.old_z.x + g_ctx.old_z.y*g_ctx.old_z.y;
                 if (r > 10.0)
                 {
-                    g_old_z.y = 0.0;
-                    g_old_z.x = g_old_z.y; // avoids math error
+                    g_ctx.old_z.y = 0.0;
+                    g_ctx.old_z.x = g_ctx.old_z.y; // avoids math error
                     iter = 1;
                     r = 0;
                 }
@@ -1051,13 +1051,13 @@ void Jiim(jiim_types which)
 
                 //       r = sqrt(old.x*old.x + old.y*old.y); calculated above
                 r = std::sqrt(r);
-                g_new_z.x = std::sqrt(std::fabs((r + g_old_z.x)/2));
-                if (g_old_z.y < 0)
+                g_ctx.new_z.x = std::sqrt(std::fabs((r + g_ctx.old_z.x)/2));
+                if (g_ctx.old_z.y < 0)
                 {
-                    g_new_z.x = -g_new_z.x;
+                    g_ctx.new_z.x = -g_ctx.new_z.x;
                 }
 
-                g_new_z.y = std::sqrt(std::fabs((r - g_old_z.x)/2));
+                g_ctx.new_z.y = std::sqrt(std::fabs((r - g_ctx.old_z.x)/2));
 
 
                 switch (SecretExperimentalMode)
@@ -1066,60 +1066,60 @@ void Jiim(jiim_types which)
                 default:
                     if (rand() % 2)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                     }
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 case 1:                     // always go one direction
                     if (g_save_c.y < 0)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                     }
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 case 2:                     // go one dir, draw the other
                     if (g_save_c.y < 0)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                     }
-                    x = (int)(-g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(-g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(-g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(-g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 case 4:                     // go negative if max color
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     if (c_getcolor(x, y) == g_colors - 1)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
-                        x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                        y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
+                        x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                        y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     }
                     break;
                 case 5:                     // go positive if max color
-                    g_new_z.x = -g_new_z.x;
-                    g_new_z.y = -g_new_z.y;
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    g_ctx.new_z.x = -g_ctx.new_z.x;
+                    g_ctx.new_z.y = -g_ctx.new_z.y;
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     if (c_getcolor(x, y) == g_colors - 1)
                     {
-                        x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                        y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                        x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                        y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     }
                     break;
                 case 7:
                     if (g_save_c.y < 0)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                     }
-                    x = (int)(-g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(-g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(-g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(-g_ctx.new_z.y * yfactor * zoom + yoff);
                     if (iter > 10)
                     {
                         if (mode == 0)                          // pixels
@@ -1139,8 +1139,8 @@ void Jiim(jiim_types which)
                         old_x = x;
                         old_y = y;
                     }
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 case 8:                     // go in long zig zags
                     if (rancnt >= 300)
@@ -1149,11 +1149,11 @@ void Jiim(jiim_types which)
                     }
                     if (rancnt < 0)
                     {
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                     }
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 case 9:                     // "random run"
                     switch (randir)
@@ -1161,8 +1161,8 @@ void Jiim(jiim_types which)
                     case 0:             // go random direction for a while
                         if (rand() % 2)
                         {
-                            g_new_z.x = -g_new_z.x;
-                            g_new_z.y = -g_new_z.y;
+                            g_ctx.new_z.x = -g_ctx.new_z.x;
+                            g_ctx.new_z.y = -g_ctx.new_z.y;
                         }
                         if (++rancnt > 1024)
                         {
@@ -1178,8 +1178,8 @@ void Jiim(jiim_types which)
                         }
                         break;
                     case 1:             // now go negative dir for a while
-                        g_new_z.x = -g_new_z.x;
-                        g_new_z.y = -g_new_z.y;
+                        g_ctx.new_z.x = -g_ctx.new_z.x;
+                        g_ctx.new_z.y = -g_ctx.new_z.y;
                         // fall through
                     case -1:            // now go positive dir for a while
                         if (++rancnt > 512)
@@ -1189,8 +1189,8 @@ void Jiim(jiim_types which)
                         }
                         break;
                     }
-                    x = (int)(g_new_z.x * xfactor * zoom + xoff);
-                    y = (int)(g_new_z.y * yfactor * zoom + yoff);
+                    x = (int)(g_ctx.new_z.x * xfactor * zoom + xoff);
+                    y = (int)(g_ctx.new_z.y * yfactor * zoom + yoff);
                     break;
                 } // end switch SecretMode (sorry about the indentation)
             } // end if not MIIM
@@ -1202,13 +1202,13 @@ void Jiim(jiim_types which)
                 color = (int)iter%g_colors;
                 if (g_integer_fractal)
                 {
-                    g_old_z.x = g_l_old_z.x;
-                    g_old_z.x /= g_fudge_factor;
-                    g_old_z.y = g_l_old_z.y;
-                    g_old_z.y /= g_fudge_factor;
+                    g_ctx.old_z.x = g_l_old_z.x;
+                    g_ctx.old_z.x /= g_fudge_factor;
+                    g_ctx.old_z.y = g_l_old_z.y;
+                    g_ctx.old_z.y /= g_fudge_factor;
                 }
-                x = (int)((g_old_z.x - g_init.x) * xfactor * 3 * zoom + xoff);
-                y = (int)((g_old_z.y - g_init.y) * yfactor * 3 * zoom + yoff);
+                x = (int)((g_ctx.old_z.x - g_ctx.init.x) * xfactor * 3 * zoom + xoff);
+                y = (int)((g_ctx.old_z.y - g_ctx.init.y) * yfactor * 3 * zoom + yoff);
                 if ((*ORBIT_CALC)())
                 {
                     iter = g_max_iterations;
@@ -1244,7 +1244,7 @@ void Jiim(jiim_types which)
             old_x = x;
             old_y = y;
         }
-        g_old_z = g_new_z;
+        g_ctx.old_z = g_ctx.new_z;
         g_l_old_z = g_l_new_z;
     } // end while (still)
 finish:
@@ -1475,9 +1475,9 @@ int targa_color(int x, int y, int color)
         break;
 
     case true_color_mode::iterate:
-        RGB[0] = (BYTE)((g_real_color_iter >> 16) & 0xff);  // red
-        RGB[1] = (BYTE)((g_real_color_iter >> 8) & 0xff);   // green
-        RGB[2] = (BYTE)((g_real_color_iter) & 0xff);        // blue
+        RGB[0] = (BYTE)((g_ctx.real_color_iter >> 16) & 0xff);  // red
+        RGB[1] = (BYTE)((g_ctx.real_color_iter >> 8) & 0xff);   // green
+        RGB[2] = (BYTE)((g_ctx.real_color_iter) & 0xff);        // blue
         break;
     }
 
@@ -8,7 +8,10 @@
 
 #include "3d.h"
 #include "calcfrac.h"
+#include "calclane.h"
+#include "calcpool.h"
 #include "cmdfiles.h"
+#include "density.h"
 #include "drivers.h"
 #include "encoder.h"
 #include "fracsubr.h"
@@ -22,16 +25,28 @@
 #include "lorenz.h"
 #include "miscres.h"
 #include "mpmath.h"
+#include "orbitsave.h"
 #include "plot3d.h"
 #include "realdos.h"
 
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#if defined(CALC_VECTOR_LANES)
+#include <immintrin.h>
+#endif
+
 // orbitcalc is declared with no arguments so jump through hoops here
 #define LORBIT(x, y, z) \
    (*(int(*)(long *, long *, long *))g_cur_fractal_specific->orbitcalc)(x, y, z)
@@ -96,11 +111,14 @@ static int  ifs2d();
 static int  ifs3d();
 static int  ifs3dlong();
 static int  ifs3dfloat();
+static int  ifs_threads(bool three_d);
+static bool miim_threads_setup();
+static int  miim_threads();
+static int  orbit3d_batch();
 static bool l_setup_convert_to_screen(l_affine *);
 static void setupmatrix(MATRIX);
 static bool long3dviewtransf(long3dvtinf *inf);
 static bool float3dviewtransf(float3dvtinf *inf);
-static std::FILE *open_orbitsave();
 static void plothist(int x, int y, int color);
 static bool realtime = false;
 
@@ -393,6 +411,10 @@ bool orbit3dlongsetup()
         switch (g_major_method)
         {
         case Major::breadth_first:
+            if (miim_threads_setup())
+            {
+                break;              // miim_threads() starts from the fixed points
+            }
             if (!Init_Queue(32*1024UL))
             {
                 // can't get queue memory: fall back to random walk
@@ -405,6 +427,10 @@ bool orbit3dlongsetup()
             break;
 
         case Major::depth_first:
+            if (miim_threads_setup())
+            {
+                break;
+            }
             if (!Init_Queue(32*1024UL))
             {
                 // can't get queue memory: fall back to random walk
@@ -595,6 +621,10 @@ bool orbit3dfloatsetup()
         switch (g_major_method)
         {
         case Major::breadth_first:
+            if (miim_threads_setup())
+            {
+                break;              // miim_threads() starts from the fixed points
+            }
             if (!Init_Queue(32*1024UL))
             {
                 // can't get queue memory: fall back to random walk
@@ -606,6 +636,10 @@ bool orbit3dfloatsetup()
             EnQueueFloat((float)((1 - Sqrt.x) / 2), (float)(-Sqrt.y / 2));
             break;
         case Major::depth_first:                      // depth first (choose direction)
+            if (miim_threads_setup())
+            {
+                break;
+            }
             if (!Init_Queue(32*1024UL))
             {
                 // can't get queue memory: fall back to random walk
@@ -628,16 +662,16 @@ bool orbit3dfloatsetup()
         case Major::random_walk:
 rwalk:
             initorbitfp[0] = 1 + Sqrt.x / 2;
-            g_new_z.x = initorbitfp[0];
+            g_ctx.new_z.x = initorbitfp[0];
             initorbitfp[1] = Sqrt.y / 2;
-            g_new_z.y = initorbitfp[1];
+            g_ctx.new_z.y = initorbitfp[1];
             break;
         case Major::random_run:       // random run, choose intervals
             g_major_method = Major::random_run;
             initorbitfp[0] = 1 + Sqrt.x / 2;
-            g_new_z.x = initorbitfp[0];
+            g_ctx.new_z.x = initorbitfp[0];
             initorbitfp[1] = Sqrt.y / 2;
-            g_new_z.y = initorbitfp[1];
+            g_ctx.new_z.y = initorbitfp[1];
             break;
         }
     }
@@ -678,14 +712,14 @@ int Minverse_julia_orbit()
         {
             return -1;
         }
-        g_new_z = DeQueueFloat();
+        g_ctx.new_z = DeQueueFloat();
         break;
     case Major::depth_first:
         if (QueueEmpty())
         {
             return -1;
         }
-        g_new_z = PopFloat();
+        g_ctx.new_z = PopFloat();
         break;
     case Major::random_walk:
         break;
@@ -696,14 +730,14 @@ int Minverse_julia_orbit()
     /*
      * Next, find its pixel position
      */
-    newcol = (int)(cvt.a * g_new_z.x + cvt.b * g_new_z.y + cvt.e);
-    newrow = (int)(cvt.c * g_new_z.x + cvt.d * g_new_z.y + cvt.f);
+    newcol = (int)(cvt.a * g_ctx.new_z.x + cvt.b * g_ctx.new_z.y + cvt.e);
+    newrow = (int)(cvt.c * g_ctx.new_z.x + cvt.d * g_ctx.new_z.y + cvt.f);
 
     /*
      * Now find the next point(s), and flip a coin to choose one.
      */
 
-    g_new_z       = ComplexSqrtFloat(g_new_z.x - Cx, g_new_z.y - Cy);
+    g_ctx.new_z       = ComplexSqrtFloat(g_ctx.new_z.x - Cx, g_ctx.new_z.y - Cy);
     leftright = (RANDOM(2)) ? 1 : -1;
 
     if (newcol < 1 || newcol >= g_logical_screen_x_dots || newrow < 1 || newrow >= g_logical_screen_y_dots)
@@ -715,10 +749,10 @@ int Minverse_julia_orbit()
         switch (g_major_method)
         {
         case Major::breadth_first:
-            EnQueueFloat((float)(leftright * g_new_z.x), (float)(leftright * g_new_z.y));
+            EnQueueFloat((float)(leftright * g_ctx.new_z.x), (float)(leftright * g_ctx.new_z.y));
             return 1;
         case Major::depth_first:
-            PushFloat((float)(leftright * g_new_z.x), (float)(leftright * g_new_z.y));
+            PushFloat((float)(leftright * g_ctx.new_z.x), (float)(leftright * g_ctx.new_z.y));
             return 1;
         case Major::random_run:
         case Major::random_walk:
@@ -738,8 +772,8 @@ int Minverse_julia_orbit()
         if (color < mxhits)
         {
             g_put_color(newcol, newrow, color+1);
-            EnQueueFloat((float)g_new_z.x, (float)g_new_z.y);
-            EnQueueFloat((float)-g_new_z.x, (float)-g_new_z.y);
+            EnQueueFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
+            EnQueueFloat((float)-g_ctx.new_z.x, (float)-g_ctx.new_z.y);
         }
         break;
     case Major::depth_first:
@@ -750,24 +784,24 @@ int Minverse_julia_orbit()
             {
                 if (QueueFullAlmost())
                 {
-                    PushFloat((float)-g_new_z.x, (float)-g_new_z.y);
+                    PushFloat((float)-g_ctx.new_z.x, (float)-g_ctx.new_z.y);
                 }
                 else
                 {
-                    PushFloat((float)g_new_z.x, (float)g_new_z.y);
-                    PushFloat((float)-g_new_z.x, (float)-g_new_z.y);
+                    PushFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
+                    PushFloat((float)-g_ctx.new_z.x, (float)-g_ctx.new_z.y);
                 }
             }
             else
             {
                 if (QueueFullAlmost())
                 {
-                    PushFloat((float)g_new_z.x, (float)g_new_z.y);
+                    PushFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
                 }
                 else
                 {
-                    PushFloat((float)-g_new_z.x, (float)-g_new_z.y);
-                    PushFloat((float)g_new_z.x, (float)g_new_z.y);
+                    PushFloat((float)-g_ctx.new_z.x, (float)-g_ctx.new_z.y);
+                    PushFloat((float)g_ctx.new_z.x, (float)g_ctx.new_z.y);
                 }
             }
         }
@@ -783,12 +817,12 @@ int Minverse_julia_orbit()
         case 0:     // left
             break;
         case 1:     // right
-            g_new_z.x = -g_new_z.x;
-            g_new_z.y = -g_new_z.y;
+            g_ctx.new_z.x = -g_ctx.new_z.x;
+            g_ctx.new_z.y = -g_ctx.new_z.y;
             break;
         case 2:     // random direction
-            g_new_z.x = leftright * g_new_z.x;
-            g_new_z.y = leftright * g_new_z.y;
+            g_ctx.new_z.x = leftright * g_ctx.new_z.x;
+            g_ctx.new_z.y = leftright * g_ctx.new_z.y;
             break;
         }
         if (color < g_colors-1)
@@ -801,8 +835,8 @@ int Minverse_julia_orbit()
         {
             g_put_color(newcol, newrow, color+1);
         }
-        g_new_z.x = leftright * g_new_z.x;
-        g_new_z.y = leftright * g_new_z.y;
+        g_ctx.new_z.x = leftright * g_ctx.new_z.x;
+        g_ctx.new_z.y = leftright * g_ctx.new_z.y;
         break;
     }
     return 1;
@@ -1330,24 +1364,24 @@ int latoofloatorbit(double *x, double *y, double * /*z*/)
     yold = *y;
 
     //    *x = sin(yold * PAR_B) + PAR_C * sin(xold * PAR_B);
-    g_old_z.x = yold * PAR_B;
-    g_old_z.y = 0;          // old = (y * B) + 0i (in the complex)
-    CMPLXtrig0(g_old_z, g_new_z);
-    tmp = (double) g_new_z.x;
-    g_old_z.x = xold * PAR_B;
-    g_old_z.y = 0;          // old = (x * B) + 0i
-    CMPLXtrig1(g_old_z, g_new_z);
-    *x  = PAR_C * g_new_z.x + tmp;
+    g_ctx.old_z.x = yold * PAR_B;
+    g_ctx.old_z.y = 0;          // old = (y * B) + 0i (in the complex)
+    CMPLXtrig0(g_ctx.old_z, g_ctx.new_z);
+    tmp = (double) g_ctx.new_z.x;
+    g_ctx.old_z.x = xold * PAR_B;
+    g_ctx.old_z.y = 0;          // old = (x * B) + 0i
+    CMPLXtrig1(g_ctx.old_z, g_ctx.new_z);
+    *x  = PAR_C * g_ctx.new_z.x + tmp;
 
     //    *y = sin(xold * PAR_A) + PAR_D * sin(yold * PAR_A);
-    g_old_z.x = xold * PAR_A;
-    g_old_z.y = 0;          // old = (y * A) + 0i (in the complex)
-    CMPLXtrig2(g_old_z, g_new_z);
-    tmp = (double) g_new_z.x;
-    g_old_z.x = yold * PAR_A;
-    g_old_z.y = 0;          // old = (x * B) + 0i
-    CMPLXtrig3(g_old_z, g_new_z);
-    *y  = PAR_D * g_new_z.x + tmp;
+    g_ctx.old_z.x = xold * PAR_A;
+    g_ctx.old_z.y = 0;          // old = (y * A) + 0i (in the complex)
+    CMPLXtrig2(g_ctx.old_z, g_ctx.new_z);
+    tmp = (double) g_ctx.new_z.x;
+    g_ctx.old_z.x = yold * PAR_A;
+    g_ctx.old_z.y = 0;          // old = (x * B) + 0i
+    CMPLXtrig3(g_ctx.old_z, g_ctx.new_z);
+    *y  = PAR_D * g_ctx.new_z.x + tmp;
 
     return 0;
 }
@@ -1370,6 +1404,12 @@ int inverse_julia_per_image()
         return -1;
     }
 
+    int const ret = miim_threads();
+    if (ret != 1)
+    {
+        return ret;
+    }
+
     while (color >= 0)       // generate points
     {
         if (check_key())
@@ -1378,7 +1418,7 @@ int inverse_julia_per_image()
             return -1;
         }
         color = g_cur_fractal_specific->orbitcalc();
-        g_old_z = g_new_z;
+        g_ctx.old_z = g_ctx.new_z;
     }
     Free_Queue();
     return 0;
@@ -1386,7 +1426,7 @@ int inverse_julia_per_image()
 
 int orbit2dfloat()
 {
-    std::FILE *fp;
+    bool save;
     double *soundvar;
     double x, y, z;
     int color, col, row;
@@ -1401,7 +1441,7 @@ int orbit2dfloat()
     p0 = p1;
     soundvar = p0;
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
     // setup affine screen coord conversion
     setup_convert_to_screen(&cvt);
 
@@ -1451,7 +1491,7 @@ int orbit2dfloat()
     x = initorbitfp[0];
     y = initorbitfp[1];
     z = initorbitfp[2];
-    g_color_iter = 0L;
+    g_ctx.color_iter = 0L;
     ret = 0;
     count = ret;
     if (g_max_iterations > 0x1fffffL || g_max_count)
@@ -1463,18 +1503,19 @@ int orbit2dfloat()
         g_max_count = g_max_iterations*1024L;
     }
 
+    bool const density = density_start();
     if (g_resuming)
     {
         start_resume();
         get_resume(sizeof(count), &count, sizeof(color), &color,
                    sizeof(oldrow), &oldrow, sizeof(oldcol), &oldcol,
                    sizeof(x), &x, sizeof(y), &y, sizeof(z), &z, sizeof(t), &t,
-                   sizeof(orbit), &orbit, sizeof(g_color_iter), &g_color_iter,
+                   sizeof(orbit), &orbit, sizeof(g_ctx.color_iter), &g_ctx.color_iter,
                    0);
         end_resume();
     }
 
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         if (driver_key_pressed())
         {
@@ -1483,7 +1524,7 @@ int orbit2dfloat()
             put_resume(sizeof(count), &count, sizeof(color), &color,
                        sizeof(oldrow), &oldrow, sizeof(oldcol), &oldcol,
                        sizeof(x), &x, sizeof(y), &y, sizeof(z), &z, sizeof(t), &t,
-                       sizeof(orbit), &orbit, sizeof(g_color_iter), &g_color_iter,
+                       sizeof(orbit), &orbit, sizeof(g_ctx.color_iter), &g_ctx.color_iter,
                        0);
             ret = -1;
             break;
@@ -1506,7 +1547,11 @@ int orbit2dfloat()
             {
                 w_snd((int)(*soundvar*100 + g_base_hertz));
             }
-            if ((g_fractal_type != fractal_type::ICON) && (g_fractal_type != fractal_type::LATOO))
+            if (density)
+            {
+                density_hit(col, row);
+            }
+            else if ((g_fractal_type != fractal_type::ICON) && (g_fractal_type != fractal_type::LATOO))
             {
                 if (oldcol != -1 && connect)
                 {
@@ -1544,21 +1589,21 @@ int orbit2dfloat()
         {
             break;
         }
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", *p0, *p1, 0.0);
+            orbit_save_point(*p0, *p1, 0.0, color % g_colors);
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
 
 int orbit2dlong()
 {
-    std::FILE *fp;
+    bool save;
     long *soundvar;
     long x, y, z;
     int color, col, row;
@@ -1573,7 +1618,7 @@ int orbit2dlong()
     p1 = p2;
     p0 = p1;
     soundvar = p0;
-    fp = open_orbitsave();
+    save = orbit_save_open();
 
     // setup affine screen coord conversion
     l_setup_convert_to_screen(&cvt);
@@ -1637,7 +1682,7 @@ int orbit2dlong()
     {
         g_max_count = g_max_iterations*1024L;
     }
-    g_color_iter = 0L;
+    g_ctx.color_iter = 0L;
 
     if (g_resuming)
     {
@@ -1645,12 +1690,12 @@ int orbit2dlong()
         get_resume(sizeof(count), &count, sizeof(color), &color,
                    sizeof(oldrow), &oldrow, sizeof(oldcol), &oldcol,
                    sizeof(x), &x, sizeof(y), &y, sizeof(z), &z, sizeof(t), &t,
-                   sizeof(l_orbit), &l_orbit, sizeof(g_color_iter), &g_color_iter,
+                   sizeof(l_orbit), &l_orbit, sizeof(g_ctx.color_iter), &g_ctx.color_iter,
                    0);
         end_resume();
     }
 
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         if (driver_key_pressed())
         {
@@ -1659,7 +1704,7 @@ int orbit2dlong()
             put_resume(sizeof(count), &count, sizeof(color), &color,
                        sizeof(oldrow), &oldrow, sizeof(oldcol), &oldcol,
                        sizeof(x), &x, sizeof(y), &y, sizeof(z), &z, sizeof(t), &t,
-                       sizeof(l_orbit), &l_orbit, sizeof(g_color_iter), &g_color_iter,
+                       sizeof(l_orbit), &l_orbit, sizeof(g_ctx.color_iter), &g_ctx.color_iter,
                        0);
             ret = -1;
             break;
@@ -1717,21 +1762,21 @@ int orbit2dlong()
         {
             break;
         }
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", (double)*p0/g_fudge_factor, (double)*p1/g_fudge_factor, 0.0);
+            orbit_save_point((double)*p0/g_fudge_factor, (double)*p1/g_fudge_factor, 0.0, color % g_colors);
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
 
 static int orbit3dlongcalc()
 {
-    std::FILE *fp;
+    bool save;
     unsigned long count;
     int oldcol, oldrow;
     int oldcol1, oldrow1;
@@ -1761,7 +1806,7 @@ static int orbit3dlongcalc()
         notdiskmsg();
     }
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
 
     ret = 0;
     count = ret;
@@ -1773,8 +1818,8 @@ static int orbit3dlongcalc()
     {
         g_max_count = g_max_iterations*1024L;
     }
-    g_color_iter = 0L;
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    g_ctx.color_iter = 0L;
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         // calc goes here
         if (++count > 1000)
@@ -1794,9 +1839,9 @@ static int orbit3dlongcalc()
         }
 
         LORBIT(&inf.orbit[0], &inf.orbit[1], &inf.orbit[2]);
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", (double)inf.orbit[0]/g_fudge_factor, (double)inf.orbit[1]/g_fudge_factor, (double)inf.orbit[2]/g_fudge_factor);
+            orbit_save_point((double)inf.orbit[0]/g_fudge_factor, (double)inf.orbit[1]/g_fudge_factor, (double)inf.orbit[2]/g_fudge_factor, color % g_colors);
         }
         if (long3dviewtransf(&inf))
         {
@@ -1853,9 +1898,9 @@ static int orbit3dlongcalc()
             }
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
@@ -1863,7 +1908,7 @@ static int orbit3dlongcalc()
 
 static int orbit3dfloatcalc()
 {
-    std::FILE *fp;
+    bool save;
     unsigned long count;
     int oldcol, oldrow;
     int oldcol1, oldrow1;
@@ -1871,6 +1916,12 @@ static int orbit3dfloatcalc()
     int ret;
     float3dvtinf inf;
 
+    ret = orbit3d_batch();
+    if (ret != 1)
+    {
+        return ret;
+    }
+
     // setup affine screen coord conversion
     setup_convert_to_screen(&inf.cvt);
 
@@ -1892,7 +1943,8 @@ static int orbit3dfloatcalc()
         notdiskmsg();
     }
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
+    bool const density = g_glasses_type == 0 && density_start();
 
     ret = 0;
     if (g_max_iterations > 0x1fffffL || g_max_count)
@@ -1903,9 +1955,9 @@ static int orbit3dfloatcalc()
     {
         g_max_count = g_max_iterations*1024L;
     }
-    g_color_iter = 0L;
-    count = g_color_iter;
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    g_ctx.color_iter = 0L;
+    count = g_ctx.color_iter;
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         // calc goes here
         if (++count > 1000)
@@ -1926,9 +1978,9 @@ static int orbit3dfloatcalc()
         }
 
         FORBIT(&inf.orbit[0], &inf.orbit[1], &inf.orbit[2]);
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", inf.orbit[0], inf.orbit[1], inf.orbit[2]);
+            orbit_save_point(inf.orbit[0], inf.orbit[1], inf.orbit[2], color % g_colors);
         }
         if (float3dviewtransf(&inf))
         {
@@ -1943,7 +1995,11 @@ static int orbit3dfloatcalc()
                 {
                     w_snd((int)(inf.viewvect[((g_sound_flag & SOUNDFLAG_ORBITMASK) - SOUNDFLAG_X)]*100+g_base_hertz));
                 }
-                if (oldcol != -1 && connect)
+                if (density)
+                {
+                    density_hit(inf.col, inf.row);
+                }
+                else if (oldcol != -1 && connect)
                 {
                     driver_draw_line(inf.col, inf.row, oldcol, oldrow, color%g_colors);
                 }
@@ -1982,9 +2038,9 @@ static int orbit3dfloatcalc()
             }
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
@@ -2034,7 +2090,7 @@ bool dynam2dfloatsetup()
  */
 int dynam2dfloat()
 {
-    std::FILE *fp = nullptr;
+    bool save = false;
     double *soundvar = nullptr;
     double x = 0.0;
     double y = 0.0;
@@ -2053,7 +2109,7 @@ int dynam2dfloat()
     double xpixel = 0.0;
     double ypixel = 0.0; // Our pixel position on the screen
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
     // setup affine screen coord conversion
     setup_convert_to_screen(&cvt);
 
@@ -2088,6 +2144,12 @@ int dynam2dfloat()
     xstep = -1;
     ystep = 0;
 
+    bool const density = density_start();
+    if (density)
+    {
+        g_plot = density_plot;
+        connect = false;
+    }
     if (g_resuming)
     {
         start_resume();
@@ -2189,15 +2251,15 @@ int dynam2dfloat()
             {
                 break;
             }
-            if (fp)
+            if (save)
             {
-                std::fprintf(fp, "%g %g %g 15\n", *p0, *p1, 0.0);
+                orbit_save_point(*p0, *p1, 0.0, color % g_colors);
             }
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
@@ -2205,6 +2267,8 @@ int dynam2dfloat()
 bool g_keep_screen_coords = false;
 bool g_set_orbit_corners = false;
 long g_orbit_interval;
+int g_orbit_trajectories = 1;
+bool g_orbit_rk4 = false;
 double g_orbit_corner_min_x;
 double g_orbit_corner_min_y;
 double g_orbit_corner_max_x;
@@ -2286,7 +2350,11 @@ int plotorbits2dsetup()
 
     o_color = 1;
 
-    if (g_outside_color == SUM)
+    if (density_start())
+    {
+        g_plot = density_plot;
+    }
+    else if (g_outside_color == SUM)
     {
         g_plot = plothist;
     }
@@ -2360,8 +2428,8 @@ int plotorbits2dfloat()
         }
 
         // else count >= orbit_delay and we want to plot it
-        col = (int)(o_cvt.a*g_new_z.x + o_cvt.b*g_new_z.y + o_cvt.e);
-        row = (int)(o_cvt.c*g_new_z.x + o_cvt.d*g_new_z.y + o_cvt.f);
+        col = (int)(o_cvt.a*g_ctx.new_z.x + o_cvt.b*g_ctx.new_z.y + o_cvt.e);
+        row = (int)(o_cvt.c*g_ctx.new_z.x + o_cvt.d*g_ctx.new_z.y + o_cvt.f);
 #ifdef XFRACT
         if (col >= 0 && col < g_logical_screen_x_dots && row >= 0 && row < g_logical_screen_y_dots)
 #else
@@ -2452,7 +2520,7 @@ done:
 static int ifs3dfloat()
 {
     int color_method;
-    std::FILE *fp;
+    bool save;
     int color;
 
     double newx, newy, newz, r, sum;
@@ -2464,6 +2532,12 @@ static int ifs3dfloat()
 
     float *ffptr;
 
+    ret = ifs_threads(true);
+    if (ret != 1)
+    {
+        return ret;
+    }
+
     // setup affine screen coord conversion
     setup_convert_to_screen(&inf.cvt);
     srand(1);
@@ -2477,7 +2551,8 @@ static int ifs3dfloat()
     inf.orbit[1] = 0;
     inf.orbit[2] = 0;
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
+    bool const density = color_method == 0 && g_glasses_type == 0 && density_start();
 
     ret = 0;
     if (g_max_iterations > 0x1fffffL)
@@ -2488,8 +2563,8 @@ static int ifs3dfloat()
     {
         g_max_count = g_max_iterations*1024;
     }
-    g_color_iter = 0L;
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    g_ctx.color_iter = 0L;
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         if (driver_key_pressed())  // keypress bails out
         {
@@ -2526,9 +2601,9 @@ static int ifs3dfloat()
         inf.orbit[0] = newx;
         inf.orbit[1] = newy;
         inf.orbit[2] = newz;
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", newx, newy, newz);
+            orbit_save_point(newx, newy, newz, (k % g_colors) + 1);
         }
         if (float3dviewtransf(&inf))
         {
@@ -2539,17 +2614,24 @@ static int ifs3dfloat()
                 {
                     g_which_image = stereo_images::RED;
                 }
-                if (color_method)
+                if (density)
                 {
-                    color = (k%g_colors)+1;
+                    density_hit(inf.col, inf.row);
                 }
                 else
                 {
-                    color = getcolor(inf.col, inf.row)+1;
-                }
-                if (color < g_colors)     // color sticks on last value
-                {
-                    (*g_plot)(inf.col, inf.row, color);
+                    if (color_method)
+                    {
+                        color = (k%g_colors)+1;
+                    }
+                    else
+                    {
+                        color = getcolor(inf.col, inf.row)+1;
+                    }
+                    if (color < g_colors)     // color sticks on last value
+                    {
+                        (*g_plot)(inf.col, inf.row, color);
+                    }
                 }
             }
             else if (inf.col == -2)
@@ -2582,9 +2664,9 @@ static int ifs3dfloat()
             }
         }
     } // end while
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
@@ -2611,7 +2693,7 @@ char insufficient_ifs_mem[] = {"Insufficient memory for IFS"};
 static int ifs2d()
 {
     int color_method;
-    std::FILE *fp;
+    bool save;
     int col;
     int row;
     int color;
@@ -2620,6 +2702,13 @@ static int ifs2d()
     long *lfptr;
     long x, y, newx, newy, r, sum, tempr;
     l_affine cvt;
+
+    ret = ifs_threads(false);
+    if (ret != 1)
+    {
+        return ret;
+    }
+
     // setup affine screen coord conversion
     l_setup_convert_to_screen(&cvt);
 
@@ -2650,7 +2739,8 @@ static int ifs2d()
 
     tempr = g_fudge_factor / 32767;        // find the proper rand() fudge
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
+    bool const density = color_method == 0 && density_start();
 
     y = 0;
     x = y;
@@ -2663,8 +2753,8 @@ static int ifs2d()
     {
         g_max_count = g_max_iterations*1024L;
     }
-    g_color_iter = 0L;
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    g_ctx.color_iter = 0L;
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         if (driver_key_pressed())  // keypress bails out
         {
@@ -2689,9 +2779,9 @@ static int ifs2d()
                multiply(lfptr[3], y, g_bit_shift) + lfptr[5];
         x = newx;
         y = newy;
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", (double)newx/g_fudge_factor, (double)newy/g_fudge_factor, 0.0);
+            orbit_save_point((double)newx/g_fudge_factor, (double)newy/g_fudge_factor, 0.0, (k % g_colors) + 1);
         }
 
         // plot if inside window
@@ -2700,17 +2790,24 @@ static int ifs2d()
         if (col >= 0 && col < g_logical_screen_x_dots && row >= 0 && row < g_logical_screen_y_dots)
         {
             // color is count of hits on this pixel
-            if (color_method)
+            if (density)
             {
-                color = (k%g_colors)+1;
+                density_hit(col, row);
             }
             else
             {
-                color = getcolor(col, row)+1;
-            }
-            if (color < g_colors)     // color sticks on last value
-            {
-                (*g_plot)(col, row, color);
+                if (color_method)
+                {
+                    color = (k%g_colors)+1;
+                }
+                else
+                {
+                    color = getcolor(col, row)+1;
+                }
+                if (color < g_colors)     // color sticks on last value
+                {
+                    (*g_plot)(col, row, color);
+                }
             }
         }
         else if ((long)std::abs(row) + (long)std::abs(col) > BAD_PIXEL)   // sanity check
@@ -2718,9 +2815,9 @@ static int ifs2d()
             return ret;
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
@@ -2728,7 +2825,7 @@ static int ifs2d()
 static int ifs3dlong()
 {
     int color_method;
-    std::FILE *fp;
+    bool save;
     int color;
     int ret;
     std::vector<long> localifs;
@@ -2736,6 +2833,12 @@ static int ifs3dlong()
     long newx, newy, newz, r, sum, tempr;
     long3dvtinf inf;
 
+    ret = ifs_threads(true);
+    if (ret != 1)
+    {
+        return ret;
+    }
+
     srand(1);
     color_method = (int)g_params[0];
     try
@@ -2765,7 +2868,8 @@ static int ifs3dlong()
     inf.orbit[1] = 0;
     inf.orbit[2] = 0;
 
-    fp = open_orbitsave();
+    save = orbit_save_open();
+    bool const density = color_method == 0 && g_glasses_type == 0 && density_start();
 
     ret = 0;
     if (g_max_iterations > 0x1fffffL)
@@ -2776,8 +2880,8 @@ static int ifs3dlong()
     {
         g_max_count = g_max_iterations*1024L;
     }
-    g_color_iter = 0L;
-    while (g_color_iter++ <= g_max_count) // loop until keypress or maxit
+    g_ctx.color_iter = 0L;
+    while (g_ctx.color_iter++ <= g_max_count) // loop until keypress or maxit
     {
         if (driver_key_pressed())  // keypress bails out
         {
@@ -2816,9 +2920,9 @@ static int ifs3dlong()
         inf.orbit[0] = newx;
         inf.orbit[1] = newy;
         inf.orbit[2] = newz;
-        if (fp)
+        if (save)
         {
-            std::fprintf(fp, "%g %g %g 15\n", (double)newx/g_fudge_factor, (double)newy/g_fudge_factor, (double)newz/g_fudge_factor);
+            orbit_save_point((double)newx/g_fudge_factor, (double)newy/g_fudge_factor, (double)newz/g_fudge_factor, (k % g_colors) + 1);
         }
 
         if (long3dviewtransf(&inf))
@@ -2834,17 +2938,24 @@ static int ifs3dlong()
                 {
                     g_which_image = stereo_images::RED;
                 }
-                if (color_method)
+                if (density)
                 {
-                    color = (k%g_colors)+1;
+                    density_hit(inf.col, inf.row);
                 }
                 else
                 {
-                    color = getcolor(inf.col, inf.row)+1;
-                }
-                if (color < g_colors)     // color sticks on last value
-                {
-                    (*g_plot)(inf.col, inf.row, color);
+                    if (color_method)
+                    {
+                        color = (k%g_colors)+1;
+                    }
+                    else
+                    {
+                        color = getcolor(inf.col, inf.row)+1;
+                    }
+                    if (color < g_colors)     // color sticks on last value
+                    {
+                        (*g_plot)(inf.col, inf.row, color);
+                    }
                 }
             }
             if (realtime)
@@ -2869,13 +2980,896 @@ static int ifs3dlong()
             }
         }
     }
-    if (fp)
+    if (save)
     {
-        std::fclose(fp);
+        orbit_save_close();
     }
     return ret;
 }
 
+// IFS on the calc threads.  Each thread plays its own chaos game, drawing
+// its random numbers from a stream of its own, and counts the hits in a
+// buffer of its own.  Every so often the buffers are handed back to this
+// thread to go on the screen, and a cleared one is taken in exchange.  With
+// density= the threads count straight into the shared hit counts instead.
+
+namespace
+{
+struct ifs_walk
+{
+    float3dvtinf inf;           // orbit, and the 3D view transform
+    std::uint64_t key;          // which random number stream
+    std::uint64_t counter;      // how far along it
+    long points;                // points still to plot
+    unsigned handed;            // last request for the hits answered
+    std::vector<BYTE> hits;     // hits not yet on the screen
+};
+
+std::vector<ifs_walk> s_ifs_walks;
+std::vector<double> s_ifs_odds;                 // running total of the odds of each transform
+bool s_ifs_3d = false;
+int s_ifs_color_method = 0;
+bool s_ifs_density = false;
+std::mutex s_ifs_lock;
+std::vector<std::vector<BYTE>> s_ifs_full;      // hits to go on the screen
+std::vector<std::vector<BYTE>> s_ifs_empty;     // cleared, for the walks
+std::atomic<unsigned> s_ifs_request(0);         // bumped to ask for the hits
+unsigned s_ifs_drains = 0;
+}
+
+// A random number between 0 and 1 from a counter-based generator: the
+// splitmix64 mix of the stream key plus the counter, so a walk's numbers
+// don't depend on what else is running.
+static double ifs_random(std::uint64_t key, std::uint64_t counter)
+{
+    std::uint64_t z = key + counter*0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (double)(z >> 11)/9007199254740992.0;
+}
+
+// Take one step of a walk with a transform picked at random, weighted by
+// its odds.  Returns the transform.
+static int ifs_step(ifs_walk &walk)
+{
+    double const r = ifs_random(walk.key, walk.counter++);
+    int const last = (int) s_ifs_odds.size() - 1;
+    int k = 0;
+    while (s_ifs_odds[k] < r && k < last)
+    {
+        ++k;
+    }
+    double *orbit = walk.inf.orbit;
+    if (s_ifs_3d)
+    {
+        float const *ffptr = &g_ifs_definition[k*NUM_IFS_3D_PARAMS];
+        double const newx = ffptr[0]*orbit[0] + ffptr[1]*orbit[1] + ffptr[2]*orbit[2] + ffptr[9];
+        double const newy = ffptr[3]*orbit[0] + ffptr[4]*orbit[1] + ffptr[5]*orbit[2] + ffptr[10];
+        double const newz = ffptr[6]*orbit[0] + ffptr[7]*orbit[1] + ffptr[8]*orbit[2] + ffptr[11];
+        orbit[0] = newx;
+        orbit[1] = newy;
+        orbit[2] = newz;
+    }
+    else
+    {
+        float const *ffptr = &g_ifs_definition[k*NUM_IFS_PARAMS];
+        double const newx = ffptr[0]*orbit[0] + ffptr[1]*orbit[1] + ffptr[4];
+        double const newy = ffptr[2]*orbit[0] + ffptr[3]*orbit[1] + ffptr[5];
+        orbit[0] = newx;
+        orbit[1] = newy;
+    }
+    return k;
+}
+
+// Find where a walk is on the screen, in inf.col and inf.row, -1 if off
+// the screen.  Returns false if the walk has gone off to infinity.
+static bool ifs_screen(ifs_walk &walk)
+{
+    float3dvtinf &inf = walk.inf;
+    if (s_ifs_3d)
+    {
+        float3dviewtransf(&inf);
+        return inf.col != -2;
+    }
+    double const col = inf.cvt.a*inf.orbit[0] + inf.cvt.b*inf.orbit[1] + inf.cvt.e;
+    double const row = inf.cvt.c*inf.orbit[0] + inf.cvt.d*inf.orbit[1] + inf.cvt.f;
+    if (!(std::fabs(col) + std::fabs(row) <= BAD_PIXEL))   // sanity check
+    {
+        return false;
+    }
+    inf.col = (int) col;
+    inf.row = (int) row;
+    if (inf.col < 0 || inf.col >= g_logical_screen_x_dots || inf.row < 0 || inf.row >= g_logical_screen_y_dots)
+    {
+        inf.col = -1;
+    }
+    return true;
+}
+
+static bool ifs_walk_task(ifs_walk &walk)
+{
+    while (walk.points > 0)
+    {
+        if (calc_pool_interrupted())
+        {
+            return false;
+        }
+        long const batch = std::min(walk.points, 1L << 16);
+        walk.points -= batch;
+        for (long i = 0; i < batch; ++i)
+        {
+            int const k = ifs_step(walk);
+            if (!ifs_screen(walk))
+            {
+                walk.points = 0;
+                break;
+            }
+            if (walk.inf.col >= 0 && s_ifs_density)
+            {
+                density_hit_shared(walk.inf.col, walk.inf.row);
+            }
+            else if (walk.inf.col >= 0)
+            {
+                BYTE &hit = walk.hits[(std::size_t) walk.inf.row*g_logical_screen_x_dots + walk.inf.col];
+                if (s_ifs_color_method)
+                {
+                    int const color = (k%g_colors)+1;
+                    if (color < g_colors)     // color sticks on last value
+                    {
+                        hit = (BYTE) color;
+                    }
+                }
+                else if (hit < 255)
+                {
+                    ++hit;
+                }
+            }
+        }
+        unsigned const request = s_ifs_request;
+        if (request != walk.handed && !s_ifs_density)
+        {
+            // hand the hits over if there's a cleared buffer to go on with
+            std::lock_guard<std::mutex> lock(s_ifs_lock);
+            if (!s_ifs_empty.empty())
+            {
+                s_ifs_full.push_back(std::move(walk.hits));
+                walk.hits = std::move(s_ifs_empty.back());
+                s_ifs_empty.pop_back();
+                walk.handed = request;
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(s_ifs_lock);
+    s_ifs_full.push_back(std::move(walk.hits));
+    return true;
+}
+
+// put the hits handed over on the screen
+static void ifs_drain()
+{
+    std::vector<std::vector<BYTE>> full;
+    {
+        std::lock_guard<std::mutex> lock(s_ifs_lock);
+        full.swap(s_ifs_full);
+    }
+    for (std::vector<BYTE> &hits : full)
+    {
+        std::size_t const size = hits.size();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (hits[i] == 0)
+            {
+                continue;
+            }
+            int const col = (int) (i % g_logical_screen_x_dots);
+            int const row = (int) (i / g_logical_screen_x_dots);
+            if (s_ifs_color_method)
+            {
+                (*g_plot)(col, row, hits[i]);
+            }
+            else
+            {
+                // color is count of hits on this pixel
+                int const old = getcolor(col, row);
+                int const color = std::min(old + hits[i], g_colors - 1);
+                if (color > old)
+                {
+                    (*g_plot)(col, row, color);
+                }
+            }
+            hits[i] = 0;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(s_ifs_lock);
+        for (std::vector<BYTE> &hits : full)
+        {
+            s_ifs_empty.push_back(std::move(hits));
+        }
+    }
+    if (++s_ifs_drains % 10 == 0)
+    {
+        ++s_ifs_request;            // half a second or so since the last
+    }
+    if (s_ifs_density)
+    {
+        density_update();
+    }
+}
+
+// Play the chaos game of the IFS on the calc threads.  It is played in
+// floating point whatever the float= setting.  Returns 0 when done, -1 if
+// interrupted, or 1 if the calc threads can't be used.
+static int ifs_threads(bool three_d)
+{
+    long const max_count = g_max_iterations > 0x1fffffL ? 0x7fffffffL : g_max_iterations*1024L;
+    unsigned const num_threads = calc_pool_threads();
+    if (num_threads < 2
+        || calc_pool_worker()
+        || realtime
+        || (g_orbit_save_flags & osf_raw)
+        || max_count/num_threads < (1L << 16))
+    {
+        return 1;
+    }
+
+    s_ifs_3d = three_d;
+    s_ifs_color_method = (int)g_params[0];
+    int const num_params = three_d ? NUM_IFS_3D_PARAMS : NUM_IFS_PARAMS;
+    s_ifs_odds.clear();
+    double sum = 0.0;
+    for (int k = 0; k < g_num_affine_transforms; ++k)
+    {
+        sum += g_ifs_definition[k*num_params + num_params - 1];
+        s_ifs_odds.push_back(sum);
+    }
+
+    // settle on the attractor, and for 3D find the view, on this thread
+    ifs_walk start{};
+    setup_convert_to_screen(&start.inf.cvt);
+    long const warm_up = three_d ? waste : 100;
+    for (g_ctx.color_iter = 1; g_ctx.color_iter <= warm_up; ++g_ctx.color_iter)
+    {
+        ifs_step(start);
+        if (three_d)
+        {
+            float3dviewtransf(&start.inf);
+        }
+    }
+    g_max_count = max_count;
+
+    s_ifs_density = s_ifs_color_method == 0 && (!three_d || g_glasses_type == 0) && density_start();
+    std::size_t const screen_size = s_ifs_density ? 0 : (std::size_t) g_logical_screen_x_dots*g_logical_screen_y_dots;
+    try
+    {
+        s_ifs_walks.assign(num_threads, start);
+        for (unsigned i = 0; i < num_threads; ++i)
+        {
+            ifs_walk &walk = s_ifs_walks[i];
+            walk.key = (i + 1)*0xd1b54a32d192ed03ULL;
+            walk.counter = 0;
+            walk.points = (max_count - warm_up)/num_threads + (i < (max_count - warm_up) % num_threads ? 1 : 0);
+            walk.handed = 0;
+            walk.hits.assign(screen_size, 0);
+            s_ifs_empty.emplace_back(screen_size, 0);
+        }
+    }
+    catch (std::bad_alloc const &)
+    {
+        s_ifs_walks.clear();
+        s_ifs_empty.clear();
+        return 1;
+    }
+
+    s_ifs_request = 0;
+    s_ifs_drains = 0;
+    int const status = calc_pool_tasks([num_threads]()
+    {
+        for (unsigned i = 1; i < num_threads; ++i)
+        {
+            calc_pool_spawn([i]()
+            {
+                return ifs_walk_task(s_ifs_walks[i]);
+            });
+        }
+        return ifs_walk_task(s_ifs_walks[0]);
+    }, ifs_drain);
+    if (status != 1)
+    {
+        for (ifs_walk &walk : s_ifs_walks)
+        {
+            s_ifs_full.push_back(std::move(walk.hits)); // of any walks cut short
+        }
+        ifs_drain();
+    }
+    std::vector<ifs_walk>().swap(s_ifs_walks);
+    std::vector<std::vector<BYTE>>().swap(s_ifs_full);
+    std::vector<std::vector<BYTE>>().swap(s_ifs_empty);
+    return status;
+}
+
+// The modified inverse iteration method of the inverse Julia types on the
+// calc threads, in floating point whatever the float= setting.  Each task
+// works through a queue of points of its own, handing the older half of it
+// to a new task whenever it grows, for idle threads to steal.  Breadth first
+// takes the points from the front of the queue and depth first from the
+// back, so between them the threads work through the points in much the
+// same order as one thread would.  The hits on each pixel are counted in a
+// shared image, and as with one thread a point's two preimages are only
+// followed if its pixel has had fewer than the most hits allowed.  The count
+// is taken with a compare and exchange, so however many threads land on a
+// pixel at once, no more than that many carry on from it.  The pixels
+// counted are handed back to this thread every so often to go on the
+// screen.  Unlike the queue of one thread, which has to drop points once
+// it's full, the queues grow as they need to, and don't use the disk video
+// memory, so this also works in disk video modes.
+
+namespace
+{
+struct miim_point
+{
+    double x;
+    double y;
+};
+
+std::size_t const MIIM_SPLIT = 256;             // queue size at which half is handed off
+std::size_t const MIIM_PLOTS = 4096;            // pixels counted between hand overs
+
+std::vector<std::atomic<BYTE>> s_miim_hits;     // empty unless drawing on the calc threads
+std::vector<std::vector<std::size_t>> s_miim_full;  // pixels counted, to go on the screen
+std::mutex s_miim_lock;
+std::atomic<std::uint64_t> s_miim_keys(0);      // random number streams handed out
+bool s_miim_breadth_first = false;
+double s_miim_first = 1.0;                      // sign of the preimage queued first
+}
+
+static void miim_hand_over(std::vector<std::size_t> &plots)
+{
+    std::lock_guard<std::mutex> lock(s_miim_lock);
+    s_miim_full.push_back(std::move(plots));
+    plots.clear();
+}
+
+static bool miim_task(std::deque<miim_point> &queue)
+{
+    std::uint64_t const key = ++s_miim_keys*0xd1b54a32d192ed03ULL;
+    std::uint64_t counter = 0;
+    std::vector<std::size_t> plots;
+    plots.reserve(MIIM_PLOTS);
+    unsigned steps = 0;
+    while (!queue.empty())
+    {
+        if ((++steps & 0xfff) == 0 && calc_pool_interrupted())
+        {
+            return false;
+        }
+        miim_point z;
+        if (s_miim_breadth_first)
+        {
+            z = queue.front();
+            queue.pop_front();
+        }
+        else
+        {
+            z = queue.back();
+            queue.pop_back();
+        }
+        int const col = (int)(cvt.a*z.x + cvt.b*z.y + cvt.e);
+        int const row = (int)(cvt.c*z.x + cvt.d*z.y + cvt.f);
+        DComplex const root = ComplexSqrtFloat(z.x - Cx, z.y - Cy);
+        if (col < 1 || col >= g_logical_screen_x_dots || row < 1 || row >= g_logical_screen_y_dots)
+        {
+            // off the screen: follow one preimage, picked at random
+            double const sign = ifs_random(key, counter++) < 0.5 ? 1.0 : -1.0;
+            queue.push_back(miim_point{sign*root.x, sign*root.y});
+            continue;
+        }
+        std::size_t const pixel = (std::size_t) row*g_logical_screen_x_dots + col;
+        std::atomic<BYTE> &hits = s_miim_hits[pixel];
+        BYTE count = hits.load(std::memory_order_relaxed);
+        while (count < mxhits
+            && !hits.compare_exchange_weak(count, (BYTE)(count + 1), std::memory_order_relaxed))
+        {
+        }
+        if (count >= mxhits)
+        {
+            continue;
+        }
+        queue.push_back(miim_point{s_miim_first*root.x, s_miim_first*root.y});
+        queue.push_back(miim_point{-s_miim_first*root.x, -s_miim_first*root.y});
+        plots.push_back(pixel);
+        if (plots.size() >= MIIM_PLOTS)
+        {
+            miim_hand_over(plots);
+        }
+        if (queue.size() >= 2*MIIM_SPLIT)
+        {
+            std::shared_ptr<std::deque<miim_point>> const half =
+                std::make_shared<std::deque<miim_point>>(queue.begin(), queue.begin() + MIIM_SPLIT);
+            queue.erase(queue.begin(), queue.begin() + MIIM_SPLIT);
+            calc_pool_spawn([half]()
+            {
+                return miim_task(*half);
+            });
+        }
+    }
+    miim_hand_over(plots);
+    return true;
+}
+
+// put the pixels counted on the screen, in the color of their count
+static void miim_drain()
+{
+    std::vector<std::vector<std::size_t>> full;
+    {
+        std::lock_guard<std::mutex> lock(s_miim_lock);
+        full.swap(s_miim_full);
+    }
+    for (std::vector<std::size_t> const &plots : full)
+    {
+        for (std::size_t const pixel : plots)
+        {
+            g_put_color((int) (pixel % g_logical_screen_x_dots), (int) (pixel / g_logical_screen_x_dots),
+                s_miim_hits[pixel].load(std::memory_order_relaxed));
+        }
+    }
+}
+
+// Called by the setup of the inverse Julia types in place of Init_Queue().
+// Returns true, with the hit counts ready, if the image is to be drawn on
+// the calc threads.
+static bool miim_threads_setup()
+{
+    std::vector<std::atomic<BYTE>>().swap(s_miim_hits);
+    if (calc_pool_threads() < 2
+        || calc_pool_worker()
+        || (g_major_method != Major::breadth_first && g_major_method != Major::depth_first))
+    {
+        return false;
+    }
+    try
+    {
+        std::vector<std::atomic<BYTE>>((std::size_t) g_logical_screen_x_dots*g_logical_screen_y_dots).swap(s_miim_hits);
+    }
+    catch (std::bad_alloc const &)
+    {
+        return false;
+    }
+    return true;
+}
+
+// Draw the inverse Julia set on the calc threads, starting from the two
+// fixed points.  Returns 0 when done, -1 if interrupted or no calc thread
+// could be started, or 1 if the setup didn't get the calc threads ready.
+static int miim_threads()
+{
+    if (s_miim_hits.empty()
+        || (g_major_method != Major::breadth_first && g_major_method != Major::depth_first))
+    {
+        return 1;
+    }
+    Cx = g_params[0];
+    Cy = g_params[1];
+    s_miim_breadth_first = g_major_method == Major::breadth_first;
+    s_miim_first = !s_miim_breadth_first && g_inverse_julia_minor_method == Minor::right_first ? -1.0 : 1.0;
+    DComplex const root = ComplexSqrtFloat(1 - 4*Cx, -4*Cy);
+    std::shared_ptr<std::deque<miim_point>> const start = std::make_shared<std::deque<miim_point>>();
+    start->push_back(miim_point{(1 + s_miim_first*root.x)/2, s_miim_first*root.y/2});
+    start->push_back(miim_point{(1 - s_miim_first*root.x)/2, -s_miim_first*root.y/2});
+    s_miim_keys = 0;
+    int const status = calc_pool_tasks([start]()
+    {
+        return miim_task(*start);
+    }, miim_drain);
+    std::vector<std::atomic<BYTE>>().swap(s_miim_hits);
+    std::vector<std::vector<std::size_t>>().swap(s_miim_full);
+    return status == 0 ? 0 : -1;
+}
+
+// Many trajectories of a 3D orbit type at once, for trajectories=.  The
+// trajectories are kept side by side, one array per coordinate, and stepped
+// together ORBIT_LANES at a time, as vectors where the CPU has AVX2.  The
+// view transform and the projection onto the screen are done the same way
+// straight after each step, so only the plotting is left point by point.
+// The flows can be stepped by fourth order Runge-Kutta instead of Euler's
+// method; the maps just take their step.
+
+#define ORBIT_LANES 4
+
+namespace
+{
+#if defined(CALC_VECTOR_LANES)
+typedef double orbit_vector __attribute__((vector_size(ORBIT_LANES*sizeof(double))));
+#endif
+
+// the view transform of float3dviewtransf() and the screen conversion,
+// ready to use on many points
+struct orbit_view
+{
+    double m[4][3];             // first three columns of the view matrix
+    bool perspective;
+    double view[3];             // g_view, the viewer's position
+    affine cvt;                 // with g_xx_adjust and g_yy_adjust added
+};
+
+typedef void (*orbit_steps)(double *x, double *y, double *z, double *col, double *row, int count,
+    orbit_view const &view);
+
+struct orbit_batch_kernel
+{
+    int (*orbitcalc)(double *, double *, double *); // the orbit routine stepped
+    orbit_steps steps[2][2];    // [rk4][vector]
+};
+
+std::vector<double> s_batch_x;
+std::vector<double> s_batch_y;
+std::vector<double> s_batch_z;
+std::vector<double> s_batch_col;
+std::vector<double> s_batch_row;
+}
+
+// The vector arithmetic is only ever compiled for AVX2, once inlined into
+// flow_steps_vector(), so vectors are passed by reference to keep the
+// calling convention out of it.
+#if defined(__GNUC__)
+#define ORBIT_INLINE inline __attribute__((always_inline))
+#else
+#define ORBIT_INLINE inline
+#endif
+
+static ORBIT_INLINE void orbit_sqrt(double const &x, double &root)
+{
+    root = std::sqrt(x);
+}
+
+#if defined(CALC_VECTOR_LANES)
+LANE_CODE static void orbit_sqrt(orbit_vector const &x, orbit_vector &root)
+{
+    root = (orbit_vector) _mm256_sqrt_pd((__m256d) x);
+}
+#endif
+
+// The change over one Euler step of each flow, worked out as its orbit
+// routine does.
+
+struct lorenz_change
+{
+    template <typename V>
+    static ORBIT_INLINE void apply(V const &x, V const &y, V const &z, V &sx, V &sy, V &sz)
+    {
+        V const x_dt = x*dt;
+        V const y_dt = y*dt;
+        sx = -adt*x + adt*y;
+        sy = bdt*x - y_dt - z*x_dt;
+        sz = -cdt*z + x*y_dt;
+    }
+};
+
+struct lorenz1_change
+{
+    template <typename V>
+    static ORBIT_INLINE void apply(V const &x, V const &y, V const &z, V &sx, V &sy, V &sz)
+    {
+        V const x_dt = x*dt;
+        V const y_dt = y*dt;
+        V const z_dt = z*dt;
+        V norm;
+        orbit_sqrt(x*x + y*y, norm);
+        sx = (-adt-dt)*x + (adt-bdt)*y + (dt-adt)*norm + y_dt*z;
+        sy = (bdt-adt)*x - (adt+dt)*y + (bdt+adt)*norm - x_dt*z - norm*z_dt;
+        sz = (y_dt/2) - cdt*z;
+    }
+};
+
+struct lorenz3_change
+{
+    template <typename V>
+    static ORBIT_INLINE void apply(V const &x, V const &y, V const &z, V &sx, V &sy, V &sz)
+    {
+        V const x_dt = x*dt;
+        V const y_dt = y*dt;
+        V const z_dt = z*dt;
+        V norm;
+        orbit_sqrt(x*x + y*y, norm);
+        sx = (-(adt+dt)*x + (adt-bdt+z_dt)*y) / 3
+            + ((dt-adt)*(x*x-y*y) + 2*(bdt+adt-z_dt)*x*y)/(3*norm);
+        sy = ((bdt-adt-z_dt)*x - (adt+dt)*y) / 3
+            + (2*(adt-dt)*x*y + (bdt+adt-z_dt)*(x*x-y*y))/(3*norm);
+        sz = (3*x_dt*x*y-y_dt*y*y)/2 - cdt*z;
+    }
+};
+
+struct lorenz4_change
+{
+    template <typename V>
+    static ORBIT_INLINE void apply(V const &x, V const &y, V const &z, V &sx, V &sy, V &sz)
+    {
+        V const x_dt = x*dt;
+        V const z_dt = z*dt;
+        sx = (-adt*x*x*x + (2*adt+bdt-z_dt)*x*x*y + (adt-2*dt)*x*y*y + (z_dt-bdt)*y*y*y)
+            / (2 * (x*x+y*y));
+        sy = ((bdt-z_dt)*x*x*x + (adt-2*dt)*x*x*y + (-2*adt-bdt+z_dt)*x*y*y - adt*y*y*y)
+            / (2 * (x*x+y*y));
+        sz = (2*x_dt*x*x*y - 2*x_dt*y*y*y - cdt*z);
+    }
+};
+
+struct rossler_change
+{
+    template <typename V>
+    static ORBIT_INLINE void apply(V const &x, V const &y, V const &z, V &sx, V &sy, V &sz)
+    {
+        V const x_dt = x*dt;
+        V const y_dt = y*dt;
+        sx = -y_dt - z*dt;
+        sy = x_dt + y*adt;
+        sz = bdt + z*x_dt - z*cdt;
+    }
+};
+
+// one step of a flow, by Euler's method or by Runge-Kutta
+template <typename Change, bool RK4, typename V>
+static ORBIT_INLINE void flow_step(V &x, V &y, V &z)
+{
+    V sx1, sy1, sz1;
+    Change::apply(x, y, z, sx1, sy1, sz1);
+    if (!RK4)
+    {
+        x += sx1;
+        y += sy1;
+        z += sz1;
+        return;
+    }
+    V sx2, sy2, sz2;
+    Change::apply(V(x + sx1*0.5), V(y + sy1*0.5), V(z + sz1*0.5), sx2, sy2, sz2);
+    V sx3, sy3, sz3;
+    Change::apply(V(x + sx2*0.5), V(y + sy2*0.5), V(z + sz2*0.5), sx3, sy3, sz3);
+    V sx4, sy4, sz4;
+    Change::apply(V(x + sx3), V(y + sy3), V(z + sz3), sx4, sy4, sz4);
+    x += (sx1 + 2*(sx2 + sx3) + sx4)*(1.0/6);
+    y += (sy1 + 2*(sy2 + sy3) + sy4)*(1.0/6);
+    z += (sz1 + 2*(sz2 + sz3) + sz4)*(1.0/6);
+}
+
+// Where a point lands on the screen, as float3dviewtransf() and the plot
+// would have it.  Points behind the viewer come out as NaN.
+template <typename V>
+static ORBIT_INLINE void orbit_project(orbit_view const &view, V const &x, V const &y, V const &z, V &col, V &row)
+{
+    V vx = x*view.m[0][0] + y*view.m[1][0] + z*view.m[2][0] + view.m[3][0];
+    V vy = x*view.m[0][1] + y*view.m[1][1] + z*view.m[2][1] + view.m[3][1];
+    if (view.perspective)
+    {
+        V const vz = x*view.m[0][2] + y*view.m[1][2] + z*view.m[2][2] + view.m[3][2];
+        V const denom = view.view[2] - vz;
+        V const behind = vz*0.0 + std::numeric_limits<double>::quiet_NaN();
+        vx = denom < 0.0 ? (vx*view.view[2] - view.view[0]*vz)/denom : behind;
+        vy = denom < 0.0 ? (vy*view.view[2] - view.view[1]*vz)/denom : behind;
+    }
+    col = view.cvt.a*vx + view.cvt.b*vy + view.cvt.e;
+    row = view.cvt.c*vx + view.cvt.d*vy + view.cvt.f;
+}
+
+template <typename Change, bool RK4>
+static void flow_steps(double *x, double *y, double *z, double *col, double *row, int count,
+    orbit_view const &view)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        flow_step<Change, RK4>(x[i], y[i], z[i]);
+        orbit_project(view, x[i], y[i], z[i], col[i], row[i]);
+    }
+}
+
+#if defined(CALC_VECTOR_LANES)
+template <typename Change, bool RK4>
+LANE_CODE static void flow_steps_vector(double *x, double *y, double *z, double *col, double *row,
+    int count, orbit_view const &view)
+{
+    for (int i = 0; i < count; i += ORBIT_LANES)
+    {
+        orbit_vector vx, vy, vz, vcol, vrow;
+        std::memcpy(&vx, &x[i], sizeof(vx));
+        std::memcpy(&vy, &y[i], sizeof(vy));
+        std::memcpy(&vz, &z[i], sizeof(vz));
+        flow_step<Change, RK4>(vx, vy, vz);
+        orbit_project(view, vx, vy, vz, vcol, vrow);
+        std::memcpy(&x[i], &vx, sizeof(vx));
+        std::memcpy(&y[i], &vy, sizeof(vy));
+        std::memcpy(&z[i], &vz, sizeof(vz));
+        std::memcpy(&col[i], &vcol, sizeof(vcol));
+        std::memcpy(&row[i], &vrow, sizeof(vrow));
+    }
+}
+#define FLOW_STEPS(change_) \
+    { { flow_steps<change_, false>, flow_steps_vector<change_, false> }, \
+      { flow_steps<change_, true>, flow_steps_vector<change_, true> } }
+#else
+#define FLOW_STEPS(change_) \
+    { { flow_steps<change_, false>, flow_steps<change_, false> }, \
+      { flow_steps<change_, true>, flow_steps<change_, true> } }
+#endif
+
+// the pickover map, which has no vector sin and cos to work with
+static void pickover_steps(double *x, double *y, double *z, double *col, double *row, int count,
+    orbit_view const &view)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        pickoverfloatorbit(&x[i], &y[i], &z[i]);
+        orbit_project(view, x[i], y[i], z[i], col[i], row[i]);
+    }
+}
+
+static orbit_batch_kernel const s_orbit_batch_kernels[] =
+{
+    { lorenz3dfloatorbit, FLOW_STEPS(lorenz_change) },
+    { lorenz3d1floatorbit, FLOW_STEPS(lorenz1_change) },
+    { lorenz3d3floatorbit, FLOW_STEPS(lorenz3_change) },
+    { lorenz3d4floatorbit, FLOW_STEPS(lorenz4_change) },
+    { rosslerfloatorbit, FLOW_STEPS(rossler_change) },
+    { pickoverfloatorbit, { { pickover_steps, pickover_steps }, { pickover_steps, pickover_steps } } },
+};
+
+// Follow trajectories=nnn trajectories of the orbit, started all over the
+// box the orbit settles into, splitting the points between them.  Each is
+// drawn in a color of its own.  Returns 0 when done, -1 if interrupted, or
+// 1 if the orbit type or the settings need orbit3dfloatcalc() itself.
+static int orbit3d_batch()
+{
+    orbit_batch_kernel const *kernel = nullptr;
+    for (orbit_batch_kernel const &k : s_orbit_batch_kernels)
+    {
+        if ((int (*)()) k.orbitcalc == g_cur_fractal_specific->orbitcalc)
+        {
+            kernel = &k;
+        }
+    }
+    if ((g_orbit_trajectories < 2 && !g_orbit_rk4)
+        || kernel == nullptr
+        || realtime
+        || (g_orbit_save_flags & osf_raw)
+        || (g_sound_flag & SOUNDFLAG_ORBITMASK) > SOUNDFLAG_BEEP)
+    {
+        return 1;
+    }
+    bool vector = false;
+#if defined(CALC_VECTOR_LANES)
+    vector = g_debug_flag != debug_flags::prevent_simd_math && __builtin_cpu_supports("avx2");
+#endif
+    orbit_steps const steps = kernel->steps[g_orbit_rk4 ? 1 : 0][vector ? 1 : 0];
+
+    if (driver_diskp())                  // this would KILL a disk drive!
+    {
+        notdiskmsg();
+    }
+    long const max_count = g_max_iterations > 0x1fffffL || g_max_count ? 0x7fffffffL : g_max_iterations*1024L;
+    g_max_count = max_count;
+
+    // settle on the attractor, and find the view, on one trajectory
+    float3dvtinf inf;
+    setup_convert_to_screen(&inf.cvt);
+    inf.orbit[0] = initorbitfp[0];
+    inf.orbit[1] = initorbitfp[1];
+    inf.orbit[2] = initorbitfp[2];
+    double low[3];
+    double high[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        low[i] = inf.orbit[i];
+        high[i] = inf.orbit[i];
+    }
+    for (g_ctx.color_iter = 1; g_ctx.color_iter <= waste; ++g_ctx.color_iter)
+    {
+        FORBIT(&inf.orbit[0], &inf.orbit[1], &inf.orbit[2]);
+        float3dviewtransf(&inf);
+        for (int i = 0; i < 3; ++i)
+        {
+            low[i] = std::min(low[i], inf.orbit[i]);
+            high[i] = std::max(high[i], inf.orbit[i]);
+        }
+    }
+    orbit_view view;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            view.m[i][j] = inf.doublemat[i][j];
+        }
+    }
+    view.perspective = ZVIEWER != 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        view.view[i] = g_view[i];
+    }
+    view.cvt = inf.cvt;
+    view.cvt.e += g_xx_adjust;
+    view.cvt.f += g_yy_adjust;
+
+    // the first trajectory carries on from there, the others start at
+    // random in the box it went through
+    int const trajectories = std::max(g_orbit_trajectories, 1);
+    std::size_t const lanes = (trajectories + ORBIT_LANES - 1)/ORBIT_LANES*ORBIT_LANES;
+    try
+    {
+        s_batch_x.assign(lanes, 0.0);
+        s_batch_y.assign(lanes, 0.0);
+        s_batch_z.assign(lanes, 0.0);
+        s_batch_col.assign(lanes, 0.0);
+        s_batch_row.assign(lanes, 0.0);
+    }
+    catch (std::bad_alloc const &)
+    {
+        std::vector<double>().swap(s_batch_x);
+        std::vector<double>().swap(s_batch_y);
+        std::vector<double>().swap(s_batch_z);
+        std::vector<double>().swap(s_batch_col);
+        std::vector<double>().swap(s_batch_row);
+        return 1;
+    }
+    double *const start[3] = { s_batch_x.data(), s_batch_y.data(), s_batch_z.data() };
+    for (std::size_t k = 0; k < lanes; ++k)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            start[i][k] = k == 0 ? inf.orbit[i]
+                : low[i] + (high[i] - low[i])*ifs_random((i + 1)*0x2545f4914f6cdd1dULL, k);
+        }
+    }
+
+    bool const density = g_glasses_type == 0 && density_start();
+    long const points = std::max((max_count - waste)/trajectories, 1L);
+    long const settle = trajectories > 1 ? waste : 0;   // for the others to reach the attractor
+    long const steps_per_check = std::max((1L << 16)/trajectories, 1L);
+    int ret = 0;
+    for (long step = 0; step < settle + points; ++step)
+    {
+        if (step % steps_per_check == 0 && driver_key_pressed())
+        {
+            driver_mute();
+            ret = -1;
+            break;
+        }
+        steps(s_batch_x.data(), s_batch_y.data(), s_batch_z.data(), s_batch_col.data(), s_batch_row.data(),
+            (int) lanes, view);
+        if (step < settle)
+        {
+            continue;
+        }
+        for (int k = 0; k < trajectories; ++k)
+        {
+            double const col = s_batch_col[k];
+            double const row = s_batch_row[k];
+            if (col > -1.0 && col < g_logical_screen_x_dots && row > -1.0 && row < g_logical_screen_y_dots)
+            {
+                if (density)
+                {
+                    density_hit((int) col, (int) row);
+                }
+                else
+                {
+                    (*g_plot)((int) col, (int) row, 1 + k % std::max(g_colors - 1, 1));
+                }
+            }
+            else if (std::fabs(col) + std::fabs(row) > BAD_PIXEL)
+            {
+                // gone off to infinity: drop it
+                s_batch_x[k] = std::numeric_limits<double>::quiet_NaN();
+                s_batch_y[k] = s_batch_x[k];
+                s_batch_z[k] = s_batch_x[k];
+            }
+        }
+    }
+    g_ctx.color_iter = max_count;
+    std::vector<double>().swap(s_batch_x);
+    std::vector<double>().swap(s_batch_y);
+    std::vector<double>().swap(s_batch_z);
+    std::vector<double>().swap(s_batch_col);
+    std::vector<double>().swap(s_batch_row);
+    return ret;
+}
+
 static void setupmatrix(MATRIX doublemat)
 {
     // build transformation matrix
@@ -2921,7 +3915,7 @@ static int ifs3d()
 
 static bool long3dviewtransf(long3dvtinf *inf)
 {
-    if (g_color_iter == 1)  // initialize on first call
+    if (g_ctx.color_iter == 1)  // initialize on first call
     {
         for (int i = 0; i < 3; i++)
         {
@@ -2954,7 +3948,7 @@ static bool long3dviewtransf(long3dvtinf *inf)
         longvmult(inf->orbit, inf->longmat1, inf->viewvect1, g_bit_shift);
     }
 
-    if (g_color_iter <= waste) // waste this many points to find minz and maxz
+    if (g_ctx.color_iter <= waste) // waste this many points to find minz and maxz
     {
         // find minz and maxz
         for (int i = 0; i < 3; i++)
@@ -2970,7 +3964,7 @@ static bool long3dviewtransf(long3dvtinf *inf)
             }
         }
 
-        if (g_color_iter == waste) // time to work it out
+        if (g_ctx.color_iter == waste) // time to work it out
         {
             inf->iview[1] = 0L;
             inf->iview[0] = inf->iview[1]; // center viewer on origin
@@ -3111,7 +4105,7 @@ static bool long3dviewtransf(long3dvtinf *inf)
 
 static bool float3dviewtransf(float3dvtinf *inf)
 {
-    if (g_color_iter == 1)  // initialize on first call
+    if (g_ctx.color_iter == 1)  // initialize on first call
     {
         for (int i = 0; i < 3; i++)
         {
@@ -3132,7 +4126,7 @@ static bool float3dviewtransf(float3dvtinf *inf)
         vmult(inf->orbit, inf->doublemat1, inf->viewvect1);
     }
 
-    if (g_color_iter <= waste) // waste this many points to find minz and maxz
+    if (g_ctx.color_iter <= waste) // waste this many points to find minz and maxz
     {
         // find minz and maxz
         for (int i = 0; i < 3; i++)
@@ -3147,7 +4141,7 @@ static bool float3dviewtransf(float3dvtinf *inf)
                 inf->maxvals[i] = tmp;
             }
         }
-        if (g_color_iter == waste) // time to work it out
+        if (g_ctx.color_iter == waste) // time to work it out
         {
             g_view[1] = 0;
             g_view[0] = g_view[1]; // center on origin
@@ -3229,17 +4223,6 @@ static bool float3dviewtransf(float3dvtinf *inf)
     return true;
 }
 
-static std::FILE *open_orbitsave()
-{
-    std::FILE *fp;
-    if ((g_orbit_save_flags & osf_raw) && (fp = std::fopen("orbits.raw", "w")) != nullptr)
-    {
-        std::fprintf(fp, "pointlist x y z color\n");
-        return fp;
-    }
-    return nullptr;
-}
-
 // Plot a histogram by incrementing the pixel each time it it touched
 static void plothist(int x, int y, int color)
 {
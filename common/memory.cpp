@@ -13,6 +13,11 @@
 #include <cstdio>
 #include <cstring>
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 // Memory allocation routines.
 
 #define FAR_RESERVE   8192L    // amount of far mem we will leave avail.
@@ -45,6 +50,7 @@ struct disk
     stored_at_values stored_at;
     long size;
     std::FILE *file;
+    BYTE *mapped;                    // set by MemoryMap
 };
 
 union mem
@@ -72,6 +78,7 @@ void InitMemory();
 void ExitCheck();
 U16 MemoryAlloc(U16 size, long count, int stored_at);
 void MemoryRelease(U16 handle);
+BYTE *MemoryMap(U16 handle);
 bool CopyFromMemoryToHandle(BYTE *buffer, U16 size, long count, long offset, U16 handle);
 bool CopyFromHandleToMemory(BYTE *buffer, U16 size, long count, long offset, U16 handle);
 bool SetMemory(int value, U16 size, long count, long offset, U16 handle);
@@ -363,6 +370,7 @@ U16 MemoryAlloc(U16 size, long count, int stored_at)
         // cppcheck-suppress useClosedFile
         rewind(handletable[handle].Disk.file);
         handletable[handle].Disk.size = toallocate;
+        handletable[handle].Disk.mapped = nullptr;
         handletable[handle].Disk.stored_at = DISK;
         use_this_type = DISK;
         break;
@@ -406,6 +414,13 @@ void MemoryRelease(U16 handle)
         memfile[9] = (char)(handle % 10 + (int)'0');
         memfile[8] = (char)((handle % 100) / 10 + (int)'0');
         memfile[7] = (char)((handle % 1000) / 100 + (int)'0');
+#if !defined(_WIN32)
+        if (handletable[handle].Disk.mapped != nullptr)
+        {
+            munmap(handletable[handle].Disk.mapped, handletable[handle].Disk.size);
+            handletable[handle].Disk.mapped = nullptr;
+        }
+#endif
         std::fclose(handletable[handle].Disk.file);
         dir_remove(g_temp_dir.c_str(), memfile);
         handletable[handle].Disk.file = nullptr;
@@ -416,6 +431,47 @@ void MemoryRelease(U16 handle)
     } // end of switch
 }
 
+// Returns a pointer to all of the memory of handle, or nullptr if it can't
+// be had.  Disk memory is mapped, the file grown to its full size first, so
+// that the system pages it in and out.  Once mapped, the memory must only
+// be used through the pointer; MemoryRelease unmaps it.
+BYTE *MemoryMap(U16 handle)
+{
+    switch (handletable[handle].Nowhere.stored_at)
+    {
+    case MEMORY: // MemoryMap
+        return handletable[handle].Linearmem.memory;
+
+    case DISK: // MemoryMap
+#if !defined(_WIN32)
+        if (handletable[handle].Disk.mapped == nullptr)
+        {
+            std::FILE *file = handletable[handle].Disk.file;
+            long const size = handletable[handle].Disk.size;
+            int const fd = fileno(file);
+            std::fflush(file);
+            if (lseek(fd, 0, SEEK_END) < size && ftruncate(fd, size) != 0)
+            {
+                WhichDiskError(2);
+                return nullptr;
+            }
+            void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            handletable[handle].Disk.mapped = (BYTE *) mapped;
+        }
+        return handletable[handle].Disk.mapped;
+#else
+        return nullptr;
+#endif
+
+    default:
+        return nullptr;
+    }
+}
+
 // buffer is a pointer to local memory
 // Always start moving from the beginning of buffer
 // offset is the number of units from the start of the allocated "Memory"
@@ -70,8 +70,8 @@ int test()
             for (g_col = 0; g_col <= g_i_x_stop; g_col++)       // look at each point on screen
             {
                 int color;
-                g_init.x = g_dx_pixel();
-                g_init.y = g_dy_pixel();
+                g_ctx.init.x = g_dx_pixel();
+                g_ctx.init.y = g_dy_pixel();
                 if (driver_key_pressed())
                 {
                     testend();
@@ -79,7 +79,7 @@ int test()
                     put_resume(sizeof(g_row), &g_row, sizeof(passes), &passes, 0);
                     return -1;
                 }
-                color = testpt(g_init.x, g_init.y, g_param_z1.x, g_param_z1.y, g_max_iterations, g_inside_color);
+                color = testpt(g_ctx.init.x, g_ctx.init.y, g_ctx.param_z1.x, g_ctx.param_z1.y, g_max_iterations, g_inside_color);
                 if (color >= g_colors)
                 {
                     // avoid trouble if color is 0
@@ -408,11 +408,11 @@ int plasma()
         return -1;
     }
     iparmx = (int)(g_params[0] * 8);
-    if (g_param_z1.x <= 0.0)
+    if (g_ctx.param_z1.x <= 0.0)
     {
         iparmx = 0;
     }
-    if (g_param_z1.x >= 100)
+    if (g_ctx.param_z1.x >= 100)
     {
         iparmx = 800;
     }
@@ -1040,7 +1040,7 @@ int Bifurcation()
         }
     }
 
-    filter_cycles = (g_param_z1.x <= 0) ? DEFAULTFILTER : (long)g_param_z1.x;
+    filter_cycles = (g_ctx.param_z1.x <= 0) ? DEFAULTFILTER : (long)g_ctx.param_z1.x;
     half_time_check = false;
     if (g_periodicity_check && (unsigned long)g_max_iterations < filter_cycles)
     {
@@ -1054,7 +1054,7 @@ int Bifurcation()
     }
     else
     {
-        g_init.y = (double)(g_y_max - g_i_y_stop*g_delta_y); // bottom pixels
+        g_ctx.init.y = (double)(g_y_max - g_i_y_stop*g_delta_y); // bottom pixels
     }
 
     while (x <= g_i_x_stop)
@@ -1108,11 +1108,11 @@ static void verhulst()          // P. F. Verhulst (1845)
 
     if (g_integer_fractal)
     {
-        lPopulation = (g_param_z1.y == 0) ? (long)(SEED*g_fudge_factor) : (long)(g_param_z1.y*g_fudge_factor);
+        lPopulation = (g_ctx.param_z1.y == 0) ? (long)(SEED*g_fudge_factor) : (long)(g_ctx.param_z1.y*g_fudge_factor);
     }
     else
     {
-        Population = (g_param_z1.y == 0) ? SEED : g_param_z1.y;
+        Population = (g_ctx.param_z1.y == 0) ? SEED : g_ctx.param_z1.y;
     }
 
     g_overflow = false;
@@ -1169,7 +1169,7 @@ static void verhulst()          // P. F. Verhulst (1845)
         }
         else
         {
-            pixel_row = g_i_y_stop - (int)((Population - g_init.y) / g_delta_y);
+            pixel_row = g_i_y_stop - (int)((Population - g_ctx.init.y) / g_delta_y);
         }
 
         // if it's visible on the screen, save it in the column array
@@ -1267,10 +1267,10 @@ int BifurcLambda() // Used by lyanupov
 int BifurcVerhulstTrig()
 {
     //  Population = Pop + Rate * fn(Pop) * (1 - fn(Pop))
-    g_tmp_z.x = Population;
-    g_tmp_z.y = 0;
-    CMPLXtrig0(g_tmp_z, g_tmp_z);
-    Population += Rate * g_tmp_z.x * (1 - g_tmp_z.x);
+    g_ctx.tmp_z.x = Population;
+    g_ctx.tmp_z.y = 0;
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.tmp_z);
+    Population += Rate * g_ctx.tmp_z.x * (1 - g_ctx.tmp_z.x);
     return std::fabs(Population) > BIG;
 }
 
@@ -1289,10 +1289,10 @@ int LongBifurcVerhulstTrig()
 int BifurcStewartTrig()
 {
     //  Population = (Rate * fn(Population) * fn(Population)) - 1.0
-    g_tmp_z.x = Population;
-    g_tmp_z.y = 0;
-    CMPLXtrig0(g_tmp_z, g_tmp_z);
-    Population = (Rate * g_tmp_z.x * g_tmp_z.x) - 1.0;
+    g_ctx.tmp_z.x = Population;
+    g_ctx.tmp_z.y = 0;
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.tmp_z);
+    Population = (Rate * g_ctx.tmp_z.x * g_ctx.tmp_z.x) - 1.0;
     return std::fabs(Population) > BIG;
 }
 
@@ -1311,10 +1311,10 @@ int LongBifurcStewartTrig()
 
 int BifurcSetTrigPi()
 {
-    g_tmp_z.x = Population * PI;
-    g_tmp_z.y = 0;
-    CMPLXtrig0(g_tmp_z, g_tmp_z);
-    Population = Rate * g_tmp_z.x;
+    g_ctx.tmp_z.x = Population * PI;
+    g_ctx.tmp_z.y = 0;
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.tmp_z);
+    Population = Rate * g_ctx.tmp_z.x;
     return std::fabs(Population) > BIG;
 }
 
@@ -1331,10 +1331,10 @@ int LongBifurcSetTrigPi()
 
 int BifurcAddTrigPi()
 {
-    g_tmp_z.x = Population * PI;
-    g_tmp_z.y = 0;
-    CMPLXtrig0(g_tmp_z, g_tmp_z);
-    Population += Rate * g_tmp_z.x;
+    g_ctx.tmp_z.x = Population * PI;
+    g_ctx.tmp_z.y = 0;
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.tmp_z);
+    Population += Rate * g_ctx.tmp_z.x;
     return std::fabs(Population) > BIG;
 }
 
@@ -1352,10 +1352,10 @@ int LongBifurcAddTrigPi()
 int BifurcLambdaTrig()
 {
     //  Population = Rate * fn(Population) * (1 - fn(Population))
-    g_tmp_z.x = Population;
-    g_tmp_z.y = 0;
-    CMPLXtrig0(g_tmp_z, g_tmp_z);
-    Population = Rate * g_tmp_z.x * (1 - g_tmp_z.x);
+    g_ctx.tmp_z.x = Population;
+    g_ctx.tmp_z.y = 0;
+    CMPLXtrig0(g_ctx.tmp_z, g_ctx.tmp_z);
+    Population = Rate * g_ctx.tmp_z.x * (1 - g_ctx.tmp_z.x);
     return std::fabs(Population) > BIG;
 }
 
@@ -1380,9 +1380,9 @@ int BifurcMay()
 {
     /* X = (lambda * X) / (1 + X)^beta, from R.May as described in Pickover,
             Computers, Pattern, Chaos, and Beauty, page 153 */
-    g_tmp_z.x = 1.0 + Population;
-    g_tmp_z.x = std::pow(g_tmp_z.x, -beta); // pow in math.h included with mpmath.h
-    Population = (Rate * Population) * g_tmp_z.x;
+    g_ctx.tmp_z.x = 1.0 + Population;
+    g_ctx.tmp_z.x = std::pow(g_ctx.tmp_z.x, -beta); // pow in math.h included with mpmath.h
+    Population = (Rate * Population) * g_ctx.tmp_z.x;
     return std::fabs(Population) > BIG;
 }
 
@@ -1433,7 +1433,7 @@ int popcorn()   // subset of std engine
     g_keyboard_check_interval = g_max_keyboard_check_interval;
     g_plot = noplot;
     g_l_temp_sqr_x = 0;
-    g_temp_sqr_x = g_l_temp_sqr_x;
+    g_ctx.temp_sqr_x = g_l_temp_sqr_x;
     for (g_row = start_row; g_row <= g_i_y_stop; g_row++)
     {
         g_reset_periodicity = true;
@@ -1498,9 +1498,9 @@ int lyapunov()
     (*g_plot)(g_col, g_row, 1);
     if (g_invert != 0)
     {
-        invertz2(&g_init);
-        a = g_init.y;
-        b = g_init.x;
+        invertz2(&g_ctx.init);
+        a = g_ctx.init.y;
+        b = g_ctx.init.x;
     }
     else
     {
@@ -2319,9 +2319,9 @@ bool froth_setup()
 
     // rqlim needs to be at least sq(1+sqrt(1+sq(a))),
     // which is never bigger than 6.93..., so we'll call it 7.0
-    if (g_magnitude_limit < 7.0)
+    if (g_ctx.magnitude_limit < 7.0)
     {
-        g_magnitude_limit = 7.0;
+        g_ctx.magnitude_limit = 7.0;
     }
     set_Froth_palette();
     // make the best of the .map situation
@@ -2370,7 +2370,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
     }
 
     g_orbit_save_index = 0;
-    g_color_iter = 0;
+    g_ctx.color_iter = 0;
     if (g_show_dot >0)
     {
         (*g_plot)(g_col, g_row, g_show_dot %g_colors);
@@ -2379,34 +2379,34 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
     {
         if (g_invert != 0)
         {
-            invertz2(&g_tmp_z);
-            g_old_z = g_tmp_z;
+            invertz2(&g_ctx.tmp_z);
+            g_ctx.old_z = g_ctx.tmp_z;
         }
         else
         {
-            g_old_z.x = g_dx_pixel();
-            g_old_z.y = g_dy_pixel();
+            g_ctx.old_z.x = g_dx_pixel();
+            g_ctx.old_z.y = g_dy_pixel();
         }
 
-        g_temp_sqr_x = sqr(g_old_z.x);
-        g_temp_sqr_y = sqr(g_old_z.y);
+        g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+        g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
         while (!found_attractor
-            && (g_temp_sqr_x + g_temp_sqr_y < g_magnitude_limit)
-            && (g_color_iter < g_max_iterations))
+            && (g_ctx.temp_sqr_x + g_ctx.temp_sqr_y < g_ctx.magnitude_limit)
+            && (g_ctx.color_iter < g_max_iterations))
         {
             // simple formula: z = z^2 + conj(z*(-1+ai))
             // but it's the attractor that makes this so interesting
-            g_new_z.x = g_temp_sqr_x - g_temp_sqr_y - g_old_z.x - fsp.fl.f.a*g_old_z.y;
-            g_old_z.y += (g_old_z.x+g_old_z.x)*g_old_z.y - fsp.fl.f.a*g_old_z.x;
-            g_old_z.x = g_new_z.x;
+            g_ctx.new_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y - g_ctx.old_z.x - fsp.fl.f.a*g_ctx.old_z.y;
+            g_ctx.old_z.y += (g_ctx.old_z.x+g_ctx.old_z.x)*g_ctx.old_z.y - fsp.fl.f.a*g_ctx.old_z.x;
+            g_ctx.old_z.x = g_ctx.new_z.x;
             if (fsp.repeat_mapping)
             {
-                g_new_z.x = sqr(g_old_z.x) - sqr(g_old_z.y) - g_old_z.x - fsp.fl.f.a*g_old_z.y;
-                g_old_z.y += (g_old_z.x+g_old_z.x)*g_old_z.y - fsp.fl.f.a*g_old_z.x;
-                g_old_z.x = g_new_z.x;
+                g_ctx.new_z.x = sqr(g_ctx.old_z.x) - sqr(g_ctx.old_z.y) - g_ctx.old_z.x - fsp.fl.f.a*g_ctx.old_z.y;
+                g_ctx.old_z.y += (g_ctx.old_z.x+g_ctx.old_z.x)*g_ctx.old_z.y - fsp.fl.f.a*g_ctx.old_z.x;
+                g_ctx.old_z.x = g_ctx.new_z.x;
             }
 
-            g_color_iter++;
+            g_ctx.color_iter++;
 
             if (g_show_orbit)
             {
@@ -2414,23 +2414,23 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                 {
                     break;
                 }
-                plot_orbit(g_old_z.x, g_old_z.y, -1);
+                plot_orbit(g_ctx.old_z.x, g_ctx.old_z.y, -1);
             }
 
-            if (std::fabs(fsp.fl.f.halfa-g_old_z.y) < FROTH_CLOSE
-                && g_old_z.x >= fsp.fl.f.top_x1
-                && g_old_z.x <= fsp.fl.f.top_x2)
+            if (std::fabs(fsp.fl.f.halfa-g_ctx.old_z.y) < FROTH_CLOSE
+                && g_ctx.old_z.x >= fsp.fl.f.top_x1
+                && g_ctx.old_z.x <= fsp.fl.f.top_x2)
             {
                 if ((!fsp.repeat_mapping && fsp.attractors == 2)
                     || (fsp.repeat_mapping && fsp.attractors == 3))
                 {
                     found_attractor = 1;
                 }
-                else if (g_old_z.x <= fsp.fl.f.top_x3)
+                else if (g_ctx.old_z.x <= fsp.fl.f.top_x3)
                 {
                     found_attractor = 1;
                 }
-                else if (g_old_z.x >= fsp.fl.f.top_x4)
+                else if (g_ctx.old_z.x >= fsp.fl.f.top_x4)
                 {
                     if (!fsp.repeat_mapping)
                     {
@@ -2442,9 +2442,9 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                     }
                 }
             }
-            else if (std::fabs(FROTH_SLOPE*g_old_z.x - fsp.fl.f.a - g_old_z.y) < FROTH_CLOSE
-                && g_old_z.x <= fsp.fl.f.right_x1
-                && g_old_z.x >= fsp.fl.f.right_x2)
+            else if (std::fabs(FROTH_SLOPE*g_ctx.old_z.x - fsp.fl.f.a - g_ctx.old_z.y) < FROTH_CLOSE
+                && g_ctx.old_z.x <= fsp.fl.f.right_x1
+                && g_ctx.old_z.x >= fsp.fl.f.right_x2)
             {
                 if (!fsp.repeat_mapping && fsp.attractors == 2)
                 {
@@ -2454,7 +2454,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                 {
                     found_attractor = 3;
                 }
-                else if (g_old_z.x >= fsp.fl.f.right_x3)
+                else if (g_ctx.old_z.x >= fsp.fl.f.right_x3)
                 {
                     if (!fsp.repeat_mapping)
                     {
@@ -2465,7 +2465,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                         found_attractor = 4;
                     }
                 }
-                else if (g_old_z.x <= fsp.fl.f.right_x4)
+                else if (g_ctx.old_z.x <= fsp.fl.f.right_x4)
                 {
                     if (!fsp.repeat_mapping)
                     {
@@ -2477,9 +2477,9 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                     }
                 }
             }
-            else if (std::fabs(-FROTH_SLOPE*g_old_z.x - fsp.fl.f.a - g_old_z.y) < FROTH_CLOSE
-                && g_old_z.x <= fsp.fl.f.left_x1
-                && g_old_z.x >= fsp.fl.f.left_x2)
+            else if (std::fabs(-FROTH_SLOPE*g_ctx.old_z.x - fsp.fl.f.a - g_ctx.old_z.y) < FROTH_CLOSE
+                && g_ctx.old_z.x <= fsp.fl.f.left_x1
+                && g_ctx.old_z.x >= fsp.fl.f.left_x2)
             {
                 if (!fsp.repeat_mapping && fsp.attractors == 2)
                 {
@@ -2489,7 +2489,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                 {
                     found_attractor = 2;
                 }
-                else if (g_old_z.x >= fsp.fl.f.left_x3)
+                else if (g_ctx.old_z.x >= fsp.fl.f.left_x3)
                 {
                     if (!fsp.repeat_mapping)
                     {
@@ -2500,7 +2500,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                         found_attractor = 5;
                     }
                 }
-                else if (g_old_z.x <= fsp.fl.f.left_x4)
+                else if (g_ctx.old_z.x <= fsp.fl.f.left_x4)
                 {
                     if (!fsp.repeat_mapping)
                     {
@@ -2512,17 +2512,17 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                     }
                 }
             }
-            g_temp_sqr_x = sqr(g_old_z.x);
-            g_temp_sqr_y = sqr(g_old_z.y);
+            g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+            g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
         }
     }
     else // integer mode
     {
         if (g_invert != 0)
         {
-            invertz2(&g_tmp_z);
-            g_l_old_z.x = (long)(g_tmp_z.x * g_fudge_factor);
-            g_l_old_z.y = (long)(g_tmp_z.y * g_fudge_factor);
+            invertz2(&g_ctx.tmp_z);
+            g_l_old_z.x = (long)(g_ctx.tmp_z.x * g_fudge_factor);
+            g_l_old_z.y = (long)(g_ctx.tmp_z.y * g_fudge_factor);
         }
         else
         {
@@ -2536,7 +2536,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
         while (!found_attractor
             && (g_l_magnitude < g_l_magnitude_limit)
             && (g_l_magnitude >= 0)
-            && (g_color_iter < g_max_iterations))
+            && (g_ctx.color_iter < g_max_iterations))
         {
             // simple formula: z = z^2 + conj(z*(-1+ai))
             // but it's the attractor that makes this so interesting
@@ -2554,7 +2554,7 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
                 g_l_old_z.y += (multiply(g_l_old_z.x, g_l_old_z.y, g_bit_shift)<<1) - multiply(fsp.fl.l.a, g_l_old_z.x, g_bit_shift);
                 g_l_old_z.x = g_l_new_z.x;
             }
-            g_color_iter++;
+            g_ctx.color_iter++;
 
             if (g_show_orbit)
             {
@@ -2668,8 +2668,8 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
         scrub_orbit();
     }
 
-    g_real_color_iter = g_color_iter;
-    if ((g_keyboard_check_interval -= std::abs((int)g_real_color_iter)) <= 0)
+    g_ctx.real_color_iter = g_ctx.color_iter;
+    if ((g_keyboard_check_interval -= std::abs((int)g_ctx.real_color_iter)) <= 0)
     {
         if (check_key())
         {
@@ -2687,20 +2687,20 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
         {
             if (!fsp.altcolor)
             {
-                if (g_color_iter > fsp.shades)
+                if (g_ctx.color_iter > fsp.shades)
                 {
-                    g_color_iter = fsp.shades;
+                    g_ctx.color_iter = fsp.shades;
                 }
             }
             else
             {
-                g_color_iter = fsp.shades * g_color_iter / g_max_iterations;
+                g_ctx.color_iter = fsp.shades * g_ctx.color_iter / g_max_iterations;
             }
-            if (g_color_iter == 0)
+            if (g_ctx.color_iter == 0)
             {
-                g_color_iter = 1;
+                g_ctx.color_iter = 1;
             }
-            g_color_iter += fsp.shades * (found_attractor-1);
+            g_ctx.color_iter += fsp.shades * (found_attractor-1);
         }
         else if (g_colors >= 16)
         {
@@ -2710,56 +2710,56 @@ int calcfroth()   // per pixel 1/2/g, called with row & col set
             // Trying to make a better 16 color distribution.
             // Since their are only a few possiblities, just handle each case.
             // This is a mostly guess work here.
-            lshade = (g_color_iter<<16)/g_max_iterations;
+            lshade = (g_ctx.color_iter<<16)/g_max_iterations;
             if (fsp.attractors != 6) // either 2 or 3 attractors
             {
                 if (lshade < 2622)         // 0.04
                 {
-                    g_color_iter = 1;
+                    g_ctx.color_iter = 1;
                 }
                 else if (lshade < 10486)     // 0.16
                 {
-                    g_color_iter = 2;
+                    g_ctx.color_iter = 2;
                 }
                 else if (lshade < 23593)     // 0.36
                 {
-                    g_color_iter = 3;
+                    g_ctx.color_iter = 3;
                 }
                 else if (lshade < 41943L)     // 0.64
                 {
-                    g_color_iter = 4;
+                    g_ctx.color_iter = 4;
                 }
                 else
                 {
-                    g_color_iter = 5;
+                    g_ctx.color_iter = 5;
                 }
-                g_color_iter += 5 * (found_attractor-1);
+                g_ctx.color_iter += 5 * (found_attractor-1);
             }
             else // 6 attractors
             {
                 if (lshade < 10486)        // 0.16
                 {
-                    g_color_iter = 1;
+                    g_ctx.color_iter = 1;
                 }
                 else
                 {
-                    g_color_iter = 2;
+                    g_ctx.color_iter = 2;
                 }
-                g_color_iter += 2 * (found_attractor-1);
+                g_ctx.color_iter += 2 * (found_attractor-1);
             }
         }
         else   // use a color corresponding to the attractor
         {
-            g_color_iter = found_attractor;
+            g_ctx.color_iter = found_attractor;
         }
-        g_old_color_iter = g_color_iter;
+        g_ctx.old_color_iter = g_ctx.color_iter;
     }
     else   // outside, or inside but didn't get sucked in by attractor.
     {
-        g_color_iter = 0;
+        g_ctx.color_iter = 0;
     }
 
-    g_color = std::abs((int)(g_color_iter));
+    g_color = std::abs((int)(g_ctx.color_iter));
 
     (*g_plot)(g_col, g_row, g_color);
 
@@ -2777,10 +2777,10 @@ int froth_per_pixel()
 {
     if (!g_integer_fractal) // fp mode
     {
-        g_old_z.x = g_dx_pixel();
-        g_old_z.y = g_dy_pixel();
-        g_temp_sqr_x = sqr(g_old_z.x);
-        g_temp_sqr_y = sqr(g_old_z.y);
+        g_ctx.old_z.x = g_dx_pixel();
+        g_ctx.old_z.y = g_dy_pixel();
+        g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+        g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
     }
     else  // integer mode
     {
@@ -2796,22 +2796,22 @@ int froth_per_orbit()
 {
     if (!g_integer_fractal) // fp mode
     {
-        g_new_z.x = g_temp_sqr_x - g_temp_sqr_y - g_old_z.x - fsp.fl.f.a*g_old_z.y;
-        g_new_z.y = 2.0*g_old_z.x*g_old_z.y - fsp.fl.f.a*g_old_z.x + g_old_z.y;
+        g_ctx.new_z.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y - g_ctx.old_z.x - fsp.fl.f.a*g_ctx.old_z.y;
+        g_ctx.new_z.y = 2.0*g_ctx.old_z.x*g_ctx.old_z.y - fsp.fl.f.a*g_ctx.old_z.x + g_ctx.old_z.y;
         if (fsp.repeat_mapping)
         {
-            g_old_z = g_new_z;
-            g_new_z.x = sqr(g_old_z.x) - sqr(g_old_z.y) - g_old_z.x - fsp.fl.f.a*g_old_z.y;
-            g_new_z.y = 2.0*g_old_z.x*g_old_z.y - fsp.fl.f.a*g_old_z.x + g_old_z.y;
+            g_ctx.old_z = g_ctx.new_z;
+            g_ctx.new_z.x = sqr(g_ctx.old_z.x) - sqr(g_ctx.old_z.y) - g_ctx.old_z.x - fsp.fl.f.a*g_ctx.old_z.y;
+            g_ctx.new_z.y = 2.0*g_ctx.old_z.x*g_ctx.old_z.y - fsp.fl.f.a*g_ctx.old_z.x + g_ctx.old_z.y;
         }
 
-        g_temp_sqr_x = sqr(g_new_z.x);
-        g_temp_sqr_y = sqr(g_new_z.y);
-        if (g_temp_sqr_x + g_temp_sqr_y >= g_magnitude_limit)
+        g_ctx.temp_sqr_x = sqr(g_ctx.new_z.x);
+        g_ctx.temp_sqr_y = sqr(g_ctx.new_z.y);
+        if (g_ctx.temp_sqr_x + g_ctx.temp_sqr_y >= g_ctx.magnitude_limit)
         {
             return 1;
         }
-        g_old_z = g_new_z;
+        g_ctx.old_z = g_ctx.new_z;
     }
     else  // integer mode
     {
@@ -7,6 +7,7 @@
 #include "biginit.h"
 #include "calcfrac.h"
 #include "cmdfiles.h"
+#include "density.h"
 #include "drivers.h"
 #include "fractalp.h"
 #include "fractype.h"
@@ -1103,6 +1104,11 @@ void write_batch_parms(char const *colorinf, bool colorsonly, int maxcolor, int
             put_parm(" %s=%d", "rseed", g_random_seed);
         }
 
+        if (g_density_gamma > 0.0)
+        {
+            put_parm(" %s=%g", "density", g_density_gamma);
+        }
+
         if (g_iteration_ranges_len)
         {
             put_parm(" %s=", "ranges");
@@ -1398,6 +1404,15 @@ void write_batch_parms(char const *colorinf, bool colorsonly, int maxcolor, int
             put_parm(" %s=%d", "orbitinterval", g_orbit_interval);
         }
 
+        if (g_orbit_trajectories != 1 || g_orbit_rk4)
+        {
+            put_parm(" %s=%d", "trajectories", g_orbit_trajectories);
+            if (g_orbit_rk4)
+            {
+                put_parm("/rk4");
+            }
+        }
+
         if (g_start_show_orbit)
         {
             put_parm(" %s=%s", "showorbit", "yes");
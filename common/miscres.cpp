@@ -799,6 +799,8 @@ bool tab_display_2(char *msg)
                   g_operation_index, g_variable_index);
         write_row(row++, "   Store ptr %d Loadptr %d Max_Ops var %u Max_Args var %u LastInitOp %d",
                   g_store_index, g_load_index, g_max_function_ops, g_max_function_args, g_last_init_op);
+        write_row(row++, "   Ops %u of %u parsed, per iteration %u of %u parsed",
+                  g_last_op, g_parsed_op_count, g_loop_op_count, g_parsed_loop_op_count);
     }
     else if (g_rhombus_stack[0])
     {
@@ -820,6 +822,7 @@ bool tab_display_2(char *msg)
 #if !defined(XFRACT) && !defined(_WIN32)
               g_cur_fractal_specific->orbitcalc == fFormula ? "fast parser" :
 #endif
+              g_cur_fractal_specific->orbitcalc == dtFormula ? "threaded parser" :
               g_cur_fractal_specific->orbitcalc ==  Formula ? "slow parser" :
               g_cur_fractal_specific->orbitcalc ==  BadFormula ? "bad formula" :
               "", g_frm_uses_ismand ? 1 : 0);
@@ -1058,6 +1061,9 @@ top:
         case 6:
             driver_put_string(s_row, 2, C_GENERAL_HI, "Orbits");
             break;
+        case 7:
+            driver_put_string(s_row, 2, C_GENERAL_HI, "Mariani-Silver");
+            break;
         }
         ++s_row;
         if (g_got_status == 5)
@@ -1073,7 +1079,7 @@ top:
             std::sprintf(msg, "Working on block (y, x) [%d, %d]...[%d, %d], ",
                     g_yy_start, g_xx_start, g_yy_stop, g_xx_stop);
             driver_put_string(s_row, 2, C_GENERAL_MED, msg);
-            if (g_got_status == 2 || g_got_status == 4)  // btm or tesseral
+            if (g_got_status == 2 || g_got_status == 4 || g_got_status == 7)  // btm, tesseral or mariani-silver
             {
                 driver_put_string(-1, -1, C_GENERAL_MED, "at ");
                 std::sprintf(msg, "[%d, %d]", g_current_row, g_current_column);
@@ -1111,10 +1117,10 @@ top:
         driver_put_string(-1, -1, C_GENERAL_HI, msg);
     }
 
-    if ((g_cur_fractal_specific->flags&INFCALC) && (g_color_iter != 0))
+    if ((g_cur_fractal_specific->flags&INFCALC) && (g_ctx.color_iter != 0))
     {
         driver_put_string(s_row, -1, C_GENERAL_MED, " 1000's of points:");
-        std::sprintf(msg, " %ld of %ld", g_color_iter-2, g_max_count);
+        std::sprintf(msg, " %ld of %ld", g_ctx.color_iter-2, g_max_count);
         driver_put_string(s_row, -1, C_GENERAL_HI, msg);
     }
 
@@ -1251,10 +1257,10 @@ top:
         }
     }
     driver_put_string(s_row += 2, 2, C_GENERAL_MED, "Current (Max) Iteration: ");
-    std::sprintf(msg, "%ld (%ld)", g_color_iter, g_max_iterations);
+    std::sprintf(msg, "%ld (%ld)", g_ctx.color_iter, g_max_iterations);
     driver_put_string(-1, -1, C_GENERAL_HI, msg);
     driver_put_string(-1, -1, C_GENERAL_MED, "     Effective bailout: ");
-    std::sprintf(msg, "%f", g_magnitude_limit);
+    std::sprintf(msg, "%f", g_ctx.magnitude_limit);
     driver_put_string(-1, -1, C_GENERAL_HI, msg);
 
     if (g_fractal_type == fractal_type::PLASMA || g_fractal_type == fractal_type::ANT || g_fractal_type == fractal_type::CELLULAR)
@@ -731,27 +731,27 @@ int ComplexNewton()
     cd1.x = cdegree.x - 1.0;
     cd1.y = cdegree.y;
 
-    temp = ComplexPower(g_old_z, cd1);
-    FPUcplxmul(&temp, &g_old_z, &g_new_z);
+    temp = ComplexPower(g_ctx.old_z, cd1);
+    FPUcplxmul(&temp, &g_ctx.old_z, &g_ctx.new_z);
 
-    g_tmp_z.x = g_new_z.x - croot.x;
-    g_tmp_z.y = g_new_z.y - croot.y;
-    if ((sqr(g_tmp_z.x) + sqr(g_tmp_z.y)) < g_threshold)
+    g_ctx.tmp_z.x = g_ctx.new_z.x - croot.x;
+    g_ctx.tmp_z.y = g_ctx.new_z.y - croot.y;
+    if ((sqr(g_ctx.tmp_z.x) + sqr(g_ctx.tmp_z.y)) < g_threshold)
     {
         return 1;
     }
 
-    FPUcplxmul(&g_new_z, &cd1, &g_tmp_z);
-    g_tmp_z.x += croot.x;
-    g_tmp_z.y += croot.y;
+    FPUcplxmul(&g_ctx.new_z, &cd1, &g_ctx.tmp_z);
+    g_ctx.tmp_z.x += croot.x;
+    g_ctx.tmp_z.y += croot.y;
 
     FPUcplxmul(&temp, &cdegree, &cd1);
-    FPUcplxdiv(&g_tmp_z, &cd1, &g_old_z);
+    FPUcplxdiv(&g_ctx.tmp_z, &cd1, &g_ctx.old_z);
     if (g_overflow)
     {
         return 1;
     }
-    g_new_z = g_old_z;
+    g_ctx.new_z = g_ctx.old_z;
     return 0;
 }
 
@@ -766,51 +766,51 @@ int ComplexBasin()
     cd1.x = cdegree.x - 1.0;
     cd1.y = cdegree.y;
 
-    temp = ComplexPower(g_old_z, cd1);
-    FPUcplxmul(&temp, &g_old_z, &g_new_z);
+    temp = ComplexPower(g_ctx.old_z, cd1);
+    FPUcplxmul(&temp, &g_ctx.old_z, &g_ctx.new_z);
 
-    g_tmp_z.x = g_new_z.x - croot.x;
-    g_tmp_z.y = g_new_z.y - croot.y;
-    if ((sqr(g_tmp_z.x) + sqr(g_tmp_z.y)) < g_threshold)
+    g_ctx.tmp_z.x = g_ctx.new_z.x - croot.x;
+    g_ctx.tmp_z.y = g_ctx.new_z.y - croot.y;
+    if ((sqr(g_ctx.tmp_z.x) + sqr(g_ctx.tmp_z.y)) < g_threshold)
     {
-        if (std::fabs(g_old_z.y) < .01)
+        if (std::fabs(g_ctx.old_z.y) < .01)
         {
-            g_old_z.y = 0.0;
+            g_ctx.old_z.y = 0.0;
         }
-        FPUcplxlog(&g_old_z, &temp);
-        FPUcplxmul(&temp, &cdegree, &g_tmp_z);
-        double mod = g_tmp_z.y/TwoPi;
-        g_color_iter = (long)mod;
-        if (std::fabs(mod - g_color_iter) > 0.5)
+        FPUcplxlog(&g_ctx.old_z, &temp);
+        FPUcplxmul(&temp, &cdegree, &g_ctx.tmp_z);
+        double mod = g_ctx.tmp_z.y/TwoPi;
+        g_ctx.color_iter = (long)mod;
+        if (std::fabs(mod - g_ctx.color_iter) > 0.5)
         {
             if (mod < 0.0)
             {
-                g_color_iter--;
+                g_ctx.color_iter--;
             }
             else
             {
-                g_color_iter++;
+                g_ctx.color_iter++;
             }
         }
-        g_color_iter += 2;
-        if (g_color_iter < 0)
+        g_ctx.color_iter += 2;
+        if (g_ctx.color_iter < 0)
         {
-            g_color_iter += 128;
+            g_ctx.color_iter += 128;
         }
         return 1;
     }
 
-    FPUcplxmul(&g_new_z, &cd1, &g_tmp_z);
-    g_tmp_z.x += croot.x;
-    g_tmp_z.y += croot.y;
+    FPUcplxmul(&g_ctx.new_z, &cd1, &g_ctx.tmp_z);
+    g_ctx.tmp_z.x += croot.x;
+    g_ctx.tmp_z.y += croot.y;
 
     FPUcplxmul(&temp, &cdegree, &cd1);
-    FPUcplxdiv(&g_tmp_z, &cd1, &g_old_z);
+    FPUcplxdiv(&g_ctx.tmp_z, &cd1, &g_ctx.old_z);
     if (g_overflow)
     {
         return 1;
     }
-    g_new_z = g_old_z;
+    g_ctx.new_z = g_ctx.old_z;
     return 0;
 }
 
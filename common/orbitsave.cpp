@@ -0,0 +1,328 @@
+// ORBITS.RAW, the orbit points saved by orbitsave= for the orbit and IFS types.
+//
+// orbitsave=yes writes the points as the text pointlist Acrospin reads, as it
+// always has.  orbitsave=float and orbitsave=double write them in binary, each
+// point in 13 or 25 bytes instead of the 30 or more of text, and without
+// losing any digits along the way:
+//
+//   header   "idorb01\0", then 4 byte little-endian integers for the size of
+//            a value (4 or 8) and the encoding (0 plain, 1 delta)
+//   plain    x, y and z as little-endian IEEE floats of that size, then the
+//            color in a byte
+//   delta    a 2 byte little-endian control word, then for each of x, y and z
+//            the bits of the float exclusive or'ed with the bits of the one
+//            before it (0 for the first point), lowest byte first, leaving off
+//            the zero bytes at the top.  Bits 0-3, 4-7 and 8-11 of the control
+//            word count the bytes kept of x, y and z.  When bit 12 is set a
+//            color byte follows; otherwise the color is the last one given.
+//            The first point always gives its color.
+//
+// Consecutive orbit points often share their sign, exponent and the top of
+// their mantissa, so orbitsave=float/delta or double/delta files come out
+// smaller still (by about a sixth for a Lorenz orbit), and squeeze further
+// with a general purpose packer.
+//
+// The engine hands the points to orbit_save_point(), which only copies them
+// into one of two large buffers.  When a buffer fills, a thread of its own
+// formats and writes it while the engine fills the other one, so the engine
+// only waits on the disk if the disk can't keep up.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "cmdfiles.h"
+#include "orbitsave.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+orbit_save_format g_orbit_save_format = orbit_save_format::text;
+bool g_orbit_save_delta = false;
+
+namespace
+{
+
+char const ORBIT_SAVE_ID[8] = "idorb01";
+std::size_t const BUFFER_POINTS = 1U << 16;    // points in each of the two buffers
+
+enum
+{
+    PLAIN_ENCODING = 0,
+    DELTA_ENCODING = 1
+};
+
+unsigned const DELTA_COLOR = 1U << 12;          // control word bit for a new color
+
+struct orbit_point
+{
+    double x;
+    double y;
+    double z;
+    int color;
+};
+
+// Writes the points in the engine's buffers from a thread of its own.
+class orbit_writer
+{
+public:
+    orbit_writer(std::FILE *fp, orbit_save_format format, bool delta);
+    ~orbit_writer();
+
+    void point(double x, double y, double z, int color)
+    {
+        m_fill->push_back(orbit_point{x, y, z, color});
+        if (m_fill->size() == BUFFER_POINTS)
+        {
+            hand_off();
+        }
+    }
+
+private:
+    void hand_off();
+    void run();
+    void put(std::vector<orbit_point> const &points);
+    template <typename Float, typename Bits>
+    void encode(std::vector<orbit_point> const &points);
+
+    std::FILE *m_fp;
+    orbit_save_format m_format;
+    bool m_delta;
+    bool m_failed{};
+    std::uint64_t m_last_bits[3]{};     // for the delta encoding
+    int m_last_color{-1};               // none yet, so the first point has one
+    std::vector<char> m_bytes;
+    std::vector<orbit_point> m_buffers[2];
+    std::vector<orbit_point> *m_fill;   // being filled by the engine
+    std::vector<orbit_point> *m_full{}; // being written, nullptr when none is
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    bool m_closing{};
+    std::thread m_thread;
+};
+
+orbit_writer::orbit_writer(std::FILE *fp, orbit_save_format format, bool delta) :
+    m_fp(fp),
+    m_format(format),
+    m_delta(delta),
+    m_fill(&m_buffers[0])
+{
+    for (std::vector<orbit_point> &buffer : m_buffers)
+    {
+        buffer.reserve(BUFFER_POINTS);
+    }
+    try
+    {
+        m_thread = std::thread(&orbit_writer::run, this);
+    }
+    catch (std::system_error const &)
+    {
+        // hand_off() writes the points itself
+    }
+}
+
+// Writes the points still in the buffers.
+orbit_writer::~orbit_writer()
+{
+    if (!m_fill->empty())
+    {
+        hand_off();
+    }
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closing = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+    std::fclose(m_fp);
+}
+
+// Passes the buffer just filled to the writing thread, once it's done with
+// the other one, and starts filling that.
+void orbit_writer::hand_off()
+{
+    if (!m_thread.joinable())
+    {
+        put(*m_fill);
+        m_fill->clear();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_cond.wait(lock, [this]()
+        {
+            return m_full == nullptr;
+        });
+        m_full = m_fill;
+    }
+    m_cond.notify_all();
+    m_fill = m_fill == &m_buffers[0] ? &m_buffers[1] : &m_buffers[0];
+    m_fill->clear();
+}
+
+void orbit_writer::run()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true)
+    {
+        m_cond.wait(lock, [this]()
+        {
+            return m_closing || m_full != nullptr;
+        });
+        if (m_full == nullptr)
+        {
+            break;
+        }
+        std::vector<orbit_point> const &points = *m_full;
+        lock.unlock();
+        put(points);
+        lock.lock();
+        m_full = nullptr;
+        m_cond.notify_all();
+    }
+}
+
+// After a failed write the rest of the points are dropped; the file ends
+// part way through, as a full disk would leave it.
+void orbit_writer::put(std::vector<orbit_point> const &points)
+{
+    if (m_failed)
+    {
+        return;
+    }
+    m_bytes.clear();
+    switch (m_format)
+    {
+    case orbit_save_format::text:
+        for (orbit_point const &point : points)
+        {
+            // Acrospin wants every point in color 15
+            char line[80];
+            int const length = std::snprintf(line, sizeof(line), "%g %g %g 15\n", point.x, point.y, point.z);
+            m_bytes.insert(m_bytes.end(), line, line + length);
+        }
+        break;
+    case orbit_save_format::float32:
+        encode<float, std::uint32_t>(points);
+        break;
+    case orbit_save_format::float64:
+        encode<double, std::uint64_t>(points);
+        break;
+    }
+    if (std::fwrite(m_bytes.data(), 1, m_bytes.size(), m_fp) != m_bytes.size())
+    {
+        m_failed = true;
+    }
+}
+
+void put_bytes(std::vector<char> &bytes, std::uint64_t value, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        bytes.push_back((char) (value >> 8*i));
+    }
+}
+
+template <typename Float, typename Bits>
+void orbit_writer::encode(std::vector<orbit_point> const &points)
+{
+    for (orbit_point const &point : points)
+    {
+        double const values[3] = { point.x, point.y, point.z };
+        BYTE const color = (BYTE) point.color;
+        if (!m_delta)
+        {
+            for (double value : values)
+            {
+                Float const f = (Float) value;
+                Bits bits;
+                std::memcpy(&bits, &f, sizeof(bits));
+                put_bytes(m_bytes, bits, sizeof(bits));
+            }
+            m_bytes.push_back((char) color);
+            continue;
+        }
+        std::size_t const control_at = m_bytes.size();
+        m_bytes.resize(control_at + 2);
+        unsigned control = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            Float const f = (Float) values[i];
+            Bits bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            Bits const change = bits ^ (Bits) m_last_bits[i];
+            m_last_bits[i] = bits;
+            int count = 0;
+            while (count < (int) sizeof(bits) && (change >> 8*count) != 0)
+            {
+                ++count;
+            }
+            put_bytes(m_bytes, change, count);
+            control |= (unsigned) count << 4*i;
+        }
+        if (color != m_last_color)
+        {
+            control |= DELTA_COLOR;
+            m_bytes.push_back((char) color);
+            m_last_color = color;
+        }
+        m_bytes[control_at] = (char) (control & 0xff);
+        m_bytes[control_at + 1] = (char) (control >> 8);
+    }
+}
+
+std::unique_ptr<orbit_writer> s_writer;
+
+} // namespace
+
+// Start ORBITS.RAW afresh for the image about to be calculated, if
+// orbitsave= asks for it.  Returns true if points are to be saved.
+bool orbit_save_open()
+{
+    orbit_save_close();
+    if ((g_orbit_save_flags & osf_raw) == 0)
+    {
+        return false;
+    }
+    bool const text = g_orbit_save_format == orbit_save_format::text;
+    std::FILE *fp = std::fopen("orbits.raw", text ? "w" : "wb");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    if (text)
+    {
+        std::fprintf(fp, "pointlist x y z color\n");
+    }
+    else
+    {
+        std::vector<char> header(ORBIT_SAVE_ID, ORBIT_SAVE_ID + sizeof(ORBIT_SAVE_ID));
+        put_bytes(header, g_orbit_save_format == orbit_save_format::float32 ? 4 : 8, 4);
+        put_bytes(header, g_orbit_save_delta ? DELTA_ENCODING : PLAIN_ENCODING, 4);
+        std::fwrite(header.data(), 1, header.size(), fp);
+    }
+    s_writer.reset(new orbit_writer(fp, g_orbit_save_format, g_orbit_save_delta));
+    return true;
+}
+
+// Save a point from the engine that called orbit_save_open().
+void orbit_save_point(double x, double y, double z, int color)
+{
+    s_writer->point(x, y, z, color);
+}
+
+// Write out the points saved and close the file.  Called by the engines when
+// they finish, and again once they return, in case one returned early.
+void orbit_save_close()
+{
+    s_writer.reset();
+}
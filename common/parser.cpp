@@ -23,14 +23,18 @@
 #include "cmdfiles.h"
 #include "drivers.h"
 #include "fpu087.h"
+#include "fracsubr.h"
 #include "fractalp.h"
 #include "fractals.h"
+#include "fractype.h"
 #include "id_data.h"
 #include "jiim.h"
 #include "miscres.h"
 #include "mpmath_c.h"
 #include "newton.h"
 #include "parser.h"
+#include "prompts1.h"
+#include "prompts2.h"
 #include "realdos.h"
 
 #include <algorithm>
@@ -44,6 +48,7 @@
 #include <ctime>
 #include <iterator>
 #include <string>
+#include <vector>
 
 enum MATH_TYPE MathType = D_MATH;
 
@@ -188,6 +193,9 @@ bool g_is_mandelbrot = true;
 unsigned int g_operation_index;
 unsigned int g_variable_index;
 unsigned int g_last_op;
+unsigned int g_parsed_op_count;
+unsigned int g_parsed_loop_op_count;
+unsigned int g_loop_op_count;
 static unsigned int n;
 static unsigned int NextOp;
 static unsigned int InitN;
@@ -201,8 +209,8 @@ static int Delta16;
 double g_fudge_limit;
 static double fg;
 static int ShiftBack;
-static bool SetRandom = false;
-static bool Randomized = false;
+bool SetRandom = false;
+bool Randomized = false;
 static unsigned long RandNum;
 bool g_frm_uses_p1 = false;
 bool g_frm_uses_p2 = false;
@@ -2959,13 +2967,13 @@ int Formula()
     switch (MathType)
     {
     case D_MATH:
-        g_new_z = v[3].a.d;
-        g_old_z = g_new_z;
+        g_ctx.new_z = v[3].a.d;
+        g_ctx.old_z = g_ctx.new_z;
         return Arg1->d.x == 0.0;
 #if !defined(XFRACT)
     case M_MATH:
-        g_new_z = MPC2cmplx(v[3].a.m);
-        g_old_z = g_new_z;
+        g_ctx.new_z = MPC2cmplx(v[3].a.m);
+        g_ctx.old_z = g_ctx.new_z;
         return Arg1->m.x.Exp == 0 && Arg1->m.x.Mant == 0;
     case L_MATH:
         g_l_new_z = v[3].a.l;
@@ -3043,28 +3051,28 @@ int form_per_pixel()
     {
         if (g_invert != 0)
         {
-            invertz2(&g_old_z);
+            invertz2(&g_ctx.old_z);
             switch (MathType)
             {
             case D_MATH:
-                v[0].a.d.x = g_old_z.x;
-                v[0].a.d.y = g_old_z.y;
+                v[0].a.d.x = g_ctx.old_z.x;
+                v[0].a.d.y = g_ctx.old_z.y;
                 break;
 #if !defined(XFRACT)
             case M_MATH:
-                v[0].a.m.x = *d2MP(g_old_z.x);
-                v[0].a.m.y = *d2MP(g_old_z.y);
+                v[0].a.m.x = *d2MP(g_ctx.old_z.x);
+                v[0].a.m.y = *d2MP(g_ctx.old_z.y);
                 break;
             case L_MATH:
                 // watch out for overflow
-                if (sqr(g_old_z.x)+sqr(g_old_z.y) >= 127)
+                if (sqr(g_ctx.old_z.x)+sqr(g_ctx.old_z.y) >= 127)
                 {
-                    g_old_z.x = 8;  // value to bail out in one iteration
-                    g_old_z.y = 8;
+                    g_ctx.old_z.x = 8;  // value to bail out in one iteration
+                    g_ctx.old_z.y = 8;
                 }
                 // convert to fudged longs
-                v[0].a.l.x = (long)(g_old_z.x*fg);
-                v[0].a.l.y = (long)(g_old_z.y*fg);
+                v[0].a.l.x = (long)(g_ctx.old_z.x*fg);
+                v[0].a.l.y = (long)(g_ctx.old_z.y*fg);
                 break;
 #endif
             }
@@ -3107,11 +3115,11 @@ int form_per_pixel()
     switch (MathType)
     {
     case D_MATH:
-        g_old_z = v[3].a.d;
+        g_ctx.old_z = v[3].a.d;
         break;
 #if !defined(XFRACT)
     case M_MATH:
-        g_old_z = MPC2cmplx(v[3].a.m);
+        g_ctx.old_z = MPC2cmplx(v[3].a.m);
         break;
     case L_MATH:
         g_l_old_z = v[3].a.l;
@@ -4116,18 +4124,18 @@ static std::string PrepareFormula(std::FILE * File, bool from_prompts1c)
     if (!frm_check_name_and_sym(File, from_prompts1c))
     {
         fseek(File, filepos, SEEK_SET);
-        return nullptr;
+        return {};
     }
     if (!frm_prescan(File))
     {
         fseek(File, filepos, SEEK_SET);
-        return nullptr;
+        return {};
     }
 
     if (chars_in_formula > 8190)
     {
         fseek(File, filepos, SEEK_SET);
-        return nullptr;
+        return {};
     }
 
     if (g_debug_flag == debug_flags::write_formula_debug_information)
@@ -4164,7 +4172,7 @@ static std::string PrepareFormula(std::FILE * File, bool from_prompts1c)
             {
                 std::fclose(debug_fp);
             }
-            return nullptr;
+            return {};
         }
         else if (temp_tok.token_type == END_OF_FORMULA)
         {
@@ -4174,7 +4182,7 @@ static std::string PrepareFormula(std::FILE * File, bool from_prompts1c)
             {
                 std::fclose(debug_fp);
             }
-            return nullptr;
+            return {};
         }
         if (temp_tok.token_str[0] == ',')
         {
@@ -4200,7 +4208,7 @@ static std::string PrepareFormula(std::FILE * File, bool from_prompts1c)
             {
                 std::fclose(debug_fp);
             }
-            return nullptr;
+            return {};
         case END_OF_FORMULA:
             Done = true;
             fseek(File, filepos, SEEK_SET);
@@ -4230,6 +4238,739 @@ int BadFormula()
     return 1;
 }
 
+/* Formula optimizer.  Runs on the D_MATH program left by ParseStr(), before
+   fill_jump_struct() turns the jumps into op/load/store pointers.  It
+     - folds expressions whose arguments are known at parse time (literals,
+       p1-p5, pi, e, maxit, ...) by running the same dStk functions once,
+     - moves expressions of the iteration section that can't change between
+       iterations to the end of the init section, so they run once per pixel,
+     - removes if/elseif/else branches whose condition folds to a constant.
+   Values come from the same functions on the same arguments, so the images
+   don't change.  debugflag=322 turns it off along with the peephole optimizer.
+*/
+namespace
+{
+
+enum
+{
+    OPT_BINARY   = 1,   // pops two args, otherwise replaces the top one
+    OPT_HOIST    = 2,   // can't set g_overflow, so it may run speculatively
+    OPT_LAST_SQR = 4    // writes LastSqr
+};
+
+struct OPT_FN
+{
+    void (*fn)();
+    int flags;
+};
+
+OPT_FN const OptFnList[] =
+{
+    {dStkAbs,    OPT_HOIST},
+    {dStkACos,   OPT_HOIST},
+    {dStkACosh,  OPT_HOIST},
+    {dStkASin,   OPT_HOIST},
+    {dStkASinh,  OPT_HOIST},
+    {dStkATan,   OPT_HOIST},
+    {dStkATanh,  OPT_HOIST},
+    {dStkAdd,    OPT_BINARY | OPT_HOIST},
+    {dStkAND,    OPT_BINARY | OPT_HOIST},
+    {dStkCAbs,   OPT_HOIST},
+    {dStkCeil,   OPT_HOIST},
+    {dStkCoTan,  0},
+    {dStkCoTanh, 0},
+    {dStkConj,   OPT_HOIST},
+    {dStkCos,    OPT_HOIST},
+    {dStkCosh,   OPT_HOIST},
+    {dStkCosXX,  OPT_HOIST},
+    {dStkDiv,    OPT_BINARY | OPT_HOIST},
+    {dStkEQ,     OPT_BINARY | OPT_HOIST},
+    {dStkExp,    OPT_HOIST},
+    {dStkFlip,   OPT_HOIST},
+    {dStkFloor,  OPT_HOIST},
+    {dStkGT,     OPT_BINARY | OPT_HOIST},
+    {dStkGTE,    OPT_BINARY | OPT_HOIST},
+    {dStkImag,   OPT_HOIST},
+    {dStkLog,    OPT_HOIST},
+    {dStkLT,     OPT_BINARY | OPT_HOIST},
+    {dStkLTE,    OPT_BINARY | OPT_HOIST},
+    {dStkMod,    OPT_HOIST},
+    {dStkMul,    OPT_BINARY | OPT_HOIST},
+    {dStkNE,     OPT_BINARY | OPT_HOIST},
+    {dStkNeg,    OPT_HOIST},
+    {dStkOne,    OPT_HOIST},
+    {dStkOR,     OPT_BINARY | OPT_HOIST},
+    {dStkPwr,    OPT_BINARY | OPT_HOIST},
+    {dStkReal,   OPT_HOIST},
+    {dStkRecip,  0},
+    {dStkRound,  OPT_HOIST},
+    {dStkSin,    OPT_HOIST},
+    {dStkSinh,   OPT_HOIST},
+    {dStkSqr,    OPT_HOIST | OPT_LAST_SQR},
+    {dStkSqrt,   OPT_HOIST},
+    {dStkSub,    OPT_BINARY | OPT_HOIST},
+    {dStkTan,    0},
+    {dStkTanh,   0},
+    {dStkTrunc,  OPT_HOIST},
+    {dStkZero,   OPT_HOIST},
+    {StkIdent,   OPT_HOIST},
+};
+
+char const OptConstName[] = "(folded)";    // not alpha, so a constant to CvtStk()
+char const OptTempName[] = "hoisted";
+
+struct OPT_PROGRAM
+{
+    std::vector<void (*)()> ops;
+    std::vector<Arg *> loads;
+    std::vector<Arg *> stores;
+    std::vector<int> jumps;     // jump_control[].type of each jump op
+};
+
+struct OPT_ENTRY                // a value on the simulated stack
+{
+    int op;                     // first op that computes it
+    int load;                   // first load it uses
+    bool constant;              // known at parse time
+    bool invariant;             // the same on every iteration
+    Arg value;
+};
+
+struct OPT_FOLD
+{
+    OPT_PROGRAM *out;
+    OPT_PROGRAM hoisted;        // code for the end of the init section
+    std::vector<OPT_ENTRY> stack;
+    bool in_loop;
+};
+
+OPT_FN const *opt_find_fn(void (*fn)())
+{
+    for (OPT_FN const &entry : OptFnList)
+    {
+        if (entry.fn == fn)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool opt_is_jump(void (*fn)())
+{
+    return fn == StkJump || fn == StkJumpLabel || fn == dStkJumpOnFalse || fn == dStkJumpOnTrue;
+}
+
+int opt_var_index(Arg const *arg)
+{
+    for (unsigned i = 0; i < g_variable_index; i++)
+    {
+        if (&v[i].a == arg)
+        {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+Arg *opt_new_var(char const *name, Arg const &value)
+{
+    if (g_variable_index >= v.size())
+    {
+        return nullptr;
+    }
+    ConstArg &var = v[g_variable_index++];
+    var.s = name;
+    var.len = (int) std::strlen(name);
+    var.a = value;
+    return &var.a;
+}
+
+// literals and the per-image constants ParseStr() fills in
+bool opt_is_constant(int var, std::vector<bool> const &stored)
+{
+    if (var < 0 || stored[var])
+    {
+        return false;
+    }
+    switch (var)
+    {
+    case 1:     // p1
+    case 2:     // p2
+    case 5:     // pi
+    case 6:     // e
+    case 8:     // p3
+    case 11:    // scrnmax
+    case 12:    // maxit
+    case 13:    // ismand
+    case 14:    // center
+    case 15:    // magxmag
+    case 16:    // rotskew
+    case 17:    // p4
+    case 18:    // p5
+        return true;
+    default:
+        break;
+    }
+    return var >= (int)(sizeof(Constants)/sizeof(char *))
+        && v[var].s != nullptr
+        && !std::isalpha(v[var].s[0]) && v[var].s[0] != '_';
+}
+
+bool opt_evaluate(void (*fn)(), int args, OPT_ENTRY const *arg, Arg *result)
+{
+    Arg stack[3];
+    Arg *const old_arg1 = Arg1;
+    Arg *const old_arg2 = Arg2;
+    bool const old_overflow = g_overflow;
+    Arg const old_last_sqr = LastSqr;
+    for (int i = 0; i < args; i++)
+    {
+        stack[i + 1] = arg[i].value;
+    }
+    g_overflow = false;
+    Arg1 = &stack[args];
+    Arg2 = Arg1 - 1;
+    fn();
+    *result = stack[1];
+    bool const ok = !g_overflow;
+    Arg1 = old_arg1;
+    Arg2 = old_arg2;
+    g_overflow = old_overflow;
+    LastSqr = old_last_sqr;
+    return ok;
+}
+
+// Moves the code of stack entry i into the init section, leaving a load of
+// a temporary in its place.  Only invariant entries of more than one op move.
+void opt_hoist(OPT_FOLD &pass, int i)
+{
+    OPT_PROGRAM &out = *pass.out;
+    OPT_ENTRY &entry = pass.stack[i];
+    bool const top = i + 1 == (int) pass.stack.size();
+    int const end_op = top ? (int) out.ops.size() : pass.stack[i + 1].op;
+    int const end_load = top ? (int) out.loads.size() : pass.stack[i + 1].load;
+    if (!pass.in_loop || !entry.invariant || end_op - entry.op < 2)
+    {
+        return;
+    }
+    Arg *temp = opt_new_var(OptTempName, entry.value);
+    if (temp == nullptr)
+    {
+        return;
+    }
+    pass.hoisted.ops.insert(pass.hoisted.ops.end(), out.ops.begin() + entry.op, out.ops.begin() + end_op);
+    pass.hoisted.loads.insert(pass.hoisted.loads.end(), out.loads.begin() + entry.load, out.loads.begin() + end_load);
+    pass.hoisted.ops.push_back(StkSto);
+    pass.hoisted.stores.push_back(temp);
+    pass.hoisted.ops.push_back(StkClr);
+
+    out.ops.erase(out.ops.begin() + entry.op + 1, out.ops.begin() + end_op);
+    out.ops[entry.op] = StkLod;
+    out.loads.erase(out.loads.begin() + entry.load, out.loads.begin() + end_load);
+    out.loads.insert(out.loads.begin() + entry.load, temp);
+    for (int j = i + 1; j < (int) pass.stack.size(); j++)
+    {
+        pass.stack[j].op -= end_op - entry.op - 1;
+        pass.stack[j].load -= end_load - entry.load - 1;
+    }
+}
+
+void opt_hoist_all(OPT_FOLD &pass, int first)
+{
+    for (int i = (int) pass.stack.size() - 1; i >= first; i--)
+    {
+        opt_hoist(pass, i);
+    }
+}
+
+// Folds constant expressions and, with hoist set, moves invariant ones out
+// of the iteration section.  conditions gets, for every jump, 1 or 0 when
+// it is a JumpOnFalse whose whole condition is constant, otherwise -1.
+bool opt_fold(OPT_PROGRAM const &in, OPT_PROGRAM &out, std::vector<int> &conditions, bool hoist)
+{
+    std::vector<bool> stored(g_variable_index);
+    std::vector<bool> loop_stored(g_variable_index);
+    bool uses_last_sqr = false;
+    int end_init = -1;
+    int init_depth = 0;
+    int depth = 0;
+    unsigned load = 0;
+    unsigned store = 0;
+    unsigned jump = 0;
+    for (unsigned i = 0; i < in.ops.size(); i++)
+    {
+        void (*fn)() = in.ops[i];
+        if (fn == StkLod)
+        {
+            uses_last_sqr |= opt_var_index(in.loads[load++]) == 4;
+        }
+        else if (fn == StkSto)
+        {
+            int const var = opt_var_index(in.stores[store++]);
+            if (var < 0)
+            {
+                return false;
+            }
+            stored[var] = true;
+            if (end_init >= 0)
+            {
+                loop_stored[var] = true;
+            }
+        }
+        else if (fn == EndInit)
+        {
+            if (end_init >= 0)
+            {
+                hoist = false;
+            }
+            end_init = (int) i;
+            init_depth = depth;
+        }
+        else if (opt_is_jump(fn))
+        {
+            if (jump == in.jumps.size())
+            {
+                return false;
+            }
+            depth += in.jumps[jump] == 1 ? 1 : in.jumps[jump] == 4 ? -1 : 0;
+            jump++;
+        }
+    }
+    if (load != in.loads.size() || store != in.stores.size() || jump != in.jumps.size())
+    {
+        return false;
+    }
+    hoist = hoist && end_init >= 0 && init_depth == 0;
+
+    OPT_FOLD pass;
+    pass.out = &out;
+    pass.in_loop = false;
+    out = OPT_PROGRAM();
+    conditions.clear();
+    int init_op = 0;
+    int init_load = 0;
+    int init_store = 0;
+    load = 0;
+    store = 0;
+    jump = 0;
+    for (void (*fn)() : in.ops)
+    {
+        if (fn == StkLod)
+        {
+            Arg *arg = in.loads[load++];
+            int const var = opt_var_index(arg);
+            OPT_ENTRY entry;
+            entry.op = (int) out.ops.size();
+            entry.load = (int) out.loads.size();
+            entry.constant = opt_is_constant(var, stored);
+            entry.invariant = pass.in_loop && var != 3 && var != 4 && var != 7 && var >= 0 && !loop_stored[var];
+            entry.value = *arg;
+            pass.stack.push_back(entry);
+            out.ops.push_back(fn);
+            out.loads.push_back(arg);
+        }
+        else if (fn == StkSto)
+        {
+            if (!pass.stack.empty())
+            {
+                opt_hoist(pass, (int) pass.stack.size() - 1);
+                pass.stack.back().constant = false;
+                pass.stack.back().invariant = false;
+            }
+            out.ops.push_back(fn);
+            out.stores.push_back(in.stores[store++]);
+        }
+        else if (fn == StkClr || fn == EndInit || opt_is_jump(fn))
+        {
+            if (opt_is_jump(fn))
+            {
+                int condition = -1;
+                if (fn == dStkJumpOnFalse && pass.stack.size() == 1 && pass.stack[0].constant)
+                {
+                    condition = pass.stack[0].value.d.x == 0.0 ? 0 : 1;
+                }
+                conditions.push_back(condition);
+                out.jumps.push_back(in.jumps[jump++]);
+            }
+            opt_hoist_all(pass, 0);
+            pass.stack.clear();
+            if (fn == EndInit)
+            {
+                init_op = (int) out.ops.size();
+                init_load = (int) out.loads.size();
+                init_store = (int) out.stores.size();
+                pass.in_loop = hoist;
+            }
+            out.ops.push_back(fn);
+        }
+        else
+        {
+            OPT_FN const *info = opt_find_fn(fn);
+            if (info != nullptr && (info->flags & OPT_LAST_SQR) && uses_last_sqr)
+            {
+                info = nullptr;
+            }
+            int const args = info != nullptr && (info->flags & OPT_BINARY) ? 2 : 1;
+            if ((int) pass.stack.size() < args)
+            {
+                // malformed, leave it alone
+                opt_hoist_all(pass, 0);
+                pass.stack.clear();
+                OPT_ENTRY entry;
+                entry.op = (int) out.ops.size();
+                entry.load = (int) out.loads.size();
+                entry.constant = false;
+                entry.invariant = false;
+                pass.stack.push_back(entry);
+                out.ops.push_back(fn);
+                continue;
+            }
+            int const first = (int) pass.stack.size() - args;
+            bool constant = info != nullptr;
+            bool invariant = info != nullptr && (info->flags & OPT_HOIST) && pass.in_loop;
+            for (int i = first; i < (int) pass.stack.size(); i++)
+            {
+                constant = constant && pass.stack[i].constant;
+                invariant = invariant && pass.stack[i].invariant;
+            }
+            OPT_ENTRY result = pass.stack[first];
+            Arg *folded = nullptr;
+            if (constant && opt_evaluate(fn, args, &pass.stack[first], &result.value))
+            {
+                folded = opt_new_var(OptConstName, result.value);
+            }
+            if (folded != nullptr)
+            {
+                out.ops.resize(result.op);
+                out.loads.resize(result.load);
+                out.ops.push_back(StkLod);
+                out.loads.push_back(folded);
+                result.constant = true;
+                result.invariant = pass.in_loop;
+            }
+            else
+            {
+                if (!invariant)
+                {
+                    opt_hoist_all(pass, first);
+                }
+                out.ops.push_back(fn);
+                result.op = pass.stack[first].op;
+                result.load = pass.stack[first].load;
+                result.constant = false;
+                result.invariant = invariant;
+            }
+            pass.stack.resize(first);
+            pass.stack.push_back(result);
+        }
+    }
+    opt_hoist_all(pass, 0);
+
+    if (!pass.hoisted.ops.empty())
+    {
+        pass.hoisted.ops.insert(pass.hoisted.ops.begin(), StkClr);
+        out.ops.insert(out.ops.begin() + init_op, pass.hoisted.ops.begin(), pass.hoisted.ops.end());
+        out.loads.insert(out.loads.begin() + init_load, pass.hoisted.loads.begin(), pass.hoisted.loads.end());
+        out.stores.insert(out.stores.begin() + init_store, pass.hoisted.stores.begin(), pass.hoisted.stores.end());
+    }
+    return true;
+}
+
+struct OPT_PRUNE
+{
+    std::vector<int> const *conditions;
+    std::vector<int> jump_op;   // op index of each jump
+    std::vector<int> types;
+    std::vector<bool> dead_op;
+    std::vector<bool> dead_jump;
+};
+
+struct OPT_BRANCH
+{
+    int first;                  // jump starting the branch
+    int test;                   // its JumpOnFalse, -1 for else
+};
+
+void opt_kill_ops(OPT_PRUNE &prune, int first, int last)
+{
+    for (int i = first; i <= last; i++)
+    {
+        prune.dead_op[i] = true;
+    }
+    for (unsigned j = 0; j < prune.jump_op.size(); j++)
+    {
+        if (prune.jump_op[j] >= first && prune.jump_op[j] <= last)
+        {
+            prune.dead_jump[j] = true;
+        }
+    }
+}
+
+// Prunes the if group starting at jump j, returns the jump after its endif.
+int opt_prune_group(OPT_PRUNE &prune, int j)
+{
+    std::vector<OPT_BRANCH> branches;
+    branches.push_back(OPT_BRANCH{j, j});
+    int endif = j + 1;
+    while (endif < (int) prune.types.size() && prune.types[endif] != 4)
+    {
+        switch (prune.types[endif])
+        {
+        case 1:
+            endif = opt_prune_group(prune, endif);
+            break;
+        case 2:
+            branches.push_back(OPT_BRANCH{endif, endif + 1});
+            endif += 2;
+            break;
+        default:
+            branches.push_back(OPT_BRANCH{endif, -1});
+            endif++;
+            break;
+        }
+    }
+    if (endif >= (int) prune.types.size())
+    {
+        return endif;
+    }
+
+    // a branch runs from its first jump (or its constant condition) up to
+    // the next branch's first jump
+    int const count = (int) branches.size();
+    auto const start = [&](int b)
+    {
+        OPT_BRANCH const &branch = branches[b];
+        return b == 0 ? prune.jump_op[branch.test] - 1 : prune.jump_op[branch.first];
+    };
+    auto const end = [&](int b)
+    {
+        return (b + 1 < count ? prune.jump_op[branches[b + 1].first] : prune.jump_op[endif]) - 1;
+    };
+    auto const condition = [&](int b)
+    {
+        return branches[b].test < 0 ? 1 : (*prune.conditions)[branches[b].test];
+    };
+
+    int live = 0;
+    int always = -1;            // branch that runs whenever it is reached
+    for (int b = 0; b < count; b++)
+    {
+        if (always >= 0 || condition(b) == 0)
+        {
+            opt_kill_ops(prune, start(b), end(b));
+        }
+        else if (condition(b) == 1)
+        {
+            always = b;
+        }
+        else
+        {
+            if (live++ == 0 && b > 0)
+            {
+                // the first remaining elseif becomes the if
+                opt_kill_ops(prune, prune.jump_op[branches[b].first], prune.jump_op[branches[b].first]);
+                prune.types[branches[b].test] = 1;
+            }
+        }
+    }
+    if (always >= 0 && branches[always].test >= 0)
+    {
+        // drop the constant condition, an elseif becomes an else
+        int const test_op = prune.jump_op[branches[always].test];
+        if (live == 0)
+        {
+            opt_kill_ops(prune, start(always), test_op);
+        }
+        else
+        {
+            opt_kill_ops(prune, test_op - 1, test_op);
+            prune.types[branches[always].first] = 3;
+        }
+    }
+    else if (always >= 0 && live == 0)
+    {
+        opt_kill_ops(prune, start(always), start(always));
+    }
+    if (live == 0)
+    {
+        opt_kill_ops(prune, prune.jump_op[endif], prune.jump_op[endif]);
+    }
+    return endif + 1;
+}
+
+// Removes the branches that can't run.  Leaves the program alone unless its
+// last statement is computed after the last jump, since the value left on
+// the stack by a removed condition could otherwise decide the bailout.
+void opt_prune(OPT_PROGRAM const &in, std::vector<int> const &conditions, OPT_PROGRAM &out)
+{
+    out = in;
+    OPT_PRUNE prune;
+    prune.conditions = &conditions;
+    prune.types = in.jumps;
+    int last_load = -1;
+    for (int i = 0; i < (int) in.ops.size(); i++)
+    {
+        if (opt_is_jump(in.ops[i]))
+        {
+            if (in.ops[i] == dStkJumpOnTrue)
+            {
+                return;
+            }
+            prune.jump_op.push_back(i);
+        }
+        else if (in.ops[i] == StkLod)
+        {
+            last_load = i;
+        }
+    }
+    if (prune.jump_op.empty() || prune.jump_op.size() != in.jumps.size()
+        || last_load < prune.jump_op.back())
+    {
+        return;
+    }
+    prune.dead_op.resize(in.ops.size());
+    prune.dead_jump.resize(in.jumps.size());
+    int j = 0;
+    while (j < (int) prune.types.size())
+    {
+        j = prune.types[j] == 1 ? opt_prune_group(prune, j) : j + 1;
+    }
+
+    out = OPT_PROGRAM();
+    unsigned load = 0;
+    unsigned store = 0;
+    unsigned jump = 0;
+    for (unsigned i = 0; i < in.ops.size(); i++)
+    {
+        void (*fn)() = in.ops[i];
+        bool const keep = !prune.dead_op[i];
+        if (fn == StkLod)
+        {
+            if (keep)
+            {
+                out.loads.push_back(in.loads[load]);
+            }
+            load++;
+        }
+        else if (fn == StkSto)
+        {
+            if (keep)
+            {
+                out.stores.push_back(in.stores[store]);
+            }
+            store++;
+        }
+        else if (opt_is_jump(fn))
+        {
+            if (!prune.dead_jump[jump])
+            {
+                out.jumps.push_back(prune.types[jump]);
+            }
+            jump++;
+        }
+        if (keep)
+        {
+            out.ops.push_back(fn);
+        }
+    }
+}
+
+unsigned opt_loop_ops(std::vector<void (*)()> const &ops, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (ops[i] == EndInit)
+        {
+            return count - i - 1;
+        }
+    }
+    return count;
+}
+
+bool opt_fits(OPT_PROGRAM const &program)
+{
+    return program.ops.size() <= f.size()
+        && program.loads.size() <= Load.size()
+        && program.stores.size() <= Store.size();
+}
+
+} // namespace
+
+static bool s_unoptimized = false;      // check_formulas() running the interpreter without it
+
+static void optimize_formula()
+{
+    g_parsed_op_count = g_last_op;
+    g_parsed_loop_op_count = opt_loop_ops(f, g_last_op);
+    g_loop_op_count = g_parsed_loop_op_count;
+    if (MathType != D_MATH || g_debug_flag == debug_flags::prevent_formula_optimizer || s_unoptimized)
+    {
+        return;
+    }
+
+    OPT_PROGRAM parsed;
+    parsed.ops.assign(f.begin(), f.begin() + g_last_op);
+    for (void (*fn)() : parsed.ops)
+    {
+        if (fn == StkLod)
+        {
+            parsed.loads.push_back(Load[parsed.loads.size()]);
+        }
+        else if (fn == StkSto)
+        {
+            parsed.stores.push_back(Store[parsed.stores.size()]);
+        }
+    }
+    for (int i = 0; i < jump_index; i++)
+    {
+        parsed.jumps.push_back(jump_control[i].type);
+    }
+
+    OPT_PROGRAM folded;
+    OPT_PROGRAM pruned;
+    OPT_PROGRAM result;
+    std::vector<int> conditions;
+    if (!opt_fold(parsed, folded, conditions, false))
+    {
+        return;
+    }
+    opt_prune(folded, conditions, pruned);
+    unsigned const vars = g_variable_index;
+    if (!opt_fold(pruned, result, conditions, true) || !opt_fits(result))
+    {
+        g_variable_index = vars;
+        result = pruned;
+    }
+
+    std::copy(result.ops.begin(), result.ops.end(), f.begin());
+    std::copy(result.loads.begin(), result.loads.end(), Load.begin());
+    std::copy(result.stores.begin(), result.stores.end(), Store.begin());
+    for (unsigned i = 0; i < result.jumps.size(); i++)
+    {
+        jump_control[i].type = result.jumps[i];
+    }
+    jump_index = (int) result.jumps.size();
+    uses_jump = jump_index > 0;
+    g_last_op = (unsigned) result.ops.size();
+    g_loop_op_count = opt_loop_ops(f, g_last_op);
+}
+
+// 2 for a dStk function that pops two args, 1 for one that replaces the
+// top one, 0 for any other op
+int formula_fn_args(void (*fn)())
+{
+    OPT_FN const *info = opt_find_fn(fn);
+    return info == nullptr ? 0 : (info->flags & OPT_BINARY) ? 2 : 1;
+}
+
+// true for a dStk function that can't set g_overflow
+bool formula_fn_is_pure(void (*fn)())
+{
+    OPT_FN const *info = opt_find_fn(fn);
+    return info != nullptr && (info->flags & OPT_HOIST) != 0;
+}
+
 //  returns true if an error occurred
 bool RunForm(char const *Name, bool from_prompts1c)
 {
@@ -4262,6 +5003,7 @@ bool RunForm(char const *Name, bool from_prompts1c)
         }
         else
         {
+            optimize_formula();
             if (uses_jump && fill_jump_struct())
             {
                 stopmsg(STOPMSG_NONE, ParseErrs(PE_ERROR_IN_PARSING_JUMP_STATEMENTS));
@@ -4298,10 +5040,221 @@ bool fpFormulaSetup()
     return RunFormRes;
 #else
     MathType = D_MATH;
-    return !RunForm(g_formula_name.c_str(), false); // RunForm() returns true for failure
+    bool RunFormRes = !RunForm(g_formula_name.c_str(), false); // RunForm() returns true for failure
+    if (RunFormRes
+        && g_debug_flag != debug_flags::force_standard_fractal)
+    {
+        dtCvtStk();    // run direct threaded code in parserdt.cpp
+        laneCvtStk();  // and batches of pixels in parserlane.cpp
+    }
+    return RunFormRes;
 #endif
 }
 
+namespace
+{
+
+// the ways check_formulas() runs each formula; the first is the one the
+// others are checked against
+struct frm_check_mode
+{
+    char const *name;
+    debug_flags flag;
+    bool unoptimized;
+};
+
+frm_check_mode const s_frm_check_modes[] =
+{
+    { "interpreter, debugflag=322", debug_flags::force_standard_fractal, true },
+    { "interpreter", debug_flags::force_standard_fractal, false },
+    { "threaded, debugflag=322", debug_flags::prevent_formula_optimizer, false },
+    { "threaded", debug_flags::none, false },
+};
+
+int const FRM_CHECK_COLS = 80;          // grid of pixels checked across the screen
+int const FRM_CHECK_ROWS = 60;
+
+// The iterations of each pixel of the grid for the formula in
+// g_formula_name, or none if it doesn't parse.
+std::vector<long> frm_check_counts()
+{
+    std::vector<long> counts;
+    calcfracinit();
+    if (!g_cur_fractal_specific->per_image())
+    {
+        return counts;
+    }
+    if (Randomized)
+    {
+        // the same 'rand' every time, instead of one seeded from the clock
+        srand(1);
+        RandNum = 0;
+        NewRandNum();
+        NewRandNum();
+        NewRandNum();
+    }
+    for (int row = 0; row < FRM_CHECK_ROWS; ++row)
+    {
+        for (int col = 0; col < FRM_CHECK_COLS; ++col)
+        {
+            g_row = row*g_logical_screen_y_dots/FRM_CHECK_ROWS;
+            g_col = col*g_logical_screen_x_dots/FRM_CHECK_COLS;
+            g_cur_fractal_specific->per_pixel();
+            long iterations = 0;
+            while (iterations < g_max_iterations)
+            {
+                ++iterations;
+                if (g_cur_fractal_specific->orbitcalc())
+                {
+                    break;
+                }
+            }
+            counts.push_back(iterations);
+        }
+    }
+    return counts;
+}
+
+} // namespace
+
+// debugflag=208: in place of calcfract(), runs every formula in the .frm
+// files of the formulas and extra directories with the dStk interpreter and
+// with the direct threaded code in parserdt.cpp, each with and without
+// debugflag=322, at the default corners.  Writes the formulas that don't
+// parse and those that take a different number of iterations for any pixel
+// of a grid across the screen to "frmcheck.txt".  Then draws the image asked
+// for.
+int check_formulas()
+{
+    {
+        SavedFractal saved;
+        int const debug_flag = g_debug_flag;
+        batch_modes const batch = g_init_batch;
+
+        std::vector<std::string> dirs;
+        for (char const *search_dir : { g_fractal_search_dir1, g_fractal_search_dir2 })
+        {
+            for (char const *sub_dir : { "formulas", "extra" })
+            {
+                // both search directories can be the same one
+                char drive[FILE_MAX_DRIVE] = "";
+                char dir[FILE_MAX_DIR];
+                makepath(dir, "", search_dir, sub_dir, "");
+                expand_dirname(dir, drive);
+                fix_dirname(dir);
+                std::string const resolved = std::string(drive) + dir;
+                if (std::find(dirs.begin(), dirs.end(), resolved) == dirs.end())
+                {
+                    dirs.push_back(resolved);
+                }
+            }
+        }
+        std::vector<std::string> files;
+        for (std::string const &dir : dirs)
+        {
+            char path[FILE_MAX_PATH];
+            makepath(path, "", dir.c_str(), "*", ".frm");
+            for (int out = fr_findfirst(path); out == 0; out = fr_findnext())
+            {
+                if (!(DTA.attribute & SUBDIR))
+                {
+                    files.push_back(dir + DTA.filename);
+                }
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        std::FILE *report = dir_fopen(g_working_dir.c_str(), "frmcheck.txt", "w");
+        std::vector<entryinfo> entries(MAXENTRIES + 1);
+        int formulas = 0;
+        int unparsed = 0;
+        int differ = 0;
+        bool interrupted = false;
+        for (std::string const &file : files)
+        {
+            std::FILE *infile = std::fopen(file.c_str(), "rb");
+            if (infile == nullptr)
+            {
+                continue;
+            }
+            int const count = scan_entries(infile, entries.data(), nullptr);
+            std::fclose(infile);
+            for (int i = 0; i < count && !interrupted; ++i)
+            {
+                ++formulas;
+                saved.use_defaults(fractal_type::FFORMULA);
+                g_formula_filename = file;
+                g_formula_name = entries[i].name;
+                std::vector<long> expected;
+                bool differs = false;
+                for (frm_check_mode const &mode : s_frm_check_modes)
+                {
+                    g_debug_flag = mode.flag;
+                    s_unoptimized = mode.unoptimized;
+                    std::vector<long> const counts = frm_check_counts();
+                    g_debug_flag = debug_flag;
+                    s_unoptimized = false;
+                    g_init_batch = batch;       // after a parse error in batch mode
+                    if (&mode == &s_frm_check_modes[0])
+                    {
+                        if (counts.empty())
+                        {
+                            ++unparsed;
+                            if (report != nullptr)
+                            {
+                                std::fprintf(report, "%s %s: doesn't parse\n", file.c_str(), g_formula_name.c_str());
+                            }
+                            break;
+                        }
+                        expected = counts;
+                        continue;
+                    }
+                    std::size_t first = counts.size();
+                    int pixels = 0;
+                    for (std::size_t j = 0; j < counts.size() && j < expected.size(); ++j)
+                    {
+                        if (counts[j] != expected[j])
+                        {
+                            first = std::min(first, j);
+                            ++pixels;
+                        }
+                    }
+                    if (counts.size() != expected.size() || pixels != 0)
+                    {
+                        differs = true;
+                        if (report != nullptr && first < counts.size())
+                        {
+                            std::fprintf(report, "%s %s: %s differs at %d of %d pixels, first at %d,%d: %ld iterations, %s: %ld\n",
+                                file.c_str(), g_formula_name.c_str(), mode.name, pixels, (int) expected.size(),
+                                (int) (first % FRM_CHECK_COLS)*g_logical_screen_x_dots/FRM_CHECK_COLS,
+                                (int) (first / FRM_CHECK_COLS)*g_logical_screen_y_dots/FRM_CHECK_ROWS,
+                                counts[first], s_frm_check_modes[0].name, expected[first]);
+                        }
+                        else if (report != nullptr)
+                        {
+                            std::fprintf(report, "%s %s: %s doesn't parse\n", file.c_str(), g_formula_name.c_str(), mode.name);
+                        }
+                    }
+                }
+                if (differs)
+                {
+                    ++differ;
+                }
+                interrupted = driver_key_pressed() != 0;
+            }
+        }
+        if (report != nullptr)
+        {
+            std::fprintf(report, "%d formulas in %d files at %dx%d maxiter=%ld, %d don't parse, %d differ%s\n",
+                formulas, (int) files.size(), g_logical_screen_x_dots, g_logical_screen_y_dots, g_max_iterations,
+                unparsed, differ, interrupted ? ", interrupted" : "");
+            std::fclose(report);
+        }
+    }
+    calcfracinit();
+    return calcfract();
+}
+
 bool intFormulaSetup()
 {
 #if defined(XFRACT) || defined(_WIN32)
@@ -4370,9 +5323,10 @@ static void parser_allocate()
         {
             if (!ParseStr(FormStr.c_str(), pass))
             {
-                // per Chuck Ebbert, fudge these up a little
-                g_max_function_ops = g_operation_index + 4;
-                g_max_function_args = g_variable_index + 4;
+                // per Chuck Ebbert, fudge these up a little, and leave
+                // optimize_formula() room for the code and values it adds
+                g_max_function_ops = g_operation_index + g_operation_index/2 + 4;
+                g_max_function_args = g_variable_index + g_operation_index + 4;
             }
         }
     }
@@ -0,0 +1,624 @@
+// PARSERDT.CPP -- Part of FRACTINT fractal drawer.
+
+// Direct threaded floating point parser code, used where the assembler
+//    "fStk" code of PARSERFP.CPP is not available.
+
+//   Converts the function pointers/load pointers/store pointers built
+//       by ParseStr() into a flat array of instructions, each holding
+//       its operand and the address of the code that runs it, and runs
+//       them with computed gotos (a switch on compilers without them).
+//       Jumps are resolved to instructions when the formula is converted,
+//       and a load followed by an operator on the loaded value, or a
+//       store followed by a clear (and a load of the value stored), is
+//       fused into one instruction.  The top of the stack is kept in
+//       registers while the instructions run.
+
+//   The instructions do the arithmetic of the dStk functions they stand
+//       for operation by operation, so images are the same as with the
+//       dStk interpreter; functions without an instruction of their own
+//       are called through Arg1 and Arg2 as before.
+
+//   Use startup parameter "debugflag=322" to run the instructions without
+//       fusing them, and "debugflag=90" to use the dStk interpreter.
+//       "debugflag=208" runs every formula in the formulas and extra
+//       directories both ways and lists those whose iterations differ.
+#include "port.h"
+#include "prototyp.h"
+
+#include "cmdfiles.h"
+#include "fpu087.h"
+#include "fractalp.h"
+#include "fractals.h"
+#include "newton.h"
+#include "parser.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+/* not moved to PROTOTYPE.H because these only communicate within
+   PARSER.C and other parser modules */
+
+extern std::vector<Arg *> Store;
+extern std::vector<Arg *> Load;
+extern std::vector<ConstArg> v;
+extern std::vector<void (*)()> f;
+extern JUMP_CONTROL_ST jump_control[];
+extern bool SetRandom;
+extern bool Randomized;
+
+extern void StkJump();
+extern void StkJumpLabel();
+extern void dStkJumpOnFalse();
+extern void dStkJumpOnTrue();
+
+#if defined(__GNUC__)
+#define DT_COMPUTED_GOTO
+#endif
+
+#define LASTSQR v[4].a
+#define MAX_STACK 20    // size of the parser's argument stack
+
+// instructions; the ones starting with LOD load an operand and then do
+//    the operation named after it
+#define DT_OPS(OP)                                                  \
+    OP(END) OP(CALL) OP(LOD) OP(STO) OP(CLR) OP(STO_CLR) OP(STO_CLR_LOD) \
+    OP(END_INIT)                                                    \
+    OP(JUMP) OP(JUMP_ON_FALSE) OP(JUMP_ON_TRUE)                     \
+    OP(ADD) OP(SUB) OP(MUL) OP(DIV) OP(SQR) OP(MOD)                 \
+    OP(NEG) OP(CONJ) OP(REAL) OP(IMAG) OP(FLIP) OP(ABS)             \
+    OP(ZERO) OP(ONE)                                                \
+    OP(LT) OP(LTE) OP(GT) OP(GTE) OP(EQ) OP(NE) OP(AND) OP(OR)      \
+    OP(LOD_ADD) OP(LOD_SUB) OP(LOD_MUL) OP(LOD_SQR) OP(LOD_MOD)     \
+    OP(LOD_LT) OP(LOD_LTE) OP(LOD_GT) OP(LOD_GTE)
+
+#define DT_ENUM(name) DT_##name,
+enum dt_op
+{
+    DT_OPS(DT_ENUM)
+    DT_NUM_OPS
+};
+#undef DT_ENUM
+
+struct dt_instruction
+{
+    void const *label;          // code for op, filled in by dt_run()
+    dt_op op;
+    int target;                 // instruction jumped to, op index of EndInit
+    Arg *operand;               // value loaded or stored
+    void (*function)();         // dStk function called by CALL
+};
+
+// the dStk functions with an instruction of their own
+struct dt_function
+{
+    void (*function)();
+    dt_op op;
+};
+
+static dt_function const s_dt_functions[] =
+{
+    { dStkAdd, DT_ADD },
+    { dStkSub, DT_SUB },
+    { dStkMul, DT_MUL },
+    { dStkDiv, DT_DIV },
+    { dStkSqr, DT_SQR },
+    { dStkMod, DT_MOD },
+    { dStkNeg, DT_NEG },
+    { dStkConj, DT_CONJ },
+    { dStkReal, DT_REAL },
+    { dStkImag, DT_IMAG },
+    { dStkFlip, DT_FLIP },
+    { dStkAbs, DT_ABS },
+    { dStkZero, DT_ZERO },
+    { dStkOne, DT_ONE },
+    { dStkLT, DT_LT },
+    { dStkLTE, DT_LTE },
+    { dStkGT, DT_GT },
+    { dStkGTE, DT_GTE },
+    { dStkEQ, DT_EQ },
+    { dStkNE, DT_NE },
+    { dStkAND, DT_AND },
+    { dStkOR, DT_OR },
+};
+
+// operators fused with a load in front of them
+static dt_function const s_dt_load_functions[] =
+{
+    { dStkAdd, DT_LOD_ADD },
+    { dStkSub, DT_LOD_SUB },
+    { dStkMul, DT_LOD_MUL },
+    { dStkSqr, DT_LOD_SQR },
+    { dStkMod, DT_LOD_MOD },
+    { dStkLT, DT_LOD_LT },
+    { dStkLTE, DT_LOD_LTE },
+    { dStkGT, DT_LOD_GT },
+    { dStkGTE, DT_LOD_GTE },
+};
+
+static std::vector<dt_instruction> s_program;
+static int s_iteration_start = 0;      // first instruction of the iteration
+static Arg s_stack[MAX_STACK];
+
+static bool dt_find(dt_function const *table, int count, void (*function)(), dt_op &op)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (table[i].function == function)
+        {
+            op = table[i].op;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run the program from instruction start until its end, or, for the
+// initialization section, until EndInit.  Returns the instruction after
+// the last one run and leaves the stack top in top.  Called with a null
+// start, fills in the labels of the program's instructions instead.
+// The value on top of the stack is kept in tos rather than in *sp.
+static int dt_run(dt_instruction const *start, Arg *&top, bool init)
+{
+#if defined(DT_COMPUTED_GOTO)
+#define DT_LABEL(name) &&dt_##name,
+    static void const *const labels[] = { DT_OPS(DT_LABEL) };
+#undef DT_LABEL
+#define DT_CASE(name) case DT_##name: dt_##name:
+#define DT_DISPATCH() goto *ip->label
+#else
+#define DT_CASE(name) case DT_##name:
+#define DT_DISPATCH() continue
+#endif
+#define DT_NEXT() ++ip; DT_DISPATCH()
+#define DT_GOTO(i) ip = &s_program[i]; DT_DISPATCH()
+
+    if (start == nullptr)
+    {
+        for (dt_instruction &ins : s_program)
+        {
+#if defined(DT_COMPUTED_GOTO)
+            ins.label = labels[ins.op];
+#else
+            ins.label = nullptr;
+#endif
+        }
+        return 0;
+    }
+
+    dt_instruction const *ip = start;
+    Arg *sp = top;
+    DComplex tos = sp->d;
+    double t;
+    for (;;)
+    {
+        switch (ip->op)
+        {
+        DT_CASE(END)
+            sp->d = tos;
+            top = sp;
+            return static_cast<int>(ip - &s_program[0]);
+
+        DT_CASE(CALL)
+            sp->d = tos;
+            Arg1 = sp;
+            Arg2 = sp - 1;
+            ip->function();
+            sp = Arg1;
+            tos = sp->d;
+            DT_NEXT();
+
+        DT_CASE(LOD)
+            sp->d = tos;
+            ++sp;
+            tos = ip->operand->d;
+            DT_NEXT();
+
+        DT_CASE(STO)
+            ip->operand->d = tos;
+            DT_NEXT();
+
+        DT_CASE(CLR)
+            sp = &s_stack[0];
+            DT_NEXT();
+
+        DT_CASE(STO_CLR)
+            ip->operand->d = tos;
+            sp = &s_stack[0];
+            DT_NEXT();
+
+        DT_CASE(STO_CLR_LOD)
+            ip->operand->d = tos;
+            s_stack[0].d = tos;
+            sp = &s_stack[1];
+            DT_NEXT();
+
+        DT_CASE(END_INIT)
+            g_last_init_op = ip->target;
+            if (init)
+            {
+                sp->d = tos;
+                top = sp;
+                return static_cast<int>(ip + 1 - &s_program[0]);
+            }
+            DT_NEXT();
+
+        DT_CASE(JUMP)
+            DT_GOTO(ip->target);
+
+        DT_CASE(JUMP_ON_FALSE)
+            if (tos.x == 0)
+            {
+                DT_GOTO(ip->target);
+            }
+            DT_NEXT();
+
+        DT_CASE(JUMP_ON_TRUE)
+            if (tos.x)
+            {
+                DT_GOTO(ip->target);
+            }
+            DT_NEXT();
+
+        DT_CASE(ADD)
+            --sp;
+            tos.x = sp->d.x + tos.x;
+            tos.y = sp->d.y + tos.y;
+            DT_NEXT();
+
+        DT_CASE(SUB)
+            --sp;
+            tos.x = sp->d.x - tos.x;
+            tos.y = sp->d.y - tos.y;
+            DT_NEXT();
+
+        DT_CASE(MUL)
+            --sp;
+            t = sp->d.x * tos.x - sp->d.y * tos.y;
+            tos.y = sp->d.x * tos.y + sp->d.y * tos.x;
+            tos.x = t;
+            DT_NEXT();
+
+        DT_CASE(DIV)
+        {
+            DComplex y = tos;       // keeps tos out of memory
+            --sp;
+            FPUcplxdiv(&sp->d, &y, &y);
+            tos = y;
+            DT_NEXT();
+        }
+
+        DT_CASE(SQR)
+        dt_sqr:
+            LASTSQR.d.x = tos.x * tos.x;
+            LASTSQR.d.y = tos.y * tos.y;
+            tos.y = tos.x * tos.y * 2.0;
+            tos.x = LASTSQR.d.x - LASTSQR.d.y;
+            LASTSQR.d.x += LASTSQR.d.y;
+            LASTSQR.d.y = 0;
+            DT_NEXT();
+
+        DT_CASE(MOD)
+        dt_mod:
+            tos.x = (tos.x * tos.x) + (tos.y * tos.y);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(NEG)
+            tos.x = -tos.x;
+            tos.y = -tos.y;
+            DT_NEXT();
+
+        DT_CASE(CONJ)
+            tos.y = -tos.y;
+            DT_NEXT();
+
+        DT_CASE(REAL)
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(IMAG)
+            tos.x = tos.y;
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(FLIP)
+            t = tos.x;
+            tos.x = tos.y;
+            tos.y = t;
+            DT_NEXT();
+
+        DT_CASE(ABS)
+            tos.x = std::fabs(tos.x);
+            tos.y = std::fabs(tos.y);
+            DT_NEXT();
+
+        DT_CASE(ZERO)
+            tos.x = 0.0;
+            tos.y = tos.x;
+            DT_NEXT();
+
+        DT_CASE(ONE)
+            tos.x = 1.0;
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LT)
+            --sp;
+            tos.x = (double)(sp->d.x < tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LTE)
+            --sp;
+            tos.x = (double)(sp->d.x <= tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(GT)
+            --sp;
+            tos.x = (double)(sp->d.x > tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(GTE)
+            --sp;
+            tos.x = (double)(sp->d.x >= tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(EQ)
+            --sp;
+            tos.x = (double)(sp->d.x == tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(NE)
+            --sp;
+            tos.x = (double)(sp->d.x != tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(AND)
+            --sp;
+            tos.x = (double)(sp->d.x && tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(OR)
+            --sp;
+            tos.x = (double)(sp->d.x || tos.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LOD_ADD)
+            tos.x += ip->operand->d.x;
+            tos.y += ip->operand->d.y;
+            DT_NEXT();
+
+        DT_CASE(LOD_SUB)
+            tos.x -= ip->operand->d.x;
+            tos.y -= ip->operand->d.y;
+            DT_NEXT();
+
+        DT_CASE(LOD_MUL)
+            t = tos.x * ip->operand->d.x - tos.y * ip->operand->d.y;
+            tos.y = tos.x * ip->operand->d.y + tos.y * ip->operand->d.x;
+            tos.x = t;
+            DT_NEXT();
+
+        DT_CASE(LOD_SQR)
+            sp->d = tos;
+            ++sp;
+            tos = ip->operand->d;
+            goto dt_sqr;
+
+        DT_CASE(LOD_MOD)
+            sp->d = tos;
+            ++sp;
+            tos = ip->operand->d;
+            goto dt_mod;
+
+        DT_CASE(LOD_LT)
+            tos.x = (double)(tos.x < ip->operand->d.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LOD_LTE)
+            tos.x = (double)(tos.x <= ip->operand->d.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LOD_GT)
+            tos.x = (double)(tos.x > ip->operand->d.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        DT_CASE(LOD_GTE)
+            tos.x = (double)(tos.x >= ip->operand->d.x);
+            tos.y = 0.0;
+            DT_NEXT();
+
+        default:
+            sp->d = tos;
+            top = sp;
+            return static_cast<int>(ip - &s_program[0]);
+        }
+    }
+#undef DT_CASE
+#undef DT_DISPATCH
+#undef DT_NEXT
+#undef DT_GOTO
+}
+
+// convert the array of ptrs; returns false if the formula can't be converted
+bool dtCvtStk()
+{
+    bool const fuse = g_debug_flag != debug_flags::prevent_formula_optimizer;
+    std::vector<int> op_start(g_last_op + 1);  // instruction of each op
+    int load_index = 0;
+    int store_index = 0;
+    int jumps = 0;
+
+    s_program.clear();
+    for (unsigned op = 0; op < g_last_op; op++)
+    {
+        void (*ftst)() = f[op];
+        dt_instruction ins = { nullptr, DT_CALL, 0, nullptr, ftst };
+        op_start[op] = static_cast<int>(s_program.size());
+        if (ftst == StkLod)
+        {
+            ins.op = DT_LOD;
+            ins.operand = Load[load_index++];
+            if (fuse
+                && op + 1 < g_last_op
+                && dt_find(s_dt_load_functions,
+                    sizeof(s_dt_load_functions)/sizeof(s_dt_load_functions[0]), f[op + 1], ins.op))
+            {
+                op++;
+                op_start[op] = op_start[op - 1];
+            }
+        }
+        else if (ftst == StkSto)
+        {
+            ins.op = DT_STO;
+            ins.operand = Store[store_index++];
+            if (fuse && op + 1 < g_last_op && f[op + 1] == StkClr)
+            {
+                ins.op = DT_STO_CLR;
+                op++;
+                op_start[op] = op_start[op - 1];
+                if (op + 1 < g_last_op && f[op + 1] == StkLod && Load[load_index] == ins.operand)
+                {
+                    // the value loaded is the one left on the stack
+                    ins.op = DT_STO_CLR_LOD;
+                    load_index++;
+                    op++;
+                    op_start[op] = op_start[op - 1];
+                }
+            }
+        }
+        else if (ftst == StkClr)
+        {
+            ins.op = DT_CLR;
+        }
+        else if (ftst == EndInit)
+        {
+            ins.op = DT_END_INIT;
+            ins.target = static_cast<int>(op);
+        }
+        else if (ftst == StkJump || ftst == dStkJumpOnFalse || ftst == dStkJumpOnTrue)
+        {
+            ins.op = ftst == StkJump ? DT_JUMP
+                : ftst == dStkJumpOnFalse ? DT_JUMP_ON_FALSE : DT_JUMP_ON_TRUE;
+            ins.target = jumps++;       // resolved below
+        }
+        else if (ftst == StkJumpLabel)
+        {
+            jumps++;                    // nothing to do but count it
+            continue;
+        }
+        else if (ftst == StkIdent && fuse)
+        {
+            continue;
+        }
+        else
+        {
+            dt_find(s_dt_functions, sizeof(s_dt_functions)/sizeof(s_dt_functions[0]), ftst, ins.op);
+        }
+        s_program.push_back(ins);
+    }
+    op_start[g_last_op] = static_cast<int>(s_program.size());
+    dt_instruction const end = { nullptr, DT_END, 0, nullptr, nullptr };
+    s_program.push_back(end);
+
+    // a jump continues after the op of the jump it goes to
+    for (dt_instruction &ins : s_program)
+    {
+        if (ins.op == DT_JUMP || ins.op == DT_JUMP_ON_FALSE || ins.op == DT_JUMP_ON_TRUE)
+        {
+            if (ins.target >= jumps)
+            {
+                s_program.clear();
+                return false;
+            }
+            ins.target = op_start[jump_control[ins.target].ptrs.JumpOpPtr + 1];
+        }
+    }
+
+    Arg *top = nullptr;
+    dt_run(nullptr, top, false);
+    s_iteration_start = 0;
+    LASTSQR.d.y = 0.0;  // do this once per image
+
+    g_cur_fractal_specific->per_pixel = dtform_per_pixel;
+    g_cur_fractal_specific->orbitcalc = dtFormula;
+    return true;
+}
+
+int dtFormula()
+{
+    if (g_formula_name.empty() || g_overflow)
+    {
+        return 1;
+    }
+
+    // Set the random number
+    if (SetRandom || Randomized)
+    {
+        dRandom();
+    }
+
+    Arg *top = &s_stack[0];
+    dt_run(&s_program[s_iteration_start], top, false);
+
+    g_ctx.new_z = v[3].a.d;
+    g_ctx.old_z = g_ctx.new_z;
+    return top->d.x == 0.0;
+}
+
+int dtform_per_pixel()
+{
+    if (g_formula_name.empty())
+    {
+        return 1;
+    }
+    g_overflow = false;
+
+    v[10].a.d.x = (double)g_col;
+    v[10].a.d.y = (double)g_row;
+    v[9].a.d.x = ((g_row+g_col)&1) ? 1.0 : 0.0;
+    v[9].a.d.y = 0.0;
+
+    if (g_invert != 0)
+    {
+        invertz2(&g_ctx.old_z);
+        v[0].a.d.x = g_ctx.old_z.x;
+        v[0].a.d.y = g_ctx.old_z.y;
+    }
+    else
+    {
+        v[0].a.d.x = g_dx_pixel();
+        v[0].a.d.y = g_dy_pixel();
+    }
+
+    // run the initialization section, up to EndInit
+    s_iteration_start = 0;
+    if (g_last_init_op)
+    {
+        g_last_init_op = g_last_op;
+        Arg *top = &s_stack[0];
+        s_iteration_start = dt_run(&s_program[0], top, true);
+    }
+    // Set old variable for orbits
+    g_ctx.old_z = v[3].a.d;
+
+    if (g_overflow)
+    {
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,795 @@
+// PARSERLANE.CPP -- Part of FRACTINT fractal drawer.
+
+// Floating point parser code that runs the iteration section of a formula
+//    for FORMULA_LANES pixels at once, for calc_lanes_batch().
+
+//   Each stack entry and each variable is a vector holding one value per
+//       pixel, and an instruction does the arithmetic of its dStk function
+//       on whole vectors, so it is dispatched once per batch rather than
+//       once per pixel.  Functions without an instruction of their own are
+//       called through Arg1 and Arg2 for one pixel after the other.
+
+//   The pixels of a batch may take different branches of an if.  Each
+//       branch is run for the pixels taking it, with a mask keeping the
+//       others' variables as they were, and skipped when none takes it.
+
+//   A formula is run this way only if no pixel depends on the pixel before
+//       it: each variable it stores is stored by a statement outside any
+//       if before it is read, and it doesn't use rand, srand or LastSqr.
+//       "debugflag=8086" calculates formulas one pixel at a time.
+#include "port.h"
+#include "prototyp.h"
+
+#include "calclane.h"
+#include "cmdfiles.h"
+#include "fractalp.h"
+#include "fractals.h"
+#include "parser.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/* not moved to PROTOTYPE.H because these only communicate within
+   PARSER.C and other parser modules */
+
+extern std::vector<Arg *> Store;
+extern std::vector<Arg *> Load;
+extern std::vector<ConstArg> v;
+extern std::vector<void (*)()> f;
+extern JUMP_CONTROL_ST jump_control[];
+extern bool SetRandom;
+extern bool Randomized;
+
+extern void StkJump();
+extern void StkJumpLabel();
+extern void dStkJumpOnFalse();
+extern void dStkJumpOnTrue();
+
+bool g_lane_formula = false;
+
+#if defined(CALC_VECTOR_LANES)
+
+#if defined(__GNUC__)
+#define LANE_COMPUTED_GOTO
+#endif
+
+#define MAX_STACK 20            // size of the parser's argument stack
+#define MAX_LANE_VARIABLES 128  // variables and constants of the iteration
+
+// instructions; as in parserdt.cpp, the ones starting with LOD load an
+//    operand and then do the operation named after it
+#define LANE_OPS(OP)                                                \
+    OP(END) OP(CALL) OP(CALL2) OP(LOD) OP(STO) OP(CLR)              \
+    OP(STO_CLR) OP(STO_CLR_LOD)                                     \
+    OP(IF) OP(ELSEIF) OP(ELSEIF_TEST) OP(ELSE) OP(ENDIF)            \
+    OP(ADD) OP(SUB) OP(MUL) OP(DIV) OP(SQR) OP(MOD) OP(CABS)        \
+    OP(NEG) OP(CONJ) OP(REAL) OP(IMAG) OP(FLIP) OP(ABS)             \
+    OP(ZERO) OP(ONE)                                                \
+    OP(LT) OP(LTE) OP(GT) OP(GTE) OP(EQ) OP(NE) OP(AND) OP(OR)      \
+    OP(LOD_ADD) OP(LOD_SUB) OP(LOD_MUL) OP(LOD_SQR) OP(LOD_MOD)     \
+    OP(LOD_LT) OP(LOD_LTE) OP(LOD_GT) OP(LOD_GTE)
+
+#define LANE_ENUM(name) LANE_##name,
+enum lane_op
+{
+    LANE_OPS(LANE_ENUM)
+    LANE_NUM_OPS
+};
+#undef LANE_ENUM
+
+namespace
+{
+
+typedef double lane_real __attribute__((vector_size(FORMULA_LANES*sizeof(double))));
+typedef long long lane_mask __attribute__((vector_size(FORMULA_LANES*sizeof(long long))));
+
+struct lane_instruction
+{
+    lane_op op;
+    int operand;                // lane variable loaded or stored
+    int target;                 // instruction jumped to when no pixel takes a branch
+    int depth;                  // stack depth when the instruction starts
+    void (*function)();         // dStk function called by CALL and CALL2
+};
+
+// the dStk functions with an instruction of their own
+struct lane_function
+{
+    void (*function)();
+    lane_op op;
+};
+
+struct lane_complex             // a value for each pixel
+{
+    lane_real x;
+    lane_real y;
+};
+
+struct lane_group               // an if being run
+{
+    lane_mask outer;            // pixels running the if, -1 where they are
+    lane_mask taken;            // pixels that took one of its branches
+};
+
+} // namespace
+
+static lane_function const s_lane_functions[] =
+{
+    { dStkAdd, LANE_ADD },
+    { dStkSub, LANE_SUB },
+    { dStkMul, LANE_MUL },
+    { dStkDiv, LANE_DIV },
+    { dStkSqr, LANE_SQR },
+    { dStkMod, LANE_MOD },
+    { dStkCAbs, LANE_CABS },
+    { dStkNeg, LANE_NEG },
+    { dStkConj, LANE_CONJ },
+    { dStkReal, LANE_REAL },
+    { dStkImag, LANE_IMAG },
+    { dStkFlip, LANE_FLIP },
+    { dStkAbs, LANE_ABS },
+    { dStkZero, LANE_ZERO },
+    { dStkOne, LANE_ONE },
+    { dStkLT, LANE_LT },
+    { dStkLTE, LANE_LTE },
+    { dStkGT, LANE_GT },
+    { dStkGTE, LANE_GTE },
+    { dStkEQ, LANE_EQ },
+    { dStkNE, LANE_NE },
+    { dStkAND, LANE_AND },
+    { dStkOR, LANE_OR },
+};
+
+// operators fused with a load in front of them
+static lane_function const s_lane_load_functions[] =
+{
+    { dStkAdd, LANE_LOD_ADD },
+    { dStkSub, LANE_LOD_SUB },
+    { dStkMul, LANE_LOD_MUL },
+    { dStkSqr, LANE_LOD_SQR },
+    { dStkMod, LANE_LOD_MOD },
+    { dStkLT, LANE_LOD_LT },
+    { dStkLTE, LANE_LOD_LTE },
+    { dStkGT, LANE_LOD_GT },
+    { dStkGTE, LANE_LOD_GTE },
+};
+
+static std::vector<lane_instruction> s_program;
+static std::vector<int> s_variables;           // v[] index of each lane variable
+static lane_complex s_values[MAX_LANE_VARIABLES];
+static int s_z = 0;                             // lane variable of z
+static lane_complex s_stack[MAX_STACK];
+static lane_group s_groups[MAX_JUMPS];
+
+static bool lane_find(lane_function const *table, int count, void (*function)(), lane_op &op)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (table[i].function == function)
+        {
+            op = table[i].op;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int lane_var_index(Arg const *arg)
+{
+    for (unsigned i = 0; i < g_variable_index; i++)
+    {
+        if (&v[i].a == arg)
+        {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+static int lane_variable(std::vector<int> &lanes, int var)
+{
+    if (lanes[var] < 0)
+    {
+        lanes[var] = static_cast<int>(s_variables.size());
+        s_variables.push_back(var);
+    }
+    return lanes[var];
+}
+
+// copied member by member: a copy of the struct as a whole is made in
+// 16 byte pieces, which the 32 byte loads of the vectors then wait for
+LANE_CODE static inline void lane_copy(lane_complex &to, lane_complex const &from)
+{
+    to.x = from.x;
+    to.y = from.y;
+}
+
+// true if no lane of mask is set
+LANE_CODE static inline bool lane_none(lane_mask mask)
+{
+    long long any = 0;
+    for (int i = 0; i < FORMULA_LANES; ++i)
+    {
+        any |= mask[i];
+    }
+    return any == 0;
+}
+
+// Call a dStk function for each running pixel, on the top args entries of
+// the stack.  A pixel for which it sets g_overflow has bailed out.
+LANE_CODE static void lane_call(void (*function)(), int args, lane_complex *top, lane_mask mask, lane_mask &overflow)
+{
+    Arg *const arg1 = Arg1;
+    Arg *const arg2 = Arg2;
+    bool const old_overflow = g_overflow;
+    Arg stack[3];
+    for (int i = 0; i < FORMULA_LANES; ++i)
+    {
+        if (mask[i] == 0)
+        {
+            continue;
+        }
+        for (int a = 0; a < args; ++a)
+        {
+            stack[a + 1].d.x = top[a + 1 - args].x[i];
+            stack[a + 1].d.y = top[a + 1 - args].y[i];
+        }
+        Arg1 = &stack[args];
+        Arg2 = Arg1 - 1;
+        g_overflow = false;
+        function();
+        top[1 - args].x[i] = stack[1].d.x;
+        top[1 - args].y[i] = stack[1].d.y;
+        if (g_overflow)
+        {
+            overflow[i] = -1;
+        }
+    }
+    Arg1 = arg1;
+    Arg2 = arg2;
+    g_overflow = old_overflow;
+}
+
+// Run the iteration section once for every pixel of the batch, leaving
+// each pixel's z in new_x/new_y and -1 in escaped where it bailed out.
+// Like dt_run(), keeps the value on top of the stack in tos rather than
+// in s_stack[sp].
+LANE_CODE void laneFormula(double *new_x, double *new_y, long long *escaped)
+{
+#if defined(LANE_COMPUTED_GOTO)
+#define LANE_LABEL(name) &&lane_##name,
+    static void const *const labels[] = { LANE_OPS(LANE_LABEL) };
+#undef LANE_LABEL
+#define LANE_CASE(name) case LANE_##name: lane_##name:
+#define LANE_DISPATCH() goto *labels[ip->op]
+#else
+#define LANE_CASE(name) case LANE_##name:
+#define LANE_DISPATCH() continue
+#endif
+#define LANE_NEXT() ++ip; LANE_DISPATCH()
+// no pixel takes the branch: go on from the instruction's target
+#define LANE_SKIP()                                                 \
+    if (lane_none(mask))                                            \
+    {                                                               \
+        ip = &s_program[ip->target];                                \
+        sp = ip->depth;                                             \
+        LANE_DISPATCH();                                            \
+    }                                                               \
+    LANE_NEXT()
+
+    lane_real const zero = lane_real{};
+    lane_real const one = zero + 1.0;
+    lane_mask const sign = lane_mask{} + (1LL << 63);
+    lane_mask mask = lane_mask{} - 1;
+    lane_mask overflow = lane_mask{};
+    lane_complex tos;
+    lane_copy(tos, s_stack[0]);
+    lane_instruction const *ip = &s_program[0];
+    lane_group *group = &s_groups[0] - 1;
+    int sp = 0;
+    lane_real t;
+    for (;;)
+    {
+        switch (ip->op)
+        {
+        LANE_CASE(END)
+        {
+            lane_mask const bailout = (tos.x == zero) | overflow;
+            std::memcpy(new_x, &s_values[s_z].x, sizeof(lane_real));
+            std::memcpy(new_y, &s_values[s_z].y, sizeof(lane_real));
+            std::memcpy(escaped, &bailout, sizeof(lane_mask));
+            lane_copy(s_stack[sp], tos);
+            return;
+        }
+
+        LANE_CASE(CALL)
+            lane_copy(s_stack[sp], tos);
+            lane_call(ip->function, 1, &s_stack[sp], mask, overflow);
+            lane_copy(tos, s_stack[sp]);
+            LANE_NEXT();
+
+        LANE_CASE(CALL2)
+            lane_copy(s_stack[sp], tos);
+            lane_call(ip->function, 2, &s_stack[sp], mask, overflow);
+            lane_copy(tos, s_stack[--sp]);
+            LANE_NEXT();
+
+        LANE_CASE(LOD)
+            lane_copy(s_stack[sp++], tos);
+            lane_copy(tos, s_values[ip->operand]);
+            LANE_NEXT();
+
+        LANE_CASE(STO)
+        {
+            lane_complex &var = s_values[ip->operand];
+            var.x = mask ? tos.x : var.x;
+            var.y = mask ? tos.y : var.y;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(CLR)
+            sp = 0;
+            LANE_NEXT();
+
+        LANE_CASE(STO_CLR)
+        {
+            lane_complex &var = s_values[ip->operand];
+            var.x = mask ? tos.x : var.x;
+            var.y = mask ? tos.y : var.y;
+            sp = 0;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(STO_CLR_LOD)
+        {
+            // the value loaded is the one stored where the mask is set
+            lane_complex &var = s_values[ip->operand];
+            var.x = mask ? tos.x : var.x;
+            var.y = mask ? tos.y : var.y;
+            lane_copy(s_stack[0], tos);
+            lane_copy(tos, var);
+            sp = 1;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(IF)
+            ++group;
+            group->outer = mask;
+            mask &= tos.x != zero;
+            group->taken = mask;
+            LANE_SKIP();
+
+        LANE_CASE(ELSEIF)
+        LANE_CASE(ELSE)
+            mask = group->outer & ~group->taken;
+            LANE_SKIP();
+
+        LANE_CASE(ELSEIF_TEST)
+            mask &= tos.x != zero;
+            group->taken |= mask;
+            LANE_SKIP();
+
+        LANE_CASE(ENDIF)
+            mask = group->outer;
+            --group;
+            LANE_NEXT();
+
+        LANE_CASE(ADD)
+            --sp;
+            tos.x = s_stack[sp].x + tos.x;
+            tos.y = s_stack[sp].y + tos.y;
+            LANE_NEXT();
+
+        LANE_CASE(SUB)
+            --sp;
+            tos.x = s_stack[sp].x - tos.x;
+            tos.y = s_stack[sp].y - tos.y;
+            LANE_NEXT();
+
+        LANE_CASE(MUL)
+            --sp;
+            t = s_stack[sp].x * tos.x - s_stack[sp].y * tos.y;
+            tos.y = s_stack[sp].x * tos.y + s_stack[sp].y * tos.x;
+            tos.x = t;
+            LANE_NEXT();
+
+        LANE_CASE(DIV)
+        {
+            // FPUcplxdiv()
+            --sp;
+            lane_real const mod = tos.x * tos.x + tos.y * tos.y;
+            lane_real const yxmod = tos.x / mod;
+            lane_real const yymod = - tos.y / mod;
+            t = s_stack[sp].x * yxmod - s_stack[sp].y * yymod;
+            tos.y = s_stack[sp].x * yymod + s_stack[sp].y * yxmod;
+            tos.x = t;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(SQR)
+        lane_sqr:
+        {
+            lane_real const sqr_x = tos.x * tos.x;
+            lane_real const sqr_y = tos.y * tos.y;
+            tos.y = tos.x * tos.y * 2.0;
+            tos.x = sqr_x - sqr_y;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(MOD)
+        lane_mod:
+            tos.x = (tos.x * tos.x) + (tos.y * tos.y);
+            tos.y = zero;
+            LANE_NEXT();
+
+        LANE_CASE(CABS)
+            tos.x = tos.x * tos.x + tos.y * tos.y;
+            for (int i = 0; i < FORMULA_LANES; ++i)
+            {
+                tos.x[i] = std::sqrt(tos.x[i]);
+            }
+            tos.y = zero;
+            LANE_NEXT();
+
+        LANE_CASE(NEG)
+            tos.x = -tos.x;
+            tos.y = -tos.y;
+            LANE_NEXT();
+
+        LANE_CASE(CONJ)
+            tos.y = -tos.y;
+            LANE_NEXT();
+
+        LANE_CASE(REAL)
+            tos.y = zero;
+            LANE_NEXT();
+
+        LANE_CASE(IMAG)
+            tos.x = tos.y;
+            tos.y = zero;
+            LANE_NEXT();
+
+        LANE_CASE(FLIP)
+            t = tos.x;
+            tos.x = tos.y;
+            tos.y = t;
+            LANE_NEXT();
+
+        LANE_CASE(ABS)
+            // clears the sign bit, as fabs() does
+            tos.x = (lane_real) ((lane_mask) tos.x & ~sign);
+            tos.y = (lane_real) ((lane_mask) tos.y & ~sign);
+            LANE_NEXT();
+
+        LANE_CASE(ZERO)
+            tos.x = zero;
+            tos.y = zero;
+            LANE_NEXT();
+
+        LANE_CASE(ONE)
+            tos.x = one;
+            tos.y = zero;
+            LANE_NEXT();
+
+#define LANE_COMPARE(name, test)                                    \
+        LANE_CASE(name)                                             \
+            --sp;                                                   \
+            tos.x = (test) ? one : zero;                            \
+            tos.y = zero;                                           \
+            LANE_NEXT();
+        LANE_COMPARE(LT, s_stack[sp].x < tos.x)
+        LANE_COMPARE(LTE, s_stack[sp].x <= tos.x)
+        LANE_COMPARE(GT, s_stack[sp].x > tos.x)
+        LANE_COMPARE(GTE, s_stack[sp].x >= tos.x)
+        LANE_COMPARE(EQ, s_stack[sp].x == tos.x)
+        LANE_COMPARE(NE, s_stack[sp].x != tos.x)
+        LANE_COMPARE(AND, (s_stack[sp].x != zero) & (tos.x != zero))
+        LANE_COMPARE(OR, (s_stack[sp].x != zero) | (tos.x != zero))
+#undef LANE_COMPARE
+
+        LANE_CASE(LOD_ADD)
+            tos.x += s_values[ip->operand].x;
+            tos.y += s_values[ip->operand].y;
+            LANE_NEXT();
+
+        LANE_CASE(LOD_SUB)
+            tos.x -= s_values[ip->operand].x;
+            tos.y -= s_values[ip->operand].y;
+            LANE_NEXT();
+
+        LANE_CASE(LOD_MUL)
+        {
+            lane_complex const &b = s_values[ip->operand];
+            t = tos.x * b.x - tos.y * b.y;
+            tos.y = tos.x * b.y + tos.y * b.x;
+            tos.x = t;
+            LANE_NEXT();
+        }
+
+        LANE_CASE(LOD_SQR)
+            lane_copy(s_stack[sp++], tos);
+            lane_copy(tos, s_values[ip->operand]);
+            goto lane_sqr;
+
+        LANE_CASE(LOD_MOD)
+            lane_copy(s_stack[sp++], tos);
+            lane_copy(tos, s_values[ip->operand]);
+            goto lane_mod;
+
+#define LANE_LOAD_COMPARE(name, test)                               \
+        LANE_CASE(name)                                             \
+            tos.x = (test) ? one : zero;                            \
+            tos.y = zero;                                           \
+            LANE_NEXT();
+        LANE_LOAD_COMPARE(LOD_LT, tos.x < s_values[ip->operand].x)
+        LANE_LOAD_COMPARE(LOD_LTE, tos.x <= s_values[ip->operand].x)
+        LANE_LOAD_COMPARE(LOD_GT, tos.x > s_values[ip->operand].x)
+        LANE_LOAD_COMPARE(LOD_GTE, tos.x >= s_values[ip->operand].x)
+#undef LANE_LOAD_COMPARE
+
+        default:
+            return;
+        }
+    }
+#undef LANE_CASE
+#undef LANE_DISPATCH
+#undef LANE_NEXT
+#undef LANE_SKIP
+}
+
+// Copy the variables of the pixel just set up by dtform_per_pixel() into
+// lane lane of the batch.
+void lane_form_per_pixel(int lane)
+{
+    for (unsigned i = 0; i < s_variables.size(); i++)
+    {
+        s_values[i].x[lane] = v[s_variables[i]].a.d.x;
+        s_values[i].y[lane] = v[s_variables[i]].a.d.y;
+    }
+}
+
+// Convert the iteration section of the program dtCvtStk() runs into lane
+// instructions; returns false, leaving g_lane_formula false, if the
+// formula can't be run for several pixels at once.
+bool laneCvtStk()
+{
+    enum
+    {
+        UNUSED,
+        READ,                   // read before it is stored
+        STORED,                 // stored by a statement outside any if first
+        STORED_IN_IF            // stored inside an if first
+    };
+
+    g_lane_formula = false;
+    s_program.clear();
+    s_variables.clear();
+    if (SetRandom || Randomized || g_last_op == 0)
+    {
+        return false;
+    }
+
+    // find the iteration section and check how variables are first used
+    std::vector<int> access(v.size(), UNUSED);
+    std::vector<bool> stored(v.size(), false);
+    unsigned start = 0;         // first op of the iteration section
+    int start_load = 0;
+    int start_store = 0;
+    int start_jump = 0;
+    bool init = g_last_init_op != 0;
+    int load_index = 0;
+    int store_index = 0;
+    int jumps = 0;
+    int depth = 0;
+    unsigned last_jump = 0;     // op after the last jump
+    unsigned last_load = 0;     // op after the last load
+    for (unsigned op = 0; op < g_last_op; op++)
+    {
+        void (*fn)() = f[op];
+        if (fn == StkLod || fn == StkSto)
+        {
+            int const var = lane_var_index(fn == StkLod ? Load[load_index++] : Store[store_index++]);
+            if (var < 0 || var == 4 || var == 7)
+            {
+                return false;   // LastSqr and rand change every iteration
+            }
+            if (access[var] == UNUSED)
+            {
+                access[var] = fn == StkLod ? READ : depth == 0 ? STORED : STORED_IN_IF;
+            }
+            if (fn == StkSto)
+            {
+                stored[var] = true;
+            }
+            else
+            {
+                last_load = op + 1;
+            }
+        }
+        else if (fn == EndInit)
+        {
+            if (!init || depth != 0)
+            {
+                return false;
+            }
+            init = false;
+            start = op + 1;
+            start_load = load_index;
+            start_store = store_index;
+            start_jump = jumps;
+        }
+        else if (fn == StkJump || fn == StkJumpLabel || fn == dStkJumpOnFalse)
+        {
+            int const type = jump_control[jumps++].type;
+            depth += type == 1 ? 1 : type == 4 ? -1 : 0;
+            last_jump = op + 1;
+        }
+        else if (fn != StkClr && formula_fn_args(fn) == 0)
+        {
+            return false;
+        }
+        else if (init && fn != StkClr && !formula_fn_is_pure(fn))
+        {
+            return false;       // would bail out in the init section
+        }
+    }
+    if (init || last_load <= last_jump || last_load <= start)
+    {
+        return false;           // the bailout test isn't a plain statement
+    }
+    for (unsigned var = 0; var < v.size(); var++)
+    {
+        // pixel, whitesq and scrnpix are set for each pixel
+        if (stored[var] && access[var] != STORED && var != 0 && var != 9 && var != 10)
+        {
+            return false;
+        }
+    }
+
+    // convert the iteration section, fusing loads and stores like dtCvtStk()
+    bool const fuse = g_debug_flag != debug_flags::prevent_formula_optimizer;
+    std::vector<int> lanes(v.size(), -1);
+    s_z = lane_variable(lanes, 3);
+    load_index = start_load;
+    store_index = start_store;
+    jumps = start_jump;
+    int sp = 0;
+    for (unsigned op = start; op < g_last_op; op++)
+    {
+        void (*fn)() = f[op];
+        lane_instruction ins = { LANE_CALL, 0, 0, sp, fn };
+        if (fn == StkLod)
+        {
+            ins.op = LANE_LOD;
+            ins.operand = lane_variable(lanes, lane_var_index(Load[load_index++]));
+            ++sp;
+            if (fuse
+                && op + 1 < g_last_op
+                && lane_find(s_lane_load_functions,
+                    sizeof(s_lane_load_functions)/sizeof(s_lane_load_functions[0]), f[op + 1], ins.op))
+            {
+                op++;
+                if (ins.op != LANE_LOD_SQR && ins.op != LANE_LOD_MOD)
+                {
+                    --sp;
+                }
+            }
+        }
+        else if (fn == StkSto)
+        {
+            ins.op = LANE_STO;
+            ins.operand = lane_variable(lanes, lane_var_index(Store[store_index++]));
+            if (fuse && op + 1 < g_last_op && f[op + 1] == StkClr)
+            {
+                ins.op = LANE_STO_CLR;
+                op++;
+                sp = 0;
+                if (op + 1 < g_last_op && f[op + 1] == StkLod && Load[load_index] == Store[store_index - 1])
+                {
+                    ins.op = LANE_STO_CLR_LOD;
+                    load_index++;
+                    op++;
+                    sp = 1;
+                }
+            }
+        }
+        else if (fn == StkClr)
+        {
+            ins.op = LANE_CLR;
+            sp = 0;
+        }
+        else if (fn == StkJump || fn == StkJumpLabel || fn == dStkJumpOnFalse)
+        {
+            int const type = jump_control[jumps++].type;
+            ins.op = type == 1 ? LANE_IF
+                : type == 3 ? LANE_ELSE
+                : type == 4 ? LANE_ENDIF
+                : fn == StkJump ? LANE_ELSEIF : LANE_ELSEIF_TEST;
+        }
+        else if (fn == StkIdent && fuse)
+        {
+            continue;
+        }
+        else
+        {
+            bool const binary = formula_fn_args(fn) == 2;
+            ins.op = binary ? LANE_CALL2 : LANE_CALL;
+            lane_find(s_lane_functions, sizeof(s_lane_functions)/sizeof(s_lane_functions[0]), fn, ins.op);
+            sp -= binary ? 1 : 0;
+        }
+        if (sp < 0 || sp >= MAX_STACK)
+        {
+            return false;
+        }
+        s_program.push_back(ins);
+    }
+    lane_instruction const end = { LANE_END, 0, 0, sp, nullptr };
+    s_program.push_back(end);
+
+    // a branch that no pixel takes jumps to the next elseif, else or endif
+    // of its if; elseif and else jump to the endif when no pixel is left
+    struct open_if
+    {
+        int test;               // if or elseif test waiting for its target
+        std::vector<int> exits; // elseifs and elses waiting for the endif
+    };
+    std::vector<open_if> open;
+    for (unsigned i = 0; i < s_program.size(); i++)
+    {
+        lane_op const op = s_program[i].op;
+        if (op == LANE_IF)
+        {
+            open.push_back(open_if{static_cast<int>(i), {}});
+            continue;
+        }
+        if (op != LANE_ELSEIF && op != LANE_ELSEIF_TEST
+            && op != LANE_ELSE && op != LANE_ENDIF)
+        {
+            continue;
+        }
+        if (open.empty())
+        {
+            return false;
+        }
+        open_if &group = open.back();
+        if (op == LANE_ELSEIF_TEST)
+        {
+            group.test = static_cast<int>(i);
+            continue;
+        }
+        if (group.test >= 0)
+        {
+            s_program[group.test].target = static_cast<int>(i);
+            group.test = -1;
+        }
+        if (op == LANE_ENDIF)
+        {
+            for (int exit : group.exits)
+            {
+                s_program[exit].target = static_cast<int>(i);
+            }
+            open.pop_back();
+        }
+        else
+        {
+            group.exits.push_back(static_cast<int>(i));
+        }
+    }
+    if (!open.empty() || s_variables.size() > MAX_LANE_VARIABLES)
+    {
+        return false;
+    }
+    g_lane_formula = true;
+    return true;
+}
+
+#else
+
+bool laneCvtStk()
+{
+    g_lane_formula = false;
+    return false;
+}
+
+#endif
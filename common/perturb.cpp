@@ -0,0 +1,353 @@
+// Perturbation for deep zooms of the Mandelbrot, Julia and power types.
+//
+// With arbitrary precision math every pixel of a deep zoom iterates its own
+// bignum or bigflt orbit.  Instead, perturb_pixel() iterates one reference
+// orbit, at the pixel in the middle of the image, with the arbitrary
+// precision routines and keeps it as doubles.  Each pixel then follows only
+// its difference dz from the reference,
+//      dz' = (Z + dz)^n - Z^n + dc = (2Z + dz) dz + dc    for n = 2
+// which stays small enough for hardware floating point.  dc is the pixel's
+// distance from the reference pixel; a Julia pixel starts out that far
+// from the reference instead.  A pixel that gets closer to 0 than to the
+// reference (Z + dz smaller than dz) has lost the precision of its
+// difference, the glitch this method is known for.  A Mandelbrot pixel then
+// rebases: it carries on from the start of the reference, Z = 0, with
+// dz = Z + dz, as it also does when it outlives the reference.  0 is not on
+// a Julia reference orbit, so a Julia pixel that glitches or outlives the
+// reference is calculated with arbitrary precision after all.  Periodicity
+// is not checked; a pixel inside the set runs to maxit.
+//
+// The differences are doubles while the spacing of the pixels is in their
+// range, and long doubles past that where long doubles go further.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "calcfrac.h"
+#include "cmdfiles.h"
+#include "fractalp.h"
+#include "fractals.h"
+#include "fractype.h"
+#include "framain2.h"
+#include "id_data.h"
+#include "perturb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#define MAX_REFERENCE_ORBIT (1L << 24)  // Mandelbrot pixels rebase past this
+
+namespace
+{
+
+enum class perturb_state
+{
+    unknown,                            // not looked at yet for this image
+    off,                                // arbitrary precision for every pixel
+    double_deltas,
+    long_double_deltas
+};
+
+}
+
+static perturb_state s_state = perturb_state::unknown;
+static std::vector<DComplex> s_reference;   // Z by orbit index
+static bool s_rebase = false;           // Mandelbrot type, s_reference[0] is 0
+static int s_power = 2;
+static int s_ref_col = 0;
+static int s_ref_row = 0;
+static LDBL s_del_x = 0;                // the pixel spacing, as the per_pixel
+static LDBL s_del_x2 = 0;               // routines step it
+static LDBL s_del_y = 0;
+static LDBL s_del_y2 = 0;
+
+// true if a delta this small keeps its precision in an R
+template <typename R>
+static bool in_range(LDBL delta)
+{
+    return delta >= std::ldexp((LDBL) 1, std::numeric_limits<R>::min_exponent + 64);
+}
+
+// how the pixels of the current image are calculated
+static perturb_state choose_state()
+{
+    if (g_debug_flag == debug_flags::prevent_perturbation
+        || bf_math == bf_math_type::NONE)
+    {
+        return perturb_state::off;
+    }
+    switch (g_fractal_type)
+    {
+    case fractal_type::MANDELFP:
+        s_rebase = true;
+        s_power = 2;
+        break;
+    case fractal_type::JULIAFP:
+        s_rebase = false;
+        s_power = 2;
+        break;
+    case fractal_type::FPMANDELZPOWER:
+    case fractal_type::FPJULIAZPOWER:
+        if (g_params[3] != 0.0 || (double) g_c_exponent != g_params[2] || g_c_exponent < 2)
+        {
+            return perturb_state::off;  // not z^n
+        }
+        s_rebase = g_fractal_type == fractal_type::FPMANDELZPOWER;
+        s_power = g_c_exponent;
+        break;
+    default:
+        return perturb_state::off;
+    }
+    if ((s_rebase && (g_params[0] != 0.0 || g_params[1] != 0.0))  // z doesn't start at 0
+        || g_invert != 0
+        || g_distance_estimator
+        || g_attractors > 0
+        || (g_inside_color < ITER && g_inside_color != ZMAG && g_inside_color != ATANI)
+        || g_outside_color == TDIS
+        || g_outside_color == FMOD)
+    {
+        return perturb_state::off;      // needs more than the last z
+    }
+
+    if (bf_math == bf_math_type::BIGNUM)
+    {
+        s_del_x = bntofloat(bnxdel);
+        s_del_x2 = bntofloat(bnxdel2);
+        s_del_y = bntofloat(bnydel);
+        s_del_y2 = bntofloat(bnydel2);
+    }
+    else
+    {
+        s_del_x = bftofloat(bfxdel);
+        s_del_x2 = bftofloat(bfxdel2);
+        s_del_y = bftofloat(bfydel);
+        s_del_y2 = bftofloat(bfydel2);
+    }
+    LDBL const spacing = std::max(std::max(std::fabs(s_del_x), std::fabs(s_del_x2)),
+                                  std::max(std::fabs(s_del_y), std::fabs(s_del_y2)));
+    if (in_range<double>(spacing))
+    {
+        return perturb_state::double_deltas;
+    }
+    if (std::numeric_limits<LDBL>::min_exponent < std::numeric_limits<double>::min_exponent
+        && in_range<LDBL>(spacing))
+    {
+        return perturb_state::long_double_deltas;
+    }
+    return perturb_state::off;
+}
+
+static DComplex old_value()
+{
+    return bf_math == bf_math_type::BIGNUM ? cmplxbntofloat(&bnold) : cmplxbftofloat(&bfold);
+}
+
+static DComplex new_value()
+{
+    return bf_math == bf_math_type::BIGNUM ? cmplxbntofloat(&bnnew) : cmplxbftofloat(&bfnew);
+}
+
+// Iterate the reference orbit at the middle pixel with the arbitrary
+// precision per_pixel and orbitcalc routines, starting with
+// g_ctx.color_iter as standard_fractal() does.  Returns -1 if interrupted.
+static int make_reference()
+{
+    int const col = g_col;
+    int const row = g_row;
+    s_ref_col = g_logical_screen_x_dots/2;
+    s_ref_row = g_logical_screen_y_dots/2;
+    g_col = s_ref_col;
+    g_row = s_ref_row;
+    g_cur_fractal_specific->per_pixel();
+    g_col = col;
+    g_row = row;
+
+    s_reference.clear();
+    if (s_rebase)
+    {
+        s_reference.push_back(DComplex {0.0, 0.0});    // z before the per_pixel iteration
+    }
+    s_reference.push_back(old_value());
+    long iter = g_ctx.color_iter;
+    while (++iter < g_max_iterations && (long) s_reference.size() < MAX_REFERENCE_ORBIT)
+    {
+        if (iter % 2048 == 0 && check_key())
+        {
+            return -1;
+        }
+        bool const escaped = g_cur_fractal_specific->orbitcalc() != 0;
+        s_reference.push_back(new_value());
+        if (escaped)
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
+// the arbitrary precision bailout routines' test, on z
+template <typename R>
+static bool escaped(R x, R y)
+{
+    // the routines truncate the magnitude to a long, so >= compares the same
+    R const limit = (R)(long) g_ctx.magnitude_limit;
+    switch (g_bail_out_test)
+    {
+    case bailouts::Real:
+        return x*x >= limit;
+    case bailouts::Imag:
+        return y*y >= limit;
+    case bailouts::Or:
+        return x*x >= limit || y*y >= limit;
+    case bailouts::And:
+        return x*x >= limit && y*y >= limit;
+    case bailouts::Manh:
+    {
+        R const sum = std::fabs(x) + std::fabs(y);
+        return sum*sum >= limit;
+    }
+    case bailouts::Manr:
+        return (x + y)*(x + y) >= limit;
+    case bailouts::Mod:
+    default:
+        return x*x + y*y >= limit;
+    }
+}
+
+// Follow the pixel at (dx, dy) from the reference the way standard_fractal()
+// iterates it from color_iter, leaving color_iter and z as its loop does.
+// Returns 1 if done, 0 if the pixel must be calculated with arbitrary
+// precision, -1 if interrupted.
+template <typename R>
+static int perturb_orbit(R dx, R dy, long &color_iter, DComplex &z)
+{
+    R const dcx = s_rebase ? dx : 0;
+    R const dcy = s_rebase ? dy : 0;
+    std::size_t const last = s_reference.size() - 1;
+    std::size_t m = s_rebase ? 1 : 0;   // reference index the pixel is at
+    R zx = s_reference[m].x + dx;
+    R zy = s_reference[m].y + dy;
+    while (++color_iter < g_max_iterations)
+    {
+        if (color_iter % 2048 == 0 && check_key())
+        {
+            return -1;
+        }
+        if (m == last)                  // outlived the reference
+        {
+            if (!s_rebase)
+            {
+                return 0;
+            }
+            dx = zx;
+            dy = zy;
+            m = 0;
+        }
+
+        // dz' = ((Z + dz)^n - Z^n) + dc = dz*s + dc with
+        // s = sum of z^k Z^(n-1-k) for k = 0..n-1
+        R const Zx = s_reference[m].x;
+        R const Zy = s_reference[m].y;
+        R sx = zx + Zx;
+        R sy = zy + Zy;
+        if (s_power > 2)
+        {
+            R px = Zx;                  // Z^k
+            R py = Zy;
+            sx = 1;
+            sy = 0;
+            for (int k = 1; k < s_power; ++k)
+            {
+                R const tx = sx*zx - sy*zy + px;
+                sy = sx*zy + sy*zx + py;
+                sx = tx;
+                R const qx = px*Zx - py*Zy;
+                py = px*Zy + py*Zx;
+                px = qx;
+            }
+        }
+        R const nx = dx*sx - dy*sy + dcx;
+        dy = dx*sy + dy*sx + dcy;
+        dx = nx;
+        ++m;
+
+        zx = s_reference[m].x + dx;
+        zy = s_reference[m].y + dy;
+        if (escaped(zx, zy))
+        {
+            break;
+        }
+        if (zx*zx + zy*zy < dx*dx + dy*dy)  // glitch
+        {
+            if (!s_rebase)
+            {
+                return 0;
+            }
+            dx = zx;
+            dy = zy;
+            m = 0;
+        }
+    }
+    z.x = (double) zx;
+    z.y = (double) zy;
+    return 1;
+}
+
+// forget the reference orbit, called before calculating an image
+void perturb_start_image()
+{
+    s_state = perturb_state::unknown;
+    s_reference.clear();
+}
+
+// Calculate the pixel at g_col, g_row by perturbation if the image can
+// be, starting with g_ctx.color_iter as standard_fractal() does.  Returns
+// 1 with g_ctx.color_iter and the new z set as standard_fractal()'s loop
+// leaves them, 0 if the pixel must be calculated with arbitrary precision,
+// -1 if interrupted.
+int perturb_pixel()
+{
+    if (s_state == perturb_state::unknown)
+    {
+        perturb_state const state = choose_state();
+        if (state != perturb_state::off && make_reference() == -1)
+        {
+            return -1;                  // try again next pixel
+        }
+        s_state = state;
+    }
+    if (s_state == perturb_state::off || g_show_orbit)
+    {
+        return 0;
+    }
+
+    LDBL const col = g_col - s_ref_col;
+    LDBL const row = g_row - s_ref_row;
+    LDBL const dx = col*s_del_x + row*s_del_x2;
+    LDBL const dy = -row*s_del_y - col*s_del_y2;
+    long color_iter = g_ctx.color_iter;
+    DComplex z;
+    int const status = s_state == perturb_state::double_deltas
+        ? perturb_orbit<double>((double) dx, (double) dy, color_iter, z)
+        : perturb_orbit<LDBL>(dx, dy, color_iter, z);
+    if (status != 1)
+    {
+        return status;
+    }
+
+    g_ctx.color_iter = color_iter;
+    g_ctx.new_z = z;
+    if (bf_math == bf_math_type::BIGNUM)  // for the coloring's conversions
+    {
+        floattobn(bnnew.x, z.x);
+        floattobn(bnnew.y, z.y);
+    }
+    else
+    {
+        floattobf(bfnew.x, z.x);
+        floattobf(bfnew.y, z.y);
+    }
+    return 1;
+}
@@ -2242,11 +2242,6 @@ long get_file_entry(int type, char const *title, char const *fmask,
     return result;
 }
 
-struct entryinfo
-{
-    char name[ITEM_NAME_LEN+2];
-    long point; // points to the ( or the { following the name
-};
 static entryinfo **gfe_choices; // for format_getparm_line
 static char const *gfe_title;
 
@@ -2276,8 +2271,6 @@ int skip_comment(std::FILE *infile, long *file_offset)
     return c;
 }
 
-#define MAXENTRIES 2000L
-
 int scan_entries(std::FILE *infile, entryinfo *choices, char const *itemname)
 {
     /*
@@ -3619,10 +3612,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpMODbailout;
+            g_ctx.bailout = asmfpMODbailout;
         }
         else
         {
             floatbailout = fpMODbailout;
+            g_ctx.bailout = fpMODbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3640,10 +3635,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpREALbailout;
+            g_ctx.bailout = asmfpREALbailout;
         }
         else
         {
             floatbailout = fpREALbailout;
+            g_ctx.bailout = fpREALbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3661,10 +3658,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpIMAGbailout;
+            g_ctx.bailout = asmfpIMAGbailout;
         }
         else
         {
             floatbailout = fpIMAGbailout;
+            g_ctx.bailout = fpIMAGbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3682,10 +3681,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpORbailout;
+            g_ctx.bailout = asmfpORbailout;
         }
         else
         {
             floatbailout = fpORbailout;
+            g_ctx.bailout = fpORbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3703,10 +3704,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpANDbailout;
+            g_ctx.bailout = asmfpANDbailout;
         }
         else
         {
             floatbailout = fpANDbailout;
+            g_ctx.bailout = fpANDbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3724,10 +3727,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpMANHbailout;
+            g_ctx.bailout = asmfpMANHbailout;
         }
         else
         {
             floatbailout = fpMANHbailout;
+            g_ctx.bailout = fpMANHbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
@@ -3745,10 +3750,12 @@ void setbailoutformula(bailouts test)
         if (g_debug_flag != debug_flags::prevent_287_math)
         {
             floatbailout = asmfpMANRbailout;
+            g_ctx.bailout = asmfpMANRbailout;
         }
         else
         {
             floatbailout = fpMANRbailout;
+            g_ctx.bailout = fpMANRbailout;
         }
         if (g_debug_flag != debug_flags::prevent_386_math)
         {
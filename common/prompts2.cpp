@@ -97,7 +97,7 @@ int get_toggles()
     int old_fillcolor;
     int old_stoppass;
     double old_closeprox;
-    char const *calcmodes[] = {"1", "2", "3", "g", "g1", "g2", "g3", "g4", "g5", "g6", "b", "s", "t", "d", "o"};
+    char const *calcmodes[] = {"1", "2", "3", "g", "g1", "g2", "g3", "g4", "g5", "g6", "b", "s", "t", "d", "o", "m"};
     char const *soundmodes[5] = {"off", "beep", "x", "y", "z"};
     char const *insidemodes[] = {"numb", "maxiter", "zmag", "bof60", "bof61", "epsiloncross",
                           "startrail", "period", "atan", "fmod"
@@ -108,7 +108,7 @@ int get_toggles()
 
     k = -1;
 
-    choices[++k] = "Passes (1,2,3, g[uess], b[ound], t[ess], d[iffu], o[rbit])";
+    choices[++k] = "Passes (1,2,3, g[uess], b[ound], t[ess], d[iffu], o[rbit], m[ariani])";
     uvalues[k].type = 'l';
     uvalues[k].uval.ch.vlen = 3;
     uvalues[k].uval.ch.llen = sizeof(calcmodes)/sizeof(*calcmodes);
@@ -128,6 +128,7 @@ int get_toggles()
         : (g_user_std_calc_mode == 's') ? 11
         : (g_user_std_calc_mode == 't') ? 12
         : (g_user_std_calc_mode == 'd') ? 13
+        : (g_user_std_calc_mode == 'm') ? 15
         :        /* "o"rbits */      14;
     old_usr_stdcalcmode = g_user_std_calc_mode;
     old_stoppass = g_stop_pass;
@@ -273,7 +274,7 @@ int get_toggles()
     old_decomp = g_decomp[0];
     uvalues[k].uval.ival = old_decomp;
 
-    choices[++k] = "Fill Color (normal,#) (works with passes=t, b and d)";
+    choices[++k] = "Fill Color (normal,#) (works with passes=t, b, d and m)";
     uvalues[k].type = 's';
     if (g_fill_color < 0)
     {
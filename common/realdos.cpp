@@ -2021,8 +2021,8 @@ void load_fractint_config()
         vident.videomodecx = cx;
         vident.videomodedx = dx;
         vident.dotmode     = truecolorbits * 1000 + textsafe2 * 100 + dotmode;
-        vident.xdots       = (short)xdots;
-        vident.ydots       = (short)ydots;
+        vident.xdots       = (int)xdots;
+        vident.ydots       = (int)ydots;
         vident.colors      = colors;
 
         // if valid, add to supported modes
@@ -97,13 +97,13 @@ static long iteration(
     double re, double im,
     long start)
 {
-    g_old_z.x = re;
-    g_old_z.y = im;
-    g_temp_sqr_x = sqr(g_old_z.x);
-    g_temp_sqr_y = sqr(g_old_z.y);
-    g_float_param = &g_init;
-    g_float_param->x = cr;
-    g_float_param->y = ci;
+    g_ctx.old_z.x = re;
+    g_ctx.old_z.y = im;
+    g_ctx.temp_sqr_x = sqr(g_ctx.old_z.x);
+    g_ctx.temp_sqr_y = sqr(g_ctx.old_z.y);
+    g_ctx.float_param = &g_ctx.init;
+    g_ctx.float_param->x = cr;
+    g_ctx.float_param->y = ci;
     while (ORBIT_CALC() == 0 && start < g_max_iterations)
     {
         start++;
@@ -414,8 +414,8 @@ scan:
     tempsqry = iq;                              \
     old.x = zr;                                 \
     old.y = zi;                                 \
-    g_float_param->x = cr;                      \
-    g_float_param->y = ci;                      \
+    g_ctx.float_param->x = cr;                      \
+    g_ctx.float_param->y = ci;                      \
     (esc) = ORBITCALC();                        \
     (rq) = tempsqrx;                            \
     (iq) = tempsqry;                            \
@@ -682,6 +682,10 @@ static int check_pan() // return 0 if can't, alignment requirement if can
     {
         return 0; // tesselate, can't do it
     }
+    if (g_std_calc_mode == 'm')
+    {
+        return 0; // mariani-silver: can't do it either
+    }
     if (g_std_calc_mode == 'd')
     {
         return 0; // diffusion scan: can't do it either
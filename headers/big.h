@@ -11,6 +11,15 @@
 ****************************************************************/
 #define LOG10_256 2.4082399653118
 #define LOG_256   5.5451774444795
+// The multiplications in bignumc.c work on 64 bit limbs with 128 bit
+// products where the compiler has them.  The numbers themselves are still
+// little endian byte arrays, the limbs only live inside the multiply.
+// Define BIG_16_BIT_LIMBS for the portable 16/32 bit code.
+#if !defined(BIG_16_BIT_LIMBS) && !defined(BIG_64_BIT_LIMBS)
+#if defined(LINUX) && defined(__SIZEOF_INT128__) && !defined(ACCESS_BY_BYTE)
+#define BIG_64_BIT_LIMBS
+#endif
+#endif
 // values that bf_math can hold,
 // 0 = bf_math is not being used
 // 1 = bf_math is being used
@@ -14,5 +14,6 @@ void restore_stack(int old_offset);
 void init_bf_dec(int dec);
 void init_bf_length(int bnl);
 void init_big_pi();
+void bench_big_math();
 
 #endif
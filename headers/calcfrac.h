@@ -4,6 +4,7 @@
 
 #include "big.h"
 
+#include <string>
 #include <vector>
 
 #define MAX_CALC_WORK 12
@@ -20,6 +21,58 @@ struct WORKLIST     // work list entry for std escape time engines
     int xxbegin;    // start col within window, =0 except on resume
 };
 
+// State of the escape time engine while it calculates a pixel.  Each
+// calculating thread has its own in g_ctx; routines that take a
+// CalcContext work on the one they are given, so pixels and images can
+// be calculated side by side.
+struct CalcContext
+{
+    // orbit
+    DComplex old_z;
+    DComplex new_z;
+    DComplex tmp_z;
+    DComplex init;
+    DComplex phoenix_y;                 // previous z for the phoenix types
+    double temp_sqr_x;
+    double temp_sqr_y;
+    double magnitude;
+
+    // parameters
+    DComplex *float_param;              // points at init, tmp_z or param_z1
+    DComplex param_z1;
+    DComplex param_z2;
+    DComplex marks_coefficient;
+
+    // bailout
+    double magnitude_limit;
+    int (*bailout)(CalcContext &ctx);   // floatbailout for this context
+
+    // coloring
+    long color_iter;
+    long old_color_iter;
+    long real_color_iter;
+};
+
+// The fractal type, formula, parameters and corners of the image asked for,
+// put back when this goes out of scope.  For the debugflag= checks that
+// draw other types before drawing that image.
+struct SavedFractal
+{
+    SavedFractal();
+    ~SavedFractal();
+    SavedFractal(SavedFractal const &) = delete;
+    SavedFractal &operator=(SavedFractal const &) = delete;
+
+    void use_defaults(fractal_type new_type);
+
+    fractal_type type;
+    std::string formula_filename;
+    std::string formula_name;
+    double params[MAX_PARAMS];
+    double corners[6];                  // xmin, xmax, ymin, ymax, x3rd, y3rd
+    bf_math_type math;
+};
+
 extern int                   g_and_color;           // AND mask for iteration to get color index
 extern int                   g_atan_colors;
 extern DComplex              g_attractor[];
@@ -29,9 +82,9 @@ extern int                 (*g_calc_type)();
 extern bool                  g_cellular_next_screen;
 extern double                g_close_enough;
 extern double                g_close_proximity;
-extern int                   g_col;
-extern int                   g_color;
-extern long                  g_color_iter;
+extern THREAD_LOCAL int      g_col;
+extern THREAD_LOCAL int      g_color;
+extern THREAD_LOCAL CalcContext g_ctx;
 extern int                   g_current_column;
 extern int                   g_current_pass;
 extern int                   g_current_row;
@@ -48,43 +101,35 @@ extern int                   g_i_x_start;
 extern int                   g_i_x_stop;
 extern int                   g_i_y_start;
 extern int                   g_i_y_stop;
-extern DComplex              g_init;
 extern int                   g_invert;
-extern int                   g_keyboard_check_interval;
+extern THREAD_LOCAL int      g_keyboard_check_interval;
 extern LComplex              g_l_attractor[];
 extern long                  g_l_close_enough;
 extern LComplex              g_l_init_orbit;
-extern long                  g_l_magnitude;
+extern THREAD_LOCAL long     g_l_magnitude;
 extern long                  g_l_magnitude_limit;
 extern long                  g_l_magnitude_limit2;
-extern double                g_magnitude;
 extern bool                  g_magnitude_calc;
-extern double                g_magnitude_limit;
 extern double                g_magnitude_limit2;
 extern int                   g_max_keyboard_check_interval;
-extern DComplex              g_new_z;
 extern int                   g_num_work_list;
-extern long                  g_old_color_iter;
 extern bool                  g_old_demm_colors;
-extern DComplex              g_old_z;
 extern int                   g_orbit_color;
-extern int                   g_orbit_save_index;
+extern THREAD_LOCAL int      g_orbit_save_index;
 extern int                   g_periodicity_check;
 extern int                   g_periodicity_next_saved_incr;
 extern int                   g_pi_in_pixels;
-extern void                (*g_plot)(int, int, int);
+extern THREAD_LOCAL void    (*g_plot)(int, int, int);
 extern void                (*g_put_color)(int, int, int);
 extern bool                  g_quick_calc;
-extern long                  g_real_color_iter;
-extern bool                  g_reset_periodicity;
+extern THREAD_LOCAL bool     g_reset_periodicity;
 extern std::vector<BYTE>     g_resume_data;
 extern bool                  g_resuming;
-extern int                   g_row;
-extern bool                  g_show_orbit;
+extern THREAD_LOCAL int      g_row;
+extern THREAD_LOCAL bool     g_show_orbit;
 extern symmetry_type         g_symmetry;
 extern bool                  g_three_pass;
 extern int                   g_total_passes;
-extern DComplex              g_tmp_z;
 extern bool                  g_use_old_periodicity;
 extern bool                  g_use_old_distance_estimator;
 extern WORKLIST              g_work_list[MAX_CALC_WORK];
@@ -0,0 +1,30 @@
+#pragma once
+#if !defined(CALCLANE_H)
+#define CALCLANE_H
+
+// the lanes use GCC vector extensions, compiled for AVX2 and used when
+// the CPU has it; elsewhere calc_lanes() is 0
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CALC_VECTOR_LANES
+// everything the batch calls is compiled for AVX2 as well, so that calls
+// out of the vector code don't pay for switching to SSE
+#define LANE_CODE __attribute__((target("avx2")))
+#else
+#define LANE_CODE
+#endif
+
+#define MAX_LANE_BATCH 256
+#define FORMULA_LANES 4     // pixels a formula iterates side by side
+
+struct LanePixel            // a pixel iterated by calc_lanes_batch()
+{
+    long color_iter;        // as standard_fractal()'s loop leaves it
+    DComplex new_z;
+    bool caught_a_cycle;
+};
+
+extern int calc_lanes();
+extern long calc_lanes_batch(int const *cols, int count, LanePixel *result);
+extern int bench_lanes();
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#if !defined(CALCPOOL_H)
+#define CALCPOOL_H
+
+#include <functional>
+
+extern int                   g_calc_threads;        // threads= option, 0 for one per cpu
+
+extern unsigned calc_pool_threads();
+extern bool calc_pool_usable();
+extern int calc_pool_rows(int passnum, int (*calc_row)(int passnum), void (*rows_done)(int row));
+extern int calc_pool_strips(int num_strips, bool (*calc_strip)(int strip), void (*strip_done)(int strip));
+extern int calc_pool_tasks(std::function<bool()> task, void (*drain)());
+extern void calc_pool_spawn(std::function<bool()> task);
+extern bool calc_pool_worker();
+extern bool calc_pool_interrupted();
+
+#endif
@@ -2,7 +2,18 @@
 #if !defined(CALMANFP_H)
 #define CALMANFP_H
 
+#define MAX_MANDFP_LANES 4
+
+struct MandelFPPixel        // a pixel calculated by calcmandfpasm_batch()
+{
+    long color_iter;
+    long real_color_iter;
+    double magnitude;
+};
+
 extern void calcmandfpasmstart();
 extern long calcmandfpasm();
+extern int calcmandfpasm_lanes();
+extern long calcmandfpasm_batch(DComplex const *init, int count, MandelFPPixel *result);
 
 #endif
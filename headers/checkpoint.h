@@ -0,0 +1,15 @@
+#pragma once
+#if !defined(CHECKPOINT_H)
+#define CHECKPOINT_H
+
+#include <string>
+
+extern std::string           g_checkpoint_filename; // checkpoint= option, empty for none
+
+extern void checkpoint_start();
+extern void checkpoint_pass_start(int row);
+extern void checkpoint_rows_done(int row);
+extern void checkpoint_work_done(bool force);
+extern void checkpoint_end();
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+#if !defined(DENSITY_H)
+#define DENSITY_H
+
+extern double                g_density_gamma;       // density= option, 0 for off
+
+extern bool density_start();
+extern void density_hit(int x, int y);
+extern void density_hit_shared(int x, int y);
+extern void density_plot(int x, int y, int color);
+extern void density_update();
+extern void density_show();
+extern bool density_end();
+
+#endif
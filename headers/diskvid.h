@@ -15,6 +15,8 @@ extern int targa_startdisk(std::FILE *, int);
 extern void enddisk();
 extern int readdisk(int, int);
 extern void writedisk(int, int, int);
+extern void readdisk_span(int row, int col, int lastcol, BYTE *pixels);
+extern void writedisk_span(int row, int col, int lastcol, BYTE const *pixels);
 extern void targa_readdisk(unsigned int, unsigned int, BYTE *, BYTE *, BYTE *);
 extern void targa_writedisk(unsigned int, unsigned int, BYTE, BYTE, BYTE);
 extern void dvid_status(int line, char const *msg);
@@ -163,16 +163,19 @@ struct Driver
   }
 /* Define the drivers to be included in the compilation:
     HAVE_CURSES_DRIVER      Curses based disk driver
+    HAVE_HEADLESS_DRIVER    In-memory driver with no display
     HAVE_X11_DRIVER         XFractint code path
     HAVE_GDI_DRIVER         Win32 GDI driver
     HAVE_WIN32_DISK_DRIVER  Win32 disk driver
 */
 #if defined(XFRACT)
+#define HAVE_HEADLESS_DRIVER    1
 #define HAVE_X11_DRIVER         1
 #define HAVE_GDI_DRIVER         0
 #define HAVE_WIN32_DISK_DRIVER  0
 #endif
 #if defined(_WIN32)
+#define HAVE_HEADLESS_DRIVER    0
 #define HAVE_X11_DRIVER         0
 #define HAVE_GDI_DRIVER         1
 #define HAVE_WIN32_DISK_DRIVER  1
@@ -3,11 +3,17 @@
 
 #include <string>
 
+struct FRACTAL_INFO;
+
 extern BYTE                  g_block[];
 
 extern int savetodisk(char *filename);
 extern int savetodisk(std::string &filename);
 extern bool encoder();
+extern void encoder_start_ahead();
+extern void encoder_rows_done(int row);
+extern void encoder_cancel_ahead();
 extern int new_to_old(int new_fractype);
+extern void setup_save_info(FRACTAL_INFO *save_info);
 
 #endif
@@ -2,6 +2,8 @@
 #if !defined(FRACSUBA_H)
 #define FRACSUBA_H
 
+struct CalcContext;
+
 // fracsuba -- assembler file prototypes
 extern int asmlMODbailout();
 extern int asmlREALbailout();
@@ -18,11 +20,18 @@ extern int asm386lANDbailout();
 extern int asm386lMANHbailout();
 extern int asm386lMANRbailout();
 extern int asmfpMODbailout();
+extern int asmfpMODbailout(CalcContext &ctx);
 extern int asmfpREALbailout();
+extern int asmfpREALbailout(CalcContext &ctx);
 extern int asmfpIMAGbailout();
+extern int asmfpIMAGbailout(CalcContext &ctx);
 extern int asmfpORbailout();
+extern int asmfpORbailout(CalcContext &ctx);
 extern int asmfpANDbailout();
+extern int asmfpANDbailout(CalcContext &ctx);
 extern int asmfpMANHbailout();
+extern int asmfpMANHbailout(CalcContext &ctx);
 extern int asmfpMANRbailout();
+extern int asmfpMANRbailout(CalcContext &ctx);
 
 #endif
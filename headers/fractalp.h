@@ -5,6 +5,8 @@
 #include "big.h"
 #include "helpdefs.h"
 
+struct CalcContext;
+
 struct AlternateMath
 {
     fractal_type type;                  // index in fractalname of the fractal
@@ -56,6 +58,8 @@ struct fractalspecificstuff
     bool (*per_image)();                // once-per-image setup
     int (*calctype)();                  // name of main fractal function
     int orbit_bailout;                  // usual bailout value for orbit calc
+    int (*orbitcalc_ctx)(CalcContext &); // orbitcalc on a given context, if it has one
+    int (*per_pixel_ctx)(CalcContext &); // per_pixel on a given context, if it has one
 };
 
 extern AlternateMath         g_alternate_math[];    // alternate math function pointers
@@ -6,6 +6,7 @@
 
 #include <vector>
 
+struct CalcContext;
 struct MP;
 struct MPC;
 
@@ -17,7 +18,6 @@ extern int                   g_degree;
 extern double                g_degree_minus_1_over_degree;
 extern double              (*g_dx_pixel)();
 extern double              (*g_dy_pixel)();
-extern DComplex *            g_float_param;
 extern long                  g_fudge_half;
 extern long                  g_fudge_one;
 extern long                  g_fudge_two;
@@ -37,7 +37,6 @@ extern long                  g_l_temp_sqr_y;
 extern long                (*g_l_x_pixel)();
 extern long                (*g_l_y_pixel)();
 extern LComplex *            g_long_param;
-extern DComplex              g_marks_coefficient;
 extern int                   g_max_color;
 extern MP                    g_mp_degree_minus_1_over_degree;
 extern MP                    g_mp_one;
@@ -48,9 +47,7 @@ extern std::vector<MPC>      g_mpc_roots;
 extern MPC                   g_mpc_temp_param;
 extern MP                    g_newton_mp_r_over_d;
 extern double                g_newton_r_over_d;
-extern bool                  g_overflow;
-extern DComplex              g_param_z1;
-extern DComplex              g_param_z2;
+extern THREAD_LOCAL bool     g_overflow;
 extern DComplex              g_power_z;
 extern double                g_quaternion_c;
 extern double                g_quaternion_ci;
@@ -58,8 +55,6 @@ extern double                g_quaternion_cj;
 extern double                g_quaternino_ck;
 extern std::vector<DComplex> g_roots;
 extern double                g_sin_x;
-extern double                g_temp_sqr_x;
-extern double                g_temp_sqr_y;
 extern double                g_threshold;
 extern long                  g_xx_one;
 
@@ -74,25 +69,32 @@ extern int Barnsley2Fractal();
 extern int Barnsley2FPFractal();
 extern int JuliaFractal();
 extern int JuliafpFractal();
+extern int JuliafpFractal(CalcContext &ctx);
 extern int LambdaFPFractal();
+extern int LambdaFPFractal(CalcContext &ctx);
 extern int LambdaFractal();
 extern int SierpinskiFractal();
 extern int SierpinskiFPFractal();
+extern int SierpinskiFPFractal(CalcContext &ctx);
 extern int LambdaexponentFractal();
 extern int LongLambdaexponentFractal();
 extern int FloatTrigPlusExponentFractal();
 extern int LongTrigPlusExponentFractal();
 extern int MarksLambdaFractal();
 extern int MarksLambdafpFractal();
+extern int MarksLambdafpFractal(CalcContext &ctx);
 extern int UnityFractal();
 extern int UnityfpFractal();
 extern int Mandel4Fractal();
 extern int Mandel4fpFractal();
+extern int Mandel4fpFractal(CalcContext &ctx);
 extern int floatZtozPluszpwrFractal();
 extern int longZpowerFractal();
 extern int longCmplxZpowerFractal();
 extern int floatZpowerFractal();
+extern int floatZpowerFractal(CalcContext &ctx);
 extern int floatCmplxZpowerFractal();
+extern int floatCmplxZpowerFractal(CalcContext &ctx);
 extern int Barnsley3Fractal();
 extern int Barnsley3FPFractal();
 extern int TrigPlusZsquaredFractal();
@@ -160,13 +162,18 @@ extern int marks_mandelpwr_per_pixel();
 extern int mandel_per_pixel();
 extern int marksmandel_per_pixel();
 extern int marksmandelfp_per_pixel();
+extern int marksmandelfp_per_pixel(CalcContext &ctx);
 extern int marks_mandelpwrfp_per_pixel();
 extern int mandelfp_per_pixel();
+extern int mandelfp_per_pixel(CalcContext &ctx);
 extern int juliafp_per_pixel();
+extern int juliafp_per_pixel(CalcContext &ctx);
 extern int MPCjulia_per_pixel();
 extern int otherrichard8fp_per_pixel();
 extern int othermandelfp_per_pixel();
+extern int othermandelfp_per_pixel(CalcContext &ctx);
 extern int otherjuliafp_per_pixel();
+extern int otherjuliafp_per_pixel(CalcContext &ctx);
 extern int MarksCplxMandperp();
 extern int LambdaTrigOrTrigFractal();
 extern int LambdaTrigOrTrigfpFractal();
@@ -184,24 +191,35 @@ extern int quaternionfp_per_pixel();
 extern int quaternionjulfp_per_pixel();
 extern int LongPhoenixFractal();
 extern int PhoenixFractal();
+extern int PhoenixFractal(CalcContext &ctx);
 extern int long_phoenix_per_pixel();
 extern int phoenix_per_pixel();
+extern int phoenix_per_pixel(CalcContext &ctx);
 extern int long_mandphoenix_per_pixel();
 extern int mandphoenix_per_pixel();
+extern int mandphoenix_per_pixel(CalcContext &ctx);
 extern int HyperComplexFPFractal();
 extern int LongPhoenixFractalcplx();
 extern int PhoenixFractalcplx();
+extern int PhoenixFractalcplx(CalcContext &ctx);
 extern int (*floatbailout)();
 extern int (*longbailout)();
 extern int (*bignumbailout)();
 extern int (*bigfltbailout)();
 extern int fpMODbailout();
+extern int fpMODbailout(CalcContext &ctx);
 extern int fpREALbailout();
+extern int fpREALbailout(CalcContext &ctx);
 extern int fpIMAGbailout();
+extern int fpIMAGbailout(CalcContext &ctx);
 extern int fpORbailout();
+extern int fpORbailout(CalcContext &ctx);
 extern int fpANDbailout();
+extern int fpANDbailout(CalcContext &ctx);
 extern int fpMANHbailout();
+extern int fpMANHbailout(CalcContext &ctx);
 extern int fpMANRbailout();
+extern int fpMANRbailout(CalcContext &ctx);
 extern int bnMODbailout();
 extern int bnREALbailout();
 extern int bnIMAGbailout();
@@ -222,8 +240,10 @@ extern int LongPhoenixFractalcplx();
 extern int PhoenixFractalcplx();
 extern int LongPhoenixPlusFractal();
 extern int PhoenixPlusFractal();
+extern int PhoenixPlusFractal(CalcContext &ctx);
 extern int LongPhoenixMinusFractal();
 extern int PhoenixMinusFractal();
+extern int PhoenixMinusFractal(CalcContext &ctx);
 extern int LongPhoenixCplxPlusFractal();
 extern int PhoenixCplxPlusFractal();
 extern int LongPhoenixCplxMinusFractal();
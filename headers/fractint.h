@@ -40,7 +40,7 @@ names. So for now humor us and let's keep the names short.
 #define MSG_LEN 80                  // handy buffer size for messages
 #define MAX_COMMENT_LEN 57          // length of par comments
 #define MAX_PARAMS 10               // maximum number of parameters
-#define MAX_PIXELS   32767          // Maximum pixel count across/down the screen
+#define MAX_PIXELS   131071         // Maximum pixel count across/down the screen
 #define OLD_MAX_PIXELS 2048         // Limit of some old fixed arrays
 #define MIN_PIXELS 10               // Minimum pixel count across/down the screen
 #define DEFAULT_ASPECT 1.0F         // Assumed overall screen dimensions, y/x
@@ -59,6 +59,10 @@ enum debug_flags
     write_formula_debug_information     = 98,
     allow_init_commands_anytime         = 110,
     benchmark_encoder                   = 200,
+    benchmark_big_math                  = 202,
+    benchmark_tesseral                  = 204,
+    benchmark_lanes                     = 206,
+    check_formula_parsers               = 208,
     prevent_miim                        = 300,
     prevent_formula_optimizer           = 322,
     show_formula_info_after_compile     = 324,
@@ -77,15 +81,18 @@ enum debug_flags
     force_smaller_bitshift              = 1234,
     show_float_flag                     = 2224,
     force_arbitrary_precision_math      = 3200,
+    prevent_perturbation                = 3202,
     prevent_arbitrary_precision_math    = 3400,
     use_soi_long_double                 = 3444,
     prevent_plasma_random               = 3600,
     prevent_coordinate_grid             = 3800,
     allow_negative_cross_product        = 4010,
     force_old_sleep                     = 4020,
+    force_old_decoder                   = 4040,
     force_scaled_sound_formula          = 4030,
     force_disk_min_cache                = 4200,
     force_complex_power                 = 6000,
+    prevent_simd_math                   = 8086,
     prevent_386_math                    = 8088,
     display_memory_statistics           = 10000
 };
@@ -7,6 +7,7 @@ extern unsigned              g_num_colors;
 
 extern int get_byte();
 extern int get_bytes(BYTE *, int);
+extern void unget_byte(int);
 extern int gifview();
 
 #endif
@@ -38,6 +38,8 @@ extern double                g_orbit_corner_max_y;
 extern double                g_orbit_corner_min_x;
 extern double                g_orbit_corner_min_y;
 extern long                  g_orbit_interval;
+extern bool                  g_orbit_rk4;
+extern int                   g_orbit_trajectories;
 extern bool                  g_set_orbit_corners;
 
 extern bool orbit3dlongsetup();
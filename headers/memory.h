@@ -18,6 +18,7 @@ extern void InitMemory();
 extern void ExitCheck();
 extern U16 MemoryAlloc(U16 size, long count, int stored_at);
 extern void MemoryRelease(U16 handle);
+extern BYTE *MemoryMap(U16 handle);
 extern bool CopyFromMemoryToHandle(BYTE const *buffer, U16 size, long count, long offset, U16 handle);
 extern bool CopyFromHandleToMemory(BYTE *buffer, U16 size, long count, long offset, U16 handle);
 extern bool SetMemory(int value, U16 size, long count, long offset, U16 handle);
@@ -330,8 +330,8 @@ inline void CMPLXsqr(const DComplex &arg, DComplex &out)
 }
 inline void CMPLXsqr_old(DComplex &out)
 {
-    out.y = (g_old_z.x+g_old_z.x) * g_old_z.y;
-    out.x = g_temp_sqr_x - g_temp_sqr_y;
+    out.y = (g_ctx.old_z.x+g_ctx.old_z.x) * g_ctx.old_z.y;
+    out.x = g_ctx.temp_sqr_x - g_ctx.temp_sqr_y;
 }
 inline void CMPLXpwr(const DComplex &arg1, const DComplex &arg2, DComplex &out)
 {
@@ -0,0 +1,19 @@
+#pragma once
+#if !defined(ORBITSAVE_H)
+#define ORBITSAVE_H
+
+enum class orbit_save_format
+{
+    text,                               // orbitsave=yes, the Acrospin pointlist
+    float32,                            // orbitsave=float
+    float64                             // orbitsave=double
+};
+
+extern orbit_save_format     g_orbit_save_format;   // orbitsave= format of ORBITS.RAW
+extern bool                  g_orbit_save_delta;    // orbitsave=.../delta
+
+extern bool orbit_save_open();
+extern void orbit_save_point(double x, double y, double z, int color);
+extern void orbit_save_close();
+
+#endif
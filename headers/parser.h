@@ -38,13 +38,17 @@ extern bool                  g_frm_uses_p5;
 extern double                g_fudge_limit;
 extern std::vector<fn_operand> g_function_operands;
 extern bool                  g_is_mandelbrot;
+extern bool                  g_lane_formula;
 extern int                   g_last_init_op;
 extern unsigned              g_last_op;
 extern int                   g_load_index;
+extern unsigned              g_loop_op_count;
 extern char                  g_max_function;
 extern unsigned              g_max_function_args;
 extern unsigned              g_max_function_ops;
 extern unsigned              g_operation_index;
+extern unsigned              g_parsed_loop_op_count;
+extern unsigned              g_parsed_op_count;
 extern int                   g_store_index;
 extern unsigned              g_variable_index;
 
@@ -208,6 +212,14 @@ extern void NotAFnct();
 extern void FnctNotFound();
 extern int CvtStk();
 extern int fFormula();
+extern bool dtCvtStk();
+extern int dtFormula();
+extern int dtform_per_pixel();
+extern bool laneCvtStk();
+extern void laneFormula(double *new_x, double *new_y, long long *escaped);
+extern void lane_form_per_pixel(int lane);
+extern int formula_fn_args(void (*fn)());
+extern bool formula_fn_is_pure(void (*fn)());
 extern void RecSortPrec();
 extern int Formula();
 extern int BadFormula();
@@ -216,6 +228,7 @@ extern int frm_get_param_stuff(char const *Name);
 extern bool RunForm(char const *Name, bool from_prompts1c);
 extern bool fpFormulaSetup();
 extern bool intFormulaSetup();
+extern int check_formulas();
 extern void init_misc();
 extern void free_workarea();
 extern int fill_if_group(int endif_index, JUMP_PTRS_ST *jump_data);
@@ -0,0 +1,8 @@
+#pragma once
+#if !defined(PERTURB_H)
+#define PERTURB_H
+
+extern void perturb_start_image();
+extern int perturb_pixel();
+
+#endif
@@ -95,4 +95,13 @@ typedef int sigfunc(int);
                                 ((*((unsigned char*)&(c)+1)) << 8)
 #endif
 using LDBL = long double;
+
+// Per-thread storage for the calculation engine.  __thread has no dynamic
+// initialization, so gcc doesn't put a guard on every access from another
+// file the way it does for an extern thread_local.
+#if defined(__GNUC__)
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL thread_local
+#endif
 #endif  /* PORT_H */
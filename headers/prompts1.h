@@ -73,7 +73,14 @@ extern void setbailoutformula(bailouts);
 extern int find_extra_param(fractal_type type);
 extern void load_params(fractal_type fractype);
 extern bool check_orbit_name(char const *orbitname);
-struct entryinfo;
+#define MAXENTRIES 2000L
+
+struct entryinfo
+{
+    char name[ITEM_NAME_LEN+2];
+    long point; // points to the ( or the { following the name
+};
+
 extern int scan_entries(std::FILE *infile, struct entryinfo *ch, char const *itemname);
 
 #endif
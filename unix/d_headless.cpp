@@ -0,0 +1,566 @@
+// A driver with no display at all, for rendering in batch mode on a
+// machine without an X server.
+//
+// The image lives in a framebuffer in memory, one byte per pixel, and
+// the spans are copied in and out of it directly.  Truecolor pixels are
+// kept in a second buffer of RGBA values, allocated the first time one is
+// written.  There is no text screen and no keyboard: text goes nowhere,
+// no key is ever pressed and waiting for a key gets <Esc>.
+//
+// The driver is used instead of the X11 driver when DISPLAY is not set or
+// the command line says driver=headless.  An image too big for memory is
+// kept in disk video instead.
+//
+#include "port.h"
+#include "prototyp.h"
+
+#include "calcfrac.h"
+#include "diskvid.h"
+#include "drivers.h"
+#include "fractint.h"
+#include "id_data.h"
+#include "rotate.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+extern void fpe_handler(int signum);
+extern void set_normal_dot();
+extern void set_disk_dot();
+extern void set_disk_line();
+extern void set_driver_line();
+
+#define DRIVER_MODE(name_, comment_, key_, width_, height_, mode_) \
+    { name_, comment_, key_, 0, 0, 0, 0, mode_, width_, height_, 256 }
+#define MODE19(n_, c_, k_, w_, h_) DRIVER_MODE(n_, c_, k_, w_, h_, 19)
+#define HEADLESS_MODE(w_, h_) \
+    MODE19("Headless Video           ", "                         ", 0, w_, h_)
+static const VIDEOINFO modes[] =
+{
+    // 4:3 aspect ratio
+    HEADLESS_MODE(640, 480),
+    HEADLESS_MODE(800, 480),
+    HEADLESS_MODE(800, 600),
+    HEADLESS_MODE(1024, 768),
+    HEADLESS_MODE(1280, 960),
+    HEADLESS_MODE(1400, 1050),
+    HEADLESS_MODE(1600, 1200),
+    HEADLESS_MODE(2048, 1536),
+    HEADLESS_MODE(4096, 3072),
+    HEADLESS_MODE(8192, 6144),
+
+    // 16:9 aspect ratio
+    HEADLESS_MODE(854, 480),
+    HEADLESS_MODE(1280, 720),
+    HEADLESS_MODE(1366, 768),
+    HEADLESS_MODE(1920, 1080),
+    HEADLESS_MODE(3840, 2160),
+    HEADLESS_MODE(7680, 4320),
+
+    // 8:5 (16:10) aspect ratio
+    HEADLESS_MODE(320, 200),
+    HEADLESS_MODE(1280, 800),
+    HEADLESS_MODE(1440, 900),
+    HEADLESS_MODE(1680, 1050),
+    HEADLESS_MODE(1920, 1200),
+    HEADLESS_MODE(2560, 1600)
+};
+
+struct DriverHeadless
+{
+    Driver pub;
+    int width;                          // of the framebuffer
+    int height;
+    std::vector<BYTE> pixels;           // width x height color indices
+    std::vector<BYTE> truecolor;        // width x height RGBA, or empty
+    BYTE dac[256][3];                   // the palette
+    int key_buffer;                     // key from unget_key, or 0
+};
+
+#define DIHEADLESS(arg_) DriverHeadless *di = (DriverHeadless *) (arg_)
+
+// Same as the X11 driver's starting palette.
+static void init_dac(BYTE dac[256][3])
+{
+    for (int i = 0; i < 256; i++)
+    {
+        dac[i][0] = (i >> 5)*8+7;
+        dac[i][1] = (((i+16) & 28) >> 2)*8+7;
+        dac[i][2] = (((i+2) & 3))*16+15;
+    }
+    dac[0][0] = 0;
+    dac[0][1] = 0;
+    dac[0][2] = 0;
+    dac[1][0] = 63;
+    dac[1][1] = 63;
+    dac[1][2] = 63;
+    dac[2][0] = 47;
+    dac[2][1] = 63;
+    dac[2][2] = 63;
+}
+
+// Clip the span x..lastx of row y to the framebuffer, setting skip to the
+// number of pixels cut off on the left.  Returns false if nothing is left.
+static bool clip_span(DriverHeadless const *di, int y, int &x, int &lastx, int &skip)
+{
+    if (y < 0 || y >= di->height)
+    {
+        return false;
+    }
+    skip = x < 0 ? -x : 0;
+    x += skip;
+    lastx = std::min(lastx, di->width - 1);
+    return x <= lastx;
+}
+
+static BYTE *pixel_ptr(DriverHeadless *di, int x, int y)
+{
+    return &di->pixels[(std::size_t) y*di->width + x];
+}
+
+static void
+headless_terminate(Driver *drv)
+{
+    DIHEADLESS(drv);
+    std::vector<BYTE>().swap(di->pixels);
+    std::vector<BYTE>().swap(di->truecolor);
+    di->width = 0;
+    di->height = 0;
+}
+
+static bool
+headless_init(Driver *drv, int *argc, char **argv)
+{
+    DIHEADLESS(drv);
+
+    // filter out driver=headless
+    bool requested = false;
+    {
+        int count = *argc;
+        std::vector<char *> filtered;
+        for (int i = 0; i < count; i++)
+        {
+            if (std::strcmp(argv[i], "driver=headless") == 0)
+            {
+                requested = true;
+            }
+            else
+            {
+                filtered.push_back(argv[i]);
+            }
+        }
+        std::copy(filtered.begin(), filtered.end(), argv);
+        *argc = filtered.size();
+    }
+    if (!requested && std::getenv("DISPLAY") != nullptr)
+    {
+        return false;
+    }
+
+    init_dac(di->dac);
+    std::memcpy(g_dac_box, di->dac, sizeof(di->dac));
+    std::signal(SIGFPE, fpe_handler);
+
+    for (auto m : modes)
+    {
+        add_video_mode(drv, &m);
+    }
+    return true;
+}
+
+// Any 256 color mode from fractint.cfg fits in memory or on disk.
+static bool
+headless_validate_mode(Driver *drv, VIDEOINFO *mode)
+{
+    return mode->dotmode % 100 == 19 && mode->colors == 256;
+}
+
+static void
+headless_get_max_screen(Driver *drv, int *xmax, int *ymax)
+{
+    if (xmax != nullptr)
+    {
+        *xmax = -1;
+    }
+    if (ymax != nullptr)
+    {
+        *ymax = -1;
+    }
+}
+
+static void
+headless_pause(Driver *drv)
+{
+}
+
+static void
+headless_resume(Driver *drv)
+{
+}
+
+static void
+headless_schedule_alarm(Driver *drv, int secs)
+{
+}
+
+static void
+headless_window(Driver *drv)
+{
+}
+
+static bool
+headless_resize(Driver *drv)
+{
+    return false;
+}
+
+static void
+headless_redraw(Driver *drv)
+{
+}
+
+static int
+headless_read_palette(Driver *drv)
+{
+    DIHEADLESS(drv);
+    std::memcpy(g_dac_box, di->dac, sizeof(di->dac));
+    return 0;
+}
+
+static int
+headless_write_palette(Driver *drv)
+{
+    DIHEADLESS(drv);
+    std::memcpy(di->dac, g_dac_box, sizeof(di->dac));
+    return 0;
+}
+
+static int
+headless_read_pixel(Driver *drv, int x, int y)
+{
+    DIHEADLESS(drv);
+    if (x < 0 || y < 0 || x >= di->width || y >= di->height)
+    {
+        return 0;
+    }
+    return *pixel_ptr(di, x, y);
+}
+
+static void
+headless_write_pixel(Driver *drv, int x, int y, int color)
+{
+    DIHEADLESS(drv);
+    if (x < 0 || y < 0 || x >= di->width || y >= di->height)
+    {
+        return;
+    }
+    *pixel_ptr(di, x, y) = (BYTE) color;
+}
+
+static void
+headless_read_span(Driver *drv, int y, int x, int lastx, BYTE *pixels)
+{
+    DIHEADLESS(drv);
+    int skip;
+    if (clip_span(di, y, x, lastx, skip))
+    {
+        std::memcpy(pixels + skip, pixel_ptr(di, x, y), lastx - x + 1);
+    }
+}
+
+static void
+headless_write_span(Driver *drv, int y, int x, int lastx, BYTE *pixels)
+{
+    DIHEADLESS(drv);
+    int skip;
+    if (clip_span(di, y, x, lastx, skip))
+    {
+        std::memcpy(pixel_ptr(di, x, y), pixels + skip, lastx - x + 1);
+    }
+}
+
+static void
+headless_get_truecolor(Driver *drv, int x, int y, int *r, int *g, int *b, int *a)
+{
+    DIHEADLESS(drv);
+    BYTE rgba[4] = { 0, 0, 0, 0 };
+    if (!di->truecolor.empty()
+        && x >= 0 && y >= 0 && x < di->width && y < di->height)
+    {
+        std::memcpy(rgba, &di->truecolor[((std::size_t) y*di->width + x)*4], 4);
+    }
+    *r = rgba[0];
+    *g = rgba[1];
+    *b = rgba[2];
+    if (a != nullptr)
+    {
+        *a = rgba[3];
+    }
+}
+
+static void
+headless_put_truecolor(Driver *drv, int x, int y, int r, int g, int b, int a)
+{
+    DIHEADLESS(drv);
+    if (x < 0 || y < 0 || x >= di->width || y >= di->height)
+    {
+        return;
+    }
+    if (di->truecolor.empty())
+    {
+        di->truecolor.resize((std::size_t) di->width*di->height*4);
+    }
+    BYTE *rgba = &di->truecolor[((std::size_t) y*di->width + x)*4];
+    rgba[0] = (BYTE) r;
+    rgba[1] = (BYTE) g;
+    rgba[2] = (BYTE) b;
+    rgba[3] = (BYTE) a;
+}
+
+static void
+headless_set_line_mode(Driver *drv, int mode)
+{
+}
+
+static void
+headless_draw_line(Driver *drv, int x1, int y1, int x2, int y2, int color)
+{
+}
+
+static void
+headless_display_string(Driver *drv, int x, int y, int fg, int bg, char const *text)
+{
+}
+
+static void
+headless_save_graphics(Driver *drv)
+{
+}
+
+static void
+headless_restore_graphics(Driver *drv)
+{
+}
+
+static int
+headless_get_key(Driver *drv)
+{
+    DIHEADLESS(drv);
+    int const key = di->key_buffer;
+    di->key_buffer = 0;
+    return key != 0 ? key : FIK_ESC;
+}
+
+static int
+headless_key_cursor(Driver *drv, int row, int col)
+{
+    return headless_get_key(drv);
+}
+
+static int
+headless_key_pressed(Driver *drv)
+{
+    DIHEADLESS(drv);
+    return di->key_buffer;
+}
+
+static int
+headless_wait_key_pressed(Driver *drv, int timeout)
+{
+    return headless_key_pressed(drv);
+}
+
+static void
+headless_unget_key(Driver *drv, int key)
+{
+    DIHEADLESS(drv);
+    di->key_buffer = key;
+}
+
+static void
+headless_shell(Driver *drv)
+{
+}
+
+// Point the dot and line routines at the framebuffer, or at disk video
+// if the framebuffer doesn't fit in memory.
+static void
+headless_set_video_mode(Driver *drv, VIDEOINFO *mode)
+{
+    DIHEADLESS(drv);
+    if (g_disk_flag)
+    {
+        enddisk();
+    }
+    std::vector<BYTE>().swap(di->truecolor);
+    g_good_mode = true;
+    switch (g_dot_mode)
+    {
+    case 0:               // text
+        break;
+
+    case 19:
+        di->width = g_screen_x_dots;
+        di->height = g_screen_y_dots;
+        try
+        {
+            di->pixels.assign((std::size_t) di->width*di->height, 0);
+            set_normal_dot();
+            set_driver_line();
+        }
+        catch (std::bad_alloc const &)
+        {
+            std::vector<BYTE>().swap(di->pixels);
+            di->width = 0;
+            di->height = 0;
+            if (startdisk() != 0)
+            {
+                g_good_mode = false;
+                return;
+            }
+            set_disk_dot();
+            set_disk_line();
+        }
+        break;
+
+    default:
+        g_good_mode = false;
+        return;
+    }
+    if (g_dot_mode != 0)
+    {
+        g_got_real_dac = true;
+        headless_read_palette(drv);
+        g_and_color = g_colors-1;
+        g_box_count = 0;
+    }
+}
+
+static void
+headless_put_string(Driver *drv, int row, int col, int attr, char const *msg)
+{
+}
+
+static void
+headless_set_for_text(Driver *drv)
+{
+}
+
+static void
+headless_set_for_graphics(Driver *drv)
+{
+}
+
+static void
+headless_set_clear(Driver *drv)
+{
+}
+
+static void
+headless_move_cursor(Driver *drv, int row, int col)
+{
+}
+
+static void
+headless_hide_text_cursor(Driver *drv)
+{
+}
+
+static void
+headless_set_attr(Driver *drv, int row, int col, int attr, int count)
+{
+}
+
+static void
+headless_scroll_up(Driver *drv, int top, int bot)
+{
+}
+
+static void
+headless_stack_screen(Driver *drv)
+{
+}
+
+static void
+headless_unstack_screen(Driver *drv)
+{
+}
+
+static void
+headless_discard_screen(Driver *drv)
+{
+}
+
+static int
+headless_init_fm(Driver *drv)
+{
+    return 0;
+}
+
+static void
+headless_buzzer(Driver *drv, buzzer_codes kind)
+{
+}
+
+static bool
+headless_sound_on(Driver *drv, int freq)
+{
+    return false;
+}
+
+static void
+headless_sound_off(Driver *drv)
+{
+}
+
+static void
+headless_mute(Driver *drv)
+{
+}
+
+static bool
+headless_diskp(Driver *drv)
+{
+    return false;
+}
+
+static int
+headless_get_char_attr(Driver *drv)
+{
+    return 0;
+}
+
+static void
+headless_put_char_attr(Driver *drv, int char_attr)
+{
+}
+
+static void
+headless_delay(Driver *drv, int ms)
+{
+}
+
+static void
+headless_set_keyboard_timeout(Driver *drv, int ms)
+{
+}
+
+static void
+headless_flush(Driver *drv)
+{
+}
+
+static DriverHeadless headless_driver_info = {
+    STD_DRIVER_STRUCT(headless, "A driver with no display, for batch rendering"),
+    0, 0,                 // width, height
+    {},                   // pixels
+    {},                   // truecolor
+    { { 0 } },            // dac
+    0                     // key_buffer
+};
+
+Driver *headless_driver = &headless_driver_info.pub;
@@ -2,6 +2,7 @@
 #include "prototyp.h"
 
 #include "cmplx.h"
+#include "diskvid.h"
 #include "drivers.h"
 #include "fractint.h"
 #include "mpmath.h"
@@ -12,6 +13,8 @@
 #include <sys/statvfs.h>
 
 #include <cassert>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 
@@ -76,8 +79,16 @@ bool isadirectory(char const *s)
 // converts relative path to absolute path
 int expand_dirname(char *dirname, char *drive)
 {
-    // TODO
-    return -1;
+    char absolute[PATH_MAX];
+    if (realpath(dirname[0] == 0 ? "." : dirname, absolute) == nullptr
+        || std::strlen(absolute) + 1 >= FILE_MAX_DIR)
+    {
+        return -1;
+    }
+    std::strcpy(dirname, absolute);
+    fix_dirname(dirname);
+
+    return 0;
 }
 
 unsigned long get_disk_space()
@@ -93,7 +104,7 @@ void init_failure(char const *message)
 
 extern void (*dotwrite)(int, int, int); // write-a-dot routine
 extern int (*dotread)(int, int);    // read-a-dot routine
-extern void (*linewrite)(int y, int x, int lastx, BYTE *pixels);     // write-a-line routine
+extern void (*linewrite)(int y, int x, int lastx, BYTE const *pixels); // write-a-line routine
 extern void (*lineread)(int y, int x, int lastx, BYTE *pixels);      // read-a-line routine
 
 #if defined(USE_DRIVER_FUNCTIONS)
@@ -120,7 +131,7 @@ void set_normal_dot()
 }
 #endif
 
-void normaline(int y, int x, int lastx, BYTE *pixels)
+void normaline(int y, int x, int lastx, BYTE const *pixels)
 {
     int width = lastx - x + 1;
     assert(dotwrite);
@@ -140,12 +151,41 @@ void normalineread(int y, int x, int lastx, BYTE *pixels)
     }
 }
 
+void set_disk_dot()
+{
+    dotwrite = writedisk;
+    dotread = readdisk;
+}
+
 void set_normal_line()
 {
     lineread = normalineread;
     linewrite = normaline;
 }
 
+void set_disk_line()
+{
+    lineread = readdisk_span;
+    linewrite = writedisk_span;
+}
+
+// the driver's spans, for drivers that copy whole spans at once
+static void driver_line_write(int y, int x, int lastx, BYTE const *pixels)
+{
+    driver_write_span(y, x, lastx, const_cast<BYTE *>(pixels));
+}
+
+static void driver_line_read(int y, int x, int lastx, BYTE *pixels)
+{
+    driver_read_span(y, x, lastx, pixels);
+}
+
+void set_driver_line()
+{
+    lineread = driver_line_read;
+    linewrite = driver_line_write;
+}
+
 static char searchdir[FILE_MAX_DIR];
 static char searchname[FILE_MAX_PATH];
 static char searchext[FILE_MAX_EXT];
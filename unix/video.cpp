@@ -439,7 +439,7 @@ spindac(int dir, int inc)
             }
         }
     }
-    writevideopalette();
+    driver_write_palette();
     driver_delay(g_colors - g_dac_count - 1);
 }
 
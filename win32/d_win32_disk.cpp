@@ -493,7 +493,7 @@ disk_window(Driver *drv)
 ; table.  We use mode 19 for the X window.
 */
 extern void set_disk_dot();
-extern void set_normal_line();
+extern void set_disk_line();
 static void
 disk_set_video_mode(Driver *drv, VIDEOINFO *mode)
 {
@@ -516,7 +516,7 @@ disk_set_video_mode(Driver *drv, VIDEOINFO *mode)
     disk_resize(drv);
 
     set_disk_dot();
-    set_normal_line();
+    set_disk_line();
 }
 
 static void
@@ -740,6 +740,12 @@ void set_normal_line()
     linewrite = normaline;
 }
 
+void set_disk_line()
+{
+    lineread = readdisk_span;
+    linewrite = writedisk_span;
+}
+
 static void nullwrite(int a, int b, int c)
 {
     _ASSERTE(FALSE);